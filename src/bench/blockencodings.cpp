@@ -14,6 +14,7 @@
 #include <test/util/txmempool.h>
 #include <txmempool.h>
 #include <util/check.h>
+#include <util/threadpool.h>
 
 #include <memory>
 #include <vector>
@@ -57,7 +58,7 @@ public:
 };
 } // anon namespace
 
-static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_extra)
+static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_extra, int reconstruction_threads = 0)
 {
     const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
     CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
@@ -99,9 +100,12 @@ static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_
 
     BenchCBHAST cmpctblock{rng, 3000};
 
+    util::ThreadPool workers{"bench"};
+    if (reconstruction_threads > 0) workers.Start(reconstruction_threads);
+
     bench.run([&] {
         PartiallyDownloadedBlock pdb{&pool};
-        auto res = pdb.InitData(cmpctblock, extratxn);
+        auto res = pdb.InitData(cmpctblock, extratxn, &workers);
 
         // if there were duplicates the benchmark will be invalid
         // (eg, extra txns will be skipped) and we will receive
@@ -126,6 +130,22 @@ static void BlockEncodingLargeExtra(benchmark::Bench& bench)
     BlockEncodingBench(bench, 50000, 5000);
 }
 
+// A full mempool of about 300 MB (DEFAULT_MAX_MEMPOOL_SIZE_MB) of these transactions
+static constexpr size_t FULL_MEMPOOL_TXS{260000};
+
+static void BlockEncodingFullMempool(benchmark::Bench& bench)
+{
+    BlockEncodingBench(bench, FULL_MEMPOOL_TXS, 100);
+}
+
+static void BlockEncodingFullMempoolThreads(benchmark::Bench& bench)
+{
+    static_assert(DEFAULT_BLOCK_RECONSTRUCTION_THREADS == 2);
+    BlockEncodingBench(bench, FULL_MEMPOOL_TXS, 100, DEFAULT_BLOCK_RECONSTRUCTION_THREADS);
+}
+
 BENCHMARK(BlockEncodingNoExtra, benchmark::PriorityLevel::HIGH);
 BENCHMARK(BlockEncodingStdExtra, benchmark::PriorityLevel::HIGH);
 BENCHMARK(BlockEncodingLargeExtra, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockEncodingFullMempool, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockEncodingFullMempoolThreads, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,233 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <bench/bench.h>
+#include <common/args.h>
+#include <compat/compat.h>
+#include <httpserver.h>
+#include <netaddress.h>
+#include <netbase.h>
+#include <rpc/protocol.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <util/signalinterrupt.h>
+#include <util/sock.h>
+#include <util/strencodings.h>
+#include <util/threadinterrupt.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+
+using namespace std::chrono_literals;
+
+namespace {
+/** Requests each client sends per iteration. */
+constexpr int REQUESTS_PER_CLIENT{32};
+/** Iterations run upfront to measure the latency of the requests. */
+constexpr int LATENCY_ROUNDS{10};
+constexpr auto CLIENT_TIMEOUT{1min};
+/** A reply of the size of a typical RPC result. */
+const std::string REPLY_BODY{R"({"result":)" + std::string(200, '1') + R"(,"error":null,"id":1})"};
+
+/** A port on the loopback interface that nothing listens on. */
+uint16_t FreePort()
+{
+    const auto sock{CreateSock(AF_INET, SOCK_STREAM, IPPROTO_TCP)};
+    assert(sock);
+    sockaddr_storage storage;
+    socklen_t len{sizeof(storage)};
+    const CService any_port{LookupNumeric("127.0.0.1", 0)};
+    assert(any_port.GetSockAddr(reinterpret_cast<sockaddr*>(&storage), &len));
+    assert(sock->Bind(reinterpret_cast<sockaddr*>(&storage), len) == 0);
+    assert(sock->GetSockName(reinterpret_cast<sockaddr*>(&storage), &len) == 0);
+    CService bound;
+    assert(bound.SetSockAddr(reinterpret_cast<sockaddr*>(&storage), len));
+    return bound.GetPort();
+}
+
+/** The RPC server on a free local port, replying to every request after @p work. */
+class TestServer
+{
+public:
+    const CService addr;
+
+    TestServer(int threads, int work_queue, std::chrono::microseconds work) : addr{LookupNumeric("127.0.0.1", FreePort())}
+    {
+        gArgs.ForceSetArg("-rpcport", util::ToString(addr.GetPort()));
+        gArgs.ForceSetArg("-rpcthreads", util::ToString(threads));
+        gArgs.ForceSetArg("-rpcworkqueue", util::ToString(work_queue));
+        assert(InitHTTPServer(m_interrupt));
+        RegisterHTTPHandler("/", /*exactMatch=*/false, [work](HTTPRequest* req, const std::string&) {
+            if (work > 0us) UninterruptibleSleep(work);
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, REPLY_BODY);
+            return true;
+        });
+        StartHTTPServer();
+    }
+
+    ~TestServer()
+    {
+        InterruptHTTPServer();
+        StopHTTPServer();
+        UnregisterHTTPHandler("/", /*exactMatch=*/false);
+    }
+
+private:
+    util::SignalInterrupt m_interrupt;
+};
+
+/** An HTTP client sending requests and reading the replies in order. */
+class TestClient
+{
+public:
+    explicit TestClient(const CService& addr) : m_sock{ConnectDirectly(addr, /*manual_connection=*/true)}
+    {
+        assert(m_sock);
+    }
+
+    void Send(const std::string& requests)
+    {
+        m_sock->SendComplete(requests, CLIENT_TIMEOUT, m_interrupt);
+    }
+
+    /** Read the next reply and return its status. */
+    int Receive()
+    {
+        while (true) {
+            const size_t head_end{m_buf.find("\r\n\r\n")};
+            if (head_end != std::string::npos) {
+                const std::string head{ToLower(m_buf.substr(0, head_end))};
+                const size_t length_pos{head.find("content-length:")};
+                assert(length_pos != std::string::npos);
+                const size_t length{LocaleIndependentAtoi<size_t>(head.substr(length_pos + 15, head.find("\r\n", length_pos) - length_pos - 15))};
+                if (m_buf.size() >= head_end + 4 + length) {
+                    const int status{LocaleIndependentAtoi<int>(head.substr(9, 3))};
+                    m_buf.erase(0, head_end + 4 + length);
+                    return status;
+                }
+            }
+            char buf[16384];
+            const auto n{m_sock->Recv(buf, sizeof(buf), MSG_DONTWAIT)};
+            if (n > 0) {
+                m_buf.append(buf, n);
+            } else {
+                const int err{WSAGetLastError()};
+                assert(n < 0 && (err == WSAEWOULDBLOCK || err == WSAEAGAIN || err == WSAEINTR));
+                (void)m_sock->Wait(CLIENT_TIMEOUT, Sock::RECV);
+            }
+        }
+    }
+
+private:
+    const std::unique_ptr<Sock> m_sock;
+    CThreadInterrupt m_interrupt;
+    std::string m_buf;
+};
+
+struct RoundResult {
+    std::vector<std::chrono::nanoseconds> latencies;
+    int rejected{0};
+};
+
+/**
+ * Send requests to the RPC server from @p num_clients clients at once. Each
+ * client keeps its connection open and sends @p pipeline_depth requests before
+ * reading their replies, or opens a new connection for every request if
+ * @p new_connections. Requests per second are reported, along with the 99th
+ * percentile latency and the share of requests that were rejected, measured
+ * upfront.
+ */
+void HTTPServerLoad(benchmark::Bench& bench, int num_clients, int pipeline_depth, bool new_connections,
+                    int threads, int work_queue, std::chrono::microseconds work)
+{
+    const auto testing_setup{MakeNoLogFileContext<>()};
+    TestServer server{threads, work_queue, work};
+    const std::string request{strprintf("POST / HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n%sContent-Length: 2\r\n\r\n{}",
+                                        server.addr.ToStringAddrPort(), new_connections ? "Connection: close\r\n" : "")};
+
+    std::vector<std::unique_ptr<TestClient>> clients;
+    if (!new_connections) {
+        for (int i{0}; i < num_clients; ++i) clients.push_back(std::make_unique<TestClient>(server.addr));
+    }
+    const auto round{[&] {
+        std::vector<RoundResult> results(num_clients);
+        std::vector<std::thread> threads;
+        for (int i{0}; i < num_clients; ++i) {
+            threads.emplace_back([&, i] {
+                auto& result{results[i]};
+                for (int sent{0}; sent < REQUESTS_PER_CLIENT; sent += pipeline_depth) {
+                    const auto start{SteadyClock::now()};
+                    std::unique_ptr<TestClient> new_client{new_connections ? std::make_unique<TestClient>(server.addr) : nullptr};
+                    TestClient& client{new_connections ? *new_client : *clients[i]};
+                    std::string requests;
+                    for (int j{0}; j < pipeline_depth; ++j) requests += request;
+                    client.Send(requests);
+                    for (int j{0}; j < pipeline_depth; ++j) {
+                        const int status{client.Receive()};
+                        assert(status == HTTP_OK || status == HTTP_SERVICE_UNAVAILABLE);
+                        if (status != HTTP_OK) ++result.rejected;
+                        result.latencies.push_back(SteadyClock::now() - start);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        return results;
+    }};
+
+    std::vector<std::chrono::nanoseconds> latencies;
+    int rejected{0};
+    for (int i{0}; i < LATENCY_ROUNDS; ++i) {
+        for (auto& result : round()) {
+            latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+            rejected += result.rejected;
+        }
+    }
+    const auto p99{latencies.begin() + latencies.size() * 99 / 100};
+    std::nth_element(latencies.begin(), p99, latencies.end());
+
+    bench.batch(num_clients * REQUESTS_PER_CLIENT)
+        .unit(strprintf("request (p99 %d us, %.1f%% rejected)", Ticks<std::chrono::microseconds>(*p99), 100.0 * rejected / latencies.size()))
+        .run([&] {
+            ankerl::nanobench::doNotOptimizeAway(round());
+        });
+}
+} // namespace
+
+/** Clients sending one request at a time over a kept-alive connection. */
+static void HTTPServerKeepAlive(benchmark::Bench& bench)
+{
+    HTTPServerLoad(bench, /*num_clients=*/8, /*pipeline_depth=*/1, /*new_connections=*/false,
+                   /*threads=*/4, /*work_queue=*/DEFAULT_HTTP_WORKQUEUE, /*work=*/0us);
+}
+
+/** Clients sending several requests before reading the replies. */
+static void HTTPServerPipelined(benchmark::Bench& bench)
+{
+    HTTPServerLoad(bench, /*num_clients=*/8, /*pipeline_depth=*/8, /*new_connections=*/false,
+                   /*threads=*/4, /*work_queue=*/DEFAULT_HTTP_WORKQUEUE, /*work=*/0us);
+}
+
+/** More clients than the work queue holds, each opening a connection for a slow request. */
+static void HTTPServerConnectionBurst(benchmark::Bench& bench)
+{
+    HTTPServerLoad(bench, /*num_clients=*/64, /*pipeline_depth=*/1, /*new_connections=*/true,
+                   /*threads=*/4, /*work_queue=*/16, /*work=*/200us);
+}
+
+BENCHMARK(HTTPServerKeepAlive, benchmark::PriorityLevel::LOW);
+BENCHMARK(HTTPServerPipelined, benchmark::PriorityLevel::LOW);
+BENCHMARK(HTTPServerConnectionBurst, benchmark::PriorityLevel::LOW);
+
+#endif // WIN32
@@ -0,0 +1,169 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <net.h>
+#include <netaddress.h>
+#include <protocol.h>
+#include <random.h>
+#include <test/util/net.h>
+#include <test/util/setup_common.h>
+#include <util/fs_helpers.h>
+#include <util/sock.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#ifndef WIN32
+
+#include <sys/socket.h>
+
+namespace {
+/** Number of connected peers. */
+constexpr size_t NUM_PEERS{32};
+/** Size of the message each peer sends per iteration. */
+constexpr size_t MESSAGE_SIZE{256 << 10};
+constexpr size_t NUM_EPOCHS{5};
+
+/** Drops all messages; only the socket handler is benchmarked. */
+class NoMessages final : public NetEventsInterface
+{
+public:
+    void InitializeNode(const CNode&, ServiceFlags) override {}
+    void FinalizeNode(const CNode&) override {}
+    bool HasAllDesirableServiceFlags(ServiceFlags) const override { return true; }
+    bool ProcessMessages(CNode*, std::atomic<bool>&) override { return false; }
+    bool SendMessages(CNode*) override { return false; }
+};
+
+/** The remote end of a v2 connection, sending pre-encrypted messages. */
+struct RemotePeer {
+    std::unique_ptr<Sock> sock;
+    V2Transport transport;
+    //! Encrypted messages, one after the other
+    std::vector<uint8_t> ciphertext{};
+    //! End of each message in the ciphertext
+    std::vector<size_t> message_ends{};
+    size_t sent{0};
+
+    RemotePeer(std::unique_ptr<Sock> sock_in, NodeId id) : sock{std::move(sock_in)}, transport{id, /*initiating=*/true} {}
+
+    /** Send as much of the ciphertext as the socket takes, up to @p end. */
+    void Send(size_t end)
+    {
+        while (sent < end) {
+            const auto n{sock->Send(ciphertext.data() + sent, end - sent, MSG_DONTWAIT)};
+            if (n <= 0) return;
+            sent += n;
+        }
+    }
+};
+
+/** Move bytes from the transport to its socket, or from its socket to the transport. */
+void PumpHandshake(RemotePeer& peer)
+{
+    while (true) {
+        const auto& [to_send, _more, _msg_type] = peer.transport.GetBytesToSend(/*have_next_message=*/false);
+        if (to_send.empty()) break;
+        const auto n{peer.sock->Send(to_send.data(), to_send.size(), MSG_DONTWAIT)};
+        if (n <= 0) break;
+        peer.transport.MarkBytesSent(n);
+    }
+    uint8_t buf[4096];
+    while (true) {
+        const auto n{peer.sock->Recv(buf, sizeof(buf), MSG_DONTWAIT)};
+        if (n <= 0) break;
+        std::span<const uint8_t> received{buf, size_t(n)};
+        while (!received.empty()) assert(peer.transport.ReceivedBytes(received));
+    }
+}
+} // namespace
+
+/**
+ * Receive a large message from each of many v2 peers at once, as when
+ * downloading blocks. Sending them is done by the benchmark thread upfront,
+ * so the socket handler's reading and decrypting is what is measured.
+ */
+static void ReceiveFromV2Peers(benchmark::Bench& bench, int io_threads)
+{
+    if (RaiseFileDescriptorLimit(2 * NUM_PEERS + 100) < int(2 * NUM_PEERS + 100)) return;
+
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::REGTEST)};
+    NoMessages no_messages;
+    ConnmanTestMsg connman{0x1337, 0x1337, *testing_setup->m_node.addrman, *testing_setup->m_node.netgroupman, Params()};
+    CConnman::Options options;
+    options.m_local_services = NODE_P2P_V2;
+    options.m_max_automatic_connections = NUM_PEERS + 100;
+    options.m_msgproc = &no_messages;
+    options.nReceiveFloodSize = 2 * MESSAGE_SIZE;
+    options.m_peer_connect_timeout = 3600;
+    connman.Init(options);
+    if (io_threads > 0) connman.StartIOThreads(io_threads);
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::unique_ptr<RemotePeer>> peers;
+    for (size_t i{0}; i < NUM_PEERS; ++i) {
+        int s[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, s) != 0) return;
+        in_addr peer_addr;
+        peer_addr.s_addr = htonl(0x01020300 + i);
+        connman.CreateNodeFromAcceptedSocketPublic(std::make_unique<Sock>(s[0]), NetPermissionFlags::None,
+                                                   CAddress{}, CAddress{CService{peer_addr, 8333}, NODE_NONE});
+        peers.push_back(std::make_unique<RemotePeer>(std::make_unique<Sock>(s[1]), i));
+    }
+    const auto nodes{connman.TestNodes()};
+    assert(nodes.size() == NUM_PEERS);
+
+    // Complete the v2 handshakes.
+    for (int round{0}; round < 10; ++round) {
+        for (auto& peer : peers) PumpHandshake(*peer);
+        connman.SocketHandlerPublic();
+    }
+    for (CNode* node : nodes) assert(node->m_transport->GetInfo().session_id);
+
+    // Encrypt the messages of all iterations upfront.
+    for (auto& peer : peers) {
+        for (size_t i{0}; i < NUM_EPOCHS; ++i) {
+            CSerializedNetMsg msg;
+            msg.m_type = NetMsgType::BLOCK;
+            msg.data = rng.randbytes<uint8_t>(MESSAGE_SIZE);
+            assert(peer->transport.SetMessageToSend(msg));
+            while (true) {
+                const auto& [to_send, _more, _msg_type] = peer->transport.GetBytesToSend(/*have_next_message=*/false);
+                if (to_send.empty()) break;
+                peer->ciphertext.insert(peer->ciphertext.end(), to_send.begin(), to_send.end());
+                peer->transport.MarkBytesSent(to_send.size());
+            }
+            peer->message_ends.push_back(peer->ciphertext.size());
+        }
+    }
+
+    size_t iteration{0};
+    bench.epochs(NUM_EPOCHS).epochIterations(1).unit("byte").batch(NUM_PEERS * MESSAGE_SIZE).run([&] {
+        assert(iteration < NUM_EPOCHS);
+        size_t received{0};
+        while (received < NUM_PEERS) {
+            for (auto& peer : peers) peer->Send(peer->message_ends[iteration]);
+            connman.SocketHandlerPublic();
+            for (CNode* node : nodes) {
+                while (node->PollMessage()) ++received;
+            }
+        }
+        ++iteration;
+    });
+}
+
+static void NetReceiveV2(benchmark::Bench& bench) { ReceiveFromV2Peers(bench, /*io_threads=*/0); }
+static void NetReceiveV2IOThreads(benchmark::Bench& bench) { ReceiveFromV2Peers(bench, /*io_threads=*/3); }
+
+BENCHMARK(NetReceiveV2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(NetReceiveV2IOThreads, benchmark::PriorityLevel::HIGH);
+
+#endif // WIN32
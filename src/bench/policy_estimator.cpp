@@ -0,0 +1,89 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_entry.h>
+#include <policy/fees.h>
+#include <policy/fees_args.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+/** One day of blocks. */
+constexpr unsigned int NUM_BLOCKS{144};
+/** Transactions entering the mempool between two blocks. */
+constexpr unsigned int TXS_PER_BLOCK{3000};
+/** Transactions confirm within this many blocks, or are evicted after it. */
+constexpr unsigned int MAX_DELAY{48};
+
+/** Transaction events of a simulated day, grouped by block height. */
+struct SimulatedDay {
+    //! Transactions entering the mempool while the tip is at the given height
+    std::vector<std::vector<NewMempoolTransactionInfo>> added;
+    //! Transactions confirmed by the block at the given height
+    std::vector<std::vector<RemovedMempoolTransactionInfo>> confirmed;
+    //! Transactions evicted from the mempool at the given height
+    std::vector<std::vector<Txid>> evicted;
+
+    SimulatedDay() : added(NUM_BLOCKS), confirmed(NUM_BLOCKS + MAX_DELAY), evicted(NUM_BLOCKS + MAX_DELAY)
+    {
+        FastRandomContext det_rand{/*fDeterministic=*/true};
+        for (unsigned int height{0}; height < NUM_BLOCKS; ++height) {
+            for (unsigned int i{0}; i < TXS_PER_BLOCK; ++i) {
+                CMutableTransaction mtx;
+                mtx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+                mtx.vout.emplace_back(COIN, CScript{});
+                const CTransactionRef tx{MakeTransactionRef(std::move(mtx))};
+                // Feerates between 1 and ~500 sat/vB, higher ones confirming sooner.
+                const int64_t vsize{150 + int64_t(det_rand.randrange(300))};
+                const uint64_t feerate{1 + det_rand.randrange<uint64_t>(500)};
+                const CAmount fee{CAmount(feerate) * vsize};
+                const CTxMemPoolEntry entry{tx, fee, /*time=*/0, height, /*entry_sequence=*/0,
+                                            /*spends_coinbase=*/false, /*sigops_cost=*/4, LockPoints{}};
+                added[height].emplace_back(tx, fee, vsize, height,
+                                           /*mempool_limit_bypassed=*/false,
+                                           /*submitted_in_package=*/false,
+                                           /*chainstate_is_current=*/true,
+                                           /*has_no_mempool_parents=*/true);
+                const unsigned int delay{1 + unsigned(det_rand.randrange(1 + MAX_DELAY * 10 / (feerate + 10)))};
+                if (delay < MAX_DELAY) {
+                    confirmed[height + delay].emplace_back(entry);
+                } else {
+                    evicted[height + MAX_DELAY].push_back(tx->GetHash());
+                }
+            }
+        }
+    }
+};
+} // namespace
+
+/** Feed a day of mempool and block traffic through a fresh fee estimator. */
+static void BlockPolicyEstimatorDay(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<>()};
+    const SimulatedDay day;
+
+    bench.run([&] {
+        CBlockPolicyEstimator estimator{FeeestPath(*testing_setup->m_node.args), DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+        for (unsigned int height{0}; height < NUM_BLOCKS; ++height) {
+            if (height > 0) {
+                estimator.processBlock(day.confirmed[height], height);
+            }
+            for (const Txid& txid : day.evicted[height]) {
+                estimator.removeTx(txid);
+            }
+            for (const auto& tx : day.added[height]) {
+                estimator.processTransaction(tx);
+            }
+        }
+        ankerl::nanobench::doNotOptimizeAway(estimator.estimateSmartFee(6, nullptr, /*conservative=*/false));
+    });
+}
+
+BENCHMARK(BlockPolicyEstimatorDay, benchmark::PriorityLevel::HIGH);
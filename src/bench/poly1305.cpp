@@ -6,6 +6,7 @@
 #include <bench/bench.h>
 #include <crypto/poly1305.h>
 #include <span.h>
+#include <tinyformat.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -41,6 +42,22 @@ static void POLY1305_1MB(benchmark::Bench& bench)
     POLY1305(bench, BUFFER_SIZE_LARGE);
 }
 
+static void POLY1305_1MB_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' Poly1305 implementation", __func__, Poly1305AutoDetect(poly1305_implementation::STANDARD)));
+    POLY1305(bench, BUFFER_SIZE_LARGE);
+    Poly1305AutoDetect();
+}
+
+static void POLY1305_1MB_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' Poly1305 implementation", __func__, Poly1305AutoDetect(poly1305_implementation::USE_AVX2)));
+    POLY1305(bench, BUFFER_SIZE_LARGE);
+    Poly1305AutoDetect();
+}
+
 BENCHMARK(POLY1305_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(POLY1305_256BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(POLY1305_1MB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(POLY1305_1MB_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(POLY1305_1MB_AVX2, benchmark::PriorityLevel::HIGH);
@@ -7,6 +7,7 @@
 #include <common/bloom.h>
 #include <crypto/common.h>
 #include <span.h>
+#include <tinyformat.h>
 
 #include <cstdint>
 #include <vector>
@@ -34,5 +35,62 @@ static void RollingBloomReset(benchmark::Bench& bench)
     });
 }
 
+static void RollingCuckoo(benchmark::Bench& bench)
+{
+    RollingCuckooFilter<uint32_t> filter(120000, 0.000001);
+    std::vector<unsigned char> data(32);
+    uint32_t count = 0;
+    bench.run([&] {
+        count++;
+        WriteLE32(data.data(), count);
+        filter.insert(data);
+
+        WriteBE32(data.data(), count);
+        filter.contains(data);
+    });
+}
+
+static void RollingCuckooReset(benchmark::Bench& bench)
+{
+    RollingCuckooFilter<uint32_t> filter(120000, 0.000001);
+    bench.run([&] {
+        filter.reset();
+    });
+}
+
+/** Set up the known transaction and address filters net_processing keeps for
+ *  every peer, and announce a batch of transactions to it. The unit shows how
+ *  much memory the two filters take per peer. */
+template <typename TxFilter, typename AddrFilter>
+static void PerPeerKnownInventory(benchmark::Bench& bench)
+{
+    TxFilter tx_filter(50000, 0.000001);
+    AddrFilter addr_filter(5000, 0.001);
+    const size_t usage{tx_filter.DynamicMemoryUsage() + addr_filter.DynamicMemoryUsage()};
+    std::vector<unsigned char> data(32);
+    uint32_t count = 0;
+    bench.batch(1000).unit(strprintf("inv (%u kB per peer)", usage / 1000)).run([&] {
+        for (int i = 0; i < 1000; ++i) {
+            WriteLE32(data.data(), ++count);
+            if (!tx_filter.contains(data)) tx_filter.insert(data);
+        }
+        addr_filter.insert(data);
+    });
+}
+
+static void RollingBloomPerPeer(benchmark::Bench& bench)
+{
+    PerPeerKnownInventory<CRollingBloomFilter, CRollingBloomFilter>(bench);
+}
+
+static void RollingCuckooPerPeer(benchmark::Bench& bench)
+{
+    PerPeerKnownInventory<RollingCuckooFilter<uint32_t>, RollingCuckooFilter<uint16_t>>(bench);
+}
+
 BENCHMARK(RollingBloom, benchmark::PriorityLevel::HIGH);
 BENCHMARK(RollingBloomReset, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RollingBloomPerPeer, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RollingCuckoo, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RollingCuckooReset, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RollingCuckooPerPeer, benchmark::PriorityLevel::HIGH);
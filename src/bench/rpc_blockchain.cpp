@@ -6,19 +6,27 @@
 #include <bench/data/block413567.raw.h>
 #include <chain.h>
 #include <core_io.h>
+#include <memusage.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
+#include <rpc/cbor.h>
+#include <rpc/request.h>
+#include <rpc/util.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
+#include <tinyformat.h>
 #include <uint256.h>
 #include <univalue.h>
+#include <util/strencodings.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -43,6 +51,21 @@ struct TestBlockAndIndex {
     }
 };
 
+//! Heap memory held by a UniValue tree.
+size_t UniValueUsage(const UniValue& value)
+{
+    size_t usage{memusage::DynamicUsage(value.getValStr())};
+    if (value.isObject()) {
+        usage += memusage::DynamicUsage(value.getKeys());
+        for (const auto& key : value.getKeys()) usage += memusage::DynamicUsage(key);
+    }
+    if (value.isObject() || value.isArray()) {
+        usage += memusage::DynamicUsage(value.getValues());
+        for (const auto& child : value.getValues()) usage += UniValueUsage(child);
+    }
+    return usage;
+}
+
 } // namespace
 
 static void BlockToJson(benchmark::Bench& bench, TxVerbosity verbosity)
@@ -86,3 +109,73 @@ static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
 }
 
 BENCHMARK(BlockToJsonVerboseWrite, benchmark::PriorityLevel::HIGH);
+
+/** The RPC reply to getblock at verbosity 3 without a result writer: the whole
+ * result is built, then written to a string. */
+static void BlockToJsonVerbosity3Reply(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    const auto univalue{blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit)};
+    const size_t peak_usage{UniValueUsage(univalue) + memusage::DynamicUsage(univalue.write())};
+    bench.unit(strprintf("block (%u kB held)", peak_usage >> 10)).run([&] {
+        auto str = blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit).write();
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+/** The RPC reply to getblock at verbosity 3 with a result writer, which only
+ * holds a chunk of text and the transaction being written at any time. */
+static void BlockToJsonVerbosity3Stream(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    const auto univalue{blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit)};
+    size_t max_tx_usage{0};
+    for (const auto& tx : univalue["tx"].getValues()) {
+        max_tx_usage = std::max(max_tx_usage, UniValueUsage(tx) + memusage::DynamicUsage(tx.write()));
+    }
+    const size_t peak_usage{memusage::MallocUsage(UniValueWriter::DEFAULT_CHUNK_SIZE) + max_tx_usage};
+    bench.unit(strprintf("block (%u kB held)", peak_usage >> 10)).run([&] {
+        UniValueWriter writer{[](std::string_view chunk) { ankerl::nanobench::doNotOptimizeAway(chunk); }};
+        blockToJSON(writer, data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit);
+        writer.flush();
+    });
+}
+
+BENCHMARK(BlockToJsonVerbosity3Reply, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockToJsonVerbosity3Stream, benchmark::PriorityLevel::HIGH);
+
+/** The RPC reply to getblock at verbosity 0, with the block in hex. */
+static void BlockToReplyJSON(benchmark::Bench& bench)
+{
+    const auto reply{[&] {
+        return JSONRPCReplyObj(HexStr(benchmark::data::block413567), NullUniValue, UniValue{1}, JSONRPCVersion::V2).write();
+    }};
+    bench.unit(strprintf("block (%u kB sent)", reply().size() >> 10)).run([&] {
+        ankerl::nanobench::doNotOptimizeAway(reply());
+    });
+}
+
+/** The RPC reply to getblock at verbosity 0 in CBOR, with the block in bytes. */
+static void BlockToReplyCBOR(benchmark::Bench& bench)
+{
+    const RPCResults doc{RPCResult{RPCResult::Type::STR_HEX, "", "A string that is serialized, hex-encoded data for block 'hash'"}};
+    const auto reply{[&] {
+        std::string out;
+        EncodeCBORMapHead(out, 3);
+        EncodeCBOR(out, UniValue{"jsonrpc"});
+        EncodeCBOR(out, UniValue{"2.0"});
+        EncodeCBOR(out, UniValue{"result"});
+        EncodeCBOR(out, UniValue{HexStr(benchmark::data::block413567)}, doc);
+        EncodeCBOR(out, UniValue{"id"});
+        EncodeCBOR(out, UniValue{1});
+        return out;
+    }};
+    bench.unit(strprintf("block (%u kB sent)", reply().size() >> 10)).run([&] {
+        ankerl::nanobench::doNotOptimizeAway(reply());
+    });
+}
+
+BENCHMARK(BlockToReplyJSON, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockToReplyCBOR, benchmark::PriorityLevel::HIGH);
@@ -25,13 +25,11 @@ static void AddTx(const CTransactionRef& tx, const CAmount& fee, CTxMemPool& poo
     AddToMempool(pool, CTxMemPoolEntry(tx, fee, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, lp));
 }
 
-static void RpcMempool(benchmark::Bench& bench)
+static std::vector<Txid> PopulateMempool(CTxMemPool& pool, int num_txs)
 {
-    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
-    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
     LOCK2(cs_main, pool.cs);
-
-    for (int i = 0; i < 1000; ++i) {
+    std::vector<Txid> txids;
+    for (int i = 0; i < num_txs; ++i) {
         CMutableTransaction tx = CMutableTransaction();
         tx.vin.resize(1);
         tx.vin[0].scriptSig = CScript() << OP_1;
@@ -41,11 +39,36 @@ static void RpcMempool(benchmark::Bench& bench)
         tx.vout[0].nValue = i;
         const CTransactionRef tx_r{MakeTransactionRef(tx)};
         AddTx(tx_r, /*fee=*/i, pool);
+        txids.push_back(tx_r->GetHash());
     }
+    return txids;
+}
+
+static void RpcMempool(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    PopulateMempool(pool, 1000);
 
     bench.run([&] {
         (void)MempoolToJSON(pool, /*verbose=*/true);
     });
 }
 
+/** Cost of refreshing the mempool snapshot after a single entry changed. */
+static void RpcMempoolSnapshotRefresh(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    const auto txids{PopulateMempool(pool, 10000)};
+    (void)pool.GetSnapshot();
+
+    size_t i{0};
+    bench.run([&] {
+        pool.PrioritiseTransaction(txids[i++ % txids.size()], 1);
+        (void)pool.GetSnapshot();
+    });
+}
+
 BENCHMARK(RpcMempool, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RpcMempoolSnapshotRefresh, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,72 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <util/fs_helpers.h>
+#include <util/sock.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#ifndef WIN32
+
+#include <sys/socket.h>
+
+using namespace std::chrono_literals;
+
+/**
+ * Wait for incoming data on the sockets of many mostly idle peers, as the
+ * socket handler thread does, with one in a hundred of them having something
+ * to receive.
+ */
+static void SockWait(benchmark::Bench& bench, size_t num_peers, bool use_wait_many)
+{
+    // Both ends of each connection are open.
+    if (RaiseFileDescriptorLimit(2 * num_peers + 100) < int(2 * num_peers + 100)) return;
+
+    std::vector<std::shared_ptr<const Sock>> socks, others;
+    for (size_t i{0}; i < num_peers; ++i) {
+        int s[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, s) != 0) return;
+        socks.push_back(std::make_shared<const Sock>(s[0]));
+        others.push_back(std::make_shared<const Sock>(s[1]));
+        if (i % 100 == 0) {
+            if (others.back()->Send("a", 1, 0) != 1) return;
+        }
+    }
+
+    const auto wait_set{use_wait_many ? std::make_unique<SockWaitSet>() : socks.front()->CreateWaitSet()};
+    Sock::EventsPerSock events_per_sock;
+    bench.batch(num_peers).unit("peer").run([&] {
+        for (const auto& sock : socks) {
+            wait_set->Add(sock, Sock::RECV);
+        }
+        const bool waited{wait_set->Wait(0ms, events_per_sock)};
+        assert(waited);
+    });
+}
+
+static void SockWaitMany10(benchmark::Bench& bench) { SockWait(bench, 10, /*use_wait_many=*/true); }
+static void SockWaitMany100(benchmark::Bench& bench) { SockWait(bench, 100, /*use_wait_many=*/true); }
+static void SockWaitMany1000(benchmark::Bench& bench) { SockWait(bench, 1000, /*use_wait_many=*/true); }
+static void SockWaitMany5000(benchmark::Bench& bench) { SockWait(bench, 5000, /*use_wait_many=*/true); }
+static void SockWaitSet10(benchmark::Bench& bench) { SockWait(bench, 10, /*use_wait_many=*/false); }
+static void SockWaitSet100(benchmark::Bench& bench) { SockWait(bench, 100, /*use_wait_many=*/false); }
+static void SockWaitSet1000(benchmark::Bench& bench) { SockWait(bench, 1000, /*use_wait_many=*/false); }
+static void SockWaitSet5000(benchmark::Bench& bench) { SockWait(bench, 5000, /*use_wait_many=*/false); }
+
+BENCHMARK(SockWaitMany10, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitMany100, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitMany1000, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitMany5000, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitSet10, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitSet100, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitSet1000, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitSet5000, benchmark::PriorityLevel::HIGH);
+
+#endif // WIN32
@@ -20,7 +20,7 @@
 static constexpr node::TxOrphanage::Usage TINY_TX_WEIGHT{240};
 static constexpr int64_t APPROX_WEIGHT_PER_INPUT{200};
 
-// Creates a transaction with num_inputs inputs and 1 output, padded to target_weight. Use this function to maximize m_outpoint_to_orphan_it operations.
+// Creates a transaction with num_inputs inputs and 1 output, padded to target_weight. Use this function to maximize m_parent_to_orphan_spends operations.
 // If num_inputs is 0, we maximize the number of inputs.
 static CTransactionRef MakeTransactionBulkedTo(unsigned int num_inputs, int64_t target_weight, FastRandomContext& det_rand)
 {
@@ -52,6 +52,17 @@ static CTransactionRef MakeTransactionSpendingUpTo(const std::vector<CTxIn>& inp
     assert(tx.vin.size() > 0);
     return MakeTransactionRef(tx);
 }
+// Constructs a small transaction spending the given outputs of parent.
+static CTransactionRef MakeChildOf(const CTransaction& parent, unsigned int first_output, unsigned int num_outputs)
+{
+    CMutableTransaction tx;
+    for (unsigned int i{first_output}; i < first_output + num_outputs; ++i) {
+        tx.vin.emplace_back(parent.GetHash(), i);
+    }
+    tx.vout.resize(1);
+    return MakeTransactionRef(tx);
+}
+
 static void OrphanageSinglePeerEviction(benchmark::Bench& bench)
 {
     FastRandomContext det_rand{true};
@@ -262,7 +273,71 @@ static void OrphanageEraseForPeer(benchmark::Bench& bench)
     OrphanageEraseAll(bench, /*block_or_disconnect=*/false);
 }
 
+// A peer floods the orphanage with unrelated orphans, hiding a few children of a parent among them. Looking for
+// packages of that parent and its children from this peer should not depend on the size of the flood.
+static void OrphanageChildrenFromFloodingPeer(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    static constexpr unsigned int NUM_PARENTS{100};
+    static constexpr unsigned int CHILDREN_PER_PARENT{3};
+    const auto orphanage{node::MakeTxOrphanage(/*max_global_latency_score=*/node::DEFAULT_MAX_ORPHANAGE_LATENCY_SCORE, /*reserved_peer_usage=*/node::DEFAULT_RESERVED_ORPHAN_WEIGHT_PER_PEER)};
+    const NodeId peer{0};
+
+    std::vector<CTransactionRef> parents;
+    for (unsigned int i{0}; i < NUM_PARENTS; ++i) {
+        CMutableTransaction parent;
+        parent.vin.emplace_back(Txid::FromUint256(det_rand.rand256()), 0);
+        parent.vout.resize(CHILDREN_PER_PARENT);
+        parents.emplace_back(MakeTransactionRef(parent));
+        for (unsigned int output{0}; output < CHILDREN_PER_PARENT; ++output) {
+            assert(orphanage->AddTx(MakeChildOf(*parents.back(), output, 1), peer));
+        }
+    }
+    // Fill the rest of the peer's allowance with unrelated tiny orphans.
+    while (orphanage->TotalOrphanUsage() + 2 * TINY_TX_WEIGHT <= orphanage->MaxGlobalUsage() &&
+           orphanage->TotalLatencyScore() < orphanage->MaxGlobalLatencyScore()) {
+        assert(orphanage->AddTx(MakeTransactionBulkedTo(1, TINY_TX_WEIGHT, det_rand), peer));
+    }
+    assert(orphanage->CountAnnouncements() > NUM_PARENTS * CHILDREN_PER_PARENT * 4);
+
+    bench.batch(NUM_PARENTS).run([&] {
+        for (const auto& parent : parents) {
+            const auto children{orphanage->GetChildrenFromSamePeer(parent, peer)};
+            assert(children.size() == CHILDREN_PER_PARENT);
+        }
+    });
+}
+
+// A parent with many outputs arrives after its children were sent by many peers. All of them are added to a work
+// set, then reconsidered (and kept, as if they were still missing other inputs).
+static void OrphanageReconsiderFanOut(benchmark::Bench& bench)
+{
+    static constexpr unsigned int NUM_PEERS{10};
+    static constexpr unsigned int NUM_CHILDREN{node::DEFAULT_MAX_ORPHANAGE_LATENCY_SCORE * 4 / 5};
+    const auto orphanage{node::MakeTxOrphanage(/*max_global_latency_score=*/node::DEFAULT_MAX_ORPHANAGE_LATENCY_SCORE, /*reserved_peer_usage=*/node::DEFAULT_RESERVED_ORPHAN_WEIGHT_PER_PEER)};
+
+    CMutableTransaction parent_mtx;
+    parent_mtx.vin.emplace_back(Txid{}, 0);
+    parent_mtx.vout.resize(NUM_CHILDREN);
+    const CTransactionRef parent{MakeTransactionRef(parent_mtx)};
+    for (unsigned int i{0}; i < NUM_CHILDREN; ++i) {
+        assert(orphanage->AddTx(MakeChildOf(*parent, i, 1), i % NUM_PEERS));
+    }
+    assert(orphanage->CountAnnouncements() == NUM_CHILDREN);
+
+    FastRandomContext det_rand{true};
+    bench.run([&] {
+        const auto work{orphanage->AddChildrenToWorkSet(*parent, det_rand)};
+        assert(work.size() == NUM_CHILDREN);
+        for (NodeId peer{0}; peer < NUM_PEERS; ++peer) {
+            while (orphanage->GetTxToReconsider(peer)) {}
+        }
+    });
+}
+
 BENCHMARK(OrphanageSinglePeerEviction, benchmark::PriorityLevel::LOW);
 BENCHMARK(OrphanageMultiPeerEviction, benchmark::PriorityLevel::LOW);
 BENCHMARK(OrphanageEraseForBlock, benchmark::PriorityLevel::LOW);
 BENCHMARK(OrphanageEraseForPeer, benchmark::PriorityLevel::LOW);
+BENCHMARK(OrphanageChildrenFromFloodingPeer, benchmark::PriorityLevel::HIGH);
+BENCHMARK(OrphanageReconsiderFanOut, benchmark::PriorityLevel::HIGH);
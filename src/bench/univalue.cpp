@@ -0,0 +1,109 @@
+// Copyright (c) 2025 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data/block413567.raw.h>
+#include <chain.h>
+#include <core_io.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <rpc/blockchain.h>
+#include <rpc/request.h>
+#include <serialize.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <uint256.h>
+#include <univalue.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <string>
+
+/** Parse JSON-RPC requests and replies as they are sent to and by the node. */
+static void UniValueRead(benchmark::Bench& bench, const std::string& json)
+{
+    bench.batch(json.size()).unit("byte").run([&] {
+        UniValue value;
+        bool ok{value.read(json)};
+        assert(ok);
+        ankerl::nanobench::doNotOptimizeAway(value);
+    });
+}
+
+static CBlock TestBlock()
+{
+    DataStream stream{benchmark::data::block413567};
+    CBlock block;
+    stream >> TX_WITH_WITNESS(block);
+    return block;
+}
+
+static std::string Request(const std::string& method, const UniValue& params)
+{
+    UniValue request{JSONRPCRequestObj(method, params, /*id=*/1)};
+    return request.write();
+}
+
+static void UniValueReadSendRawTransaction(benchmark::Bench& bench)
+{
+    // The largest transaction of the block.
+    const CBlock block{TestBlock()};
+    const auto tx{std::ranges::max(block.vtx, {}, [](const CTransactionRef& tx) { return tx->GetTotalSize(); })};
+    UniValue params{UniValue::VARR};
+    params.push_back(EncodeHexTx(*tx));
+    UniValueRead(bench, Request("sendrawtransaction", params));
+}
+
+static void UniValueReadSubmitPackage(benchmark::Bench& bench)
+{
+    const CBlock block{TestBlock()};
+    UniValue txs{UniValue::VARR};
+    for (size_t i{1}; i <= 25; ++i) {
+        txs.push_back(EncodeHexTx(*block.vtx.at(i)));
+    }
+    UniValue params{UniValue::VARR};
+    params.push_back(std::move(txs));
+    UniValueRead(bench, Request("submitpackage", params));
+}
+
+static void UniValueReadImportDescriptors(benchmark::Bench& bench)
+{
+    UniValue requests{UniValue::VARR};
+    for (int i{0}; i < 200; ++i) {
+        UniValue request{UniValue::VOBJ};
+        request.pushKV("desc", strprintf("wpkh([d34db33f/84h/0h/%dh]xpub6ERApfZwUNrhLCkDtcHTcxd75RbzS1ed54G1LkBUHQVHQKqhMkhgbmJbZRkrgZw4koxb5JaHWkY4ALHY2grBGRjaDMzQLcgJvLJuZZvRcEL/%d/*)#c8v3xz4p", i, i % 2));
+        request.pushKV("timestamp", "now");
+        UniValue range{UniValue::VARR};
+        range.push_back(0);
+        range.push_back(1000);
+        request.pushKV("range", std::move(range));
+        request.pushKV("active", true);
+        request.pushKV("internal", i % 2 == 1);
+        request.pushKV("label", strprintf("account %d", i));
+        requests.push_back(std::move(request));
+    }
+    UniValue params{UniValue::VARR};
+    params.push_back(std::move(requests));
+    UniValueRead(bench, Request("importdescriptors", params));
+}
+
+static void UniValueReadVerboseBlock(benchmark::Bench& bench)
+{
+    // The reply to getblock at verbosity 3, as read by bitcoin-cli.
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    const CBlock block{TestBlock()};
+    const uint256 hash{block.GetHash()};
+    CBlockIndex blockindex;
+    blockindex.phashBlock = &hash;
+    blockindex.nBits = 403014710;
+    const uint256 pow_limit{testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    const UniValue result{blockToJSON(testing_setup->m_node.chainman->m_blockman, block, blockindex, blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit)};
+    UniValueRead(bench, JSONRPCReplyObj(result, NullUniValue, /*id=*/1, JSONRPCVersion::V2).write());
+}
+
+BENCHMARK(UniValueReadSendRawTransaction, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueReadSubmitPackage, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueReadImportDescriptors, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueReadVerboseBlock, benchmark::PriorityLevel::HIGH);
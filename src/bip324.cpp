@@ -86,6 +86,14 @@ void BIP324Cipher::Encrypt(std::span<const std::byte> contents, std::span<const
     m_send_p_cipher->Encrypt(header, contents, aad, output.subspan(LENGTH_LEN));
 }
 
+void BIP324Cipher::EncryptInPlace(std::span<std::byte> packet, std::span<const std::byte> aad, bool ignore) noexcept
+{
+    assert(packet.size() >= EXPANSION);
+
+    // ChaCha20 permits the input and output to be the same buffer.
+    Encrypt(packet.subspan(LENGTH_LEN + HEADER_LEN, packet.size() - EXPANSION), aad, ignore, packet);
+}
+
 uint32_t BIP324Cipher::DecryptLength(std::span<const std::byte> input) noexcept
 {
     assert(input.size() == LENGTH_LEN);
@@ -70,6 +70,14 @@ public:
      */
     void Encrypt(std::span<const std::byte> contents, std::span<const std::byte> aad, bool ignore, std::span<std::byte> output) noexcept;
 
+    /** Encrypt a packet whose contents are already in place. Only after Initialize().
+     *
+     * The contents must be stored in packet after its first LENGTH_LEN + HEADER_LEN bytes, so
+     * that packet.size() == contents.size() + EXPANSION. This saves a copy when the caller can
+     * construct the contents directly in the output buffer.
+     */
+    void EncryptInPlace(std::span<std::byte> packet, std::span<const std::byte> aad, bool ignore) noexcept;
+
     /** Decrypt the length of a packet. Only after Initialize().
      *
      * It must hold that input.size() == LENGTH_LEN.
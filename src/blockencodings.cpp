@@ -13,8 +13,13 @@
 #include <random.h>
 #include <streams.h>
 #include <txmempool.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <span>
 #include <unordered_map>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce) :
@@ -52,7 +57,7 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const Wtxid& wtxid) const {
  * in a vector and iterate over the vector directly. This allows optimal
  * CPU caching behaviour, at a cost of only 40 bytes per transaction.
  */
-ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<Wtxid, CTransactionRef>>& extra_txn)
+ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<Wtxid, CTransactionRef>>& extra_txn, util::ThreadPool* workers)
 {
     LogDebug(BCLog::CMPCTBLOCK, "Initializing PartiallyDownloadedBlock for block %s using a cmpctblock of %u bytes\n", cmpctblock.header.GetHash().ToString(), GetSerializeSize(cmpctblock));
     if (cmpctblock.header.IsNull() || (cmpctblock.shorttxids.empty() && cmpctblock.prefilledtxn.empty()))
@@ -111,32 +116,73 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     if (shorttxids.size() != cmpctblock.shorttxids.size())
         return READ_STATUS_FAILED; // Short ID collision
 
+    // Almost all mempool transactions are not in the block. To rule those out without a lookup
+    // in shorttxids, keep a bit per value of the low bits of the short IDs in a filter that is
+    // small enough to stay in the CPU cache.
+    const size_t filter_bits{std::max<size_t>(size_t{1} << 16, std::bit_ceil(cmpctblock.shorttxids.size() * 16))};
+    std::vector<uint64_t> filter(filter_bits / 64);
+    for (const uint64_t shortid : cmpctblock.shorttxids) {
+        const uint64_t bit{shortid & (filter_bits - 1)};
+        filter[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+    auto find_shortid = [&](uint64_t shortid) {
+        const uint64_t bit{shortid & (filter_bits - 1)};
+        if (!((filter[bit / 64] >> (bit % 64)) & 1)) return shorttxids.end();
+        return shorttxids.find(shortid);
+    };
+
     std::vector<bool> have_txn(txn_available.size());
+    auto add_mempool_match = [&](uint16_t index, const CTxMemPool::txiter& txit) {
+        if (!have_txn[index]) {
+            txn_available[index] = txit->GetSharedTx();
+            have_txn[index]  = true;
+            mempool_count++;
+        } else {
+            // If we find two mempool txn that match the short id, just request it.
+            // This should be rare enough that the extra bandwidth doesn't matter,
+            // but eating a round-trip due to FillBlock failure would be annoying
+            if (txn_available[index]) {
+                txn_available[index].reset();
+                mempool_count--;
+            }
+        }
+    };
     {
     LOCK(pool->cs);
-    for (const auto& [wtxid, txit] : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(wtxid);
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = txit->GetSharedTx();
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
-                }
+    const std::span txns{pool->txns_randomized};
+    const size_t tasks{workers ? std::min(txns.size() / SHORTID_SCAN_MIN_PER_TASK, workers->WorkersCount() + 1) : 0};
+    if (tasks > 1) {
+        // Compute the short IDs of equal parts of the mempool concurrently, with this thread
+        // taking the first part, and process the matches in mempool order, as the sequential
+        // scan below would (except that all parts are scanned to the end).
+        using Matches = std::vector<std::pair<uint16_t, CTxMemPool::txiter>>;
+        auto scan = [&](std::span<const std::pair<Wtxid, CTxMemPool::txiter>> part) {
+            Matches matches;
+            for (const auto& [wtxid, txit] : part) {
+                const auto idit{find_shortid(cmpctblock.GetShortID(wtxid))};
+                if (idit != shorttxids.end()) matches.emplace_back(idit->second, txit);
             }
+            return matches;
+        };
+        const size_t per_task{(txns.size() + tasks - 1) / tasks};
+        std::vector<std::future<Matches>> futures;
+        for (size_t i = 1; i < tasks; ++i) {
+            futures.push_back(workers->Submit([&scan, part{txns.subspan(i * per_task, std::min(per_task, txns.size() - i * per_task))}] { return scan(part); }));
+        }
+        for (const auto& [index, txit] : scan(txns.first(per_task))) add_mempool_match(index, txit);
+        for (auto& future : futures) {
+            for (const auto& [index, txit] : future.get()) add_mempool_match(index, txit);
+        }
+    } else {
+        for (const auto& [wtxid, txit] : txns) {
+            const auto idit{find_shortid(cmpctblock.GetShortID(wtxid))};
+            if (idit != shorttxids.end()) add_mempool_match(idit->second, txit);
+            // Though ideally we'd continue scanning for the two-txn-match-shortid case,
+            // the performance win of an early exit here is too good to pass up and worth
+            // the extra risk.
+            if (mempool_count == shorttxids.size())
+                break;
         }
-        // Though ideally we'd continue scanning for the two-txn-match-shortid case,
-        // the performance win of an early exit here is too good to pass up and worth
-        // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
     }
     }
 
@@ -14,6 +14,12 @@ class BlockValidationState;
 namespace Consensus {
 struct Params;
 };
+namespace util {
+class ThreadPool;
+} // namespace util
+
+/** Minimum number of mempool transactions per task when scanning the mempool for short IDs in parallel. */
+static constexpr size_t SHORTID_SCAN_MIN_PER_TASK{16384};
 
 // Transaction compression schemes for compact block relay can be introduced by writing
 // an actual formatter here.
@@ -145,7 +151,8 @@ public:
     explicit PartiallyDownloadedBlock(CTxMemPool* poolIn) : pool(poolIn) {}
 
     // extra_txn is a list of extra transactions to look at, in <witness hash, reference> form
-    ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<Wtxid, CTransactionRef>>& extra_txn);
+    // workers, if given, scan parts of a large mempool for short IDs concurrently
+    ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<Wtxid, CTransactionRef>>& extra_txn, util::ThreadPool* workers = nullptr);
     bool IsTxAvailable(size_t index) const;
     // segwit_active enforces witness mutation checks just before reporting a healthy status
     ReadStatus FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing, bool segwit_active);
@@ -4,7 +4,9 @@
 
 #include <common/bloom.h>
 
+#include <crypto/siphash.h>
 #include <hash.h>
+#include <memusage.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <script/script.h>
@@ -17,6 +19,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <limits>
+#include <utility>
 #include <vector>
 
 static constexpr double LN2SQUARED = 0.4804530139182014246671025263266649717305529515945455;
@@ -244,3 +247,152 @@ void CRollingBloomFilter::reset()
     nGeneration = 1;
     std::fill(data.begin(), data.end(), 0);
 }
+
+size_t CRollingBloomFilter::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(data);
+}
+
+/** Number of entries moved between buckets before an insert gives up. */
+static constexpr int MAX_CUCKOO_KICKS{500};
+
+template <typename Entry>
+RollingCuckooFilter<Entry>::RollingCuckooFilter(const unsigned int nElements, const double fpRate)
+{
+    /* Like CRollingBloomFilter, keep three generations of (nElements + 1) / 2
+     * entries each, and wipe the oldest one when a new generation starts. */
+    m_entries_per_generation = (nElements + 1) / 2;
+    const uint32_t max_elements = m_entries_per_generation * 3;
+    /* Cuckoo tables with four slots per bucket fill to ~95% before inserts
+     * start failing, so a 90% load leaves some headroom. */
+    const uint32_t slots = std::ceil(max_elements / 0.9);
+    m_buckets = std::max<uint32_t>(1, (slots + BUCKET_SIZE - 1) / BUCKET_SIZE);
+    m_table.resize(m_buckets * BUCKET_SIZE);
+    /* A lookup compares the item's fingerprint against the 2 * BUCKET_SIZE
+     * slots of its two buckets, each matching with probability 2^-bits. */
+    const int fingerprint_bits = std::clamp<int>(std::ceil(std::log2(2 * BUCKET_SIZE / fpRate)), 1, sizeof(Entry) * 8 - 2);
+    m_fingerprint_mask = Entry((uint64_t{1} << fingerprint_bits) - 1);
+    reset();
+}
+
+template <typename Entry>
+typename RollingCuckooFilter<Entry>::Position RollingCuckooFilter<Entry>::Locate(std::span<const unsigned char> vKey) const
+{
+    const uint64_t h{CSipHasher(m_k0, m_k1).Write(vKey).Finalize()};
+    /* FastRange32 uses the upper bits of its (32-bit) input, so the fingerprint is taken from the upper half of h. */
+    Entry fingerprint = Entry((h >> 32) & m_fingerprint_mask);
+    if (fingerprint == 0) fingerprint = 1; // 0 marks an empty slot
+    return {fingerprint, FastRange32(uint32_t(h), m_buckets)};
+}
+
+template <typename Entry>
+uint32_t RollingCuckooFilter<Entry>::AltBucket(uint32_t bucket, Entry fingerprint) const
+{
+    /* (H(fingerprint) - bucket) mod m_buckets maps either bucket of an entry
+     * onto the other one, which lets entries move without rehashing the item. */
+    const uint32_t h{FastRange32(uint32_t{fingerprint} * 0x9E3779B1U, m_buckets)};
+    return h >= bucket ? h - bucket : h + m_buckets - bucket;
+}
+
+template <typename Entry>
+std::optional<size_t> RollingCuckooFilter<Entry>::Find(uint32_t bucket, Entry fingerprint) const
+{
+    for (size_t i = bucket * BUCKET_SIZE; i < (bucket + 1) * BUCKET_SIZE; ++i) {
+        if ((m_table[i] >> 2) == fingerprint) return i;
+    }
+    return std::nullopt;
+}
+
+template <typename Entry>
+bool RollingCuckooFilter<Entry>::Place(uint32_t bucket, Entry entry)
+{
+    for (size_t i = bucket * BUCKET_SIZE; i < (bucket + 1) * BUCKET_SIZE; ++i) {
+        if (m_table[i] == 0) {
+            m_table[i] = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Entry>
+void RollingCuckooFilter<Entry>::insert(std::span<const unsigned char> vKey)
+{
+    if (m_entries_this_generation == m_entries_per_generation) {
+        m_entries_this_generation = 0;
+        if (++m_generation == 4) m_generation = 1;
+        /* Wipe old entries that used this generation number. */
+        for (Entry& entry : m_table) {
+            if ((entry & 3) == m_generation) entry = 0;
+        }
+        if (m_victim && (m_victim->first & 3) == m_generation) m_victim.reset();
+        if (m_victim) {
+            const auto [entry, bucket]{*m_victim};
+            if (Place(bucket, entry) || Place(AltBucket(bucket, entry >> 2), entry)) m_victim.reset();
+        }
+    }
+    m_entries_this_generation++;
+
+    const auto [fingerprint, bucket1]{Locate(vKey)};
+    const Entry entry = Entry(fingerprint << 2) | m_generation;
+    const uint32_t bucket2{AltBucket(bucket1, fingerprint)};
+
+    /* Refresh the generation of an entry that is already present. */
+    std::optional<size_t> slot{Find(bucket1, fingerprint)};
+    if (!slot) slot = Find(bucket2, fingerprint);
+    if (slot) {
+        m_table[*slot] = entry;
+        return;
+    }
+    if (m_victim && (m_victim->first >> 2) == fingerprint && (m_victim->second == bucket1 || m_victim->second == bucket2)) {
+        m_victim->first = entry;
+        return;
+    }
+    if (Place(bucket1, entry) || Place(bucket2, entry)) return;
+
+    /* Both buckets are full: evict entries to their alternate bucket until one
+     * of them finds an empty slot there. */
+    Entry homeless{entry};
+    uint32_t bucket{bucket1};
+    for (int kick = 0; kick < MAX_CUCKOO_KICKS; ++kick) {
+        m_kick_state = m_kick_state * 1664525U + 1013904223U;
+        std::swap(homeless, m_table[bucket * BUCKET_SIZE + (m_kick_state >> 30)]);
+        bucket = AltBucket(bucket, homeless >> 2);
+        if (Place(bucket, homeless)) return;
+    }
+    /* The table is too full. Keep the entry left over aside; if that space is
+     * taken already, keep the more recent of the two. */
+    const auto age{[&](Entry e) { return (m_generation + 3 - (e & 3)) % 3; }};
+    if (!m_victim || age(homeless) <= age(m_victim->first)) m_victim.emplace(homeless, bucket);
+}
+
+template <typename Entry>
+bool RollingCuckooFilter<Entry>::contains(std::span<const unsigned char> vKey) const
+{
+    const auto [fingerprint, bucket1]{Locate(vKey)};
+    const uint32_t bucket2{AltBucket(bucket1, fingerprint)};
+    if (Find(bucket1, fingerprint) || Find(bucket2, fingerprint)) return true;
+    return m_victim && (m_victim->first >> 2) == fingerprint && (m_victim->second == bucket1 || m_victim->second == bucket2);
+}
+
+template <typename Entry>
+void RollingCuckooFilter<Entry>::reset()
+{
+    FastRandomContext rng;
+    m_k0 = rng.rand64();
+    m_k1 = rng.rand64();
+    m_kick_state = rng.rand32();
+    m_entries_this_generation = 0;
+    m_generation = 1;
+    std::fill(m_table.begin(), m_table.end(), 0);
+    m_victim.reset();
+}
+
+template <typename Entry>
+size_t RollingCuckooFilter<Entry>::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(m_table);
+}
+
+template class RollingCuckooFilter<uint16_t>;
+template class RollingCuckooFilter<uint32_t>;
@@ -8,6 +8,10 @@
 #include <serialize.h>
 #include <span.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
 #include <vector>
 
 class COutPoint;
@@ -115,6 +119,8 @@ public:
 
     void reset();
 
+    size_t DynamicMemoryUsage() const;
+
 private:
     int nEntriesPerGeneration;
     int nEntriesThisGeneration;
@@ -124,4 +130,65 @@ private:
     int nHashFuncs;
 };
 
+/**
+ * RollingCuckooFilter is a drop-in alternative to CRollingBloomFilter that
+ * keeps track of the most recently inserted items: contains(item) returns
+ * true if item was one of the last N to 1.5*N insert()'ed, unless it was
+ * dropped because the table overflowed. When an insert() finds no free slot
+ * after relocating entries a bounded number of times, and the single overflow
+ * slot is already taken, the older of the two entries is dropped. The table
+ * is sized for this to be rare, but unlike CRollingBloomFilter it is not a
+ * strict guarantee, so a recent item may occasionally be reported missing.
+ *
+ * Instead of setting a two-bit generation in nHashFuncs positions spread over
+ * the whole filter, every item is stored once, as a fingerprint tagged with
+ * its generation, in one of two buckets of four slots. A lookup hashes the
+ * item once and reads at most two adjacent cache lines, and the table needs
+ * about 1.1 * (log2(8 / fpRate) + 2) bits per tracked item, which is less than
+ * the rolling bloom filter for false positive rates below ~0.1.
+ *
+ * Entry is the unsigned integer type of a slot. Its width minus the two
+ * generation bits bounds the fingerprint, and with it the lowest achievable
+ * false positive rate (8 / 2^14 for uint16_t, 8 / 2^30 for uint32_t).
+ */
+template <typename Entry>
+class RollingCuckooFilter
+{
+public:
+    RollingCuckooFilter(unsigned int nElements, double nFPRate);
+
+    void insert(std::span<const unsigned char> vKey);
+    bool contains(std::span<const unsigned char> vKey) const;
+
+    void reset();
+
+    size_t DynamicMemoryUsage() const;
+
+private:
+    static constexpr size_t BUCKET_SIZE{4};
+
+    struct Position {
+        Entry fingerprint;
+        uint32_t bucket;
+    };
+
+    Position Locate(std::span<const unsigned char> vKey) const;
+    uint32_t AltBucket(uint32_t bucket, Entry fingerprint) const;
+    /** Return the index of the slot holding fingerprint in bucket, if any. */
+    std::optional<size_t> Find(uint32_t bucket, Entry fingerprint) const;
+    /** Store entry in an empty slot of bucket. Return whether there was one. */
+    bool Place(uint32_t bucket, Entry entry);
+
+    int m_entries_per_generation;
+    int m_entries_this_generation;
+    Entry m_generation;
+    Entry m_fingerprint_mask;
+    uint32_t m_buckets;
+    std::vector<Entry> m_table;
+    uint64_t m_k0, m_k1;
+    uint32_t m_kick_state;
+    /** An entry that could not be placed in a full table, with its bucket. */
+    std::optional<std::pair<Entry, uint32_t>> m_victim;
+};
+
 #endif // BITCOIN_COMMON_BLOOM_H
@@ -22,5 +22,18 @@ void static inline GetCPUID(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32
 #endif
 }
 
+/** Check whether the CPU supports AVX2 and the OS has enabled the AVX registers. */
+bool static inline HaveAVX2()
+{
+    uint32_t a, b, c, d;
+    GetCPUID(1, 0, a, b, c, d);
+    // OSXSAVE and AVX
+    if (((c >> 27) & 1) == 0 || ((c >> 28) & 1) == 0) return false;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    if ((a & 6) != 6) return false;
+    GetCPUID(7, 0, a, b, c, d);
+    return (b >> 5) & 1;
+}
+
 #endif // defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #endif // BITCOIN_COMPAT_CPUID_H
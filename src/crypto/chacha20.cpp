@@ -7,6 +7,7 @@
 
 #include <crypto/common.h>
 #include <crypto/chacha20.h>
+#include <compat/cpuid.h>
 #include <support/cleanse.h>
 #include <span.h>
 
@@ -14,6 +15,19 @@
 #include <bit>
 #include <cstring>
 
+namespace chacha20_avx2
+{
+void Crypt_8way(uint32_t* input, const unsigned char* in, unsigned char* out, size_t blocks);
+}
+
+namespace {
+/** Implementation generating multiple blocks at once, or nullptr if none is available. It
+ *  processes the largest multiple of MultiBlockWidth blocks of its input, xoring them with in
+ *  unless that is nullptr, and advances the block counter in input accordingly. */
+void (*CryptMultiBlock)(uint32_t* input, const unsigned char* in, unsigned char* out, size_t blocks) = nullptr;
+size_t MultiBlockWidth{0};
+} // namespace
+
 #define QUARTERROUND(a,b,c,d) \
   a += b; d = std::rotl(d ^ a, 16); \
   c += d; b = std::rotl(b ^ c, 12); \
@@ -66,6 +80,12 @@ inline void ChaCha20Aligned::Keystream(std::span<std::byte> output) noexcept
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
+    if (CryptMultiBlock && blocks >= MultiBlockWidth) {
+        const size_t multi{blocks - blocks % MultiBlockWidth};
+        CryptMultiBlock(input, nullptr, UCharCast(c), multi);
+        c += multi * BLOCKLEN;
+        blocks -= multi;
+    }
     if (!blocks) return;
 
     j4 = input[0];
@@ -169,6 +189,13 @@ inline void ChaCha20Aligned::Crypt(std::span<const std::byte> in_bytes, std::spa
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
+    if (CryptMultiBlock && blocks >= MultiBlockWidth) {
+        const size_t multi{blocks - blocks % MultiBlockWidth};
+        CryptMultiBlock(input, UCharCast(m), UCharCast(c), multi);
+        m += multi * BLOCKLEN;
+        c += multi * BLOCKLEN;
+        blocks -= multi;
+    }
     if (!blocks) return;
 
     j4 = input[0];
@@ -370,3 +397,53 @@ void FSChaCha20::Crypt(std::span<const std::byte> input, std::span<std::byte> ou
         m_chunk_counter = 0;
     }
 }
+
+namespace {
+/** Check that the multi-block implementation matches generating one block at a time. */
+bool SelfTest()
+{
+    static constexpr size_t BLOCKS{9};
+    std::array<std::byte, ChaCha20Aligned::KEYLEN> key;
+    std::array<std::byte, BLOCKS * ChaCha20Aligned::BLOCKLEN> in, out, expected;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = std::byte(i);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = std::byte(i * 7);
+
+    // Start right before the block counter overflows, to test carrying into the nonce.
+    const ChaCha20Aligned::Nonce96 nonce{0x01020304, 0x05060708090a0b0c};
+    ChaCha20Aligned single{key}, multi{key};
+    single.Seek(nonce, 0xfffffffc);
+    multi.Seek(nonce, 0xfffffffc);
+    for (size_t i = 0; i < BLOCKS; ++i) {
+        single.Keystream(std::span{expected}.subspan(i * ChaCha20Aligned::BLOCKLEN, ChaCha20Aligned::BLOCKLEN));
+    }
+    multi.Keystream(out);
+    if (out != expected) return false;
+
+    single.Seek(nonce, 0xfffffffc);
+    multi.Seek(nonce, 0xfffffffc);
+    for (size_t i = 0; i < BLOCKS; ++i) {
+        const size_t pos{i * ChaCha20Aligned::BLOCKLEN};
+        single.Crypt(std::span{in}.subspan(pos, ChaCha20Aligned::BLOCKLEN), std::span{expected}.subspan(pos, ChaCha20Aligned::BLOCKLEN));
+    }
+    multi.Crypt(in, out);
+    return out == expected;
+}
+} // namespace
+
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    CryptMultiBlock = nullptr;
+    MultiBlockWidth = 0;
+
+#if defined(HAVE_GETCPUID) && defined(ENABLE_AVX2)
+    if ((use_implementation & chacha20_implementation::USE_AVX2) && HaveAVX2()) {
+        CryptMultiBlock = chacha20_avx2::Crypt_8way;
+        MultiBlockWidth = 8;
+        ret = "avx2(8way)";
+    }
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace chacha20_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+
+template <int n>
+__m256i inline RotL(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+/** Rotations by multiples of 8 bits are byte shuffles. */
+template <>
+__m256i inline RotL<16>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                                  13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+
+template <>
+__m256i inline RotL<8>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                                  14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3));
+}
+
+void ALWAYS_INLINE QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b); d = RotL<16>(Xor(d, a));
+    c = Add(c, d); b = RotL<12>(Xor(b, c));
+    a = Add(a, b); d = RotL<8>(Xor(d, a));
+    c = Add(c, d); b = RotL<7>(Xor(b, c));
+}
+
+/** Transpose four state words of eight blocks into the words of each block. Afterwards, the
+ *  low half of x[i] holds the four words of block i, and the high half those of block i + 4. */
+void ALWAYS_INLINE Transpose(__m256i* x)
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(x[0], x[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(x[0], x[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(x[2], x[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(x[2], x[3]);
+    x[0] = _mm256_unpacklo_epi64(t0, t2);
+    x[1] = _mm256_unpackhi_epi64(t0, t2);
+    x[2] = _mm256_unpacklo_epi64(t1, t3);
+    x[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+void inline Write(unsigned char* out, const unsigned char* in, __m256i v)
+{
+    if (in) v = Xor(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+}
+
+} // namespace
+
+void Crypt_8way(uint32_t* input, const unsigned char* in, unsigned char* out, size_t blocks)
+{
+    const __m256i j4 = K(input[0]), j5 = K(input[1]), j6 = K(input[2]), j7 = K(input[3]);
+    const __m256i j8 = K(input[4]), j9 = K(input[5]), j10 = K(input[6]), j11 = K(input[7]);
+    const __m256i j14 = K(input[10]), j15 = K(input[11]);
+
+    for (; blocks >= 8; blocks -= 8) {
+        // Block counters of the eight blocks, carrying into the first word of the nonce.
+        alignas(32) uint32_t counter[8], nonce[8];
+        for (int i = 0; i < 8; ++i) {
+            counter[i] = input[8] + i;
+            nonce[i] = input[9] + (counter[i] < input[8]);
+        }
+        const __m256i j12 = _mm256_load_si256(reinterpret_cast<const __m256i*>(counter));
+        const __m256i j13 = _mm256_load_si256(reinterpret_cast<const __m256i*>(nonce));
+
+        __m256i x[16] = {K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+                         j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15};
+        for (int i = 0; i < 10; ++i) {
+            QuarterRound(x[0], x[4], x[8], x[12]);
+            QuarterRound(x[1], x[5], x[9], x[13]);
+            QuarterRound(x[2], x[6], x[10], x[14]);
+            QuarterRound(x[3], x[7], x[11], x[15]);
+            QuarterRound(x[0], x[5], x[10], x[15]);
+            QuarterRound(x[1], x[6], x[11], x[12]);
+            QuarterRound(x[2], x[7], x[8], x[13]);
+            QuarterRound(x[3], x[4], x[9], x[14]);
+        }
+        x[0] = Add(x[0], K(0x61707865));
+        x[1] = Add(x[1], K(0x3320646e));
+        x[2] = Add(x[2], K(0x79622d32));
+        x[3] = Add(x[3], K(0x6b206574));
+        x[4] = Add(x[4], j4);
+        x[5] = Add(x[5], j5);
+        x[6] = Add(x[6], j6);
+        x[7] = Add(x[7], j7);
+        x[8] = Add(x[8], j8);
+        x[9] = Add(x[9], j9);
+        x[10] = Add(x[10], j10);
+        x[11] = Add(x[11], j11);
+        x[12] = Add(x[12], j12);
+        x[13] = Add(x[13], j13);
+        x[14] = Add(x[14], j14);
+        x[15] = Add(x[15], j15);
+
+        Transpose(x + 0);
+        Transpose(x + 4);
+        Transpose(x + 8);
+        Transpose(x + 12);
+        for (int i = 0; i < 4; ++i) {
+            // Block i is made of the low halves of x[i], x[i + 4], x[i + 8] and x[i + 12], block
+            // i + 4 of their high halves.
+            Write(out + 64 * i, in ? in + 64 * i : nullptr, _mm256_permute2x128_si256(x[i], x[i + 4], 0x20));
+            Write(out + 64 * i + 32, in ? in + 64 * i + 32 : nullptr, _mm256_permute2x128_si256(x[i + 8], x[i + 12], 0x20));
+            Write(out + 64 * (i + 4), in ? in + 64 * (i + 4) : nullptr, _mm256_permute2x128_si256(x[i], x[i + 4], 0x31));
+            Write(out + 64 * (i + 4) + 32, in ? in + 64 * (i + 4) + 32 : nullptr, _mm256_permute2x128_si256(x[i + 8], x[i + 12], 0x31));
+        }
+
+        input[8] += 8;
+        if (input[8] < 8) ++input[9];
+        if (in) in += 512;
+        out += 512;
+    }
+}
+
+} // namespace chacha20_avx2
+
+#endif
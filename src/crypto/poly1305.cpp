@@ -4,9 +4,26 @@
 
 #include <crypto/common.h>
 #include <crypto/poly1305.h>
+#include <compat/cpuid.h>
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
+namespace poly1305_avx2
+{
+void Blocks_4way(uint32_t* h, const uint32_t* r, const unsigned char* m, size_t blocks);
+}
+
+namespace {
+/** Implementation processing multiple blocks at once, or nullptr if none is available. It
+ *  processes a multiple of MultiBlockWidth blocks, and is only worth using for inputs of at
+ *  least MULTI_BLOCK_MIN_BLOCKS blocks, as it needs to compute powers of r first. */
+void (*BlocksMultiWay)(uint32_t* h, const uint32_t* r, const unsigned char* m, size_t blocks) = nullptr;
+size_t MultiBlockWidth{0};
+constexpr size_t MULTI_BLOCK_MIN_BLOCKS{16};
+} // namespace
+
 namespace poly1305_donna {
 
 // Based on the public domain implementation by Andrew Moon
@@ -203,7 +220,14 @@ void poly1305_update(poly1305_context *st, const unsigned char *m, size_t bytes)
         st->leftover = 0;
     }
 
-    /* process full blocks */
+    /* process full blocks, several at once if possible */
+    if (BlocksMultiWay && bytes >= MULTI_BLOCK_MIN_BLOCKS * POLY1305_BLOCK_SIZE) {
+        size_t blocks = bytes / POLY1305_BLOCK_SIZE;
+        blocks -= blocks % MultiBlockWidth;
+        BlocksMultiWay(st->h, st->r, m, blocks);
+        m += blocks * POLY1305_BLOCK_SIZE;
+        bytes -= blocks * POLY1305_BLOCK_SIZE;
+    }
     if (bytes >= POLY1305_BLOCK_SIZE) {
         size_t want = (bytes & ~(POLY1305_BLOCK_SIZE - 1));
         poly1305_blocks(st, m, want);
@@ -221,3 +245,41 @@ void poly1305_update(poly1305_context *st, const unsigned char *m, size_t bytes)
 }
 
 }  // namespace poly1305_donna
+
+namespace {
+/** Check that the multi-block implementation matches processing one block at a time. */
+bool SelfTest()
+{
+    std::array<std::byte, Poly1305::KEYLEN> key;
+    std::array<std::byte, 16 * POLY1305_BLOCK_SIZE * 2 + 7> msg;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = std::byte(0xff - i);
+    for (size_t i = 0; i < msg.size(); ++i) msg[i] = std::byte(0xff - i * 3);
+
+    std::array<std::byte, Poly1305::TAGLEN> tag, expected;
+    Poly1305 single{key};
+    for (size_t i = 0; i < msg.size(); i += POLY1305_BLOCK_SIZE) {
+        single.Update(std::span{msg}.subspan(i, std::min<size_t>(POLY1305_BLOCK_SIZE, msg.size() - i)));
+    }
+    single.Finalize(expected);
+    Poly1305{key}.Update(msg).Finalize(tag);
+    return tag == expected;
+}
+} // namespace
+
+std::string Poly1305AutoDetect(poly1305_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    BlocksMultiWay = nullptr;
+    MultiBlockWidth = 0;
+
+#if defined(HAVE_GETCPUID) && defined(ENABLE_AVX2)
+    if ((use_implementation & poly1305_implementation::USE_AVX2) && HaveAVX2()) {
+        BlocksMultiWay = poly1305_avx2::Blocks_4way;
+        MultiBlockWidth = 4;
+        ret = "avx2(4way)";
+    }
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace poly1305_avx2 {
+namespace {
+
+// Field elements are kept in five 26-bit limbs, like poly1305-donna-32 does. The four lanes of
+// each vector hold the same limb of four independent accumulators, one limb per 64-bit lane.
+
+constexpr uint32_t MASK26{0x3ffffff};
+
+/** Multiply two partially reduced field elements. */
+void Mul(uint32_t* out, const uint32_t* a, const uint32_t* b)
+{
+    const uint64_t s1 = b[1] * 5ULL, s2 = b[2] * 5ULL, s3 = b[3] * 5ULL, s4 = b[4] * 5ULL;
+    uint64_t d0 = uint64_t{a[0]} * b[0] + a[1] * s4 + a[2] * s3 + a[3] * s2 + a[4] * s1;
+    uint64_t d1 = uint64_t{a[0]} * b[1] + uint64_t{a[1]} * b[0] + a[2] * s4 + a[3] * s3 + a[4] * s2;
+    uint64_t d2 = uint64_t{a[0]} * b[2] + uint64_t{a[1]} * b[1] + uint64_t{a[2]} * b[0] + a[3] * s4 + a[4] * s3;
+    uint64_t d3 = uint64_t{a[0]} * b[3] + uint64_t{a[1]} * b[2] + uint64_t{a[2]} * b[1] + uint64_t{a[3]} * b[0] + a[4] * s4;
+    uint64_t d4 = uint64_t{a[0]} * b[4] + uint64_t{a[1]} * b[3] + uint64_t{a[2]} * b[2] + uint64_t{a[3]} * b[1] + uint64_t{a[4]} * b[0];
+    d1 += d0 >> 26;
+    d2 += d1 >> 26;
+    d3 += d2 >> 26;
+    d4 += d3 >> 26;
+    d0 = (d0 & MASK26) + (d4 >> 26) * 5;
+    out[0] = d0 & MASK26;
+    out[1] = (d1 & MASK26) + (d0 >> 26);
+    out[2] = d2 & MASK26;
+    out[3] = d3 & MASK26;
+    out[4] = d4 & MASK26;
+}
+
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z, __m256i w, __m256i v) { return Add(Add(Add(x, y), Add(z, w)), v); }
+__m256i inline Mul(__m256i x, __m256i y) { return _mm256_mul_epu32(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline ShR(__m256i x, int n) { return _mm256_srli_epi64(x, n); }
+__m256i inline ShL(__m256i x, int n) { return _mm256_slli_epi64(x, n); }
+
+/** Unreduced products of the accumulators h with r, where s holds 5 * r. */
+void ALWAYS_INLINE Mul(__m256i* d, const __m256i* h, const __m256i* r, const __m256i* s)
+{
+    d[0] = Add(Mul(h[0], r[0]), Mul(h[1], s[4]), Mul(h[2], s[3]), Mul(h[3], s[2]), Mul(h[4], s[1]));
+    d[1] = Add(Mul(h[0], r[1]), Mul(h[1], r[0]), Mul(h[2], s[4]), Mul(h[3], s[3]), Mul(h[4], s[2]));
+    d[2] = Add(Mul(h[0], r[2]), Mul(h[1], r[1]), Mul(h[2], r[0]), Mul(h[3], s[4]), Mul(h[4], s[3]));
+    d[3] = Add(Mul(h[0], r[3]), Mul(h[1], r[2]), Mul(h[2], r[1]), Mul(h[3], r[0]), Mul(h[4], s[4]));
+    d[4] = Add(Mul(h[0], r[4]), Mul(h[1], r[3]), Mul(h[2], r[2]), Mul(h[3], r[1]), Mul(h[4], r[0]));
+}
+
+/** Partially reduce products back into 26-bit limbs. */
+void ALWAYS_INLINE Carry(__m256i* h, __m256i* d)
+{
+    const __m256i mask = K(MASK26);
+    d[1] = Add(d[1], ShR(d[0], 26));
+    d[2] = Add(d[2], ShR(d[1], 26));
+    d[3] = Add(d[3], ShR(d[2], 26));
+    d[4] = Add(d[4], ShR(d[3], 26));
+    const __m256i c = ShR(d[4], 26);
+    d[0] = Add(And(d[0], mask), Add(c, ShL(c, 2)));
+    h[0] = And(d[0], mask);
+    h[1] = Add(And(d[1], mask), ShR(d[0], 26));
+    h[2] = And(d[2], mask);
+    h[3] = And(d[3], mask);
+    h[4] = And(d[4], mask);
+}
+
+/** Load four message blocks, in lane order 0, 2, 1, 3. */
+void ALWAYS_INLINE Load(__m256i* m, const unsigned char* in)
+{
+    const __m256i mask = K(MASK26);
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 32));
+    const __m256i lo = _mm256_unpacklo_epi64(a, b);
+    const __m256i hi = _mm256_unpackhi_epi64(a, b);
+    m[0] = And(lo, mask);
+    m[1] = And(ShR(lo, 26), mask);
+    m[2] = And(_mm256_or_si256(ShR(lo, 52), ShL(hi, 12)), mask);
+    m[3] = And(ShR(hi, 14), mask);
+    m[4] = _mm256_or_si256(ShR(hi, 40), K(1 << 24)); // 1 << 128
+}
+
+uint64_t inline Sum(__m256i x)
+{
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), x);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+} // namespace
+
+void Blocks_4way(uint32_t* h, const uint32_t* r, const unsigned char* m, size_t blocks)
+{
+    // Block i is accumulated in accumulator i % 4, which is multiplied by r^4 for each following
+    // group of four blocks and by r^(4 - i % 4) at the end, so that the lanes sum up to the
+    // result of processing all blocks in sequence.
+    uint32_t r2[5], r3[5], r4[5];
+    Mul(r2, r, r);
+    Mul(r3, r2, r);
+    Mul(r4, r2, r2);
+    const __m256i R4[5] = {K(r4[0]), K(r4[1]), K(r4[2]), K(r4[3]), K(r4[4])};
+    const __m256i S4[5] = {K(r4[0] * 5ULL), K(r4[1] * 5ULL), K(r4[2] * 5ULL), K(r4[3] * 5ULL), K(r4[4] * 5ULL)};
+
+    __m256i acc[5], d[5];
+    Load(acc, m);
+    for (int i = 0; i < 5; ++i) {
+        acc[i] = Add(acc[i], _mm256_set_epi64x(0, 0, 0, h[i]));
+    }
+    for (blocks -= 4, m += 64; blocks >= 4; blocks -= 4, m += 64) {
+        __m256i msg[5];
+        Load(msg, m);
+        Mul(d, acc, R4, S4);
+        Carry(acc, d);
+        for (int i = 0; i < 5; ++i) acc[i] = Add(acc[i], msg[i]);
+    }
+
+    // Lanes hold blocks 0, 2, 1 and 3 of each group.
+    __m256i R[5], S[5];
+    for (int i = 0; i < 5; ++i) {
+        R[i] = _mm256_set_epi64x(r[i], r3[i], r2[i], r4[i]);
+        S[i] = _mm256_set_epi64x(r[i] * 5ULL, r3[i] * 5ULL, r2[i] * 5ULL, r4[i] * 5ULL);
+    }
+    Mul(d, acc, R, S);
+    uint64_t d0 = Sum(d[0]), d1 = Sum(d[1]), d2 = Sum(d[2]), d3 = Sum(d[3]), d4 = Sum(d[4]);
+    d1 += d0 >> 26;
+    d2 += d1 >> 26;
+    d3 += d2 >> 26;
+    d4 += d3 >> 26;
+    d0 = (d0 & MASK26) + (d4 >> 26) * 5;
+    h[0] = d0 & MASK26;
+    h[1] = (d1 & MASK26) + (d0 >> 26);
+    h[2] = d2 & MASK26;
+    h[3] = d3 & MASK26;
+    h[4] = d4 & MASK26;
+}
+
+} // namespace poly1305_avx2
+
+#endif
@@ -7,23 +7,42 @@
 #include <common/args.h>
 #include <crypto/hmac_sha256.h>
 #include <httpserver.h>
+#include <interfaces/handler.h>
 #include <logging.h>
 #include <netaddress.h>
+#include <node/context.h>
+#include <node/kernel_notifications.h>
+#include <rpc/cbor.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <uint256.h>
+#include <util/any.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/thread.h>
+#include <util/threadpool.h>
+#include <util/time.h>
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <iterator>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 using util::SplitString;
@@ -38,7 +57,99 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
 
-static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCRequest& jreq)
+/**
+ * Methods that only read the state of the node. Consecutive calls of these in
+ * a batch cannot affect each other's results, so they are run concurrently.
+ */
+static const std::set<std::string, std::less<>> g_batch_concurrent_methods{
+    "decoderawtransaction",
+    "decodescript",
+    "estimatesmartfee",
+    "getbestblockhash",
+    "getblock",
+    "getblockchaininfo",
+    "getblockcount",
+    "getblockfilter",
+    "getblockhash",
+    "getblockheader",
+    "getblockstats",
+    "getchaintips",
+    "getdifficulty",
+    "getmempoolancestors",
+    "getmempooldescendants",
+    "getmempoolentry",
+    "getmempoolinfo",
+    "getrawmempool",
+    "getrawtransaction",
+    "gettxout",
+    "gettxoutproof",
+    "validateaddress",
+};
+/* Runs the concurrent calls of batch requests (-rpcbatchthreads) */
+static util::ThreadPool g_batch_pool{"rpcbatch"};
+
+/**
+ * A request of a method waiting for the chain tip to change, such as
+ * waitfornewblock or a getblocktemplate long poll. It is parked here instead
+ * of occupying a worker thread, and resumed on one once the tip changed or its
+ * deadline passed. It is dropped if the client goes away before that.
+ */
+struct ParkedRequest {
+    std::unique_ptr<HTTPRequest> req;
+    JSONRPCRequest jreq;
+    bool catch_errors;
+    RPCTipWait wait;
+};
+
+static Mutex g_parked_mutex;
+static std::condition_variable g_parked_cv;
+static std::list<ParkedRequest> g_parked_requests GUARDED_BY(g_parked_mutex);
+//! Parked requests whose tip changed, for g_parked_thread to resume. Tip
+//! changes are notified under cs_main, which resuming must not be done under.
+static std::list<ParkedRequest> g_resumable_requests GUARDED_BY(g_parked_mutex);
+//! Number of parked requests beyond which requests are turned away, as
+//! waiting ones were when they occupied -rpcthreads and -rpcworkqueue
+static size_t g_max_parked_requests GUARDED_BY(g_parked_mutex){DEFAULT_HTTP_THREADS + DEFAULT_HTTP_WORKQUEUE};
+//! Whether requests are resumed right away, as interrupted, instead of parked
+static bool g_parked_interrupted GUARDED_BY(g_parked_mutex){false};
+//! Resumes parked requests and drops those whose client went away
+static std::thread g_parked_thread;
+//! How often g_parked_thread checks whether clients went away
+static constexpr auto PARKED_CHECK_INTERVAL{1s};
+//! Locked before KernelNotifications::m_tip_block_mutex, which is locked before g_parked_mutex
+static Mutex g_tip_handler_mutex;
+//! Resumes parked requests when the tip changes
+static std::unique_ptr<interfaces::Handler> g_tip_changed_handler GUARDED_BY(g_tip_handler_mutex);
+static node::KernelNotifications* g_tip_notifications GUARDED_BY(g_tip_handler_mutex){nullptr};
+
+/** Whether the request is sent in CBOR, which it is then replied to in as well. */
+static bool IsCBORRequest(const HTTPRequest* req)
+{
+    const auto [found, content_type]{req->GetHeader("content-type")};
+    return found && ToLower(TrimStringView(std::string_view{content_type}.substr(0, content_type.find(';')))) == "application/cbor";
+}
+
+/**
+ * Encode a reply object, as returned by JSONRPCReplyObj, in CBOR. A result
+ * that the method encoded itself takes the place of the null result.
+ */
+static std::string EncodeCBORReply(const UniValue& reply, std::string_view result)
+{
+    const bool failed{!reply.find_value("error").isNull()};
+    std::string out;
+    EncodeCBORMapHead(out, reply.size());
+    for (size_t i{0}; i < reply.size(); ++i) {
+        EncodeCBOR(out, UniValue{reply.getKeys()[i]});
+        if (reply.getKeys()[i] == "result" && !failed && !result.empty()) {
+            out += result;
+        } else {
+            EncodeCBOR(out, reply[i]);
+        }
+    }
+    return out;
+}
+
+static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCRequest& jreq, bool cbor)
 {
     // Sending HTTP errors is a legacy JSON-RPC behavior.
     Assume(jreq.m_json_version != JSONRPCVersion::V2);
@@ -52,10 +163,14 @@ static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCReq
     else if (code == RPC_METHOD_NOT_FOUND)
         nStatus = HTTP_NOT_FOUND;
 
-    std::string strReply = JSONRPCReplyObj(NullUniValue, std::move(objError), jreq.id, jreq.m_json_version).write() + "\n";
-
+    const UniValue reply{JSONRPCReplyObj(NullUniValue, std::move(objError), jreq.id, jreq.m_json_version)};
+    if (cbor) {
+        req->WriteHeader("Content-Type", "application/cbor");
+        req->WriteReply(nStatus, EncodeCBORReply(reply, {}));
+        return;
+    }
     req->WriteHeader("Content-Type", "application/json");
-    req->WriteReply(nStatus, strReply);
+    req->WriteReply(nStatus, reply.write() + "\n");
 }
 
 //This function checks username and password against -rpcauth
@@ -101,6 +216,293 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return CheckUserAuthorized(user, pass);
 }
 
+static void ParkRequest(ParkedRequest parked) EXCLUSIVE_LOCKS_REQUIRED(!g_tip_handler_mutex, !g_parked_mutex);
+
+/**
+ * Execute a single request with @p exec and send the reply. Results that
+ * methods write to JSONRPCRequest::m_result_writer are sent to the client while
+ * they are being produced. Replies that fit into one chunk are sent whole.
+ * Requests of methods that wait for the tip to change are parked.
+ */
+static void JSONRPCExecStreamed(HTTPRequest* req, JSONRPCRequest& jreq, bool catch_errors, const std::function<UniValue()>& exec)
+{
+    bool started{false};
+    bool complete{false};
+    UniValueWriter writer{[&](std::string_view chunk) {
+        if (complete && !started) {
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, strprintf("%s\n", chunk));
+            return;
+        }
+        if (!started) {
+            req->WriteHeader("Content-Type", "application/json");
+            req->StartReply(HTTP_OK);
+            started = true;
+        }
+        req->WriteReplyChunk(chunk);
+    }};
+
+    // The members of JSONRPCReplyObj, with the result written in between.
+    writer.beginObject();
+    if (jreq.m_json_version == JSONRPCVersion::V2) {
+        writer.key("jsonrpc");
+        writer.value("2.0");
+    }
+    writer.key("result");
+    const size_t result_start{writer.size()};
+
+    UniValue result;
+    UniValue error;
+    jreq.m_result_writer = &writer;
+    try {
+        result = exec();
+    } catch (RPCTipWait& wait) {
+        jreq.m_result_writer = nullptr;
+        Assume(!started);
+        ParkRequest({req->Defer(), jreq, catch_errors, std::move(wait)});
+        return;
+    } catch (UniValue& e) {
+        jreq.m_result_writer = nullptr;
+        // Legacy requests get an HTTP error, as from HTTPReq_JSONRPC, which
+        // resumed requests no longer return to.
+        if (!catch_errors && !started) {
+            JSONErrorReply(req, std::move(e), jreq, /*cbor=*/false);
+            return;
+        }
+        error = std::move(e);
+    } catch (const std::exception& e) {
+        jreq.m_result_writer = nullptr;
+        if (!catch_errors && !started) {
+            JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq, /*cbor=*/false);
+            return;
+        }
+        error = JSONRPCError(RPC_MISC_ERROR, e.what());
+    }
+    jreq.m_result_writer = nullptr;
+
+    if (!error.isNull()) {
+        if (started) {
+            // Part of the result was sent already and cannot be taken back.
+            // Cut the reply short, so that the client fails to parse it.
+            LogPrintf("RPC %s failed after sending part of its result: %s\n", jreq.strMethod, error.write());
+            req->EndReply();
+            return;
+        }
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, JSONRPCReplyObj(NullUniValue, std::move(error), jreq.id, jreq.m_json_version).write() + "\n");
+        return;
+    }
+
+    if (writer.size() == result_start) writer.value(result);
+    if (jreq.m_json_version == JSONRPCVersion::V1_LEGACY) {
+        writer.key("error");
+        writer.value(NullUniValue);
+    }
+    if (jreq.id.has_value()) {
+        writer.key("id");
+        writer.value(jreq.id.value());
+    }
+    writer.endObject();
+    complete = true;
+    writer.flush();
+    if (started) {
+        req->WriteReplyChunk("\n");
+        req->EndReply();
+    }
+}
+
+/** Continue a parked request on a worker thread. */
+static void ResumeRequest(ParkedRequest parked, bool interrupted)
+{
+    ResumeHTTPRequest(std::move(parked.req), [jreq = std::move(parked.jreq), catch_errors = parked.catch_errors,
+                                              resume = std::move(parked.wait.resume), interrupted](HTTPRequest* req) mutable {
+        JSONRPCExecStreamed(req, jreq, catch_errors, [&] { return resume(interrupted); });
+    });
+}
+
+/** Have g_parked_thread resume the parked requests that are waiting for a
+ * tip other than @p tip. Does not block. */
+static void TipChanged(const uint256& tip) EXCLUSIVE_LOCKS_REQUIRED(!g_parked_mutex)
+{
+    LOCK(g_parked_mutex);
+    for (auto it{g_parked_requests.begin()}; it != g_parked_requests.end();) {
+        const auto next{std::next(it)};
+        if (it->wait.tip != tip) g_resumable_requests.splice(g_resumable_requests.end(), g_parked_requests, it);
+        it = next;
+    }
+    if (!g_resumable_requests.empty()) g_parked_cv.notify_all();
+}
+
+/**
+ * Register for tip changes to resume parked requests with, once the node is
+ * out of warmup and its chain loaded for good.
+ *
+ * @returns whether requests can be parked.
+ */
+static bool ParkingAvailable(const std::any& context) EXCLUSIVE_LOCKS_REQUIRED(!g_tip_handler_mutex)
+{
+    LOCK(g_tip_handler_mutex);
+    if (g_tip_changed_handler) return true;
+    auto node{util::AnyPtr<node::NodeContext>(context)};
+    if (!node || !node->notifications || !node->mining || RPCIsInWarmup(nullptr)) return false;
+    g_tip_notifications = node->notifications.get();
+    g_tip_changed_handler = g_tip_notifications->handleTipChanged(TipChanged);
+    return true;
+}
+
+static void ParkRequest(ParkedRequest parked)
+{
+    node::KernelNotifications& notifications{*Assert(WITH_LOCK(g_tip_handler_mutex, return g_tip_notifications))};
+    bool interrupted;
+    bool full{false};
+    {
+        // Checked under the lock that tip changes are notified under, so that
+        // a change is either seen here or resumes the parked request.
+        LOCK(notifications.m_tip_block_mutex);
+        const std::optional<uint256> tip{notifications.TipBlock()};
+        LOCK(g_parked_mutex);
+        interrupted = g_parked_interrupted;
+        if (!interrupted && (!tip || *tip == parked.wait.tip)) {
+            full = g_parked_requests.size() >= g_max_parked_requests;
+            if (!full) {
+                LogDebug(BCLog::RPC, "Parking %s request from %s until the tip changes\n", parked.jreq.strMethod, parked.jreq.peerAddr);
+                g_parked_requests.push_back(std::move(parked));
+                g_parked_cv.notify_all();
+                return;
+            }
+        }
+    }
+    if (full) {
+        LogDebug(BCLog::RPC, "Too many parked requests, rejecting %s request from %s\n", parked.jreq.strMethod, parked.jreq.peerAddr);
+        parked.req->WriteReply(HTTP_SERVICE_UNAVAILABLE);
+        return;
+    }
+    ResumeRequest(std::move(parked), interrupted);
+}
+
+/** Resume parked requests once their tip changed or their deadline passed,
+ * and drop those whose client went away. */
+static void ThreadParkedRequests() EXCLUSIVE_LOCKS_REQUIRED(!g_parked_mutex)
+{
+    auto next_check{SteadyClock::now()};
+    while (true) {
+        std::list<ParkedRequest> resumed;
+        std::list<ParkedRequest> dropped;
+        {
+            WAIT_LOCK(g_parked_mutex, lock);
+            if (g_parked_interrupted) return;
+            const auto now{SteadyClock::now()};
+            const bool check{now >= next_check};
+            if (check) next_check = now + PARKED_CHECK_INTERVAL;
+            auto next{next_check};
+            for (auto it{g_parked_requests.begin()}; it != g_parked_requests.end();) {
+                const auto following{std::next(it)};
+                if (check && it->req->ConnectionLost()) {
+                    LogDebug(BCLog::RPC, "Dropping parked %s request, %s went away\n", it->jreq.strMethod, it->jreq.peerAddr);
+                    dropped.splice(dropped.end(), g_parked_requests, it);
+                } else if (it->wait.deadline && *it->wait.deadline <= now) {
+                    resumed.splice(resumed.end(), g_parked_requests, it);
+                } else if (it->wait.deadline) {
+                    next = std::min(next, *it->wait.deadline);
+                }
+                it = following;
+            }
+            resumed.splice(resumed.end(), g_resumable_requests);
+            if (resumed.empty() && dropped.empty()) {
+                g_parked_cv.wait_until(lock, next);
+                continue;
+            }
+        }
+        // Without g_parked_mutex, as resuming or dropping a request may reply to it.
+        for (auto& parked : resumed) ResumeRequest(std::move(parked), /*interrupted=*/false);
+    }
+}
+
+/**
+ * Execute a single request, with the result encoded in CBOR as documented by
+ * the method.
+ *
+ * @returns the encoded reply.
+ */
+static std::string JSONRPCExecCBOR(JSONRPCRequest jreq, bool catch_errors)
+{
+    std::string result;
+    jreq.m_cbor_result = &result;
+    const UniValue reply{JSONRPCExec(jreq, catch_errors)};
+    return EncodeCBORReply(reply, result);
+}
+
+/**
+ * Execute one request of a batch. Batches never throw HTTP errors, they are
+ * always just included in "HTTP OK" responses.
+ *
+ * @returns the encoded response, or std::nullopt for notifications, which
+ *          never get any.
+ */
+static std::optional<std::string> JSONRPCExecBatchRequest(JSONRPCRequest jreq, const UniValue& request, bool cbor)
+{
+    UniValue response;
+    std::string result;
+    if (cbor) jreq.m_cbor_result = &result;
+    try {
+        jreq.parse(request);
+        response = JSONRPCExec(jreq, /*catch_errors=*/true);
+    } catch (UniValue& e) {
+        response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+    } catch (const std::exception& e) {
+        response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
+    }
+    if (jreq.IsNotification()) return std::nullopt;
+    return cbor ? EncodeCBORReply(response, result) : response.write();
+}
+
+static bool IsBatchConcurrent(const UniValue& request)
+{
+    if (!request.isObject()) return false;
+    const UniValue& method{request.find_value("method")};
+    return method.isStr() && g_batch_concurrent_methods.contains(method.get_str());
+}
+
+/**
+ * Execute the requests of a batch. Runs of read-only calls are handed to
+ * g_batch_pool, and every other call waits for the ones before it to finish.
+ *
+ * @param[in] jreq The request, as authenticated, that each call is parsed into.
+ * @param[in] cbor Whether to encode the responses in CBOR rather than JSON.
+ * @returns the encoded responses in the order of the requests.
+ */
+static std::vector<std::string> JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& requests, bool cbor)
+{
+    std::vector<std::optional<std::string>> responses(requests.size());
+    std::vector<std::pair<size_t, std::future<std::optional<std::string>>>> running;
+    const auto wait_running{[&] {
+        for (auto& [i, response] : running) responses[i] = response.get();
+        running.clear();
+    }};
+    const bool concurrent{g_batch_pool.WorkersCount() > 0};
+    for (size_t i{0}; i < requests.size(); ++i) {
+        const UniValue& request{requests[i]};
+        if (concurrent && IsBatchConcurrent(request)) {
+            try {
+                running.emplace_back(i, g_batch_pool.Submit([&jreq, &request, cbor] { return JSONRPCExecBatchRequest(jreq, request, cbor); }));
+                continue;
+            } catch (const std::runtime_error&) {
+                // The pool is being stopped, run the call here.
+            }
+        } else {
+            wait_running();
+        }
+        responses[i] = JSONRPCExecBatchRequest(jreq, request, cbor);
+    }
+    wait_running();
+
+    std::vector<std::string> reply;
+    for (auto& response : responses) {
+        if (response) reply.push_back(std::move(*response));
+    }
+    return reply;
+}
+
 static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
 {
     // JSONRPC handles only POST
@@ -116,6 +518,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         return false;
     }
 
+    const bool cbor{IsCBORRequest(req)};
     JSONRPCRequest jreq;
     jreq.context = context;
     jreq.peerAddr = req->GetPeer().ToStringAddrPort();
@@ -135,13 +538,15 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
     try {
         // Parse request
         UniValue valRequest;
-        if (!valRequest.read(req->ReadBody()))
+        if (cbor) {
+            valRequest = DecodeCBOR(req->ReadBody());
+        } else if (!valRequest.read(req->ReadBody())) {
             throw JSONRPCError(RPC_PARSE_ERROR, "Parse error");
+        }
 
         // Set the URI
         jreq.URI = req->GetURI();
 
-        UniValue reply;
         bool user_has_whitelist = g_rpc_whitelist.count(jreq.authUser);
         if (!user_has_whitelist && g_rpc_whitelist_default) {
             LogPrintf("RPC User %s not allowed to call any methods\n", jreq.authUser);
@@ -162,13 +567,21 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
-            reply = JSONRPCExec(jreq, catch_errors);
-
             if (jreq.IsNotification()) {
                 // Even though we do execute notifications, we do not respond to them
+                JSONRPCExec(jreq, catch_errors);
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
+            if (cbor) {
+                std::string reply{JSONRPCExecCBOR(jreq, catch_errors)};
+                req->WriteHeader("Content-Type", "application/cbor");
+                req->WriteReply(HTTP_OK, reply);
+                return true;
+            }
+            jreq.m_allow_park = ParkingAvailable(context);
+            JSONRPCExecStreamed(req, jreq, catch_errors, [&] { return tableRPC.execute(jreq); });
+            return true;
 
         // array of requests
         } else if (valRequest.isArray()) {
@@ -190,24 +603,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
                 }
             }
 
-            // Execute each request
-            reply = UniValue::VARR;
-            for (size_t i{0}; i < valRequest.size(); ++i) {
-                // Batches never throw HTTP errors, they are always just included
-                // in "HTTP OK" responses. Notifications never get any response.
-                UniValue response;
-                try {
-                    jreq.parse(valRequest[i]);
-                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
-                } catch (UniValue& e) {
-                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
-                } catch (const std::exception& e) {
-                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
-                }
-                if (!jreq.IsNotification()) {
-                    reply.push_back(std::move(response));
-                }
-            }
+            const std::vector<std::string> responses{JSONRPCExecBatch(jreq, valRequest, cbor)};
             // Return no response for an all-notification batch, but only if the
             // batch request is non-empty. Technically according to the JSON-RPC
             // 2.0 spec, an empty batch request should also return no response,
@@ -217,21 +613,28 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // relying on previous behavior. Return an empty array instead of an
             // empty response in this case to favor being backwards compatible
             // over complying with the JSON-RPC 2.0 spec in this case.
-            if (reply.size() == 0 && valRequest.size() > 0) {
+            if (responses.empty() && valRequest.size() > 0) {
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
+            if (cbor) {
+                std::string reply;
+                EncodeCBORArrayHead(reply, responses.size());
+                for (const auto& response : responses) reply += response;
+                req->WriteHeader("Content-Type", "application/cbor");
+                req->WriteReply(HTTP_OK, reply);
+            } else {
+                req->WriteHeader("Content-Type", "application/json");
+                req->WriteReply(HTTP_OK, "[" + util::Join(responses, ",") + "]\n");
+            }
         }
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
-
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, reply.write() + "\n");
     } catch (UniValue& e) {
-        JSONErrorReply(req, std::move(e), jreq);
+        JSONErrorReply(req, std::move(e), jreq, cbor);
         return false;
     } catch (const std::exception& e) {
-        JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq);
+        JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq, cbor);
         return false;
     }
     return true;
@@ -339,14 +742,34 @@ bool StartHTTPRPC(const std::any& context)
     if (g_wallet_init_interface.HasWalletSupport()) {
         RegisterHTTPHandler("/wallet/", false, handle_rpc);
     }
-    struct event_base* eventBase = EventBase();
-    assert(eventBase);
+    const int batch_threads{int(std::clamp<int64_t>(gArgs.GetIntArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS), 0, MAX_RPC_BATCH_THREADS))};
+    if (batch_threads > 0) {
+        LogDebug(BCLog::RPC, "Starting %d threads for batch requests\n", batch_threads);
+        g_batch_pool.Start(batch_threads);
+    }
+    {
+        LOCK(g_parked_mutex);
+        g_parked_interrupted = false;
+        g_max_parked_requests = std::max<int64_t>(gArgs.GetIntArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1) +
+                                std::max<int64_t>(gArgs.GetIntArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1);
+    }
+    g_parked_thread = std::thread(&util::TraceThread, "rpcparked", &ThreadParkedRequests);
     return true;
 }
 
 void InterruptHTTPRPC()
 {
     LogDebug(BCLog::RPC, "Interrupting HTTP RPC server\n");
+    std::list<ParkedRequest> parked;
+    {
+        LOCK(g_parked_mutex);
+        g_parked_interrupted = true;
+        parked.swap(g_parked_requests);
+        parked.splice(parked.end(), g_resumable_requests);
+    }
+    g_parked_cv.notify_all();
+    // Let the waiting methods return, before the worker threads are stopped.
+    for (auto& request : parked) ResumeRequest(std::move(request), /*interrupted=*/true);
 }
 
 void StopHTTPRPC()
@@ -356,4 +779,9 @@ void StopHTTPRPC()
     if (g_wallet_init_interface.HasWalletSupport()) {
         UnregisterHTTPHandler("/wallet/", false);
     }
+    g_batch_pool.Stop();
+    if (g_parked_thread.joinable()) g_parked_thread.join();
+    LOCK(g_tip_handler_mutex);
+    g_tip_changed_handler.reset();
+    g_tip_notifications = nullptr;
 }
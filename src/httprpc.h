@@ -7,6 +7,10 @@
 
 #include <any>
 
+/** Default number of threads running the read-only calls of batch requests concurrently. */
+static constexpr int DEFAULT_RPC_BATCH_THREADS{4};
+static constexpr int MAX_RPC_BATCH_THREADS{64};
+
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
  */
@@ -8,124 +8,260 @@
 #include <common/args.h>
 #include <common/messages.h>
 #include <compat/compat.h>
+#include <crypto/hex_base.h>
 #include <logging.h>
 #include <netbase.h>
 #include <node/interface_ui.h>
 #include <rpc/protocol.h>
+#include <serialize.h>
 #include <sync.h>
+#include <tinyformat.h>
 #include <util/check.h>
 #include <util/signalinterrupt.h>
+#include <util/sock.h>
 #include <util/strencodings.h>
-#include <util/threadnames.h>
+#include <util/string.h>
+#include <util/thread.h>
+#include <util/threadinterrupt.h>
+#include <util/threadpool.h>
+#include <util/time.h>
 #include <util/translation.h>
 
-#include <condition_variable>
-#include <cstdio>
-#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
-#include <sys/types.h>
-#include <sys/stat.h>
-
-#include <event2/buffer.h>
-#include <event2/bufferevent.h>
+#include <event2/event.h>
 #include <event2/http.h>
-#include <event2/http_struct.h>
 #include <event2/keyvalq_struct.h>
 #include <event2/thread.h>
-#include <event2/util.h>
-
-#include <support/events.h>
 
 using common::InvalidPortErrMsg;
+using util::SplitString;
+using util::TrimStringView;
 
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
+/** Bytes received on a connection and not parsed yet beyond which it is not
+ * read from, until the request it is waiting on was replied to */
+static const size_t MAX_RECV_BUFFER = 64 << 10;
+/** How long the I/O threads wait for sockets before checking the timeout of
+ * connections and whether to stop */
+static constexpr auto SELECT_TIMEOUT{50ms};
+
+std::optional<std::string> HTTPRequestData::FindHeader(std::string_view name) const
+{
+    for (const auto& [header, value] : headers) {
+        if (header.size() == name.size() && ToLower(header) == ToLower(name)) return value;
+    }
+    return std::nullopt;
+}
+
+bool HTTPRequestData::KeepAlive() const
+{
+    bool keep_alive{minor_version >= 1};
+    if (const auto connection{FindHeader("Connection")}) {
+        for (const auto& token : SplitString(ToLower(*connection), ',')) {
+            if (TrimStringView(token) == "close") return false;
+            if (TrimStringView(token) == "keep-alive") keep_alive = true;
+        }
+    }
+    return keep_alive;
+}
+
+size_t HTTPRequestParser::Feed(std::string_view data)
+{
+    size_t consumed{0};
+    while (consumed < data.size() && m_state != State::COMPLETE) {
+        const std::string_view rest{data.substr(consumed)};
+        if (m_state == State::BODY || m_state == State::CHUNK_DATA) {
+            const size_t n{std::min(m_remaining, rest.size())};
+            m_request.body.append(rest.substr(0, n));
+            m_remaining -= n;
+            consumed += n;
+            if (m_remaining == 0) m_state = m_state == State::BODY ? State::COMPLETE : State::CHUNK_DATA_END;
+            continue;
+        }
+        const size_t end{rest.find('\n')};
+        const size_t n{end == std::string_view::npos ? rest.size() : end + 1};
+        if (m_state == State::REQUEST_LINE || m_state == State::HEADERS) {
+            m_head_size += n;
+            if (m_head_size > MAX_HEADERS_SIZE) throw HTTPParseError(HTTP_BAD_REQUEST, "request header too large");
+        } else if (m_line.size() + n > MAX_HEADERS_SIZE) {
+            throw HTTPParseError(HTTP_BAD_REQUEST, "chunk size or trailer line too large");
+        }
+        m_line.append(rest.substr(0, n));
+        consumed += n;
+        if (end == std::string_view::npos) break;
+        std::string_view line{m_line};
+        line.remove_suffix(1);
+        if (line.ends_with('\r')) line.remove_suffix(1);
+        ParseLine(line);
+        m_line.clear();
+    }
+    return consumed;
+}
+
+void HTTPRequestParser::ParseLine(std::string_view line)
+{
+    switch (m_state) {
+    case State::REQUEST_LINE: {
+        // Empty lines before a request are ignored.
+        if (line.empty()) return;
+        const auto parts{SplitString(line, ' ')};
+        if (parts.size() != 3 || parts[0].empty() || parts[1].empty()) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed request line");
+        if (parts[2] == "HTTP/1.1") {
+            m_request.minor_version = 1;
+        } else if (parts[2] == "HTTP/1.0") {
+            m_request.minor_version = 0;
+        } else {
+            throw HTTPParseError(HTTP_BAD_REQUEST, "unsupported HTTP version");
+        }
+        m_request.method = parts[0];
+        m_request.uri = parts[1];
+        m_state = State::HEADERS;
+        return;
+    }
+    case State::HEADERS: {
+        if (line.empty()) return EndHead();
+        if (line.front() == ' ' || line.front() == '\t') {
+            // Continuation of the previous header (obsolete line folding).
+            if (m_request.headers.empty()) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed header");
+            auto& value{m_request.headers.back().second};
+            value += ' ';
+            value += TrimStringView(line);
+            return;
+        }
+        const size_t colon{line.find(':')};
+        if (colon == 0 || colon == std::string_view::npos) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed header");
+        const std::string_view name{line.substr(0, colon)};
+        if (name.find_first_of(" \t") != std::string_view::npos) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed header");
+        m_request.headers.emplace_back(name, TrimStringView(line.substr(colon + 1)));
+        return;
+    }
+    case State::CHUNK_SIZE: {
+        const std::string_view size_str{TrimStringView(line.substr(0, line.find(';')))};
+        if (size_str.empty()) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed chunk size");
+        uint64_t size{0};
+        for (const char c : size_str) {
+            const signed char digit{HexDigit(c)};
+            if (digit < 0) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed chunk size");
+            size = size * 16 + digit;
+            if (m_request.body.size() + size > MAX_SIZE) throw HTTPParseError(HTTP_PAYLOAD_TOO_LARGE, "request body too large");
+        }
+        m_remaining = size;
+        m_state = size == 0 ? State::TRAILERS : State::CHUNK_DATA;
+        return;
+    }
+    case State::CHUNK_DATA_END:
+        if (!line.empty()) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed chunk");
+        m_state = State::CHUNK_SIZE;
+        return;
+    case State::TRAILERS:
+        // Trailers are not used by any handler and dropped.
+        if (line.empty()) m_state = State::COMPLETE;
+        return;
+    case State::BODY:
+    case State::CHUNK_DATA:
+    case State::COMPLETE:
+        break;
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+void HTTPRequestParser::EndHead()
+{
+    if (const auto encoding{m_request.FindHeader("Transfer-Encoding")}) {
+        if (!ToLower(*encoding).ends_with("chunked")) throw HTTPParseError(HTTP_BAD_REQUEST, "unsupported transfer encoding");
+        m_state = State::CHUNK_SIZE;
+    } else if (const auto length_str{m_request.FindHeader("Content-Length")}) {
+        const auto length{ToIntegral<uint64_t>(*length_str)};
+        if (!length) throw HTTPParseError(HTTP_BAD_REQUEST, "malformed content length");
+        // The same limit as for a deserialized vector.
+        if (*length > MAX_SIZE) throw HTTPParseError(HTTP_PAYLOAD_TOO_LARGE, "request body too large");
+        m_remaining = *length;
+        m_state = m_remaining == 0 ? State::COMPLETE : State::BODY;
+    } else {
+        m_state = State::COMPLETE;
+    }
+}
+
+bool HTTPRequestParser::ExpectsContinue() const
+{
+    assert(HeadComplete());
+    // 1xx replies must not be sent to HTTP/1.0 clients.
+    if (m_request.minor_version < 1) return false;
+    const auto expect{m_request.FindHeader("Expect")};
+    return expect && ToLower(TrimStringView(*expect)) == "100-continue";
+}
+
+HTTPRequestData HTTPRequestParser::Take()
+{
+    assert(Complete());
+    HTTPRequestData request{std::move(m_request)};
+    *this = HTTPRequestParser{};
+    return request;
+}
+
+/** A connection of a client, read from by an I/O thread. Replies are sent by
+ * the thread handling its request, except for those written on the I/O thread,
+ * which are queued and sent by it as the socket accepts them. */
+struct HTTPConnection
+{
+    HTTPConnection(std::shared_ptr<const Sock> sock_in, CService peer_in)
+        : sock{std::move(sock_in)}, peer{std::move(peer_in)} {}
+
+    const std::shared_ptr<const Sock> sock;
+    const CService peer;
+
+    Mutex m_mutex;
+    //! Bytes received and not parsed yet
+    std::string m_recv_buffer GUARDED_BY(m_mutex);
+    HTTPRequestParser m_parser GUARDED_BY(m_mutex);
+    //! Whether a request was taken from the connection and not replied to
+    //! yet. The next request is parsed only then, so replies are in order.
+    bool m_busy GUARDED_BY(m_mutex){false};
+    //! Whether to close the connection once it is not busy
+    bool m_close GUARDED_BY(m_mutex){false};
+    //! Whether the request being received was answered with "100 Continue",
+    //! if it asked for it
+    bool m_continue_sent GUARDED_BY(m_mutex){false};
+    //! Queued reply bytes the socket did not accept yet. The next request is
+    //! parsed, and the connection closed, only once they were sent.
+    std::string m_send_buffer GUARDED_BY(m_mutex);
+    //! When a request was last received or replied to, or queued reply bytes
+    //! were last sent, for -rpcservertimeout
+    SteadyClock::time_point m_last_active GUARDED_BY(m_mutex){SteadyClock::now()};
+};
 
 /** HTTP request work item */
-class HTTPWorkItem final : public HTTPClosure
+class HTTPWorkItem
 {
 public:
-    HTTPWorkItem(std::unique_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler& _func):
-        req(std::move(_req)), path(_path), func(_func)
+    HTTPWorkItem(std::unique_ptr<HTTPRequest> _req, std::shared_ptr<HTTPConnection> _connection, const std::string &_path, const HTTPRequestHandler& _func):
+        req(std::move(_req)), connection(std::move(_connection)), path(_path), func(_func)
     {
     }
-    void operator()() override
+    void operator()()
     {
         func(req.get(), path);
     }
 
     std::unique_ptr<HTTPRequest> req;
+    std::shared_ptr<HTTPConnection> connection;
 
 private:
     std::string path;
     HTTPRequestHandler func;
 };
 
-/** Simple work queue for distributing work over multiple threads.
- * Work items are simply callable objects.
- */
-template <typename WorkItem>
-class WorkQueue
-{
-private:
-    Mutex cs;
-    std::condition_variable cond GUARDED_BY(cs);
-    std::deque<std::unique_ptr<WorkItem>> queue GUARDED_BY(cs);
-    bool running GUARDED_BY(cs){true};
-    const size_t maxDepth;
-
-public:
-    explicit WorkQueue(size_t _maxDepth) : maxDepth(_maxDepth)
-    {
-    }
-    /** Precondition: worker threads have all stopped (they have been joined).
-     */
-    ~WorkQueue() = default;
-    /** Enqueue a work item */
-    bool Enqueue(WorkItem* item) EXCLUSIVE_LOCKS_REQUIRED(!cs)
-    {
-        LOCK(cs);
-        if (!running || queue.size() >= maxDepth) {
-            return false;
-        }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
-        cond.notify_one();
-        return true;
-    }
-    /** Thread function */
-    void Run() EXCLUSIVE_LOCKS_REQUIRED(!cs)
-    {
-        while (true) {
-            std::unique_ptr<WorkItem> i;
-            {
-                WAIT_LOCK(cs, lock);
-                while (running && queue.empty())
-                    cond.wait(lock);
-                if (!running && queue.empty())
-                    break;
-                i = std::move(queue.front());
-                queue.pop_front();
-            }
-            (*i)();
-        }
-    }
-    /** Interrupt and exit loops */
-    void Interrupt() EXCLUSIVE_LOCKS_REQUIRED(!cs)
-    {
-        LOCK(cs);
-        running = false;
-        cond.notify_all();
-    }
-};
-
 struct HTTPPathHandler
 {
     HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
@@ -139,74 +275,31 @@ struct HTTPPathHandler
 
 /** HTTP module state */
 
-//! libevent event loop
-static struct event_base* eventBase = nullptr;
-//! HTTP server
-static struct evhttp* eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
-//! Work queue for handling longer requests off the event loop thread
-static std::unique_ptr<WorkQueue<HTTPClosure>> g_work_queue{nullptr};
+//! Threads handling requests
+static util::ThreadPool g_http_workers{"httpworker"};
+//! Maximum number of requests waiting for a worker thread, see -rpcworkqueue
+static size_t g_work_queue_depth{DEFAULT_HTTP_WORKQUEUE};
+static Mutex g_work_mutex;
+//! Requests waiting for the work queue to have room. Each connection has at
+//! most one request waiting, and is not read from beyond MAX_RECV_BUFFER
+//! meanwhile, so clients are slowed down instead of turned away.
+static std::deque<std::unique_ptr<HTTPWorkItem>> g_work_backlog GUARDED_BY(g_work_mutex);
 //! Handlers for (sub)paths
 static GlobalMutex g_httppathhandlers_mutex;
 static std::vector<HTTPPathHandler> pathHandlers GUARDED_BY(g_httppathhandlers_mutex);
 //! Bound listening sockets
-static std::vector<evhttp_bound_socket *> boundSockets;
-
-/**
- * @brief Helps keep track of open `evhttp_connection`s with active `evhttp_requests`
- *
- */
-class HTTPRequestTracker
-{
-private:
-    mutable Mutex m_mutex;
-    mutable std::condition_variable m_cv;
-    //! For each connection, keep a counter of how many requests are open
-    std::unordered_map<const evhttp_connection*, size_t> m_tracker GUARDED_BY(m_mutex);
-
-    void RemoveConnectionInternal(const decltype(m_tracker)::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
-    {
-        m_tracker.erase(it);
-        if (m_tracker.empty()) m_cv.notify_all();
-    }
-public:
-    //! Increase request counter for the associated connection by 1
-    void AddRequest(evhttp_request* req) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
-    {
-        const evhttp_connection* conn{Assert(evhttp_request_get_connection(Assert(req)))};
-        WITH_LOCK(m_mutex, ++m_tracker[conn]);
-    }
-    //! Decrease request counter for the associated connection by 1, remove connection if counter is 0
-    void RemoveRequest(evhttp_request* req) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
-    {
-        const evhttp_connection* conn{Assert(evhttp_request_get_connection(Assert(req)))};
-        LOCK(m_mutex);
-        auto it{m_tracker.find(conn)};
-        if (it != m_tracker.end() && it->second > 0) {
-            if (--(it->second) == 0) RemoveConnectionInternal(it);
-        }
-    }
-    //! Remove a connection entirely
-    void RemoveConnection(const evhttp_connection* conn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
-    {
-        LOCK(m_mutex);
-        auto it{m_tracker.find(Assert(conn))};
-        if (it != m_tracker.end()) RemoveConnectionInternal(it);
-    }
-    size_t CountActiveConnections() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
-    {
-        return WITH_LOCK(m_mutex, return m_tracker.size());
-    }
-    //! Wait until there are no more connections with active requests in the tracker
-    void WaitUntilEmpty() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
-    {
-        WAIT_LOCK(m_mutex, lock);
-        m_cv.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_tracker.empty(); });
-    }
-};
-//! Track active requests
-static HTTPRequestTracker g_requests;
+static std::vector<std::shared_ptr<const Sock>> boundSockets;
+//! Threads accepting connections and reading requests
+static std::vector<std::thread> g_thread_http_io;
+static CThreadInterrupt g_http_io_interrupt;
+//! Node shutdown signal, which makes replies close the connection
+static const util::SignalInterrupt* g_shutdown_signal{nullptr};
+//! Whether new requests are rejected because the server is being stopped
+static std::atomic<bool> g_http_rejecting{false};
+//! Time to wait for a complete request or for a reply to be sent, see -rpcservertimeout
+static std::chrono::seconds g_http_timeout{DEFAULT_HTTP_SERVER_TIMEOUT};
 
 /** Check if a network address is allowed to access the HTTP server */
 static bool ClientAllowed(const CNetAddr& netaddr)
@@ -260,39 +353,162 @@ std::string RequestMethodString(HTTPRequest::RequestMethod m)
     assert(false);
 }
 
-/** HTTP request callback */
-static void http_request_cb(struct evhttp_request* req, void* arg)
+/** Reason phrase of an HTTP status code */
+static std::string_view HTTPStatusReason(int status)
 {
-    evhttp_connection* conn{evhttp_request_get_connection(req)};
-    // Track active requests
-    {
-        g_requests.AddRequest(req);
-        evhttp_request_set_on_complete_cb(req, [](struct evhttp_request* req, void*) {
-            g_requests.RemoveRequest(req);
-        }, nullptr);
-        evhttp_connection_set_closecb(conn, [](evhttp_connection* conn, void* arg) {
-            g_requests.RemoveConnection(conn);
-        }, nullptr);
-    }
-
-    // Disable reading to work around a libevent bug, fixed in 2.1.9
-    // See https://github.com/libevent/libevent/commit/5ff8eb26371c4dc56f384b2de35bea2d87814779
-    // and https://github.com/bitcoin/bitcoin/pull/11593.
-    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
-        if (conn) {
-            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-            if (bev) {
-                bufferevent_disable(bev, EV_READ);
-            }
+    switch (status) {
+    case 100: return "Continue";
+    case HTTP_OK: return "OK";
+    case HTTP_NO_CONTENT: return "No Content";
+    case HTTP_BAD_REQUEST: return "Bad Request";
+    case HTTP_UNAUTHORIZED: return "Unauthorized";
+    case HTTP_FORBIDDEN: return "Forbidden";
+    case HTTP_NOT_FOUND: return "Not Found";
+    case HTTP_BAD_METHOD: return "Method Not Allowed";
+    case HTTP_PAYLOAD_TOO_LARGE: return "Payload Too Large";
+    case HTTP_INTERNAL_SERVER_ERROR: return "Internal Server Error";
+    case HTTP_SERVICE_UNAVAILABLE: return "Service Unavailable";
+    default: return "Unknown";
+    }
+}
+
+/** Whether a socket error only means that the operation should be retried. */
+static bool IOErrorIsTransient(int err)
+{
+    return err == WSAEWOULDBLOCK || err == WSAEMSGSIZE || err == WSAEINTR || err == WSAEINPROGRESS;
+}
+
+/** Send all of @p data to a connection, giving up once the client did not
+ * accept any of it for -rpcservertimeout. Replies are sent in full while
+ * shutting down too, such as the reply to the stop RPC. */
+static bool SendToConnection(const HTTPConnection& connection, std::string_view data)
+{
+    auto deadline{SteadyClock::now() + g_http_timeout};
+    while (!data.empty()) {
+        const ssize_t n{connection.sock->Send(data.data(), data.size(), MSG_NOSIGNAL)};
+        const auto now{SteadyClock::now()};
+        if (n > 0) {
+            data.remove_prefix(n);
+            // Large replies to slow clients take as long as they take.
+            deadline = now + g_http_timeout;
+            continue;
+        }
+        const int nErr = WSAGetLastError();
+        if (n < 0 && !IOErrorIsTransient(nErr)) {
+            LogDebug(BCLog::HTTP, "Sending to %s failed: %s\n", connection.peer.ToStringAddrPort(), NetworkErrorString(nErr));
+            return false;
+        }
+        if (now >= deadline) {
+            LogDebug(BCLog::HTTP, "Sending to %s timed out with %u bytes left\n", connection.peer.ToStringAddrPort(), data.size());
+            return false;
         }
+        (void)connection.sock->Wait(std::chrono::duration_cast<std::chrono::milliseconds>(std::min<SteadyClock::duration>(deadline - now, SELECT_TIMEOUT)), Sock::SEND);
+    }
+    return true;
+}
+
+/** Send as much of the queued reply bytes of a connection as its socket
+ * accepts without blocking. The connection is closed if sending fails. */
+static void FlushConnection(HTTPConnection& connection) EXCLUSIVE_LOCKS_REQUIRED(connection.m_mutex)
+{
+    while (!connection.m_send_buffer.empty()) {
+        const ssize_t n{connection.sock->Send(connection.m_send_buffer.data(), connection.m_send_buffer.size(), MSG_NOSIGNAL | MSG_DONTWAIT)};
+        if (n < 0) {
+            const int nErr = WSAGetLastError();
+            if (IOErrorIsTransient(nErr)) return;
+            LogDebug(BCLog::HTTP, "Sending to %s failed: %s\n", connection.peer.ToStringAddrPort(), NetworkErrorString(nErr));
+            connection.m_send_buffer.clear();
+            connection.m_close = true;
+            return;
+        }
+        if (n == 0) return;
+        connection.m_send_buffer.erase(0, n);
+        connection.m_last_active = SteadyClock::now();
+    }
+}
+
+/** Queue reply bytes on a connection, sending what its socket accepts right
+ * away. Used on the I/O threads, which must not wait for a client to read. */
+static void QueueToConnection(HTTPConnection& connection, std::string_view data) EXCLUSIVE_LOCKS_REQUIRED(connection.m_mutex)
+{
+    connection.m_send_buffer.append(data);
+    FlushConnection(connection);
+}
+
+/** Run the handlers of requests, and of the requests waiting for room in the
+ * work queue after them. */
+static void RunWorkItems(std::unique_ptr<HTTPWorkItem> item);
+
+/** Parse the next request of a connection, unless it is waiting on the reply
+ * to the previous one. */
+static std::unique_ptr<HTTPRequest> TakeRequest(const std::shared_ptr<HTTPConnection>& connection) EXCLUSIVE_LOCKS_REQUIRED(!connection->m_mutex)
+{
+    LOCK(connection->m_mutex);
+    // Queued replies are sent before the reply to the next request.
+    if (connection->m_busy || connection->m_close || !connection->m_send_buffer.empty()) return nullptr;
+    try {
+        connection->m_recv_buffer.erase(0, connection->m_parser.Feed(connection->m_recv_buffer));
+    } catch (const HTTPParseError& e) {
+        LogDebug(BCLog::HTTP, "Malformed HTTP request from %s: %s\n", connection->peer.ToStringAddrPort(), e.what());
+        connection->m_close = true;
+        connection->m_recv_buffer.clear();
+        QueueToConnection(*connection, strprintf("HTTP/1.1 %d %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", e.status, HTTPStatusReason(e.status)));
+        return nullptr;
+    }
+    if (connection->m_parser.Complete()) {
+        connection->m_busy = true;
+        connection->m_continue_sent = false;
+        connection->m_last_active = SteadyClock::now();
+        return std::make_unique<HTTPRequest>(connection, connection->m_parser.Take(), *Assert(g_shutdown_signal));
+    }
+    // Clients sending "Expect: 100-continue" wait for this before sending the body.
+    if (connection->m_parser.HeadComplete() && !connection->m_continue_sent) {
+        connection->m_continue_sent = true;
+        if (connection->m_parser.ExpectsContinue()) QueueToConnection(*connection, "HTTP/1.1 100 Continue\r\n\r\n");
+    }
+    return nullptr;
+}
+
+/** Queue a request for a worker thread. */
+static void QueueWorkItem(std::unique_ptr<HTTPWorkItem> item) EXCLUSIVE_LOCKS_REQUIRED(!g_work_mutex)
+{
+    LOCK(g_work_mutex);
+    // A request waits in the backlog only while there are queued tasks, each
+    // of which runs the backlog after its own request.
+    if (g_http_workers.WorkQueueSize() >= g_work_queue_depth) {
+        LogDebug(BCLog::HTTP, "Work queue depth exceeded, request from %s waits for a worker thread\n", item->connection->peer.ToStringAddrPort());
+        g_work_backlog.push_back(std::move(item));
+        return;
+    }
+    try {
+        (void)g_http_workers.Submit([item = std::move(item)]() mutable { RunWorkItems(std::move(item)); });
+    } catch (const std::runtime_error&) {
+        // The worker threads were stopped; the submitted closure, and with
+        // it the request, was destroyed without running.
+    }
+}
+
+/** Dispatch a request to its handler, or reply to it if there is none. */
+static void HandleRequest(const std::shared_ptr<HTTPConnection>& connection, std::unique_ptr<HTTPRequest> hreq)
+{
+    // This may run on an I/O thread, which must not wait for the client to
+    // read the reply.
+    const auto reject{[&](int status) {
+        hreq->QueueReply();
+        hreq->WriteReply(status);
+    }};
+
+    if (g_http_rejecting) {
+        LogDebug(BCLog::HTTP, "Rejecting request while shutting down\n");
+        reject(HTTP_SERVICE_UNAVAILABLE);
+        return;
     }
-    auto hreq{std::make_unique<HTTPRequest>(req, *static_cast<const util::SignalInterrupt*>(arg))};
 
     // Early address-based allow check
     if (!ClientAllowed(hreq->GetPeer())) {
         LogDebug(BCLog::HTTP, "HTTP request from %s rejected: Client network is not allowed RPC access\n",
                  hreq->GetPeer().ToStringAddrPort());
-        hreq->WriteReply(HTTP_FORBIDDEN);
+        reject(HTTP_FORBIDDEN);
         return;
     }
 
@@ -300,7 +516,7 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
     if (hreq->GetRequestMethod() == HTTPRequest::UNKNOWN) {
         LogDebug(BCLog::HTTP, "HTTP request from %s rejected: Unknown HTTP request method\n",
                  hreq->GetPeer().ToStringAddrPort());
-        hreq->WriteReply(HTTP_BAD_METHOD);
+        reject(HTTP_BAD_METHOD);
         return;
     }
 
@@ -310,55 +526,189 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
     // Find registered handler for prefix
     std::string strURI = hreq->GetURI();
     std::string path;
-    LOCK(g_httppathhandlers_mutex);
-    std::vector<HTTPPathHandler>::const_iterator i = pathHandlers.begin();
-    std::vector<HTTPPathHandler>::const_iterator iend = pathHandlers.end();
-    for (; i != iend; ++i) {
-        bool match = false;
-        if (i->exactMatch)
-            match = (strURI == i->prefix);
-        else
-            match = strURI.starts_with(i->prefix);
-        if (match) {
-            path = strURI.substr(i->prefix.size());
-            break;
+    std::optional<HTTPRequestHandler> handler;
+    {
+        LOCK(g_httppathhandlers_mutex);
+        for (const HTTPPathHandler& i : pathHandlers) {
+            bool match = false;
+            if (i.exactMatch)
+                match = (strURI == i.prefix);
+            else
+                match = strURI.starts_with(i.prefix);
+            if (match) {
+                path = strURI.substr(i.prefix.size());
+                handler = i.handler;
+                break;
+            }
         }
     }
 
     // Dispatch to worker thread
-    if (i != iend) {
-        std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
-        assert(g_work_queue);
-        if (g_work_queue->Enqueue(item.get())) {
-            item.release(); /* if true, queue took ownership */
+    if (handler) {
+        QueueWorkItem(std::make_unique<HTTPWorkItem>(std::move(hreq), connection, path, *handler));
+    } else {
+        reject(HTTP_NOT_FOUND);
+    }
+}
+
+/** Handle the requests of a connection that were received in full. */
+static void ProcessConnection(const std::shared_ptr<HTTPConnection>& connection)
+{
+    while (auto hreq{TakeRequest(connection)}) {
+        HandleRequest(connection, std::move(hreq));
+    }
+}
+
+static void RunWorkItems(std::unique_ptr<HTTPWorkItem> item)
+{
+    while (item) {
+        (*item)();
+        const auto connection{std::move(item->connection)};
+        // Replies to the request if the handler did not.
+        item.reset();
+        // Continue with a request the client sent before this reply.
+        ProcessConnection(connection);
+        LOCK(g_work_mutex);
+        if (!g_work_backlog.empty()) {
+            item = std::move(g_work_backlog.front());
+            g_work_backlog.pop_front();
+        }
+    }
+}
+
+/** Accept the connections waiting on a listening socket. */
+static void AcceptConnections(const Sock& listen_sock, std::vector<std::shared_ptr<HTTPConnection>>& connections)
+{
+    while (true) {
+        struct sockaddr_storage sockaddr;
+        socklen_t len = sizeof(sockaddr);
+        auto sock{listen_sock.Accept((struct sockaddr*)&sockaddr, &len)};
+        if (!sock) {
+            const int nErr = WSAGetLastError();
+            if (nErr != WSAEWOULDBLOCK) {
+                LogDebug(BCLog::HTTP, "Accepting HTTP connection failed: %s\n", NetworkErrorString(nErr));
+            }
+            return;
+        }
+        CService peer;
+        if (!peer.SetSockAddr((const struct sockaddr*)&sockaddr, len)) {
+            LogDebug(BCLog::HTTP, "Unknown socket family of HTTP connection\n");
         } else {
-            LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
-            item->req->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
+            peer = MaybeFlipIPv6toCJDNS(peer);
         }
-    } else {
-        hreq->WriteReply(HTTP_NOT_FOUND);
+        if (!sock->SetNonBlocking()) {
+            LogDebug(BCLog::HTTP, "Unable to set HTTP connection from %s non-blocking\n", peer.ToStringAddrPort());
+            continue;
+        }
+        // Set the no-delay option (disable Nagle's algorithm) on the TCP socket.
+        const int one{1};
+        if (sock->SetSockOpt(IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == SOCKET_ERROR) {
+            LogDebug(BCLog::HTTP, "Unable to set TCP_NODELAY on HTTP connection from %s, continuing anyway\n", peer.ToStringAddrPort());
+        }
+        LogDebug(BCLog::HTTP, "Accepted HTTP connection from %s\n", peer.ToStringAddrPort());
+        connections.push_back(std::make_shared<HTTPConnection>(std::move(sock), peer));
     }
 }
 
-/** Callback to reject HTTP requests after shutdown. */
-static void http_reject_request_cb(struct evhttp_request* req, void*)
+/** Read from a connection and handle the requests received in full. */
+static void ReceiveFromConnection(const std::shared_ptr<HTTPConnection>& connection, std::span<char> buf)
 {
-    LogDebug(BCLog::HTTP, "Rejecting request while shutting down\n");
-    evhttp_send_error(req, HTTP_SERVUNAVAIL, nullptr);
+    const ssize_t n{connection->sock->Recv(buf.data(), buf.size(), MSG_DONTWAIT)};
+    if (n > 0) {
+        {
+            LOCK(connection->m_mutex);
+            connection->m_recv_buffer.append(buf.data(), n);
+            connection->m_last_active = SteadyClock::now();
+        }
+        ProcessConnection(connection);
+        return;
+    }
+    if (n < 0) {
+        const int nErr = WSAGetLastError();
+        if (IOErrorIsTransient(nErr)) return;
+        LogDebug(BCLog::HTTP, "Receiving from HTTP connection %s failed: %s\n", connection->peer.ToStringAddrPort(), NetworkErrorString(nErr));
+    }
+    // The client closed the connection, possibly after sending a last request.
+    ProcessConnection(connection);
+    WITH_LOCK(connection->m_mutex, connection->m_close = true);
 }
 
-/** Event dispatcher thread */
-static void ThreadHTTP(struct event_base* base)
+/** I/O thread: accept connections and read requests from them */
+static void ThreadHTTPIO()
 {
-    util::ThreadRename("http");
-    LogDebug(BCLog::HTTP, "Entering http event loop\n");
-    event_base_dispatch(base);
-    // Event loop will be interrupted by InterruptHTTPServer()
-    LogDebug(BCLog::HTTP, "Exited http event loop\n");
+    const auto wait_set{Assert(boundSockets.front())->CreateWaitSet()};
+    std::vector<std::shared_ptr<HTTPConnection>> connections;
+    std::vector<char> buf(MAX_RECV_BUFFER);
+    Sock::EventsPerSock events_per_sock;
+    while (!g_http_io_interrupt) {
+        for (const auto& sock : boundSockets) {
+            wait_set->Add(sock, Sock::RECV);
+        }
+        const auto now{SteadyClock::now()};
+        std::erase_if(connections, [&](const std::shared_ptr<HTTPConnection>& connection) {
+            LOCK(connection->m_mutex);
+            if (!connection->m_busy) {
+                if (connection->m_close && connection->m_send_buffer.empty()) return true;
+                if (now - connection->m_last_active > g_http_timeout) {
+                    LogDebug(BCLog::HTTP, "Closing idle HTTP connection from %s\n", connection->peer.ToStringAddrPort());
+                    return true;
+                }
+            }
+            Sock::Event requested{0};
+            if (!connection->m_close && connection->m_recv_buffer.size() < MAX_RECV_BUFFER) requested |= Sock::RECV;
+            if (!connection->m_send_buffer.empty()) requested |= Sock::SEND;
+            if (requested) wait_set->Add(connection->sock, requested);
+            return false;
+        });
+
+        if (!wait_set->Wait(SELECT_TIMEOUT, events_per_sock)) {
+            g_http_io_interrupt.sleep_for(SELECT_TIMEOUT);
+            continue;
+        }
+        const auto occurred{[&](const std::shared_ptr<const Sock>& sock, Sock::Event event) {
+            const auto it{events_per_sock.find(sock)};
+            return it != events_per_sock.end() && (it->second.occurred & event);
+        }};
+        for (const auto& sock : boundSockets) {
+            if (occurred(sock, Sock::RECV)) AcceptConnections(*sock, connections);
+        }
+        for (const auto& connection : connections) {
+            if (occurred(connection->sock, Sock::SEND)) {
+                // Continue with the next request once the queued reply was sent.
+                if (WITH_LOCK(connection->m_mutex, FlushConnection(*connection); return connection->m_send_buffer.empty())) {
+                    ProcessConnection(connection);
+                }
+            }
+            if (occurred(connection->sock, Sock::RECV)) ReceiveFromConnection(connection, buf);
+        }
+    }
+}
+
+/** Create a socket listening on the given address. */
+static std::shared_ptr<const Sock> BindListenSocket(const CService& addr)
+{
+    struct sockaddr_storage sockaddr;
+    socklen_t len = sizeof(sockaddr);
+    if (!addr.GetSockAddr((struct sockaddr*)&sockaddr, &len)) return nullptr;
+    std::unique_ptr<Sock> sock{CreateSock(addr.GetSAFamily(), SOCK_STREAM, IPPROTO_TCP)};
+    if (!sock) return nullptr;
+    // Allow binding if the port is still in TIME_WAIT state after
+    // the program was closed and restarted.
+    const int one{1};
+    if (sock->SetSockOpt(SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) == SOCKET_ERROR) {
+        LogInfo("WARNING: Unable to set SO_REUSEADDR on RPC server socket, continuing anyway\n");
+    }
+    if (sock->Bind((struct sockaddr*)&sockaddr, len) == SOCKET_ERROR ||
+        sock->Listen(SOMAXCONN) == SOCKET_ERROR ||
+        !sock->SetNonBlocking()) {
+        LogDebug(BCLog::HTTP, "Listening on %s failed: %s\n", addr.ToStringAddrPort(), NetworkErrorString(WSAGetLastError()));
+        return nullptr;
+    }
+    return sock;
 }
 
 /** Bind HTTP server to specified addresses */
-static bool HTTPBindAddresses(struct evhttp* http)
+static bool HTTPBindAddresses()
 {
     uint16_t http_port{static_cast<uint16_t>(gArgs.GetIntArg("-rpcport", BaseParams().RPCPort()))};
     std::vector<std::pair<std::string, uint16_t>> endpoints;
@@ -392,19 +742,14 @@ static bool HTTPBindAddresses(struct evhttp* http)
     // Bind addresses
     for (std::vector<std::pair<std::string, uint16_t> >::iterator i = endpoints.begin(); i != endpoints.end(); ++i) {
         LogInfo("Binding RPC on address %s port %i", i->first, i->second);
-        evhttp_bound_socket *bind_handle = evhttp_bind_socket_with_handle(http, i->first.empty() ? nullptr : i->first.c_str(), i->second);
-        if (bind_handle) {
-            const std::optional<CNetAddr> addr{LookupHost(i->first, false)};
-            if (i->first.empty() || (addr.has_value() && addr->IsBindAny())) {
+        // An empty host binds to all IPv4 addresses, like getaddrinfo(3) for a passive socket.
+        const std::optional<CService> addr{Lookup(i->first.empty() ? "0.0.0.0" : i->first, i->second, /*fAllowLookup=*/true)};
+        std::shared_ptr<const Sock> sock{addr ? BindListenSocket(*addr) : nullptr};
+        if (sock) {
+            if (i->first.empty() || addr->IsBindAny()) {
                 LogPrintf("WARNING: the RPC server is not safe to expose to untrusted networks such as the public internet\n");
             }
-            // Set the no-delay option (disable Nagle's algorithm) on the TCP socket.
-            evutil_socket_t fd = evhttp_bound_socket_get_fd(bind_handle);
-            int one = 1;
-            if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&one), sizeof(one)) == SOCKET_ERROR) {
-                LogInfo("WARNING: Unable to set TCP_NODELAY on RPC server socket, continuing anyway\n");
-            }
-            boundSockets.push_back(bind_handle);
+            boundSockets.push_back(std::move(sock));
         } else {
             LogPrintf("Binding RPC on address %s port %i failed.\n", i->first, i->second);
         }
@@ -412,13 +757,6 @@ static bool HTTPBindAddresses(struct evhttp* http)
     return !boundSockets.empty();
 }
 
-/** Simple wrapper to set thread name and run work queue */
-static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, int worker_num)
-{
-    util::ThreadRename(strprintf("httpworker.%i", worker_num));
-    queue->Run();
-}
-
 /** libevent event log callback */
 static void libevent_log_cb(int severity, const char *msg)
 {
@@ -450,28 +788,19 @@ bool InitHTTPServer(const util::SignalInterrupt& interrupt)
     // Update libevent's log handling.
     UpdateHTTPServerLogging(LogInstance().WillLogCategory(BCLog::LIBEVENT));
 
+    // libevent is no longer used by the server, but by the Tor controller,
+    // whose event loop is stopped from another thread.
 #ifdef WIN32
     evthread_use_windows_threads();
 #else
     evthread_use_pthreads();
 #endif
 
-    raii_event_base base_ctr = obtain_event_base();
-
-    /* Create a new evhttp object to handle requests. */
-    raii_evhttp http_ctr = obtain_evhttp(base_ctr.get());
-    struct evhttp* http = http_ctr.get();
-    if (!http) {
-        LogPrintf("couldn't create evhttp. Exiting.\n");
-        return false;
-    }
-
-    evhttp_set_timeout(http, gArgs.GetIntArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT));
-    evhttp_set_max_headers_size(http, MAX_HEADERS_SIZE);
-    evhttp_set_max_body_size(http, MAX_SIZE);
-    evhttp_set_gencb(http, http_request_cb, (void*)&interrupt);
+    g_shutdown_signal = &interrupt;
+    g_http_timeout = std::chrono::seconds{std::max(gArgs.GetIntArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT), int64_t{1})};
+    g_http_rejecting = false;
 
-    if (!HTTPBindAddresses(http)) {
+    if (!HTTPBindAddresses()) {
         LogPrintf("Unable to bind any endpoint for RPC server\n");
         return false;
     }
@@ -479,11 +808,7 @@ bool InitHTTPServer(const util::SignalInterrupt& interrupt)
     LogDebug(BCLog::HTTP, "Initialized HTTP server\n");
     int workQueueDepth = std::max((long)gArgs.GetIntArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
     LogDebug(BCLog::HTTP, "creating work queue of depth %d\n", workQueueDepth);
-
-    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth);
-    // transfer ownership to eventBase/HTTP via .release()
-    eventBase = base_ctr.release();
-    eventHTTP = http_ctr.release();
+    g_work_queue_depth = workQueueDepth;
     return true;
 }
 
@@ -495,238 +820,219 @@ void UpdateHTTPServerLogging(bool enable) {
     }
 }
 
-static std::thread g_thread_http;
-static std::vector<std::thread> g_thread_http_workers;
-
 void StartHTTPServer()
 {
     int rpcThreads = std::max((long)gArgs.GetIntArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogInfo("Starting HTTP server with %d worker threads\n", rpcThreads);
-    g_thread_http = std::thread(ThreadHTTP, eventBase);
-
-    for (int i = 0; i < rpcThreads; i++) {
-        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, g_work_queue.get(), i);
+    const int io_threads{int(std::clamp<int64_t>(gArgs.GetIntArg("-rpciothreads", DEFAULT_HTTP_IO_THREADS), 1, MAX_HTTP_IO_THREADS))};
+    LogInfo("Starting HTTP server with %d worker threads and %d I/O threads\n", rpcThreads, io_threads);
+    g_http_workers.Start(rpcThreads);
+    g_http_io_interrupt.reset();
+    for (int i = 0; i < io_threads; i++) {
+        g_thread_http_io.emplace_back(&util::TraceThread, strprintf("httpio.%i", i), &ThreadHTTPIO);
     }
 }
 
 void InterruptHTTPServer()
 {
     LogDebug(BCLog::HTTP, "Interrupting HTTP server\n");
-    if (eventHTTP) {
-        // Reject requests on current connections
-        evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
-    }
-    if (g_work_queue) {
-        g_work_queue->Interrupt();
-    }
+    // Reject requests on current connections
+    g_http_rejecting = true;
 }
 
 void StopHTTPServer()
 {
     LogDebug(BCLog::HTTP, "Stopping HTTP server\n");
-    if (g_work_queue) {
-        LogDebug(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
-        for (auto& thread : g_thread_http_workers) {
-            thread.join();
-        }
-        g_thread_http_workers.clear();
-    }
-    // Unlisten sockets, these are what make the event loop running, which means
-    // that after this and all connections are closed the event loop will quit.
-    for (evhttp_bound_socket *socket : boundSockets) {
-        evhttp_del_accept_socket(eventHTTP, socket);
+    LogDebug(BCLog::HTTP, "Waiting for HTTP I/O threads to exit\n");
+    g_http_io_interrupt();
+    for (auto& thread : g_thread_http_io) {
+        thread.join();
     }
+    g_thread_http_io.clear();
+    // Unlisten sockets. Idle connections were closed as their I/O threads
+    // exited, the others are closed once their request was replied to.
     boundSockets.clear();
-    {
-        if (const auto n_connections{g_requests.CountActiveConnections()}; n_connections != 0) {
-            LogDebug(BCLog::HTTP, "Waiting for %d connections to stop HTTP server\n", n_connections);
-        }
-        g_requests.WaitUntilEmpty();
-    }
-    if (eventHTTP) {
-        // Schedule a callback to call evhttp_free in the event base thread, so
-        // that evhttp_free does not need to be called again after the handling
-        // of unfinished request connections that follows.
-        event_base_once(eventBase, -1, EV_TIMEOUT, [](evutil_socket_t, short, void*) {
-            evhttp_free(eventHTTP);
-            eventHTTP = nullptr;
-        }, nullptr, nullptr);
-    }
-    if (eventBase) {
-        LogDebug(BCLog::HTTP, "Waiting for HTTP event thread to exit\n");
-        if (g_thread_http.joinable()) g_thread_http.join();
-        event_base_free(eventBase);
-        eventBase = nullptr;
-    }
-    g_work_queue.reset();
+    // Requests being handled are replied to before the worker threads exit,
+    // including those waiting for room in the work queue.
+    LogDebug(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
+    g_http_workers.Stop();
+    Assume(WITH_LOCK(g_work_mutex, return g_work_backlog.empty()));
     LogDebug(BCLog::HTTP, "Stopped HTTP server\n");
 }
 
-struct event_base* EventBase()
-{
-    return eventBase;
-}
-
-static void httpevent_callback_fn(evutil_socket_t, short, void* data)
-{
-    // Static handler: simply call inner handler
-    HTTPEvent *self = static_cast<HTTPEvent*>(data);
-    self->handler();
-    if (self->deleteWhenTriggered)
-        delete self;
-}
-
-HTTPEvent::HTTPEvent(struct event_base* base, bool _deleteWhenTriggered, const std::function<void()>& _handler):
-    deleteWhenTriggered(_deleteWhenTriggered), handler(_handler)
-{
-    ev = event_new(base, -1, 0, httpevent_callback_fn, this);
-    assert(ev);
-}
-HTTPEvent::~HTTPEvent()
-{
-    event_free(ev);
-}
-void HTTPEvent::trigger(struct timeval* tv)
-{
-    if (tv == nullptr)
-        event_active(ev, 0, 0); // immediately trigger event in main thread
-    else
-        evtimer_add(ev, tv); // trigger after timeval passed
-}
-HTTPRequest::HTTPRequest(struct evhttp_request* _req, const util::SignalInterrupt& interrupt, bool _replySent)
-    : req(_req), m_interrupt(interrupt), replySent(_replySent)
+HTTPRequest::HTTPRequest(std::shared_ptr<HTTPConnection> connection, HTTPRequestData data, const util::SignalInterrupt& interrupt)
+    : m_connection(std::move(connection)), m_data(std::move(data)), m_interrupt(interrupt)
 {
 }
 
 HTTPRequest::~HTTPRequest()
 {
-    if (!replySent) {
+    if (m_chunked_reply && !replySent) {
+        // The body was cut short; finish the reply so the connection is handed back.
+        EndReply();
+    } else if (!replySent && ConnectionLost()) {
+        // Nobody is left to reply to; just hand the connection back.
+        FinishReply();
+    } else if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL_SERVER_ERROR, "Unhandled request");
     }
-    // evhttpd cleans up the request, as long as a reply was sent.
+}
+
+bool HTTPRequest::ConnectionLost() const
+{
+    if (!m_connection) return false;
+    if (m_connection_lost) return true;
+    // The I/O thread closes connections that are busy only once the client
+    // closed them.
+    LOCK(m_connection->m_mutex);
+    return m_connection->m_close;
 }
 
 std::pair<bool, std::string> HTTPRequest::GetHeader(const std::string& hdr) const
 {
-    const struct evkeyvalq* headers = evhttp_request_get_input_headers(req);
-    assert(headers);
-    const char* val = evhttp_find_header(headers, hdr.c_str());
-    if (val)
-        return std::make_pair(true, val);
+    if (auto val{m_data.FindHeader(hdr)})
+        return std::make_pair(true, std::move(*val));
     else
         return std::make_pair(false, "");
 }
 
 std::string HTTPRequest::ReadBody()
 {
-    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
-    if (!buf)
-        return "";
-    size_t size = evbuffer_get_length(buf);
-    /** Trivial implementation: if this is ever a performance bottleneck,
-     * internal copying can be avoided in multi-segment buffers by using
-     * evbuffer_peek and an awkward loop. Though in that case, it'd be even
-     * better to not copy into an intermediate string but use a stream
-     * abstraction to consume the evbuffer on the fly in the parsing algorithm.
-     */
-    const char* data = (const char*)evbuffer_pullup(buf, size);
-    if (!data) // returns nullptr in case of empty buffer
-        return "";
-    std::string rv(data, size);
-    evbuffer_drain(buf, size);
-    return rv;
+    return std::exchange(m_data.body, {});
 }
 
 void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 {
-    struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
-    assert(headers);
-    evhttp_add_header(headers, hdr.c_str(), value.c_str());
+    m_reply_headers.emplace_back(hdr, value);
 }
 
-/** Closure sent to main thread to request a reply to be sent to
- * a HTTP request.
- * Replies must be sent in the main loop in the main http thread,
- * this cannot be done from worker threads.
- */
-void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
+std::string HTTPRequest::ReplyHead(int nStatus, std::optional<size_t> content_length)
 {
-    assert(!replySent && req);
-    if (m_interrupt) {
-        WriteHeader("Connection", "close");
-    }
-    // Send event to main http thread to send reply message
-    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
-    assert(evb);
-    evbuffer_add(evb, reply.data(), reply.size());
-    auto req_copy = req;
-    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
-        evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
+    m_keep_alive = m_connection && m_data.KeepAlive() && !m_interrupt && !g_http_rejecting;
+    // HTTP/1.0 clients can only tell the end of a body of unknown length from
+    // the connection closing.
+    if (!content_length && m_data.minor_version == 0) m_keep_alive = false;
+    std::string head{strprintf("HTTP/1.%d %d %s\r\n", m_data.minor_version, nStatus, HTTPStatusReason(nStatus))};
+    for (const auto& [name, value] : m_reply_headers) {
+        const std::string name_lower{ToLower(name)};
+        if (name_lower == "connection") {
+            if (ToLower(value) == "close") m_keep_alive = false;
+        } else if (name_lower != "content-length" && name_lower != "transfer-encoding") {
+            head += strprintf("%s: %s\r\n", name, value);
         }
-    });
-    ev->trigger(nullptr);
+    }
+    if (content_length) {
+        if (nStatus != HTTP_NO_CONTENT) head += strprintf("Content-Length: %u\r\n", *content_length);
+    } else if (m_data.minor_version >= 1) {
+        head += "Transfer-Encoding: chunked\r\n";
+    }
+    if (!m_keep_alive) {
+        head += "Connection: close\r\n";
+    } else if (m_data.minor_version == 0) {
+        head += "Connection: keep-alive\r\n";
+    }
+    head += "\r\n";
+    return head;
+}
+
+void HTTPRequest::Send(std::string_view data)
+{
+    if (!m_connection || m_connection_lost) return;
+    if (m_queue_reply) {
+        LOCK(m_connection->m_mutex);
+        QueueToConnection(*m_connection, data);
+        return;
+    }
+    if (!SendToConnection(*m_connection, data)) {
+        m_connection_lost = true;
+        m_keep_alive = false;
+    }
+}
+
+void HTTPRequest::FinishReply()
+{
     replySent = true;
-    req = nullptr; // transferred back to main thread
+    if (!m_connection) return;
+    LOCK(m_connection->m_mutex);
+    m_connection->m_busy = false;
+    m_connection->m_last_active = SteadyClock::now();
+    if (!m_keep_alive) m_connection->m_close = true;
 }
 
-CService HTTPRequest::GetPeer() const
+void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
 {
-    evhttp_connection* con = evhttp_request_get_connection(req);
-    CService peer;
-    if (con) {
-        // evhttp retains ownership over returned address string
-        const char* address = "";
-        uint16_t port = 0;
+    assert(!replySent && !m_chunked_reply);
+    std::string head{ReplyHead(nStatus, reply.size())};
+    const std::string_view body{m_data.method == "HEAD" ? std::string_view{} : std::string_view{reinterpret_cast<const char*>(reply.data()), reply.size()}};
+    // Send small replies in one go, and large ones without copying them.
+    if (body.size() <= MAX_HEADERS_SIZE) {
+        Send(head.append(body));
+    } else {
+        Send(head);
+        Send(body);
+    }
+    FinishReply();
+}
 
-#ifdef HAVE_EVHTTP_CONNECTION_GET_PEER_CONST_CHAR
-        evhttp_connection_get_peer(con, &address, &port);
-#else
-        evhttp_connection_get_peer(con, (char**)&address, &port);
-#endif // HAVE_EVHTTP_CONNECTION_GET_PEER_CONST_CHAR
+void HTTPRequest::StartReply(int nStatus)
+{
+    assert(!replySent && !m_chunked_reply);
+    m_chunked_reply = true;
+    Send(ReplyHead(nStatus, std::nullopt));
+}
 
-        peer = MaybeFlipIPv6toCJDNS(LookupNumeric(address, port));
+void HTTPRequest::WriteReplyChunk(std::span<const std::byte> chunk)
+{
+    assert(!replySent && m_chunked_reply);
+    if (chunk.empty() || m_data.method == "HEAD") return;
+    const std::string_view data{reinterpret_cast<const char*>(chunk.data()), chunk.size()};
+    if (m_data.minor_version == 0) {
+        Send(data);
+    } else {
+        Send(strprintf("%x\r\n%s\r\n", data.size(), data));
     }
-    return peer;
+}
+
+void HTTPRequest::EndReply()
+{
+    assert(!replySent && m_chunked_reply);
+    if (m_data.minor_version >= 1 && m_data.method != "HEAD") Send("0\r\n\r\n");
+    FinishReply();
+}
+
+std::unique_ptr<HTTPRequest> HTTPRequest::Defer()
+{
+    assert(!replySent && !m_chunked_reply);
+    auto deferred{std::make_unique<HTTPRequest>(std::move(m_connection), std::move(m_data), m_interrupt)};
+    deferred->m_reply_headers = std::move(m_reply_headers);
+    // Nothing is left to reply to on this one.
+    replySent = true;
+    return deferred;
+}
+
+CService HTTPRequest::GetPeer() const
+{
+    return m_connection ? m_connection->peer : CService{};
 }
 
 std::string HTTPRequest::GetURI() const
 {
-    return evhttp_request_get_uri(req);
+    return m_data.uri;
 }
 
 HTTPRequest::RequestMethod HTTPRequest::GetRequestMethod() const
 {
-    switch (evhttp_request_get_command(req)) {
-    case EVHTTP_REQ_GET:
-        return GET;
-    case EVHTTP_REQ_POST:
-        return POST;
-    case EVHTTP_REQ_HEAD:
-        return HEAD;
-    case EVHTTP_REQ_PUT:
-        return PUT;
-    default:
-        return UNKNOWN;
-    }
+    if (m_data.method == "GET") return GET;
+    if (m_data.method == "POST") return POST;
+    if (m_data.method == "HEAD") return HEAD;
+    if (m_data.method == "PUT") return PUT;
+    return UNKNOWN;
 }
 
 std::optional<std::string> HTTPRequest::GetQueryParameter(const std::string& key) const
 {
-    const char* uri{evhttp_request_get_uri(req)};
-
-    return GetQueryParameterFromUri(uri, key);
+    return GetQueryParameterFromUri(m_data.uri.c_str(), key);
 }
 
 std::optional<std::string> GetQueryParameterFromUri(const char* uri, const std::string& key)
@@ -756,6 +1062,17 @@ std::optional<std::string> GetQueryParameterFromUri(const char* uri, const std::
     return result;
 }
 
+void ResumeHTTPRequest(std::unique_ptr<HTTPRequest> req, std::function<void(HTTPRequest*)> func)
+{
+    if (!req->m_connection) {
+        func(req.get());
+        return;
+    }
+    auto connection{req->m_connection};
+    QueueWorkItem(std::make_unique<HTTPWorkItem>(std::move(req), std::move(connection), "",
+                                                 [func = std::move(func)](HTTPRequest* req, const std::string&) { func(req); return true; }));
+}
+
 void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
 {
     LogDebug(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
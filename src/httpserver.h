@@ -5,10 +5,16 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace util {
 class SignalInterrupt;
@@ -20,20 +26,24 @@ class SignalInterrupt;
 static const int DEFAULT_HTTP_THREADS=16;
 
 /**
- * The default value for `-rpcworkqueue`. This is the maximum depth of the work queue,
- * we don't allocate this number of work queue items upfront.
+ * The default value for `-rpcworkqueue`. This is the maximum number of requests
+ * waiting for a worker thread. Further requests wait on their connection,
+ * which is not read from in the meantime.
  */
 static const int DEFAULT_HTTP_WORKQUEUE=64;
 
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
-struct evhttp_request;
-struct event_base;
+/** The default value for `-rpciothreads`, the threads accepting connections and reading requests. */
+static constexpr int DEFAULT_HTTP_IO_THREADS{2};
+static constexpr int MAX_HTTP_IO_THREADS{16};
+
 class CService;
 class HTTPRequest;
+struct HTTPConnection;
 
 /** Initialize HTTP server.
- * Call this before RegisterHTTPHandler or EventBase().
+ * Call this before RegisterHTTPHandler.
  */
 bool InitHTTPServer(const util::SignalInterrupt& interrupt);
 /** Start HTTP server.
@@ -59,23 +69,120 @@ void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPR
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
-/** Return evhttp event base. This can be used by submodules to
- * queue timers or custom events.
+/** An HTTP/1.x request as received from a client. */
+struct HTTPRequestData
+{
+    std::string method;
+    std::string uri;
+    //! Minor version of HTTP/1.x
+    int minor_version{1};
+    //! Headers in the order they were received, with the names as sent
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    /** Value of the first header named @p name, compared case-insensitively. */
+    std::optional<std::string> FindHeader(std::string_view name) const;
+    /** Whether the client wants to keep the connection open after the reply. */
+    bool KeepAlive() const;
+};
+
+/** A malformed or too large request, answered with @p status before closing the connection. */
+class HTTPParseError : public std::runtime_error
+{
+public:
+    HTTPParseError(int status, const std::string& what) : std::runtime_error{what}, status{status} {}
+    const int status;
+};
+
+/**
+ * Incremental parser of HTTP/1.x requests, fed with the bytes of a connection
+ * as they are received. The body may be sent with a Content-Length or with
+ * chunked transfer encoding; requests without either have no body.
  */
-struct event_base* EventBase();
+class HTTPRequestParser
+{
+public:
+    /**
+     * Parse the next bytes received, up to the end of the current request.
+     *
+     * @returns the number of bytes of @p data that were consumed. Bytes past
+     * the end of the request are left for the next one.
+     * @throws HTTPParseError if the request is malformed or too large.
+     */
+    size_t Feed(std::string_view data);
+
+    /** Whether the request line and headers were parsed. */
+    bool HeadComplete() const { return m_state >= State::BODY; }
+    /** Whether a whole request was parsed. */
+    bool Complete() const { return m_state == State::COMPLETE; }
+    /** Whether the client waits for "100 Continue" before sending the body of
+     * the request being received. Requires HeadComplete(). */
+    bool ExpectsContinue() const;
+    /** Take the parsed request and start parsing the next one. Requires Complete(). */
+    HTTPRequestData Take();
+
+private:
+    enum class State {
+        REQUEST_LINE,
+        HEADERS,
+        BODY,
+        CHUNK_SIZE,
+        CHUNK_DATA,
+        CHUNK_DATA_END,
+        TRAILERS,
+        COMPLETE,
+    };
+
+    /** Handle a line of the request line, headers, chunk sizes or trailers. */
+    void ParseLine(std::string_view line);
+    /** Validate the headers and move on to the body. */
+    void EndHead();
+
+    State m_state{State::REQUEST_LINE};
+    //! Received part of the current line
+    std::string m_line;
+    //! Bytes of the request line and headers so far
+    size_t m_head_size{0};
+    //! Bytes of the body or the current chunk still to be received
+    size_t m_remaining{0};
+    HTTPRequestData m_request;
+};
 
 /** In-flight HTTP request.
- * Thin C++ wrapper around evhttp_request.
+ * Replies are sent by the thread calling WriteReply, or StartReply,
+ * WriteReplyChunk and EndReply, unless they are queued with QueueReply.
  */
 class HTTPRequest
 {
 private:
-    struct evhttp_request* req;
+    //! The connection the request was received on, or nullptr if none
+    std::shared_ptr<HTTPConnection> m_connection;
+    HTTPRequestData m_data;
     const util::SignalInterrupt& m_interrupt;
-    bool replySent;
+    //! Headers of the reply in the order they were written
+    std::vector<std::pair<std::string, std::string>> m_reply_headers;
+    bool replySent{false};
+    //! Whether a reply was started with StartReply
+    bool m_chunked_reply{false};
+    //! Whether the connection is kept open after the reply
+    bool m_keep_alive{false};
+    //! Whether sending the reply failed, so that the rest of it is dropped
+    bool m_connection_lost{false};
+    //! Whether the reply is queued on the connection, see QueueReply()
+    bool m_queue_reply{false};
+
+    /** Status line and headers of the reply. The body is sent with chunked
+     * transfer encoding if there is no @p content_length. */
+    std::string ReplyHead(int nStatus, std::optional<size_t> content_length);
+    /** Send part of the reply, dropping it if the client went away. */
+    void Send(std::string_view data);
+    /** Hand the connection back once the reply was sent. */
+    void FinishReply();
+
+    friend void ResumeHTTPRequest(std::unique_ptr<HTTPRequest> req, std::function<void(HTTPRequest*)> func);
 
 public:
-    explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
+    HTTPRequest(std::shared_ptr<HTTPConnection> connection, HTTPRequestData data, const util::SignalInterrupt& interrupt);
     ~HTTPRequest();
 
     enum RequestMethod {
@@ -135,16 +242,76 @@ public:
      * nStatus is the HTTP status code to send.
      * reply is the body of the reply. Keep it empty to send a standard message.
      *
-     * @note Can be called only once. As this will give the request back to the
-     * main thread, do not call any other HTTPRequest methods after calling this.
+     * @note Can be called only once. As this will give the connection back to
+     * the server, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, std::string_view reply = "")
     {
         WriteReply(nStatus, std::as_bytes(std::span{reply}));
     }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
+
+    /**
+     * Start a HTTP reply whose body is sent in parts, as it is produced.
+     * nStatus is the HTTP status code to send. The body is sent with chunked
+     * transfer encoding, or by closing the connection after it for HTTP/1.0
+     * clients.
+     *
+     * @note Call this instead of WriteReply, then WriteReplyChunk for every
+     * part of the body and EndReply once it is complete.
+     */
+    void StartReply(int nStatus);
+
+    /**
+     * Write the next part of a reply started with StartReply.
+     *
+     * Blocks while the connection does not take more data, so that a slow
+     * client does not make the whole body pile up in memory. Parts written
+     * after the client went away are dropped.
+     */
+    void WriteReplyChunk(std::string_view chunk)
+    {
+        WriteReplyChunk(std::as_bytes(std::span{chunk}));
+    }
+    void WriteReplyChunk(std::span<const std::byte> chunk);
+
+    /** Whether the client went away, so that the rest of the reply is dropped. */
+    bool ConnectionLost() const;
+
+    /**
+     * Finish a reply started with StartReply.
+     *
+     * @note As this will give the connection back to the server, do not call
+     * any other HTTPRequest methods after calling this.
+     */
+    void EndReply();
+
+    /**
+     * Take the request over from the handler, so that the worker thread can
+     * move on to other requests while the reply waits for something to
+     * happen. The connection stays busy until the returned request is replied
+     * to, which should be done with ResumeHTTPRequest.
+     *
+     * @note Do not call any other HTTPRequest methods of this one after
+     * calling this.
+     */
+    std::unique_ptr<HTTPRequest> Defer();
+
+    /**
+     * Queue the reply on the connection instead of waiting for the client to
+     * accept it. What the socket does not take right away is sent by the I/O
+     * thread, so this is for small replies written on it.
+     */
+    void QueueReply() { m_queue_reply = true; }
 };
 
+/**
+ * Reply to a request taken over with HTTPRequest::Defer: queue it for a worker
+ * thread, which calls @p func with it and then continues with the requests the
+ * client sent after it.
+ */
+void ResumeHTTPRequest(std::unique_ptr<HTTPRequest> req, std::function<void(HTTPRequest*)> func);
+
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
  * is not found.
  *
@@ -159,36 +326,4 @@ public:
  */
 std::optional<std::string> GetQueryParameterFromUri(const char* uri, const std::string& key);
 
-/** Event handler closure.
- */
-class HTTPClosure
-{
-public:
-    virtual void operator()() = 0;
-    virtual ~HTTPClosure() = default;
-};
-
-/** Event class. This can be used either as a cross-thread trigger or as a timer.
- */
-class HTTPEvent
-{
-public:
-    /** Create a new event.
-     * deleteWhenTriggered deletes this event object after the event is triggered (and the handler called)
-     * handler is the handler to call when the event is triggered.
-     */
-    HTTPEvent(struct event_base* base, bool deleteWhenTriggered, const std::function<void()>& handler);
-    ~HTTPEvent();
-
-    /** Trigger the event. If tv is 0, trigger it immediately. Otherwise trigger it after
-     * the given time has elapsed.
-     */
-    void trigger(struct timeval* tv);
-
-    bool deleteWhenTriggered;
-    std::function<void()> handler;
-private:
-    struct event* ev;
-};
-
 #endif // BITCOIN_HTTPSERVER_H
@@ -4,6 +4,8 @@
 
 #include <kernel/context.h>
 
+#include <crypto/chacha20.h>
+#include <crypto/poly1305.h>
 #include <crypto/sha256.h>
 #include <logging.h>
 #include <random.h>
@@ -18,6 +20,9 @@ Context::Context()
     std::call_once(globals_initialized, []() {
         std::string sha256_algo = SHA256AutoDetect();
         LogInfo("Using the '%s' SHA256 implementation\n", sha256_algo);
+        std::string chacha20_algo = ChaCha20AutoDetect();
+        std::string poly1305_algo = Poly1305AutoDetect();
+        LogInfo("Using the '%s' ChaCha20 and '%s' Poly1305 implementations\n", chacha20_algo, poly1305_algo);
         RandomInit();
     });
 }
@@ -0,0 +1,132 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <kernel/mempool_snapshot.h>
+
+#include <util/feefrac.h>
+#include <util/rbf.h>
+
+#include <algorithm>
+#include <set>
+
+namespace kernel {
+
+MempoolSnapshot::MempoolSnapshot() = default;
+
+MempoolSnapshot MempoolSnapshot::Update(const std::vector<MempoolSnapshotEntryRef>& updated,
+                                        const std::vector<Txid>& removed,
+                                        const MempoolSnapshotStats& stats) const
+{
+    MempoolSnapshot next{*this};
+    next.m_stats = stats;
+
+    // Copy each touched shard exactly once; untouched shards stay shared.
+    std::array<std::shared_ptr<Shard>, NUM_SHARDS> copies;
+    const auto get_copy{[&](const Txid& txid) -> Shard& {
+        const size_t index{GetShardIndex(txid)};
+        if (!copies[index]) {
+            copies[index] = m_shards[index] ? std::make_shared<Shard>(*m_shards[index]) : std::make_shared<Shard>();
+        }
+        return *copies[index];
+    }};
+
+    for (const Txid& txid : removed) {
+        next.m_size -= get_copy(txid).erase(txid);
+    }
+    for (const auto& entry : updated) {
+        auto [it, inserted]{get_copy(entry->GetHash()).insert_or_assign(entry->GetHash(), entry)};
+        if (inserted) ++next.m_size;
+    }
+
+    for (size_t i{0}; i < NUM_SHARDS; ++i) {
+        if (!copies[i]) continue;
+        if (copies[i]->empty()) {
+            next.m_shards[i].reset();
+        } else {
+            next.m_shards[i] = std::move(copies[i]);
+        }
+    }
+    return next;
+}
+
+MempoolSnapshot MempoolSnapshot::Clear() const
+{
+    MempoolSnapshot next{*this};
+    for (auto& shard : next.m_shards) shard.reset();
+    next.m_size = 0;
+    next.m_stats = {};
+    return next;
+}
+
+MempoolSnapshotEntryRef MempoolSnapshot::Find(const Txid& txid) const
+{
+    const auto& shard{m_shards[GetShardIndex(txid)]};
+    if (!shard) return nullptr;
+    const auto it{shard->find(txid)};
+    return it == shard->end() ? nullptr : it->second;
+}
+
+std::vector<MempoolSnapshotEntryRef> MempoolSnapshot::GetSortedDepthAndScore() const
+{
+    std::vector<MempoolSnapshotEntryRef> ret;
+    ret.reserve(m_size);
+    for (const auto& shard : m_shards) {
+        if (!shard) continue;
+        for (const auto& [_, entry] : *shard) ret.push_back(entry);
+    }
+    // Same order as CTxMemPool::GetSortedDepthAndScore(): parents before
+    // children, then by (unmodified) feerate, then by txid.
+    std::sort(ret.begin(), ret.end(), [](const MempoolSnapshotEntryRef& a, const MempoolSnapshotEntryRef& b) {
+        if (a->count_with_ancestors != b->count_with_ancestors) {
+            return a->count_with_ancestors < b->count_with_ancestors;
+        }
+        const FeeFrac f1{a->fee, a->vsize};
+        const FeeFrac f2{b->fee, b->vsize};
+        if (FeeRateCompare(f1, f2) == 0) {
+            return b->GetHash() < a->GetHash();
+        }
+        return f1 > f2;
+    });
+    return ret;
+}
+
+std::vector<MempoolSnapshotEntryRef> MempoolSnapshot::Walk(const MempoolSnapshotEntry& entry, bool ancestors) const
+{
+    std::vector<MempoolSnapshotEntryRef> ret;
+    std::set<Txid> visited{entry.GetHash()};
+    std::vector<Txid> stage{ancestors ? entry.parents : entry.children};
+    while (!stage.empty()) {
+        const Txid txid{stage.back()};
+        stage.pop_back();
+        if (!visited.insert(txid).second) continue;
+        auto relative{Find(txid)};
+        if (!relative) continue;
+        const auto& next{ancestors ? relative->parents : relative->children};
+        stage.insert(stage.end(), next.begin(), next.end());
+        ret.push_back(std::move(relative));
+    }
+    // Sorted by txid, like the setEntries that CTxMemPool returns them in.
+    std::sort(ret.begin(), ret.end(), [](const MempoolSnapshotEntryRef& a, const MempoolSnapshotEntryRef& b) {
+        return a->GetHash() < b->GetHash();
+    });
+    return ret;
+}
+
+std::vector<MempoolSnapshotEntryRef> MempoolSnapshot::CalculateAncestors(const MempoolSnapshotEntry& entry) const
+{
+    return Walk(entry, /*ancestors=*/true);
+}
+
+std::vector<MempoolSnapshotEntryRef> MempoolSnapshot::CalculateDescendants(const MempoolSnapshotEntry& entry) const
+{
+    return Walk(entry, /*ancestors=*/false);
+}
+
+bool MempoolSnapshot::IsRBFOptIn(const MempoolSnapshotEntry& entry) const
+{
+    if (SignalsOptInRBF(*entry.tx)) return true;
+    return std::ranges::any_of(CalculateAncestors(entry), [](const auto& ancestor) { return SignalsOptInRBF(*ancestor->tx); });
+}
+
+} // namespace kernel
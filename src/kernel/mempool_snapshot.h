@@ -0,0 +1,118 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#ifndef BITCOIN_KERNEL_MEMPOOL_SNAPSHOT_H
+#define BITCOIN_KERNEL_MEMPOOL_SNAPSHOT_H
+
+#include <consensus/amount.h>
+#include <primitives/transaction.h>
+#include <primitives/transaction_identifier.h>
+#include <util/hasher.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace kernel {
+
+/** Immutable copy of a mempool entry's state at the time a snapshot was refreshed. */
+struct MempoolSnapshotEntry {
+    CTransactionRef tx;
+    CAmount fee{0};
+    CAmount modified_fee{0};
+    int32_t vsize{0};
+    int32_t weight{0};
+    std::chrono::seconds time{0};
+    unsigned int height{0};
+    uint64_t count_with_ancestors{1};
+    int64_t size_with_ancestors{0};
+    CAmount mod_fees_with_ancestors{0};
+    uint64_t count_with_descendants{1};
+    int64_t size_with_descendants{0};
+    CAmount mod_fees_with_descendants{0};
+    //! In-mempool parents and children, sorted by txid.
+    std::vector<Txid> parents;
+    std::vector<Txid> children;
+    bool unbroadcast{false};
+
+    const Txid& GetHash() const { return tx->GetHash(); }
+};
+
+using MempoolSnapshotEntryRef = std::shared_ptr<const MempoolSnapshotEntry>;
+
+/** Pool-wide aggregates captured together with the entries of a snapshot. */
+struct MempoolSnapshotStats {
+    uint64_t total_tx_size{0};
+    CAmount total_fee{0};
+    size_t dynamic_usage{0};
+    uint64_t sequence{0};
+    size_t unbroadcast_count{0};
+    bool load_tried{false};
+};
+
+/**
+ * Read-only, internally consistent view of the mempool that can be queried
+ * without holding CTxMemPool::cs.
+ *
+ * Entries are partitioned into a fixed number of shards by a salted txid hash
+ * and each shard is held through a shared pointer. Deriving a new snapshot
+ * with Update() copies only the shards that contain changed entries and
+ * shares all others with its predecessor, so refreshing after a handful of
+ * mempool changes is cheap even for very large mempools, while readers that
+ * still hold an older snapshot keep a stable view (RCU-style).
+ */
+class MempoolSnapshot
+{
+public:
+    static constexpr size_t NUM_SHARDS{256};
+
+    MempoolSnapshot();
+
+    /** Return a new snapshot with @p updated entries inserted or replaced and
+     *  @p removed txids erased, sharing all untouched shards with this one. */
+    MempoolSnapshot Update(const std::vector<MempoolSnapshotEntryRef>& updated,
+                           const std::vector<Txid>& removed,
+                           const MempoolSnapshotStats& stats) const;
+
+    /** Return a new, empty snapshot that shares this one's salt. */
+    MempoolSnapshot Clear() const;
+
+    MempoolSnapshotEntryRef Find(const Txid& txid) const;
+    size_t size() const { return m_size; }
+    const MempoolSnapshotStats& GetStats() const { return m_stats; }
+
+    /** All entries sorted by ancestor count, then by feerate (like CTxMemPool::entryAll()). */
+    std::vector<MempoolSnapshotEntryRef> GetSortedDepthAndScore() const;
+
+    /** All in-snapshot ancestors of @p entry, excluding the entry itself, sorted by txid. */
+    std::vector<MempoolSnapshotEntryRef> CalculateAncestors(const MempoolSnapshotEntry& entry) const;
+
+    /** All in-snapshot descendants of @p entry, excluding the entry itself, sorted by txid. */
+    std::vector<MempoolSnapshotEntryRef> CalculateDescendants(const MempoolSnapshotEntry& entry) const;
+
+    /** Whether @p entry or any of its in-snapshot ancestors signal BIP125 replaceability. */
+    bool IsRBFOptIn(const MempoolSnapshotEntry& entry) const;
+
+private:
+    using Shard = std::unordered_map<Txid, MempoolSnapshotEntryRef, SaltedTxidHasher>;
+
+    size_t GetShardIndex(const Txid& txid) const { return m_hasher(txid) % NUM_SHARDS; }
+
+    std::vector<MempoolSnapshotEntryRef> Walk(const MempoolSnapshotEntry& entry, bool ancestors) const;
+
+    //! Shared by all snapshots derived from the same original, so shard
+    //! assignment is stable across updates.
+    SaltedTxidHasher m_hasher;
+    std::array<std::shared_ptr<const Shard>, NUM_SHARDS> m_shards;
+    size_t m_size{0};
+    MempoolSnapshotStats m_stats;
+};
+
+} // namespace kernel
+
+#endif // BITCOIN_KERNEL_MEMPOOL_SNAPSHOT_H
@@ -42,7 +42,9 @@
 #include <cstring>
 #include <cmath>
 #include <cstdint>
+#include <exception>
 #include <functional>
+#include <future>
 #include <optional>
 #include <unordered_map>
 
@@ -837,9 +839,14 @@ CNetMessage V1Transport::GetReceivedMessage(const std::chrono::microseconds time
 bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
-    // Determine whether a new message can be set.
+    // Determine whether a new message can be set, either directly or queued behind the current one.
     LOCK(m_send_mutex);
-    if (m_sending_header || m_bytes_sent < m_message_to_send.data.size()) return false;
+    const bool busy{m_sending_header || m_bytes_sent < m_message_to_send.data.size()};
+    if (busy) {
+        size_t pending{m_send_queue_bytes + m_message_to_send.data.size() - m_bytes_sent};
+        if (m_sending_header) pending += m_header_to_send.size();
+        if (pending >= TRANSPORT_SEND_BATCH_BYTES) return false;
+    }
 
     // create dbl-sha256 checksum
     uint256 hash = Hash(msg.data);
@@ -848,6 +855,14 @@ bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     CMessageHeader hdr(m_magic_bytes, msg.m_type.c_str(), msg.data.size());
     memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
 
+    if (busy) {
+        auto& [header, queued_msg] = m_send_queue.emplace_back();
+        VectorWriter{header, 0, hdr};
+        queued_msg = std::move(msg);
+        m_send_queue_bytes += header.size() + queued_msg.data.size();
+        return true;
+    }
+
     // serialize header
     m_header_to_send.clear();
     VectorWriter{m_header_to_send, 0, hdr};
@@ -867,19 +882,53 @@ Transport::BytesToSend V1Transport::GetBytesToSend(bool have_next_message) const
         return {std::span{m_header_to_send}.subspan(m_bytes_sent),
                 // We have more to send after the header if the message has payload, or if there
                 // is a next message after that.
-                have_next_message || !m_message_to_send.data.empty(),
+                have_next_message || !m_message_to_send.data.empty() || !m_send_queue.empty(),
                 m_message_to_send.m_type
                };
     } else {
         return {std::span{m_message_to_send.data}.subspan(m_bytes_sent),
                 // We only have more to send after this message's payload if there is another
                 // message.
-                have_next_message,
+                have_next_message || !m_send_queue.empty(),
                 m_message_to_send.m_type
                };
     }
 }
 
+void V1Transport::GetBytesToSendBatch(bool have_next_message, std::vector<BytesToSend>& chunks, size_t max_chunks) const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    Assume(max_chunks > 0);
+    // Collect the remaining non-empty spans in sending order, the first one even if empty.
+    std::vector<std::pair<std::span<const uint8_t>, const std::string*>> spans;
+    bool dropped{false};
+    auto add = [&](std::span<const uint8_t> bytes, const std::string& type) {
+        if (!spans.empty() && bytes.empty()) return;
+        if (spans.size() == max_chunks) {
+            dropped = true;
+        } else {
+            spans.emplace_back(bytes, &type);
+        }
+    };
+    if (m_sending_header) {
+        add(std::span{m_header_to_send}.subspan(m_bytes_sent), m_message_to_send.m_type);
+        add(m_message_to_send.data, m_message_to_send.m_type);
+    } else {
+        add(std::span{m_message_to_send.data}.subspan(m_bytes_sent), m_message_to_send.m_type);
+    }
+    for (const auto& [header, msg] : m_send_queue) {
+        add(header, msg.m_type);
+        add(msg.data, msg.m_type);
+    }
+    // Every chunk but the last is followed by more bytes. After the last one, there are more
+    // if chunks were left out, or if the caller has a next message.
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const bool more{i + 1 < spans.size() || dropped || have_next_message};
+        chunks.emplace_back(spans[i].first, more, *spans[i].second);
+    }
+}
+
 void V1Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -894,14 +943,25 @@ void V1Transport::MarkBytesSent(size_t bytes_sent) noexcept
         ClearShrink(m_message_to_send.data);
         m_bytes_sent = 0;
     }
+    if (!m_sending_header && m_bytes_sent == m_message_to_send.data.size() && !m_send_queue.empty()) {
+        // The current message is done; continue with the header of the next queued one.
+        auto& [header, msg] = m_send_queue.front();
+        m_send_queue_bytes -= header.size() + msg.data.size();
+        m_header_to_send = std::move(header);
+        m_message_to_send = std::move(msg);
+        m_send_queue.pop_front();
+        m_sending_header = true;
+    }
 }
 
 size_t V1Transport::GetSendMemoryUsage() const noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
-    // Don't count sending-side fields besides m_message_to_send, as they're all small and bounded.
-    return m_message_to_send.GetMemoryUsage();
+    // Don't count headers, as they're small and bounded.
+    size_t usage{m_message_to_send.GetMemoryUsage()};
+    for (const auto& [_, msg] : m_send_queue) usage += msg.GetMemoryUsage();
+    return usage;
 }
 
 namespace {
@@ -1480,27 +1540,36 @@ bool V2Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     LOCK(m_send_mutex);
     if (m_send_state == SendState::V1) return m_v1_fallback.SetMessageToSend(msg);
     // We only allow adding a new message to be sent when in the READY state (so the packet cipher
-    // is available) and the send buffer is empty. This limits the number of messages in the send
-    // buffer to just one, and leaves the responsibility for queueing them up to the caller.
-    if (!(m_send_state == SendState::READY && m_send_buffer.empty())) return false;
-    // Construct contents (encoding message type + payload).
-    std::vector<uint8_t> contents;
+    // is available), and while few enough bytes are still waiting to be sent. Packets that
+    // cannot go into the send buffer right away are queued behind it, already encrypted; this
+    // bounds what is buffered here, and leaves the responsibility for queueing more up to the
+    // caller.
+    if (m_send_state != SendState::READY) return false;
+    if (m_send_queue_bytes + m_send_buffer.size() - m_send_pos >= TRANSPORT_SEND_BATCH_BYTES) return false;
+    // Construct contents (encoding message type + payload) directly in the packet, after room
+    // for the encrypted length and header, and encrypt it there.
+    std::vector<uint8_t> packet;
+    const size_t contents_pos{BIP324Cipher::LENGTH_LEN + BIP324Cipher::HEADER_LEN};
     auto short_message_id = V2_MESSAGE_MAP(msg.m_type);
     if (short_message_id) {
-        contents.resize(1 + msg.data.size());
-        contents[0] = *short_message_id;
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1);
+        packet.resize(1 + msg.data.size() + BIP324Cipher::EXPANSION);
+        packet[contents_pos] = *short_message_id;
+        std::copy(msg.data.begin(), msg.data.end(), packet.begin() + contents_pos + 1);
     } else {
         // Initialize with zeroes, and then write the message type string starting at offset 1.
         // This means contents[0] and the unused positions in contents[1..13] remain 0x00.
-        contents.resize(1 + CMessageHeader::MESSAGE_TYPE_SIZE + msg.data.size(), 0);
-        std::copy(msg.m_type.begin(), msg.m_type.end(), contents.data() + 1);
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1 + CMessageHeader::MESSAGE_TYPE_SIZE);
-    }
-    // Construct ciphertext in send buffer.
-    m_send_buffer.resize(contents.size() + BIP324Cipher::EXPANSION);
-    m_cipher.Encrypt(MakeByteSpan(contents), {}, false, MakeWritableByteSpan(m_send_buffer));
-    m_send_type = msg.m_type;
+        packet.resize(1 + CMessageHeader::MESSAGE_TYPE_SIZE + msg.data.size() + BIP324Cipher::EXPANSION, 0);
+        std::copy(msg.m_type.begin(), msg.m_type.end(), packet.begin() + contents_pos + 1);
+        std::copy(msg.data.begin(), msg.data.end(), packet.begin() + contents_pos + 1 + CMessageHeader::MESSAGE_TYPE_SIZE);
+    }
+    m_cipher.EncryptInPlace(MakeWritableByteSpan(packet), {}, false);
+    if (m_send_buffer.empty()) {
+        m_send_buffer = std::move(packet);
+        m_send_type = msg.m_type;
+    } else {
+        m_send_queue_bytes += packet.size();
+        m_send_queue.emplace_back(std::move(packet), msg.m_type);
+    }
     // Release memory
     ClearShrink(msg.data);
     return true;
@@ -1516,13 +1585,30 @@ Transport::BytesToSend V2Transport::GetBytesToSend(bool have_next_message) const
     Assume(m_send_pos <= m_send_buffer.size());
     return {
         std::span{m_send_buffer}.subspan(m_send_pos),
-        // We only have more to send after the current m_send_buffer if there is a (next)
-        // message to be sent, and we're capable of sending packets. */
-        have_next_message && m_send_state == SendState::READY,
+        // We only have more to send after the current m_send_buffer if there are queued packets,
+        // or if there is a (next) message to be sent and we're capable of sending packets. */
+        !m_send_queue.empty() || (have_next_message && m_send_state == SendState::READY),
         m_send_type
     };
 }
 
+void V2Transport::GetBytesToSendBatch(bool have_next_message, std::vector<BytesToSend>& chunks, size_t max_chunks) const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    if (m_send_state == SendState::V1) return m_v1_fallback.GetBytesToSendBatch(have_next_message, chunks, max_chunks);
+
+    Assume(max_chunks > 0);
+    Assume(m_send_pos <= m_send_buffer.size());
+    const size_t queued{std::min(m_send_queue.size(), max_chunks - 1)};
+    const bool can_send_more{queued < m_send_queue.size() || (have_next_message && m_send_state == SendState::READY)};
+    chunks.emplace_back(std::span{m_send_buffer}.subspan(m_send_pos), queued > 0 || can_send_more, m_send_type);
+    for (size_t i = 0; i < queued; ++i) {
+        const auto& [packet, type] = m_send_queue[i];
+        chunks.emplace_back(std::span{packet}, i + 1 < queued || can_send_more, type);
+    }
+}
+
 void V2Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -1538,10 +1624,16 @@ void V2Transport::MarkBytesSent(size_t bytes_sent) noexcept
     if (m_send_pos >= CMessageHeader::HEADER_SIZE) {
         m_sent_v1_header_worth = true;
     }
-    // Wipe the buffer when everything is sent.
+    // Wipe the buffer when everything is sent, and continue with the next queued packet.
     if (m_send_pos == m_send_buffer.size()) {
         m_send_pos = 0;
         ClearShrink(m_send_buffer);
+        if (!m_send_queue.empty()) {
+            m_send_buffer = std::move(m_send_queue.front().first);
+            m_send_type = std::move(m_send_queue.front().second);
+            m_send_queue_bytes -= m_send_buffer.size();
+            m_send_queue.pop_front();
+        }
     }
 }
 
@@ -1568,7 +1660,9 @@ size_t V2Transport::GetSendMemoryUsage() const noexcept
     LOCK(m_send_mutex);
     if (m_send_state == SendState::V1) return m_v1_fallback.GetSendMemoryUsage();
 
-    return sizeof(m_send_buffer) + memusage::DynamicUsage(m_send_buffer);
+    size_t usage{sizeof(m_send_buffer) + memusage::DynamicUsage(m_send_buffer)};
+    for (const auto& [packet, _] : m_send_queue) usage += sizeof(packet) + memusage::DynamicUsage(packet);
+    return usage;
 }
 
 Transport::Info V2Transport::GetInfo() const noexcept
@@ -1592,33 +1686,58 @@ Transport::Info V2Transport::GetInfo() const noexcept
     return info;
 }
 
+/** CPU time consumed by the calling thread so far, or zero where that is not available. */
+static std::chrono::microseconds ThreadCPUTime()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return std::chrono::seconds{ts.tv_sec} + std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds{ts.tv_nsec});
+    }
+#endif
+    return 0us;
+}
+
 std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
 {
+    const auto cpu_start{ThreadCPUTime()};
     auto it = node.vSendMsg.begin();
     size_t nSentSize = 0;
     bool data_left{false}; //!< second return value (whether unsent data remains)
     std::optional<bool> expected_more;
+    std::vector<Transport::BytesToSend> chunks;
+    std::vector<std::span<const uint8_t>> buffers;
 
     while (true) {
-        if (it != node.vSendMsg.end()) {
-            // If possible, move one message from the send queue to the transport. This fails when
-            // there is an existing message still being sent, or (for v2 transports) when the
-            // handshake has not yet completed.
+        // Move as many messages from the send queue to the transport as it accepts. This stops
+        // when enough earlier messages are still waiting to be sent, or (for v2 transports) when
+        // the handshake has not yet completed.
+        while (it != node.vSendMsg.end()) {
             size_t memusage = it->GetMemoryUsage();
-            if (node.m_transport->SetMessageToSend(*it)) {
-                // Update memory usage of send buffer (as *it will be deleted).
-                node.m_send_memusage -= memusage;
-                ++it;
-            }
+            if (!node.m_transport->SetMessageToSend(*it)) break;
+            // Update memory usage of send buffer (as *it will be deleted).
+            node.m_send_memusage -= memusage;
+            ++m_send_messages;
+            ++it;
         }
-        const auto& [data, more, msg_type] = node.m_transport->GetBytesToSend(it != node.vSendMsg.end());
-        // We rely on the 'more' value returned by GetBytesToSend to correctly predict whether more
+        // Get everything the transport has ready, so it can be sent in one system call.
+        chunks.clear();
+        node.m_transport->GetBytesToSendBatch(it != node.vSendMsg.end(), chunks, SEND_MANY_MAX_BUFFERS);
+        const auto data{std::get<0>(chunks.front())};
+        const bool more{std::get<1>(chunks.back())};
+        // We rely on the 'more' value returned by the transport to correctly predict whether more
         // bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity check,
         // verify that the previously returned 'more' was correct.
         if (expected_more.has_value()) Assume(!data.empty() == *expected_more);
         expected_more = more;
         data_left = !data.empty(); // will be overwritten on next loop if all of data gets sent
-        int nBytes = 0;
+        size_t total{0};
+        buffers.clear();
+        for (const auto& [bytes, _more, _type] : chunks) {
+            buffers.push_back(bytes);
+            total += bytes.size();
+        }
+        ssize_t nBytes = 0;
         if (!data.empty()) {
             LOCK(node.m_sock_mutex);
             // There is no socket in case we've already disconnected, or in test cases without
@@ -1633,20 +1752,32 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
                 flags |= MSG_MORE;
             }
 #endif
-            nBytes = node.m_sock->Send(data.data(), data.size(), flags);
+            nBytes = buffers.size() == 1 ? node.m_sock->Send(data.data(), data.size(), flags) : node.m_sock->SendMany(buffers, flags);
+            ++m_send_syscalls;
         }
         if (nBytes > 0) {
             node.m_last_send = GetTime<std::chrono::seconds>();
             node.nSendBytes += nBytes;
-            // Notify transport that bytes have been processed.
-            node.m_transport->MarkBytesSent(nBytes);
-            // Update statistics per message type.
-            if (!msg_type.empty()) { // don't report v2 handshake bytes for now
-                node.AccountForSentBytes(msg_type, nBytes);
+            m_send_bytes += nBytes;
+            // Update statistics per message type, while the chunks still refer to valid data, and
+            // then notify the transport of the processed bytes of each chunk in order.
+            size_t left = nBytes;
+            for (const auto& [bytes, _more, msg_type] : chunks) {
+                const size_t sent{std::min(left, bytes.size())};
+                if (!msg_type.empty() && sent > 0) { // don't report v2 handshake bytes for now
+                    node.AccountForSentBytes(msg_type, sent);
+                }
+                left -= sent;
+            }
+            left = nBytes;
+            for (size_t i = 0; i < chunks.size() && left > 0; ++i) {
+                const size_t sent{std::min(left, buffers[i].size())};
+                node.m_transport->MarkBytesSent(sent);
+                left -= sent;
             }
             nSentSize += nBytes;
-            if ((size_t)nBytes != data.size()) {
-                // could not send full message; stop sending more
+            if ((size_t)nBytes != total) {
+                // could not send everything; stop sending more
                 break;
             }
         } else {
@@ -1668,6 +1799,7 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
         assert(node.m_send_memusage == 0);
     }
     node.vSendMsg.erase(node.vSendMsg.begin(), it);
+    m_send_cpu_time_us += count_microseconds(ThreadCPUTime() - cpu_start);
     return {nSentSize, data_left};
 }
 
@@ -2056,12 +2188,15 @@ bool CConnman::InactivityCheck(const CNode& node) const
     return false;
 }
 
-Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
+void CConnman::AddWaitSockets(std::span<CNode* const> nodes)
 {
-    Sock::EventsPerSock events_per_sock;
+    const auto add_sock{[this](const std::shared_ptr<const Sock>& sock, Sock::Event event) {
+        if (!m_sock_wait_set) m_sock_wait_set = sock->CreateWaitSet();
+        m_sock_wait_set->Add(sock, event);
+    }};
 
     for (const ListenSocket& hListenSocket : vhListenSocket) {
-        events_per_sock.emplace(hListenSocket.sock, Sock::Events{Sock::RECV});
+        add_sock(hListenSocket.sock, Sock::RECV);
     }
 
     for (CNode* pnode : nodes) {
@@ -2080,11 +2215,9 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
         LOCK(pnode->m_sock_mutex);
         if (pnode->m_sock) {
             Sock::Event event = (select_send ? Sock::SEND : 0) | (select_recv ? Sock::RECV : 0);
-            events_per_sock.emplace(pnode->m_sock, Sock::Events{event});
+            add_sock(pnode->m_sock, event);
         }
     }
-
-    return events_per_sock;
 }
 
 void CConnman::SocketHandler()
@@ -2099,11 +2232,12 @@ void CConnman::SocketHandler()
         const auto timeout = std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS);
 
         // Check for the readiness of the already connected sockets and the
-        // listening sockets in one call ("readiness" as in poll(2) or
-        // select(2)). If none are ready, wait for a short while and return
-        // empty sets.
-        events_per_sock = GenerateWaitSockets(snap.Nodes());
-        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
+        // listening sockets in one call ("readiness" as in epoll(7), poll(2)
+        // or select(2)). If none are ready, wait for a short while and return
+        // empty sets. Sockets that are no longer added are dropped from the
+        // wait set, so it must be waited on even if there are none.
+        AddWaitSockets(snap.Nodes());
+        if (!m_sock_wait_set || !m_sock_wait_set->Wait(timeout, events_per_sock)) {
             m_interrupt_net->sleep_for(timeout);
         }
 
@@ -2120,99 +2254,129 @@ void CConnman::SocketHandlerConnected(const std::vector<CNode*>& nodes,
 {
     AssertLockNotHeld(m_total_bytes_sent_mutex);
 
-    for (CNode* pnode : nodes) {
-        if (m_interrupt_net->interrupted()) {
+    // Spread the nodes over the I/O threads, with the calling thread taking
+    // its share, unless there are too few of them to be worth it.
+    const size_t num_tasks{std::min(m_io_pool.WorkersCount() + 1, std::max<size_t>(nodes.size() / MIN_NODES_PER_IO_TASK, 1))};
+    const auto handle_share{[&](size_t task) {
+        // Interleave the shares, as busy nodes tend to be next to each other.
+        for (size_t i{task}; i < nodes.size(); i += num_tasks) {
+            if (m_interrupt_net->interrupted()) return;
+            SocketHandlerConnected(*nodes[i], events_per_sock);
+        }
+    }};
+    std::vector<std::future<void>> shares;
+    shares.reserve(num_tasks - 1);
+    std::exception_ptr error;
+    try {
+        for (size_t task{1}; task < num_tasks; ++task) {
+            shares.push_back(m_io_pool.Submit([&handle_share, task] { handle_share(task); }));
+        }
+        handle_share(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // The shares refer to this frame, so all of them must be done before it
+    // is left, even if one of them failed.
+    for (auto& share : shares) {
+        share.wait();
+    }
+    if (error) std::rethrow_exception(error);
+    for (auto& share : shares) {
+        share.get();
+    }
+}
+
+void CConnman::SocketHandlerConnected(CNode& node, const Sock::EventsPerSock& events_per_sock)
+{
+    AssertLockNotHeld(m_total_bytes_sent_mutex);
+
+    //
+    // Receive
+    //
+    bool recvSet = false;
+    bool sendSet = false;
+    bool errorSet = false;
+    {
+        LOCK(node.m_sock_mutex);
+        if (!node.m_sock) {
             return;
         }
+        const auto it = events_per_sock.find(node.m_sock);
+        if (it != events_per_sock.end()) {
+            recvSet = it->second.occurred & Sock::RECV;
+            sendSet = it->second.occurred & Sock::SEND;
+            errorSet = it->second.occurred & Sock::ERR;
+        }
+    }
 
-        //
-        // Receive
-        //
-        bool recvSet = false;
-        bool sendSet = false;
-        bool errorSet = false;
-        {
-            LOCK(pnode->m_sock_mutex);
-            if (!pnode->m_sock) {
-                continue;
-            }
-            const auto it = events_per_sock.find(pnode->m_sock);
-            if (it != events_per_sock.end()) {
-                recvSet = it->second.occurred & Sock::RECV;
-                sendSet = it->second.occurred & Sock::SEND;
-                errorSet = it->second.occurred & Sock::ERR;
-            }
+    if (sendSet) {
+        // Send data
+        auto [bytes_sent, data_left] = WITH_LOCK(node.cs_vSend, return SocketSendData(node));
+        if (bytes_sent) {
+            RecordBytesSent(bytes_sent);
+
+            // If both receiving and (non-optimistic) sending were possible, we first attempt
+            // sending. If that succeeds, but does not fully drain the send queue, do not
+            // attempt to receive. This avoids needlessly queueing data if the remote peer
+            // is slow at receiving data, by means of TCP flow control. We only do this when
+            // sending actually succeeded to make sure progress is always made; otherwise a
+            // deadlock would be possible when both sides have data to send, but neither is
+            // receiving.
+            if (data_left) recvSet = false;
         }
+    }
 
-        if (sendSet) {
-            // Send data
-            auto [bytes_sent, data_left] = WITH_LOCK(pnode->cs_vSend, return SocketSendData(*pnode));
-            if (bytes_sent) {
-                RecordBytesSent(bytes_sent);
-
-                // If both receiving and (non-optimistic) sending were possible, we first attempt
-                // sending. If that succeeds, but does not fully drain the send queue, do not
-                // attempt to receive. This avoids needlessly queueing data if the remote peer
-                // is slow at receiving data, by means of TCP flow control. We only do this when
-                // sending actually succeeded to make sure progress is always made; otherwise a
-                // deadlock would be possible when both sides have data to send, but neither is
-                // receiving.
-                if (data_left) recvSet = false;
+    if (recvSet || errorSet)
+    {
+        // typical socket buffer is 8K-64K
+        uint8_t pchBuf[0x10000];
+        int nBytes = 0;
+        {
+            LOCK(node.m_sock_mutex);
+            if (!node.m_sock) {
+                return;
             }
+            nBytes = node.m_sock->Recv(pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
         }
-
-        if (recvSet || errorSet)
+        if (nBytes > 0)
         {
-            // typical socket buffer is 8K-64K
-            uint8_t pchBuf[0x10000];
-            int nBytes = 0;
-            {
-                LOCK(pnode->m_sock_mutex);
-                if (!pnode->m_sock) {
-                    continue;
-                }
-                nBytes = pnode->m_sock->Recv(pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+            bool notify = false;
+            if (!node.ReceiveMsgBytes({pchBuf, (size_t)nBytes}, notify)) {
+                LogDebug(BCLog::NET,
+                    "receiving message bytes failed, %s\n",
+                    node.DisconnectMsg(fLogIPs)
+                );
+                node.CloseSocketDisconnect();
             }
-            if (nBytes > 0)
-            {
-                bool notify = false;
-                if (!pnode->ReceiveMsgBytes({pchBuf, (size_t)nBytes}, notify)) {
-                    LogDebug(BCLog::NET,
-                        "receiving message bytes failed, %s\n",
-                        pnode->DisconnectMsg(fLogIPs)
-                    );
-                    pnode->CloseSocketDisconnect();
-                }
-                RecordBytesRecv(nBytes);
-                if (notify) {
-                    pnode->MarkReceivedMsgsForProcessing();
-                    WakeMessageHandler();
-                }
+            RecordBytesRecv(nBytes);
+            if (notify) {
+                node.MarkReceivedMsgsForProcessing();
+                WakeMessageHandler();
             }
-            else if (nBytes == 0)
-            {
-                // socket closed gracefully
-                if (!pnode->fDisconnect) {
-                    LogDebug(BCLog::NET, "socket closed, %s\n", pnode->DisconnectMsg(fLogIPs));
-                }
-                pnode->CloseSocketDisconnect();
+        }
+        else if (nBytes == 0)
+        {
+            // socket closed gracefully
+            if (!node.fDisconnect) {
+                LogDebug(BCLog::NET, "socket closed, %s\n", node.DisconnectMsg(fLogIPs));
             }
-            else if (nBytes < 0)
+            node.CloseSocketDisconnect();
+        }
+        else if (nBytes < 0)
+        {
+            // error
+            int nErr = WSAGetLastError();
+            if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
             {
-                // error
-                int nErr = WSAGetLastError();
-                if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                {
-                    if (!pnode->fDisconnect) {
-                        LogDebug(BCLog::NET, "socket recv error, %s: %s\n", pnode->DisconnectMsg(fLogIPs), NetworkErrorString(nErr));
-                    }
-                    pnode->CloseSocketDisconnect();
+                if (!node.fDisconnect) {
+                    LogDebug(BCLog::NET, "socket recv error, %s: %s\n", node.DisconnectMsg(fLogIPs), NetworkErrorString(nErr));
                 }
+                node.CloseSocketDisconnect();
             }
         }
-
-        if (InactivityCheck(*pnode)) pnode->fDisconnect = true;
     }
+
+    if (InactivityCheck(node)) node.fDisconnect = true;
 }
 
 void CConnman::SocketHandlerListening(const Sock::EventsPerSock& events_per_sock)
@@ -3378,6 +3542,9 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     }
 
     // Send and receive from sockets, accept connections
+    if (connOptions.m_io_threads > 0) {
+        m_io_pool.Start(connOptions.m_io_threads);
+    }
     threadSocketHandler = std::thread(&util::TraceThread, "net", [this] { ThreadSocketHandler(); });
 
     if (!gArgs.GetBoolArg("-dnsseed", DEFAULT_DNSSEED))
@@ -3476,6 +3643,7 @@ void CConnman::StopThreads()
         threadDNSAddressSeed.join();
     if (threadSocketHandler.joinable())
         threadSocketHandler.join();
+    m_io_pool.Stop();
 }
 
 void CConnman::StopNodes()
@@ -3508,6 +3676,7 @@ void CConnman::StopNodes()
     }
     m_nodes_disconnected.clear();
     vhListenSocket.clear();
+    m_sock_wait_set.reset();
     semOutbound.reset();
     semAddnode.reset();
 }
@@ -3797,6 +3966,16 @@ uint64_t CConnman::GetTotalBytesSent() const
     return nTotalBytesSent;
 }
 
+SendPathStats CConnman::GetSendPathStats() const
+{
+    return {
+        .syscalls = m_send_syscalls,
+        .messages = m_send_messages,
+        .bytes = m_send_bytes,
+        .cpu_time = std::chrono::microseconds{m_send_cpu_time_us.load()},
+    };
+}
+
 ServiceFlags CConnman::GetLocalServices() const
 {
     return m_local_services;
@@ -32,6 +32,7 @@
 #include <util/check.h>
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
+#include <util/threadpool.h>
 
 #include <atomic>
 #include <condition_variable>
@@ -94,6 +95,11 @@ static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
 
 static constexpr bool DEFAULT_V2_TRANSPORT{true};
+/** Default number of threads doing socket I/O for connected peers in addition to the socket handler thread. */
+static constexpr int DEFAULT_NET_IO_THREADS{2};
+static constexpr int MAX_NET_IO_THREADS{16};
+/** Fewer connected peers than this are not spread over several threads. */
+static constexpr size_t MIN_NODES_PER_IO_TASK{16};
 
 typedef int64_t NodeId;
 
@@ -252,6 +258,10 @@ public:
     size_t GetMemoryUsage() const noexcept;
 };
 
+/** Transports keep accepting messages to send while less than this many bytes of earlier ones
+ *  remain to be sent, so that several small messages can be written out in one system call. */
+static constexpr size_t TRANSPORT_SEND_BATCH_BYTES{64 * 1024};
+
 /** The Transport converts one connection's sent messages to wire bytes, and received bytes back. */
 class Transport {
 public:
@@ -293,9 +303,10 @@ public:
 
     /** Set the next message to send.
      *
-     * If no message can currently be set (perhaps because the previous one is not yet done being
-     * sent), returns false, and msg will be unmodified. Otherwise msg is enqueued (and
-     * possibly moved-from) and true is returned.
+     * If no message can currently be set (perhaps because the previous ones are not yet done
+     * being sent), returns false, and msg will be unmodified. Otherwise msg is enqueued (and
+     * possibly moved-from) and true is returned. Transports accept further messages while
+     * fewer than TRANSPORT_SEND_BATCH_BYTES of earlier ones remain to be sent.
      */
     virtual bool SetMessageToSend(CSerializedNetMsg& msg) noexcept = 0;
 
@@ -349,6 +360,18 @@ public:
      */
     virtual BytesToSend GetBytesToSend(bool have_next_message) const noexcept = 0;
 
+    /** Get the bytes of several successive GetBytesToSend() results at once.
+     *
+     * Appends to chunks what GetBytesToSend(have_next_message) returns now, followed by what it
+     * would return after each earlier chunk was reported sent in full through MarkBytesSent(),
+     * up to the first chunk with no more bytes after it, or max_chunks chunks. Only the first
+     * chunk can be empty. This allows handing e.g. a message header and its payload, or several
+     * small messages, to the socket in one system call. The caller then reports what was sent
+     * with one MarkBytesSent() call per chunk, in order. Like the result of GetBytesToSend(),
+     * the chunks refer to data internal to the transport, which that may invalidate.
+     */
+    virtual void GetBytesToSendBatch(bool have_next_message, std::vector<BytesToSend>& chunks, size_t max_chunks) const noexcept = 0;
+
     /** Report how many bytes returned by the last GetBytesToSend() have been sent.
      *
      * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result.
@@ -414,6 +437,10 @@ private:
     bool m_sending_header GUARDED_BY(m_send_mutex) {false};
     /** How many bytes have been sent so far (from m_header_to_send, or from m_message_to_send.data). */
     size_t m_bytes_sent GUARDED_BY(m_send_mutex) {0};
+    /** Messages (with their serialized headers) queued behind the one currently being sent. */
+    std::deque<std::pair<std::vector<uint8_t>, CSerializedNetMsg>> m_send_queue GUARDED_BY(m_send_mutex);
+    /** Total size of headers and payloads in m_send_queue. */
+    size_t m_send_queue_bytes GUARDED_BY(m_send_mutex) {0};
 
 public:
     explicit V1Transport(const NodeId node_id) noexcept;
@@ -443,6 +470,7 @@ public:
 
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    void GetBytesToSendBatch(bool have_next_message, std::vector<BytesToSend>& chunks, size_t max_chunks) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     bool ShouldReconnectV1() const noexcept override { return false; }
@@ -608,6 +636,10 @@ private:
     std::vector<uint8_t> m_send_garbage GUARDED_BY(m_send_mutex);
     /** Type of the message being sent. */
     std::string m_send_type GUARDED_BY(m_send_mutex);
+    /** Encrypted packets (with their message types) queued behind the send buffer (READY state only). */
+    std::deque<std::pair<std::vector<uint8_t>, std::string>> m_send_queue GUARDED_BY(m_send_mutex);
+    /** Total size of the packets in m_send_queue. */
+    size_t m_send_queue_bytes GUARDED_BY(m_send_mutex) {0};
     /** Current sender state. */
     SendState m_send_state GUARDED_BY(m_send_mutex);
     /** Whether we've sent at least 24 bytes (which would trigger disconnect for V1 peers). */
@@ -653,6 +685,7 @@ public:
     // Send side functions.
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    void GetBytesToSendBatch(bool have_next_message, std::vector<BytesToSend>& chunks, size_t max_chunks) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
 
@@ -1055,6 +1088,14 @@ protected:
     ~NetEventsInterface() = default;
 };
 
+/** Counters describing the work done to write messages out to sockets. */
+struct SendPathStats {
+    uint64_t syscalls{0}; //!< Send system calls made
+    uint64_t messages{0}; //!< Messages handed to transports
+    uint64_t bytes{0}; //!< Bytes written by those system calls
+    std::chrono::microseconds cpu_time{0}; //!< Thread CPU time spent writing messages out
+};
+
 class CConnman
 {
 public:
@@ -1070,6 +1111,8 @@ public:
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundLimit = 0;
         int64_t m_peer_connect_timeout = DEFAULT_PEER_CONNECT_TIMEOUT;
+        //! Number of threads doing socket I/O in addition to the socket handler thread
+        int m_io_threads = 0;
         std::vector<std::string> vSeedNodes;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeIncoming;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeOutgoing;
@@ -1305,6 +1348,7 @@ public:
 
     uint64_t GetTotalBytesRecv() const;
     uint64_t GetTotalBytesSent() const EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex);
+    SendPathStats GetSendPathStats() const;
 
     /** Get a unique deterministic randomizer. */
     CSipHasher GetDeterministicRandomizer(uint64_t id) const;
@@ -1365,11 +1409,10 @@ private:
     bool InactivityCheck(const CNode& node) const;
 
     /**
-     * Generate a collection of sockets to check for IO readiness.
+     * Add the sockets to check for IO readiness to m_sock_wait_set, creating it if needed.
      * @param[in] nodes Select from these nodes' sockets.
-     * @return sockets to check for readiness
      */
-    Sock::EventsPerSock GenerateWaitSockets(std::span<CNode* const> nodes);
+    void AddWaitSockets(std::span<CNode* const> nodes);
 
     /**
      * Check connected and listening sockets for IO readiness and process them accordingly.
@@ -1377,7 +1420,8 @@ private:
     void SocketHandler() EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc);
 
     /**
-     * Do the read/write for connected sockets that are ready for IO.
+     * Do the read/write for connected sockets that are ready for IO, spread
+     * over the I/O threads if there are enough nodes.
      * @param[in] nodes Nodes to process. The socket of each node is checked against `what`.
      * @param[in] events_per_sock Sockets that are ready for IO.
      */
@@ -1385,6 +1429,10 @@ private:
                                 const Sock::EventsPerSock& events_per_sock)
         EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc);
 
+    /** Do the read/write for the socket of one node, if it is ready for IO. */
+    void SocketHandlerConnected(CNode& node, const Sock::EventsPerSock& events_per_sock)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc);
+
     /**
      * Accept incoming connections, one from each read-ready listening socket.
      * @param[in] events_per_sock Sockets that are ready for IO.
@@ -1488,6 +1536,12 @@ private:
     std::atomic<uint64_t> nTotalBytesRecv{0};
     uint64_t nTotalBytesSent GUARDED_BY(m_total_bytes_sent_mutex) {0};
 
+    // Send path statistics, updated by SocketSendData()
+    mutable std::atomic<uint64_t> m_send_syscalls{0};
+    mutable std::atomic<uint64_t> m_send_messages{0};
+    mutable std::atomic<uint64_t> m_send_bytes{0};
+    mutable std::atomic<int64_t> m_send_cpu_time_us{0};
+
     // outbound limit & stats
     uint64_t nMaxOutboundTotalBytesSentInCycle GUARDED_BY(m_total_bytes_sent_mutex) {0};
     std::chrono::seconds nMaxOutboundCycleStartTime GUARDED_BY(m_total_bytes_sent_mutex) {0};
@@ -1506,6 +1560,11 @@ private:
     unsigned int nReceiveFloodSize{0};
 
     std::vector<ListenSocket> vhListenSocket;
+    /**
+     * Sockets the socket handler waits on. Created from the first socket to wait on, so that
+     * mocked sockets come with a matching implementation. Only used by ThreadSocketHandler.
+     */
+    std::unique_ptr<SockWaitSet> m_sock_wait_set;
     std::atomic<bool> fNetworkActive{true};
     bool fAddressesInitialized{false};
     AddrMan& addrman;
@@ -1635,6 +1694,13 @@ private:
     std::thread threadMessageHandler;
     std::thread threadI2PAcceptIncoming;
 
+    /**
+     * Threads reading from and writing to the sockets of connected nodes,
+     * including the transport's decryption of received data, on behalf of
+     * the socket handler thread. Each node is handled by one thread at a time.
+     */
+    util::ThreadPool m_io_pool{"netio"};
+
     /** flag for deciding to connect to an extra outbound peer,
      *  in excess of m_max_outbound_full_relay
      *  This takes the place of a feeler connection */
@@ -57,6 +57,7 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <validation.h>
@@ -124,8 +125,17 @@ static const unsigned int MAX_LOCATOR_SZ = 101;
 static const unsigned int MAX_INV_SZ = 50000;
 /** Limit to avoid sending big packets. Not used in processing incoming GETDATA for compatibility */
 static const unsigned int MAX_GETDATA_SZ = 1000;
-/** Number of blocks that can be requested at any given time from a single peer. */
+/** Number of blocks that can be requested at any given time from a single peer, until its download speed is measured. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
+/** Bounds of the number of blocks in transit from a single peer, once its download speed is measured. */
+static constexpr int MIN_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER{2};
+static constexpr int MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER{64};
+/** Time in which a peer should be able to deliver all blocks we have in transit from it, at its measured speed. */
+static constexpr auto BLOCK_DOWNLOAD_TARGET_TIME{4s};
+/** Weight of a new measurement in the per-peer block download averages, as 1 / n. */
+static constexpr int BLOCK_DOWNLOAD_AVERAGE_WEIGHT{4};
+/** Maximum number of peers a block holding up the block download window is requested from. */
+static constexpr size_t MAX_LAGGING_BLOCK_REQUESTS{2};
 /** Default time during which a peer must stall block download progress before being disconnected.
  * the actual timeout is increased temporarily if peers are disconnected for hitting the timeout */
 static constexpr auto BLOCK_STALLING_TIMEOUT_DEFAULT{2s};
@@ -204,6 +214,8 @@ struct QueuedBlock {
     const CBlockIndex* pindex;
     /** Optional, used for CMPCTBLOCK downloads */
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
+    /** When the block was requested. */
+    std::chrono::microseconds m_requested_time{0us};
 };
 
 /**
@@ -297,7 +309,7 @@ struct Peer {
         /** A filter of all the (w)txids that the peer has announced to
          *  us or we have announced to the peer. We use this to avoid announcing
          *  the same (w)txid to a peer that already has the transaction. */
-        CRollingBloomFilter m_tx_inventory_known_filter GUARDED_BY(m_tx_inventory_mutex){50000, 0.000001};
+        RollingCuckooFilter<uint32_t> m_tx_inventory_known_filter GUARDED_BY(m_tx_inventory_mutex){50000, 0.000001};
         /** Set of wtxids we still have to announce. For non-wtxid-relay peers,
          *  we retrieve the txid from the corresponding mempool transaction when
          *  constructing the `inv` message. We use the mempool to sort transactions
@@ -343,7 +355,7 @@ struct Peer {
      *
      *  Presence of this filter must correlate with m_addr_relay_enabled.
      **/
-    std::unique_ptr<CRollingBloomFilter> m_addr_known GUARDED_BY(NetEventsInterface::g_msgproc_mutex);
+    std::unique_ptr<RollingCuckooFilter<uint16_t>> m_addr_known GUARDED_BY(NetEventsInterface::g_msgproc_mutex);
     /** Whether we are participating in address relay with this connection.
      *
      *  We set this bool to true for outbound peers (other than
@@ -385,10 +397,15 @@ struct Peer {
     /** Whether we've sent this peer a getheaders in response to an inv prior to initial-headers-sync completing */
     bool m_inv_triggered_getheaders_before_sync GUARDED_BY(NetEventsInterface::g_msgproc_mutex){false};
 
-    /** Protects m_getdata_requests **/
+    /** Protects m_getdata_requests and m_block_served **/
     Mutex m_getdata_requests_mutex;
     /** Work queue of items requested by this peer **/
     std::deque<CInv> m_getdata_requests GUARDED_BY(m_getdata_requests_mutex);
+    /** Whether a block serving thread is sending a block to this peer. Further
+     *  requests and messages from the peer are processed once it is done. **/
+    std::atomic<bool> m_serving_block{false};
+    /** Completion of the last block serving task for this peer **/
+    std::future<void> m_block_served GUARDED_BY(m_getdata_requests_mutex);
 
     /** Time of the last getheaders message to this peer */
     NodeClock::time_point m_last_getheaders_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){};
@@ -449,6 +466,12 @@ struct CNodeState {
     std::list<QueuedBlock> vBlocksInFlight;
     //! When the first entry in vBlocksInFlight started downloading. Don't care when vBlocksInFlight is empty.
     std::chrono::microseconds m_downloading_since{0us};
+    //! Average time this peer took to deliver the first entry in vBlocksInFlight, or zero until measured.
+    std::chrono::microseconds m_block_service_time{0us};
+    //! Average time from requesting a block from this peer to receiving it, or zero until measured.
+    std::chrono::microseconds m_block_latency{0us};
+    //! Average block download rate from this peer in bytes per second, or zero until measured.
+    uint64_t m_block_download_rate{0};
     //! Whether we consider this a preferred download peer.
     bool fPreferredDownload{false};
     /** Whether this peer wants invs or cmpctblocks (when possible) for block announcements. */
@@ -611,8 +634,14 @@ private:
     void ProcessValidTx(NodeId nodeid, const CTransactionRef& tx, const std::list<CTransactionRef>& replaced_transactions)
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, g_msgproc_mutex, m_tx_download_mutex);
 
-    /** Handle the results of package validation: calls ProcessValidTx and ProcessInvalidTx for
-     * individual transactions, and caches rejection for the package as a group.
+    /** The part of ProcessValidTx that does not touch m_txrequest and m_orphanage: updates vExtraTxnForCompact and
+     * queues the tx for relay. */
+    void RelayValidTx(NodeId nodeid, const CTransactionRef& tx, const std::list<CTransactionRef>& replaced_transactions)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, g_msgproc_mutex, m_tx_download_mutex);
+
+    /** Handle the results of package validation: calls RelayValidTx and ProcessInvalidTx for
+     * individual transactions, updates m_txrequest and m_orphanage for all valid transactions at
+     * once, and caches rejection for the package as a group.
      */
     void ProcessPackageResult(const node::PackageToValidate& package_to_validate, const PackageMempoolAcceptResult& package_result)
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, g_msgproc_mutex, m_tx_download_mutex);
@@ -890,6 +919,13 @@ private:
      */
     void RemoveBlockRequest(const uint256& hash, std::optional<NodeId> from_peer) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Update the download speed of a peer delivering a block we requested from it, before the request is removed. */
+    void UpdateBlockDownloadStats(NodeId nodeid, const uint256& hash, size_t block_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    /** If a slower peer holds up the block download window, also request its oldest block from this faster one. */
+    void MaybeRequestLaggingBlock(CNode& node, const Peer& peer, NodeId staller, std::chrono::microseconds current_time,
+                                  std::vector<CInv>& getdata) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /* Mark a block as in flight
      * Returns false, still setting pit, if the block was already in flight from the same peer
      * pit will only be valid as long as the same cs_main lock is being held
@@ -950,6 +986,10 @@ private:
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
         LOCKS_EXCLUDED(::cs_main);
 
+    /** Have a block serving thread send a requested block to the peer. */
+    void ServeBlockAsync(CNode& pfrom, Peer& peer, const CInv& inv, uint64_t cmpctblock_nonce)
+        EXCLUSIVE_LOCKS_REQUIRED(peer.m_getdata_requests_mutex);
+
     /** Process a new block. Perform any post-processing housekeeping */
     void ProcessBlock(CNode& node, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked);
 
@@ -1000,8 +1040,23 @@ private:
      */
     bool BlockRequestAllowed(const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AlreadyHaveBlock(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
-    void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
-        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex);
+    /**
+     * If the requested block may be in the middle of being connected, finish
+     * connecting it, so that the relay conditions of ProcessGetBlockData()
+     * see it. Runs on the message handler thread, not on block serving
+     * threads, as it may call ActivateBestChain().
+     */
+    void ActivateChainForGetBlockData(const CInv& inv)
+        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex) LOCKS_EXCLUDED(::cs_main);
+    /**
+     * Send a requested block to the peer. Only reads the block and the chain,
+     * so it can be run by a block serving thread; call
+     * ActivateChainForGetBlockData() first.
+     *
+     * @param[in] cmpctblock_nonce Nonce for the short ids, if the block is sent as a compact block.
+     */
+    void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv, uint64_t cmpctblock_nonce)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex);
 
     /**
      * Validation logic for compact filters request handling.
@@ -1057,8 +1112,13 @@ private:
      */
     void ProcessGetCFCheckPt(CNode& node, Peer& peer, DataStream& vRecv);
 
+    /** Announce the transactions a reconciliation round found the peer to be missing, and that
+     *  are still in the mempool. They were added to the peer's known filter when they were
+     *  added to the reconciliation set. */
+    void AnnounceReconciledTxs(CNode& node, Peer& peer, const std::vector<Wtxid>& wtxids);
+
     /** Checks if address relay is permitted with peer. If needed, initializes
-     * the m_addr_known bloom filter and sets m_addr_relay_enabled to true.
+     * the m_addr_known filter and sets m_addr_relay_enabled to true.
      *
      *  @return   True if address relay is enabled with peer
      *            False if address relay is disallowed
@@ -1069,6 +1129,17 @@ private:
     void PushAddress(Peer& peer, const CAddress& addr) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
     void LogBlockHeader(const CBlockIndex& index, const CNode& peer, bool via_compact_block);
+
+    /** Threads sending requested blocks to peers, so that reading them from
+     *  disk does not hold up the message handler. Only started if
+     *  Options::block_serve_threads is non-zero. Declared last, so it is
+     *  stopped before anything its tasks use is destroyed. */
+    util::ThreadPool m_block_serve_pool{"blocksrv"};
+
+    /** Threads scanning parts of the mempool for the short IDs of a compact
+     *  block, while the message handler scans the first part. Only started if
+     *  Options::block_reconstruction_threads is non-zero. */
+    util::ThreadPool m_block_reconstruction_pool{"cmpctblk"};
 };
 
 const CNodeState* PeerManagerImpl::State(NodeId pnode) const
@@ -1124,6 +1195,23 @@ static void AddKnownTx(Peer& peer, const uint256& hash)
     tx_relay->m_tx_inventory_known_filter.insert(hash);
 }
 
+void PeerManagerImpl::AnnounceReconciledTxs(CNode& node, Peer& peer, const std::vector<Wtxid>& wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay) return;
+
+    std::vector<CInv> invs;
+    for (const Wtxid& wtxid : wtxids) {
+        if (!m_mempool.exists(wtxid)) continue;
+        invs.emplace_back(MSG_WTX, wtxid.ToUint256());
+        if (invs.size() == MAX_INV_SZ) {
+            MakeAndPushMessage(node, NetMsgType::INV, invs);
+            invs.clear();
+        }
+    }
+    if (!invs.empty()) MakeAndPushMessage(node, NetMsgType::INV, invs);
+}
+
 /** Whether this peer can serve us blocks. */
 static bool CanServeBlocks(const Peer& peer)
 {
@@ -1144,6 +1232,23 @@ static bool CanServeWitnesses(const Peer& peer)
     return peer.m_their_services & NODE_WITNESS;
 }
 
+/** Number of blocks that can be in transit from this peer, so that it can
+ *  deliver them within BLOCK_DOWNLOAD_TARGET_TIME at its measured speed. */
+static int MaxBlocksInTransit(const CNodeState& state)
+{
+    if (state.m_block_service_time == 0us) return MAX_BLOCKS_IN_TRANSIT_PER_PEER;
+    return std::clamp<int64_t>(BLOCK_DOWNLOAD_TARGET_TIME / state.m_block_service_time,
+                               MIN_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER, MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER);
+}
+
+/** Add a measurement to a per-peer block download average, which is zero until the first one. */
+template <typename T>
+static T BlockDownloadAverage(T average, T sample)
+{
+    if (average == T{}) return sample;
+    return (average * (BLOCK_DOWNLOAD_AVERAGE_WEIGHT - 1) + sample) / BLOCK_DOWNLOAD_AVERAGE_WEIGHT;
+}
+
 std::chrono::microseconds PeerManagerImpl::NextInvToInbounds(std::chrono::microseconds now,
                                                              std::chrono::seconds average_interval,
                                                              uint64_t network_key)
@@ -1232,7 +1337,7 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     RemoveBlockRequest(hash, nodeid);
 
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr)});
+            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr), GetTime<std::chrono::microseconds>()});
     if (state->vBlocksInFlight.size() == 1) {
         // We're starting a block download (batch) from this peer.
         state->m_downloading_since = GetTime<std::chrono::microseconds>();
@@ -1245,6 +1350,52 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     return true;
 }
 
+void PeerManagerImpl::UpdateBlockDownloadStats(NodeId nodeid, const uint256& hash, size_t block_size)
+{
+    const auto now{GetTime<std::chrono::microseconds>()};
+    for (auto range = mapBlocksInFlight.equal_range(hash); range.first != range.second; range.first++) {
+        const auto& [node_id, list_it]{range.first->second};
+        if (node_id != nodeid) continue;
+
+        CNodeState& state = *Assert(State(nodeid));
+        state.m_block_latency = BlockDownloadAverage(state.m_block_latency, now - list_it->m_requested_time);
+        // Only the first block on the queue tells how long the peer took to
+        // deliver it, the others were waiting for it to be sent first.
+        if (state.vBlocksInFlight.begin() == list_it && now > state.m_downloading_since) {
+            const auto service_time{now - state.m_downloading_since};
+            state.m_block_service_time = BlockDownloadAverage(state.m_block_service_time, service_time);
+            state.m_block_download_rate = BlockDownloadAverage<uint64_t>(state.m_block_download_rate, block_size * 1'000'000 / count_microseconds(service_time));
+        }
+        return;
+    }
+}
+
+void PeerManagerImpl::MaybeRequestLaggingBlock(CNode& node, const Peer& peer, NodeId staller, std::chrono::microseconds current_time,
+                                               std::vector<CInv>& getdata)
+{
+    const CNodeState& state = *Assert(State(node.GetId()));
+    const CNodeState* staller_state = State(staller);
+    // Without a measurement of this peer's speed, leave it to the stalling
+    // logic.
+    if (staller == node.GetId() || !staller_state || staller_state->vBlocksInFlight.empty() || state.m_block_latency == 0us) return;
+
+    // Only request the block if the staller has been delivering it for longer
+    // than this peer typically takes to deliver a block after requesting it.
+    if (current_time - staller_state->m_downloading_since <= state.m_block_latency) return;
+
+    const CBlockIndex* pindex{staller_state->vBlocksInFlight.front().pindex};
+    const uint256& hash{pindex->GetBlockHash()};
+    if (mapBlocksInFlight.count(hash) >= MAX_LAGGING_BLOCK_REQUESTS) return;
+    if (!state.pindexBestKnownBlock || state.pindexBestKnownBlock->GetAncestor(pindex->nHeight) != pindex) return;
+    if (IsLimitedPeer(peer)) return;
+    if (!CanServeWitnesses(peer) && DeploymentActiveAt(*pindex, m_chainman, Consensus::DEPLOYMENT_SEGWIT)) return;
+
+    getdata.emplace_back(MSG_BLOCK | GetFetchFlags(peer), hash);
+    BlockRequested(node.GetId(), *pindex);
+    LogDebug(BCLog::NET, "Requesting block %s (%d) peer=%d, lagging at peer=%d\n", hash.ToString(),
+        pindex->nHeight, node.GetId(), staller);
+}
+
 void PeerManagerImpl::MaybeSetPeerAsAnnouncingHeaderAndIDs(NodeId nodeid)
 {
     AssertLockHeld(cs_main);
@@ -1594,6 +1745,12 @@ void PeerManagerImpl::ReattemptInitialBroadcast(CScheduler& scheduler)
 void PeerManagerImpl::FinalizeNode(const CNode& node)
 {
     NodeId nodeid = node.GetId();
+    if (PeerRef peer{GetPeerRef(nodeid)}) {
+        // A block serving thread may still be sending to the node, which must
+        // not be deleted before it is done.
+        auto block_served{WITH_LOCK(peer->m_getdata_requests_mutex, return std::move(peer->m_block_served))};
+        if (block_served.valid()) block_served.wait();
+    }
     {
     LOCK(cs_main);
     {
@@ -1710,6 +1867,9 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
             if (queue.pindex)
                 stats.vHeightInFlight.push_back(queue.pindex->nHeight);
         }
+        stats.m_block_download_rate = state->m_block_download_rate;
+        stats.m_block_latency = state->m_block_latency;
+        stats.m_max_blocks_in_transit = MaxBlocksInTransit(*state);
     }
 
     PeerRef peer = GetPeerRef(nodeid);
@@ -1908,6 +2068,12 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
+    if (opts.block_serve_threads > 0) {
+        m_block_serve_pool.Start(opts.block_serve_threads);
+    }
+    if (opts.block_reconstruction_threads > 0) {
+        m_block_reconstruction_pool.Start(opts.block_reconstruction_threads);
+    }
 }
 
 void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
@@ -2196,16 +2362,8 @@ void PeerManagerImpl::RelayAddress(NodeId originator,
     }
 }
 
-void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
+void PeerManagerImpl::ActivateChainForGetBlockData(const CInv& inv)
 {
-    std::shared_ptr<const CBlock> a_recent_block;
-    std::shared_ptr<const CBlockHeaderAndShortTxIDs> a_recent_compact_block;
-    {
-        LOCK(m_most_recent_block_mutex);
-        a_recent_block = m_most_recent_block;
-        a_recent_compact_block = m_most_recent_compact_block;
-    }
-
     bool need_activate_chain = false;
     {
         LOCK(cs_main);
@@ -2224,10 +2382,21 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     } // release cs_main before calling ActivateBestChain
     if (need_activate_chain) {
         BlockValidationState state;
-        if (!m_chainman.ActiveChainstate().ActivateBestChain(state, a_recent_block)) {
+        if (!m_chainman.ActiveChainstate().ActivateBestChain(state, WITH_LOCK(m_most_recent_block_mutex, return m_most_recent_block))) {
             LogDebug(BCLog::NET, "failed to activate chain (%s)\n", state.ToString());
         }
     }
+}
+
+void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv, uint64_t cmpctblock_nonce)
+{
+    std::shared_ptr<const CBlock> a_recent_block;
+    std::shared_ptr<const CBlockHeaderAndShortTxIDs> a_recent_compact_block;
+    {
+        LOCK(m_most_recent_block_mutex);
+        a_recent_block = m_most_recent_block;
+        a_recent_compact_block = m_most_recent_compact_block;
+    }
 
     const CBlockIndex* pindex{nullptr};
     const CBlockIndex* tip{nullptr};
@@ -2340,7 +2509,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
                 if (a_recent_compact_block && a_recent_compact_block->header.GetHash() == inv.hash) {
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, *a_recent_compact_block);
                 } else {
-                    CBlockHeaderAndShortTxIDs cmpctblock{*pblock, m_rng.rand64()};
+                    CBlockHeaderAndShortTxIDs cmpctblock{*pblock, cmpctblock_nonce};
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, cmpctblock);
                 }
             } else {
@@ -2388,12 +2557,35 @@ CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay,
     return {};
 }
 
+void PeerManagerImpl::ServeBlockAsync(CNode& pfrom, Peer& peer, const CInv& inv, uint64_t cmpctblock_nonce)
+{
+    // Keep the node from being deleted while the block is sent. The peer is
+    // kept alive by FinalizeNode() waiting for the task to finish.
+    pfrom.AddRef();
+    peer.m_serving_block = true;
+    peer.m_block_served = m_block_serve_pool.Submit([this, &pfrom, &peer, inv, cmpctblock_nonce] {
+        try {
+            ProcessGetBlockData(pfrom, peer, inv, cmpctblock_nonce);
+        } catch (const std::exception& e) {
+            LogDebug(BCLog::NET, "%s: Exception '%s' caught serving block %s, %s\n", __func__, e.what(), inv.hash.ToString(), pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+        }
+        peer.m_serving_block = false;
+        pfrom.Release();
+        // Continue with the peer's next request.
+        m_connman.WakeMessageHandler();
+    });
+}
+
 void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(cs_main);
 
     auto tx_relay = peer.GetTxRelay();
 
+    // Responses are sent in the order they were requested.
+    if (peer.m_serving_block) return;
+
     std::deque<CInv>::iterator it = peer.m_getdata_requests.begin();
     std::vector<CInv> vNotFound;
 
@@ -2429,7 +2621,13 @@ void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic
     if (it != peer.m_getdata_requests.end() && !pfrom.fPauseSend) {
         const CInv &inv = *it++;
         if (inv.IsGenBlkMsg()) {
-            ProcessGetBlockData(pfrom, peer, inv);
+            ActivateChainForGetBlockData(inv);
+            const uint64_t cmpctblock_nonce{inv.IsMsgCmpctBlk() ? m_rng.rand64() : 0};
+            if (m_opts.block_serve_threads > 0) {
+                ServeBlockAsync(pfrom, peer, inv, cmpctblock_nonce);
+            } else {
+                ProcessGetBlockData(pfrom, peer, inv, cmpctblock_nonce);
+            }
         }
         // else: If the first item on the queue is an unknown type, we erase it
         // and continue processing the queue on the next call.
@@ -2740,7 +2938,7 @@ void PeerManagerImpl::HeadersDirectFetchBlocks(CNode& pfrom, const Peer& peer, c
             std::vector<CInv> vGetData;
             // Download as much as possible, from earliest to latest.
             for (const CBlockIndex* pindex : vToFetch | std::views::reverse) {
-                if (nodestate->vBlocksInFlight.size() >= MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+                if (nodestate->vBlocksInFlight.size() >= size_t(MaxBlocksInTransit(*nodestate))) {
                     // Can't download any more from this peer
                     break;
                 }
@@ -2949,6 +3147,36 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
     // something new (if these headers are valid).
     bool received_new_header{last_received_header == nullptr};
 
+    // Consider fetching more headers if we are not using our headers-sync mechanism.
+    // Ask before validating these headers, so that the peer prepares its
+    // response while we do: they are continuous and connect to
+    // chain_start_header, so the locator does not depend on their validation.
+    if (nCount == m_opts.max_headers_result && !have_headers_sync) {
+        // Headers message had its maximum size; the peer may have more headers.
+        const CBlockIndex* best_header{nullptr};
+        if (m_opts.headers_sync_peers > 1 && last_received_header) {
+            // Another sync peer may already have given us these headers and
+            // more, continue from our best header instead of repeating them.
+            LOCK(cs_main);
+            if (m_chainman.m_best_header->GetAncestor(last_received_header->nHeight) == last_received_header) {
+                best_header = m_chainman.m_best_header;
+            }
+        }
+        const int locator_height{best_header ? best_header->nHeight : chain_start_header->nHeight + int(nCount)};
+        CBlockLocator locator;
+        if (best_header) {
+            locator = GetLocator(best_header);
+        } else {
+            locator.vHave.push_back(headers.back().GetHash());
+            const auto entries{LocatorEntries(chain_start_header)};
+            locator.vHave.insert(locator.vHave.end(), entries.begin(), entries.end());
+        }
+        if (MaybeSendGetHeaders(pfrom, locator, peer)) {
+            LogDebug(BCLog::NET, "more getheaders (%d) to end to peer=%d (startheight:%d)\n",
+                    locator_height, pfrom.GetId(), peer.m_starting_height);
+        }
+    }
+
     // Now process all the headers.
     BlockValidationState state;
     const bool processed{m_chainman.ProcessNewBlockHeaders(headers,
@@ -2966,15 +3194,6 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
         LogBlockHeader(*pindexLast, pfrom, /*via_compact_block=*/false);
     }
 
-    // Consider fetching more headers if we are not using our headers-sync mechanism.
-    if (nCount == m_opts.max_headers_result && !have_headers_sync) {
-        // Headers message had its maximum size; the peer may have more headers.
-        if (MaybeSendGetHeaders(pfrom, GetLocator(pindexLast), peer)) {
-            LogDebug(BCLog::NET, "more getheaders (%d) to end to peer=%d (startheight:%d)\n",
-                    pindexLast->nHeight, pfrom.GetId(), peer.m_starting_height);
-        }
-    }
-
     UpdatePeerStateForReceivedHeaders(pfrom, peer, *pindexLast, received_new_header, nCount == m_opts.max_headers_result);
 
     // Consider immediately downloading blocks.
@@ -3017,6 +3236,14 @@ void PeerManagerImpl::ProcessValidTx(NodeId nodeid, const CTransactionRef& tx, c
     AssertLockHeld(m_tx_download_mutex);
 
     m_txdownloadman.MempoolAcceptedTx(tx);
+    RelayValidTx(nodeid, tx, replaced_transactions);
+}
+
+void PeerManagerImpl::RelayValidTx(NodeId nodeid, const CTransactionRef& tx, const std::list<CTransactionRef>& replaced_transactions)
+{
+    AssertLockNotHeld(m_peer_mutex);
+    AssertLockHeld(g_msgproc_mutex);
+    AssertLockHeld(m_tx_download_mutex);
 
     LogDebug(BCLog::MEMPOOL, "AcceptToMemoryPool: peer=%d: accepted %s (wtxid=%s) (poolsz %u txn, %u kB)\n",
              nodeid,
@@ -3046,8 +3273,10 @@ void PeerManagerImpl::ProcessPackageResult(const node::PackageToValidate& packag
     // We currently only expect to process 1-parent-1-child packages. Remove if this changes.
     if (!Assume(package.size() == 2)) return;
 
-    // Iterate backwards to erase in-package descendants from the orphanage before they become
-    // relevant in AddChildrenToWorkSet.
+    // Iterate backwards to erase invalid in-package descendants from the orphanage before they become
+    // relevant in AddChildrenToWorkSet. Valid transactions are handed to m_txdownloadman together at
+    // the end, so their children are reconsidered in one pass.
+    std::vector<CTransactionRef> valid_txns;
     auto package_iter = package.rbegin();
     auto senders_iter = senders.rbegin();
     while (package_iter != package.rend()) {
@@ -3061,7 +3290,8 @@ void PeerManagerImpl::ProcessPackageResult(const node::PackageToValidate& packag
             switch (tx_result.m_result_type) {
                 case MempoolAcceptResult::ResultType::VALID:
                 {
-                    ProcessValidTx(nodeid, tx, tx_result.m_replaced_transactions);
+                    RelayValidTx(nodeid, tx, tx_result.m_replaced_transactions);
+                    valid_txns.push_back(tx);
                     break;
                 }
                 case MempoolAcceptResult::ResultType::INVALID:
@@ -3085,6 +3315,7 @@ void PeerManagerImpl::ProcessPackageResult(const node::PackageToValidate& packag
         package_iter++;
         senders_iter++;
     }
+    if (!valid_txns.empty()) m_txdownloadman.MempoolAcceptedTxs(valid_txns);
 }
 
 // NOTE: the orphan processing used to be uninterruptible and quadratic, which could allow a peer to stall the node for
@@ -3934,6 +4165,60 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    if (msg_type == NetMsgType::REQRECON) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "reqrecon from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+
+        uint16_t peer_recon_set_size, peer_q;
+        vRecv >> peer_recon_set_size >> peer_q;
+        if (!m_txreconciliation->HandleReconciliationRequest(pfrom.GetId(), peer_recon_set_size, peer_q)) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reqrecon), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+        }
+        // The sketch is sent with the next transaction announcements to the peer, see SendMessages.
+        return;
+    }
+
+    if (msg_type == NetMsgType::SKETCH) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "sketch from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+
+        std::vector<uint8_t> skdata;
+        vRecv >> skdata;
+        const auto diff{m_txreconciliation->HandleSketch(pfrom.GetId(), skdata)};
+        if (!diff) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected or malformed sketch), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, uint8_t{diff->success}, diff->ask_shortids);
+        AnnounceReconciledTxs(pfrom, *peer, diff->announce);
+        return;
+    }
+
+    if (msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "reconcildiff from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+
+        uint8_t success;
+        std::vector<uint32_t> ask_shortids;
+        vRecv >> success >> ask_shortids;
+        const auto announce{m_txreconciliation->HandleReconcilDiff(pfrom.GetId(), success, ask_shortids)};
+        if (!announce) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reconcildiff), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        AnnounceReconciledTxs(pfrom, *peer, *announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::INV) {
         std::vector<CInv> vInv;
         vRecv >> vInv;
@@ -3984,6 +4269,8 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
                 const GenTxid gtxid = ToGenTxid(inv);
                 AddKnownTx(*peer, inv.hash);
+                // No need to reconcile a transaction the peer announced to us.
+                if (m_txreconciliation && inv.IsMsgWtx()) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
 
                 if (!m_chainman.IsInitialBlockDownload()) {
                     const bool fAlreadyHave{m_txdownloadman.AddTxAnnouncement(pfrom.GetId(), gtxid, current_time)};
@@ -4271,6 +4558,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         const uint256& hash = peer->m_wtxid_relay ? wtxid.ToUint256() : txid.ToUint256();
         AddKnownTx(*peer, hash);
+        if (m_txreconciliation) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), wtxid);
 
         LOCK2(cs_main, m_tx_download_mutex);
 
@@ -4446,7 +4734,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
 
                 PartiallyDownloadedBlock& partialBlock = *(*queuedBlockIt)->partialBlock;
-                ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact, &m_block_reconstruction_pool);
                 if (status == READ_STATUS_INVALID) {
                     RemoveBlockRequest(pindex->GetBlockHash(), pfrom.GetId()); // Reset in-flight state in case Misbehaving does not result in a disconnect
                     Misbehaving(*peer, "invalid compact block");
@@ -4497,7 +4785,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 // Optimistically try to reconstruct anyway since we might be
                 // able to without any round trips.
                 PartiallyDownloadedBlock tempBlock(&m_mempool);
-                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact, &m_block_reconstruction_pool);
                 if (status != READ_STATUS_OK) {
                     // TODO: don't ignore failures
                     return;
@@ -4632,6 +4920,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             return;
         }
 
+        const size_t block_size{vRecv.size()};
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
         vRecv >> TX_WITH_WITNESS(*pblock);
 
@@ -4656,6 +4945,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             // Always process the block if we requested it, since we may
             // need it even when it's not a candidate for a new best tip.
             forceProcessing = IsBlockRequested(hash);
+            UpdateBlockDownloadStats(pfrom.GetId(), hash, block_size);
             RemoveBlockRequest(hash, pfrom.GetId());
             // mapBlockSource is only used for punishing peers and setting
             // which peers send us compact blocks, so the race between here and
@@ -4990,6 +5280,11 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
         }
     }
 
+    // Nothing else is processed for the peer while a block is being sent to
+    // it, which maintains the order of responses. The block serving thread
+    // wakes us up when it is done.
+    if (peer->m_serving_block) return false;
+
     const bool processed_orphan = ProcessOrphanTx(*peer);
 
     if (pfrom->fDisconnect)
@@ -5299,9 +5594,9 @@ void PeerManagerImpl::MaybeSendAddr(CNode& node, Peer& peer, std::chrono::micros
     // Periodically advertise our local address to the peer.
     if (fListen && !m_chainman.IsInitialBlockDownload() &&
         peer.m_next_local_addr_send < current_time) {
-        // If we've sent before, clear the bloom filter for the peer, so that our
+        // If we've sent before, clear the known address filter for the peer, so that our
         // self-announcement will actually go out.
-        // This might be unnecessary if the bloom filter has already rolled
+        // This might be unnecessary if the filter has already rolled
         // over since our last self-announcement, but there is only a small
         // bandwidth cost that we can incur by doing this (which happens
         // once a day on average).
@@ -5452,7 +5747,7 @@ bool PeerManagerImpl::SetupAddressRelay(const CNode& node, Peer& peer)
         // During version message processing (non-block-relay-only outbound peers)
         // or on first addr-related message we have received (inbound peers), initialize
         // m_addr_known.
-        peer.m_addr_known = std::make_unique<CRollingBloomFilter>(5000, 0.001);
+        peer.m_addr_known = std::make_unique<RollingCuckooFilter<uint16_t>>(5000, 0.001);
     }
 
     return true;
@@ -5530,8 +5825,8 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         }
 
         if (!state.fSyncStarted && CanServeBlocks(*peer) && !m_chainman.m_blockman.LoadingBlocks()) {
-            // Only actively request headers from a single peer, unless we're close to today.
-            if ((nSyncStarted == 0 && sync_blocks_and_headers_from_peer) || m_chainman.m_best_header->Time() > NodeClock::now() - 24h) {
+            // Only actively request headers from -headerssyncpeers peers, unless we're close to today.
+            if ((nSyncStarted < m_opts.headers_sync_peers && sync_blocks_and_headers_from_peer) || m_chainman.m_best_header->Time() > NodeClock::now() - 24h) {
                 const CBlockIndex* pindexStart = m_chainman.m_best_header;
                 /* If possible, start at the block preceding the currently
                    best known header.  This ensures that we always get a
@@ -5808,6 +6103,13 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                             continue;
                         }
                         if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
+                        // Leave it to the next reconciliation round, unless the transaction is
+                        // flooded to this peer or its reconciliation set is full.
+                        if (m_txreconciliation && !m_txreconciliation->ShouldFanoutTo(wtxid, pto->GetId()) &&
+                            m_txreconciliation->AddToSet(pto->GetId(), wtxid)) {
+                            tx_relay->m_tx_inventory_known_filter.insert(inv.hash);
+                            continue;
+                        }
                         // Send
                         vInv.push_back(inv);
                         nRelayedTransactions++;
@@ -5822,6 +6124,24 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     LOCK(m_mempool.cs);
                     tx_relay->m_last_inv_sequence = m_mempool.GetSequence();
                 }
+
+                if (m_txreconciliation) {
+                    // Answer a reconciliation request along with the announcements, so that the
+                    // sketch does not reveal when we received the transactions in it.
+                    if (fSendTrickle) {
+                        if (const auto skdata{m_txreconciliation->RespondToReconciliationRequest(pto->GetId())}) {
+                            MakeAndPushMessage(*pto, NetMsgType::SKETCH, *skdata);
+                        }
+                    }
+                    // Announce the set of a round the peer did not answer in time.
+                    AnnounceReconciledTxs(*pto, *peer, m_txreconciliation->ExpireReconciliationRequest(pto->GetId(), current_time));
+                    if (m_txreconciliation->IsPeerNextToReconcileWith(pto->GetId(), current_time)) {
+                        if (const auto request{m_txreconciliation->InitiateReconciliationRequest(pto->GetId(), current_time)}) {
+                            const auto [recon_set_size, q]{*request};
+                            MakeAndPushMessage(*pto, NetMsgType::REQRECON, recon_set_size, q);
+                        }
+                    }
+                }
         }
         if (!vInv.empty())
             MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
@@ -5860,9 +6180,9 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         if (state.fSyncStarted && peer->m_headers_sync_timeout < std::chrono::microseconds::max()) {
             // Detect whether this is a stalling initial-headers-sync peer
             if (m_chainman.m_best_header->Time() <= NodeClock::now() - 24h) {
-                if (current_time > peer->m_headers_sync_timeout && nSyncStarted == 1 && (m_num_preferred_download_peers - state.fPreferredDownload >= 1)) {
-                    // Disconnect a peer (without NetPermissionFlags::NoBan permission) if it is our only sync peer,
-                    // and we have others we could be using instead.
+                if (current_time > peer->m_headers_sync_timeout && nSyncStarted <= m_opts.headers_sync_peers && (m_num_preferred_download_peers - state.fPreferredDownload >= 1)) {
+                    // Disconnect a peer (without NetPermissionFlags::NoBan permission) if it is one of our
+                    // -headerssyncpeers sync peers, and we have others we could be using instead.
                     // Note: If all our peers are inbound, then we won't
                     // disconnect our sync peer for stalling; we have bigger
                     // problems if we can't get any outbound peers.
@@ -5897,11 +6217,11 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         // Message: getdata (blocks)
         //
         std::vector<CInv> vGetData;
-        if (CanServeBlocks(*peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(*peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        if (CanServeBlocks(*peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(*peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < size_t(MaxBlocksInTransit(state))) {
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
             auto get_inflight_budget = [&state]() {
-                return std::max(0, MAX_BLOCKS_IN_TRANSIT_PER_PEER - static_cast<int>(state.vBlocksInFlight.size()));
+                return std::max(0, MaxBlocksInTransit(state) - static_cast<int>(state.vBlocksInFlight.size()));
             };
 
             // If a snapshot chainstate is in use, we want to find its next blocks
@@ -5924,6 +6244,9 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                 LogDebug(BCLog::NET, "Requesting block %s (%d) peer=%d\n", pindex->GetBlockHash().ToString(),
                     pindex->nHeight, pto->GetId());
             }
+            if (vToDownload.empty() && staller != -1) {
+                MaybeRequestLaggingBlock(*pto, *peer, staller, current_time, vGetData);
+            }
             if (state.vBlocksInFlight.empty() && staller != -1) {
                 if (State(staller)->m_stalling_since == 0us) {
                     State(staller)->m_stalling_since = current_time;
@@ -41,6 +41,15 @@ static constexpr bool DEFAULT_TXRECONCILIATION_ENABLE{false};
 static const uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
 static const bool DEFAULT_PEERBLOOMFILTERS = false;
 static const bool DEFAULT_PEERBLOCKFILTERS = false;
+/** Default number of threads sending requested blocks to peers. */
+static constexpr int DEFAULT_BLOCK_SERVE_THREADS{2};
+static constexpr int MAX_BLOCK_SERVE_THREADS{16};
+/** Default number of threads helping to match compact block short IDs against the mempool. */
+static constexpr int DEFAULT_BLOCK_RECONSTRUCTION_THREADS{2};
+static constexpr int MAX_BLOCK_RECONSTRUCTION_THREADS{16};
+/** Default number of peers initial headers sync requests headers from concurrently. */
+static constexpr int DEFAULT_HEADERS_SYNC_PEERS{1};
+static constexpr int MAX_HEADERS_SYNC_PEERS{8};
 /** Maximum number of outstanding CMPCTBLOCK requests for the same block. */
 static const unsigned int MAX_CMPCTBLOCKS_INFLIGHT_PER_BLOCK = 3;
 /** Number of headers sent in one getheaders result. We rely on the assumption that if a peer sends
@@ -53,6 +62,9 @@ struct CNodeStateStats {
     int m_starting_height = -1;
     std::chrono::microseconds m_ping_wait;
     std::vector<int> vHeightInFlight;
+    uint64_t m_block_download_rate{0};
+    std::chrono::microseconds m_block_latency{0};
+    int m_max_blocks_in_transit{0};
     bool m_relay_txs;
     int m_inv_to_send = 0;
     uint64_t m_last_inv_seq{0};
@@ -81,6 +93,17 @@ public:
         //! Number of non-mempool transactions to keep around for block reconstruction. Includes
         //! orphan, replaced, and rejected transactions.
         uint32_t max_extra_txs{DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN};
+        //! Number of threads sending requested blocks to peers, concurrently
+        //! with message handling. Zero sends them from the message handler.
+        int block_serve_threads{0};
+        //! Number of threads helping the message handler to match compact
+        //! block short IDs against a large mempool. Zero scans it sequentially.
+        int block_reconstruction_threads{0};
+        //! Number of peers to request headers from concurrently while the best
+        //! known header is older than a day. The first peer to answer a
+        //! request drives the sync; the others are asked to continue from
+        //! the best header instead of repeating it.
+        int headers_sync_peers{DEFAULT_HEADERS_SYNC_PEERS};
         //! Whether all P2P messages are captured to disk
         bool capture_messages{false};
         //! Whether or not the internal RNG behaves deterministically (this is
@@ -14,6 +14,9 @@
 #include <net_processing.h>
 #include <netgroup.h>
 #include <node/kernel_notifications.h>
+#include <node/mempool_forecast.h>
+#include <node/mempool_persist.h>
+#include <node/response_cache.h>
 #include <node/warnings.h>
 #include <policy/fees.h>
 #include <scheduler.h>
@@ -41,6 +41,9 @@ class SignalInterrupt;
 
 namespace node {
 class KernelNotifications;
+class MempoolForecaster;
+class MempoolJournal;
+class ResponseCache;
 class Warnings;
 
 //! NodeContext struct containing references to chain state and connection
@@ -66,6 +69,9 @@ struct NodeContext {
     std::unique_ptr<AddrMan> addrman;
     std::unique_ptr<CConnman> connman;
     std::unique_ptr<CTxMemPool> mempool;
+    std::unique_ptr<MempoolJournal> mempool_journal;
+    std::unique_ptr<MempoolForecaster> mempool_forecaster;
+    std::unique_ptr<ResponseCache> response_cache;
     std::unique_ptr<const NetGroupManager> netgroupman;
     std::unique_ptr<CBlockPolicyEstimator> fee_estimator;
     std::unique_ptr<PeerManager> peerman;
@@ -0,0 +1,101 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/event_subscriber.h>
+
+#include <chain.h>
+#include <kernel/chain.h>
+#include <kernel/mempool_entry.h>
+#include <kernel/mempool_removal_reason.h>
+#include <univalue.h>
+
+#include <utility>
+
+namespace node {
+
+std::vector<std::string> EventSubscriber::Wait(std::chrono::milliseconds timeout)
+{
+    WAIT_LOCK(m_mutex, lock);
+    m_cond.wait_for(lock, timeout, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        return !m_events.empty() || m_overflowed || m_interrupted;
+    });
+    return std::exchange(m_events, {});
+}
+
+bool EventSubscriber::Overflowed() const
+{
+    return WITH_LOCK(m_mutex, return m_overflowed);
+}
+
+void EventSubscriber::Interrupt()
+{
+    WITH_LOCK(m_mutex, m_interrupted = true);
+    m_cond.notify_all();
+}
+
+bool EventSubscriber::Interrupted() const
+{
+    return WITH_LOCK(m_mutex, return m_interrupted);
+}
+
+void EventSubscriber::Push(const UniValue& event)
+{
+    {
+        LOCK(m_mutex);
+        if (m_overflowed) return;
+        if (m_events.size() >= m_max_queued) {
+            m_overflowed = true;
+        } else {
+            m_events.push_back(event.write());
+        }
+    }
+    m_cond.notify_all();
+}
+
+static UniValue BlockEvent(const std::string& type, const CBlockIndex& index)
+{
+    UniValue event{UniValue::VOBJ};
+    event.pushKV("type", type);
+    event.pushKV("hash", index.GetBlockHash().GetHex());
+    event.pushKV("height", index.nHeight);
+    return event;
+}
+
+static UniValue TransactionEvent(const std::string& type, const CTransaction& tx)
+{
+    UniValue event{UniValue::VOBJ};
+    event.pushKV("type", type);
+    event.pushKV("txid", tx.GetHash().GetHex());
+    event.pushKV("wtxid", tx.GetWitnessHash().GetHex());
+    return event;
+}
+
+void EventSubscriber::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    // Historical blocks of a background chainstate do not change the tip.
+    if (role == ChainstateRole::BACKGROUND) return;
+    Push(BlockEvent("blockconnected", *pindex));
+}
+
+void EventSubscriber::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    Push(BlockEvent("blockdisconnected", *pindex));
+}
+
+void EventSubscriber::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
+{
+    UniValue event{TransactionEvent("txadded", *tx.info.m_tx)};
+    event.pushKV("sequence", mempool_sequence);
+    Push(event);
+}
+
+void EventSubscriber::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
+{
+    UniValue event{TransactionEvent("txremoved", *tx)};
+    event.pushKV("reason", RemovalReasonToString(reason));
+    event.pushKV("sequence", mempool_sequence);
+    Push(event);
+}
+
+} // namespace node
@@ -0,0 +1,92 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_EVENT_SUBSCRIBER_H
+#define BITCOIN_NODE_EVENT_SUBSCRIBER_H
+
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <validationinterface.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class UniValue;
+enum class MemPoolRemovalReason;
+struct NewMempoolTransactionInfo;
+
+namespace node {
+
+//! Events queued for a subscriber beyond which it is dropped
+static constexpr size_t DEFAULT_EVENT_QUEUE_SIZE{10'000};
+
+/**
+ * Subscription to chain and mempool events, for clients that would otherwise
+ * poll for a new tip or mempool changes. The validation interface callbacks
+ * queue every event as a line of compact JSON until the subscriber takes it:
+ *
+ *   {"type":"blockconnected","hash":"<hex>","height":<n>}
+ *   {"type":"blockdisconnected","hash":"<hex>","height":<n>}
+ *   {"type":"txadded","txid":"<hex>","wtxid":"<hex>","sequence":<n>}
+ *   {"type":"txremoved","txid":"<hex>","wtxid":"<hex>","reason":"<reason>","sequence":<n>}
+ *
+ * where "sequence" is the mempool sequence number of the event. Transactions
+ * removed from the mempool for being included in a block are not reported,
+ * the same as in the ZMQ "sequence" topic.
+ *
+ * The callbacks never wait for the subscriber, so that a slow one cannot stall
+ * the validation interface queue. A subscriber that falls more than the queue
+ * size behind overflows instead: it gets no more events, and has to subscribe
+ * again and catch up by polling once.
+ */
+class EventSubscriber final : public CValidationInterface
+{
+public:
+    explicit EventSubscriber(size_t max_queued = DEFAULT_EVENT_QUEUE_SIZE) : m_max_queued{max_queued} {}
+
+    /**
+     * Take the queued events, waiting up to @p timeout for one if there are
+     * none. Returns right away if the subscriber overflowed or was interrupted.
+     */
+    std::vector<std::string> Wait(std::chrono::milliseconds timeout) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Whether events were dropped because the subscriber fell too far behind. */
+    bool Overflowed() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Make Wait return right away, such as when shutting down. */
+    void Interrupt() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    bool Interrupted() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const size_t m_max_queued;
+
+    mutable Mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector<std::string> m_events GUARDED_BY(m_mutex);
+    bool m_overflowed GUARDED_BY(m_mutex){false};
+    bool m_interrupted GUARDED_BY(m_mutex){false};
+
+    void Push(const UniValue& event) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_EVENT_SUBSCRIBER_H
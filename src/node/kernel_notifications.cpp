@@ -9,6 +9,7 @@
 #include <chain.h>
 #include <common/args.h>
 #include <common/system.h>
+#include <interfaces/handler.h>
 #include <kernel/context.h>
 #include <kernel/warning.h>
 #include <logging.h>
@@ -24,6 +25,7 @@
 #include <cstdint>
 #include <string>
 #include <thread>
+#include <utility>
 
 using util::ReplaceAll;
 
@@ -55,6 +57,7 @@ kernel::InterruptResult KernelNotifications::blockTip(SynchronizationState state
         Assume(index.GetBlockHash() != uint256::ZERO);
         m_tip_block = index.GetBlockHash();
         m_tip_block_cv.notify_all();
+        for (const auto& fn : m_tip_changed_fns) fn(*m_tip_block);
     }
 
     uiInterface.NotifyBlockTip(state, index, verification_progress);
@@ -67,6 +70,13 @@ kernel::InterruptResult KernelNotifications::blockTip(SynchronizationState state
     return {};
 }
 
+std::unique_ptr<interfaces::Handler> KernelNotifications::handleTipChanged(TipChangedFn fn)
+{
+    LOCK(m_tip_block_mutex);
+    auto it{m_tip_changed_fns.emplace(m_tip_changed_fns.end(), std::move(fn))};
+    return interfaces::MakeCleanupHandler([this, it] { LOCK(m_tip_block_mutex); m_tip_changed_fns.erase(it); });
+}
+
 void KernelNotifications::headerTip(SynchronizationState state, int64_t height, int64_t timestamp, bool presync)
 {
     uiInterface.NotifyHeaderTip(state, height, timestamp, presync);
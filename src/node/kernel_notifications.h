@@ -14,12 +14,17 @@
 #include <atomic>
 #include <cstdint>
 #include <functional>
+#include <list>
+#include <memory>
 
 class ArgsManager;
 class CBlockIndex;
 enum class SynchronizationState;
 struct bilingual_str;
 
+namespace interfaces {
+class Handler;
+} // namespace interfaces
 namespace kernel {
 enum class Warning;
 } // namespace kernel
@@ -61,12 +66,22 @@ public:
     //! Might be unset during an early shutdown.
     std::optional<uint256> TipBlock() EXCLUSIVE_LOCKS_REQUIRED(m_tip_block_mutex);
 
+    using TipChangedFn = std::function<void(const uint256& tip)>;
+    /**
+     * Call @p fn with the new tip block on every blockTip notification, until
+     * the returned handler is destroyed. It is called with m_tip_block_mutex
+     * held, so that a caller which checked TipBlock() under the same lock
+     * cannot miss a change, and must not block.
+     */
+    std::unique_ptr<interfaces::Handler> handleTipChanged(TipChangedFn fn) EXCLUSIVE_LOCKS_REQUIRED(!m_tip_block_mutex);
+
 private:
     const std::function<bool()>& m_shutdown_request;
     std::atomic<int>& m_exit_status;
     node::Warnings& m_warnings;
 
     std::optional<uint256> m_tip_block GUARDED_BY(m_tip_block_mutex);
+    std::list<TipChangedFn> m_tip_changed_fns GUARDED_BY(m_tip_block_mutex);
 };
 
 void ReadNotificationArgs(const ArgsManager& args, KernelNotifications& notifications);
@@ -0,0 +1,197 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <node/mempool_forecast.h>
+
+#include <kernel/mempool_snapshot.h>
+#include <txmempool.h>
+#include <util/feefrac.h>
+#include <util/hasher.h>
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace node {
+
+CFeeRate MempoolForecast::EstimateFee(unsigned int conf_target) const
+{
+    conf_target = std::max(conf_target, 1U);
+    if (conf_target > blocks.size() || (exhausted && conf_target == blocks.size())) {
+        // Either the target block has room to spare, or it is beyond what
+        // was simulated, in which case the last block is the best guess.
+        if (exhausted || blocks.empty()) return CFeeRate{0};
+        return blocks.back().min_feerate;
+    }
+    return blocks[conf_target - 1].min_feerate;
+}
+
+namespace {
+/** Per-transaction state of the simulation. */
+struct SimTx {
+    CAmount fee;
+    int64_t vsize;
+    //! Fee and size of this transaction and its not yet mined ancestors
+    CAmount anc_fee;
+    int64_t anc_vsize;
+    std::vector<uint32_t> parents{};
+    std::vector<uint32_t> children{};
+    bool mined{false};
+    //! Last walk that visited this transaction
+    uint32_t visited{0};
+};
+
+/** Candidate for selection; stale once the transaction's ancestor state changed. */
+struct Candidate {
+    FeeFrac anc_feerate;
+    uint32_t index;
+
+    bool operator<(const Candidate& other) const
+    {
+        // Highest ancestor feerate first, ties broken by lowest index.
+        if (const auto cmp{FeeRateCompare(anc_feerate, other.anc_feerate)}; cmp != 0) return cmp < 0;
+        return index > other.index;
+    }
+};
+} // namespace
+
+MempoolForecast ForecastBlocks(const kernel::MempoolSnapshot& snapshot, unsigned int num_blocks, int64_t block_vsize)
+{
+    MempoolForecast forecast;
+    forecast.sequence = snapshot.GetStats().sequence;
+    forecast.time = SteadyClock::now();
+
+    const auto entries{snapshot.GetSortedDepthAndScore()};
+    std::vector<SimTx> txs;
+    txs.reserve(entries.size());
+    std::unordered_map<Txid, uint32_t, SaltedTxidHasher> index_by_txid;
+    index_by_txid.reserve(entries.size());
+    std::priority_queue<Candidate> candidates;
+    // Entries are sorted with parents first.
+    for (const auto& entry : entries) {
+        const uint32_t index(txs.size());
+        auto& tx{txs.emplace_back(SimTx{
+            .fee = entry->modified_fee,
+            .vsize = entry->vsize,
+            .anc_fee = entry->mod_fees_with_ancestors,
+            .anc_vsize = entry->size_with_ancestors,
+        })};
+        for (const Txid& parent : entry->parents) {
+            const auto it{index_by_txid.find(parent)};
+            if (it == index_by_txid.end()) continue;
+            tx.parents.push_back(it->second);
+            txs[it->second].children.push_back(index);
+        }
+        index_by_txid.emplace(entry->GetHash(), index);
+        candidates.push({FeeFrac{tx.anc_fee, int32_t(tx.anc_vsize)}, index});
+    }
+
+    uint32_t walk{0};
+    std::vector<uint32_t> package, stack, updated;
+    ForecastBlock block;
+    while (!candidates.empty()) {
+        const Candidate candidate{candidates.top()};
+        candidates.pop();
+        SimTx& top{txs[candidate.index]};
+        if (top.mined || candidate.anc_feerate != FeeFrac{top.anc_fee, int32_t(top.anc_vsize)}) continue;
+
+        if (block.tx_count > 0 && block.vsize + top.anc_vsize > block_vsize) {
+            forecast.blocks.push_back(block);
+            block = {};
+            if (forecast.blocks.size() == num_blocks) return forecast;
+        }
+
+        // Collect the not yet mined ancestors, which are mined together.
+        ++walk;
+        package.clear();
+        stack.assign(1, candidate.index);
+        top.visited = walk;
+        while (!stack.empty()) {
+            const uint32_t index{stack.back()};
+            stack.pop_back();
+            package.push_back(index);
+            for (const uint32_t parent : txs[index].parents) {
+                if (txs[parent].mined || txs[parent].visited == walk) continue;
+                txs[parent].visited = walk;
+                stack.push_back(parent);
+            }
+        }
+
+        const CFeeRate package_feerate{top.anc_fee, int32_t(top.anc_vsize)};
+        block.min_feerate = block.tx_count == 0 ? package_feerate : std::min(block.min_feerate, package_feerate);
+        block.max_feerate = std::max(block.max_feerate, package_feerate);
+        block.vsize += top.anc_vsize;
+        block.tx_count += package.size();
+        for (const uint32_t index : package) txs[index].mined = true;
+
+        // Remove the package from the ancestor state of its descendants.
+        updated.clear();
+        for (const uint32_t index : package) {
+            const SimTx& mined{txs[index]};
+            ++walk;
+            stack.assign(mined.children.begin(), mined.children.end());
+            while (!stack.empty()) {
+                SimTx& descendant{txs[stack.back()]};
+                const uint32_t descendant_index{stack.back()};
+                stack.pop_back();
+                if (descendant.mined || descendant.visited == walk) continue;
+                descendant.visited = walk;
+                descendant.anc_fee -= mined.fee;
+                descendant.anc_vsize -= mined.vsize;
+                updated.push_back(descendant_index);
+                stack.insert(stack.end(), descendant.children.begin(), descendant.children.end());
+            }
+        }
+        std::sort(updated.begin(), updated.end());
+        updated.erase(std::unique(updated.begin(), updated.end()), updated.end());
+        for (const uint32_t index : updated) {
+            candidates.push({FeeFrac{txs[index].anc_fee, int32_t(txs[index].anc_vsize)}, index});
+        }
+    }
+
+    // The mempool ran out before all blocks were filled.
+    if (block.tx_count > 0) forecast.blocks.push_back(block);
+    forecast.exhausted = true;
+    return forecast;
+}
+
+MempoolForecaster::MempoolForecaster(const CTxMemPool& pool, std::chrono::milliseconds max_age)
+    : m_pool{pool}, m_max_age{max_age} {}
+
+std::shared_ptr<const MempoolForecast> MempoolForecaster::GetForecast()
+{
+    const auto is_fresh{[&](const std::shared_ptr<const MempoolForecast>& forecast) {
+        return forecast && SteadyClock::now() - forecast->time < m_max_age;
+    }};
+    auto cached{WITH_LOCK(m_mutex, return m_forecast)};
+    if (is_fresh(cached)) return cached;
+
+    {
+        TRY_LOCK(m_refresh_mutex, refresh_lock);
+        // Serve the previous forecast while another thread makes a new one.
+        if (!refresh_lock && cached) return cached;
+    }
+
+    LOCK(m_refresh_mutex);
+    // Another thread may have just made a new forecast.
+    cached = WITH_LOCK(m_mutex, return m_forecast);
+    if (is_fresh(cached)) return cached;
+
+    auto snapshot{m_pool.GetSnapshot()};
+    std::shared_ptr<MempoolForecast> forecast;
+    if (cached && snapshot == m_snapshot) {
+        // Nothing changed, only renew the forecast's age.
+        forecast = std::make_shared<MempoolForecast>(*cached);
+        forecast->time = SteadyClock::now();
+    } else {
+        forecast = std::make_shared<MempoolForecast>(ForecastBlocks(*snapshot, MAX_FORECAST_BLOCKS, FORECAST_BLOCK_VSIZE));
+    }
+    m_snapshot = std::move(snapshot);
+    LOCK(m_mutex);
+    m_forecast = std::move(forecast);
+    return m_forecast;
+}
+
+} // namespace node
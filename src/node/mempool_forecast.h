@@ -0,0 +1,104 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#ifndef BITCOIN_NODE_MEMPOOL_FORECAST_H
+#define BITCOIN_NODE_MEMPOOL_FORECAST_H
+
+#include <consensus/consensus.h>
+#include <policy/feerate.h>
+#include <policy/policy.h>
+#include <sync.h>
+#include <util/time.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CTxMemPool;
+namespace kernel {
+class MempoolSnapshot;
+} // namespace kernel
+
+namespace node {
+
+/** Number of blocks the mempool forecast simulates. */
+static constexpr unsigned int MAX_FORECAST_BLOCKS{24};
+/** Virtual size available to transactions in a simulated block. */
+static constexpr int64_t FORECAST_BLOCK_VSIZE{(DEFAULT_BLOCK_MAX_WEIGHT - DEFAULT_BLOCK_RESERVED_WEIGHT) / WITNESS_SCALE_FACTOR};
+/** A forecast younger than this is served without checking the mempool for changes. */
+static constexpr std::chrono::milliseconds DEFAULT_FORECAST_MAX_AGE{1000};
+
+/** Summary of one simulated block. */
+struct ForecastBlock {
+    //! Lowest feerate of an ancestor package included in the block
+    CFeeRate min_feerate;
+    //! Highest feerate of an ancestor package included in the block
+    CFeeRate max_feerate;
+    int64_t vsize{0};
+    size_t tx_count{0};
+};
+
+/** The next blocks as they would be mined from a given state of the mempool. */
+struct MempoolForecast {
+    //! Simulated blocks, in order. Fewer than requested if the mempool ran out;
+    //! only the last block may be partially filled.
+    std::vector<ForecastBlock> blocks;
+    //! Whether the whole mempool fit into the simulated blocks
+    bool exhausted{false};
+    //! Mempool sequence number of the snapshot the forecast was made from
+    uint64_t sequence{0};
+    //! When the forecast was made
+    SteadyClock::time_point time;
+
+    /**
+     * Feerate a transaction needs to be expected to confirm within
+     * @p conf_target blocks: the lowest feerate mined in that block, or zero
+     * if all of the mempool is expected to be mined by then.
+     */
+    CFeeRate EstimateFee(unsigned int conf_target) const;
+};
+
+/**
+ * Simulate mining the next @p num_blocks blocks of at most @p block_vsize
+ * from a mempool snapshot, using ancestor feerate selection as done by
+ * BlockAssembler and MiniMiner. Packages are assigned to blocks in the order
+ * they are selected, so only as much of the mempool as fits into the
+ * requested blocks is linearized.
+ */
+MempoolForecast ForecastBlocks(const kernel::MempoolSnapshot& snapshot, unsigned int num_blocks, int64_t block_vsize);
+
+/**
+ * Serves feerate forecasts based on the current contents of the mempool,
+ * complementing the historical estimates of CBlockPolicyEstimator, which
+ * react slowly to sudden changes in demand.
+ *
+ * Making a forecast walks a large part of the mempool, so forecasts are
+ * cached and shared between callers. A new one is made only when the cached
+ * one is older than the maximum age and the mempool has changed since. While
+ * one caller makes a new forecast, others are served the previous one.
+ */
+class MempoolForecaster
+{
+public:
+    explicit MempoolForecaster(const CTxMemPool& pool, std::chrono::milliseconds max_age = DEFAULT_FORECAST_MAX_AGE);
+
+    /** Return a recent forecast, making a new one if needed. */
+    std::shared_ptr<const MempoolForecast> GetForecast() EXCLUSIVE_LOCKS_REQUIRED(!m_refresh_mutex, !m_mutex);
+
+private:
+    const CTxMemPool& m_pool;
+    const std::chrono::milliseconds m_max_age;
+
+    //! Held while making a new forecast, so only one is made at a time
+    Mutex m_refresh_mutex;
+    //! Snapshot the cached forecast was made from
+    std::shared_ptr<const kernel::MempoolSnapshot> m_snapshot GUARDED_BY(m_refresh_mutex);
+    Mutex m_mutex;
+    std::shared_ptr<const MempoolForecast> m_forecast GUARDED_BY(m_mutex);
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_MEMPOOL_FORECAST_H
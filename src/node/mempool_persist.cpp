@@ -4,11 +4,17 @@
 
 #include <node/mempool_persist.h>
 
+#include <checkqueue.h>
 #include <clientversion.h>
+#include <coins.h>
 #include <consensus/amount.h>
+#include <consensus/tx_check.h>
+#include <consensus/validation.h>
 #include <logging.h>
+#include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
+#include <script/interpreter.h>
 #include <serialize.h>
 #include <streams.h>
 #include <sync.h>
@@ -30,6 +36,7 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -38,7 +45,182 @@ using fsbridge::FopenFn;
 namespace node {
 
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
-static const uint64_t MEMPOOL_DUMP_VERSION{2};
+static const uint64_t MEMPOOL_DUMP_VERSION_NO_CHUNKS{2};
+static const uint64_t MEMPOOL_DUMP_VERSION{3};
+
+/**
+ * Since version 3 the file consists of the version and obfuscation key,
+ * followed by any number of length-prefixed records. Records can be appended
+ * to an existing file (see MempoolJournal), and a truncated record at the end
+ * of the file, e.g. after a crash while appending, is ignored on load.
+ */
+enum class DumpRecord : uint8_t {
+    TXS = 0,         //!< Up to DUMP_CHUNK_TXS transactions with their entry time and fee delta
+    DELTAS = 1,      //!< Fee deltas of transactions not contained in any TXS record
+    UNBROADCAST = 2, //!< Txids that were still awaiting initial broadcast
+};
+
+/** Maximum number of transactions per TXS record. This bounds the memory
+ *  needed to write and load a file, and is the unit of parallel
+ *  pre-validation on load. */
+static constexpr size_t DUMP_CHUNK_TXS{1000};
+/** Sanity limit on the size of a single record. */
+static constexpr uint32_t MAX_DUMP_RECORD_SIZE{256 << 20};
+
+/** Serializes DumpMempool() and appends to the same file. */
+static GlobalMutex g_dump_mutex;
+/** Incremented whenever DumpMempool() replaces the file, so that appends to a
+ *  dump written earlier can tell it is gone. */
+static uint64_t g_dump_generation GUARDED_BY(g_dump_mutex){0};
+
+namespace {
+/** A transaction stored in a mempool dump. */
+struct PersistedTx {
+    CTransactionRef tx;
+    int64_t time{0};
+    int64_t fee_delta{0};
+
+    SERIALIZE_METHODS(PersistedTx, obj) { READWRITE(TX_WITH_WITNESS(obj.tx), obj.time, obj.fee_delta); }
+};
+
+/** Counters and per-phase timings of a LoadMempool() call. */
+struct LoadStats {
+    int64_t count{0};
+    int64_t expired{0};
+    int64_t failed{0};
+    int64_t already_there{0};
+    SteadyClock::duration read{0};
+    SteadyClock::duration prevalidate{0};
+    SteadyClock::duration accept{0};
+};
+} // namespace
+
+template <typename Payload>
+static void WriteRecord(AutoFile& file, DumpRecord type, const Payload& payload)
+{
+    DataStream stream;
+    stream << payload;
+    file << uint8_t(type) << uint32_t(stream.size());
+    file.write(std::span{stream});
+}
+
+/** Write transactions as TXS records of at most DUMP_CHUNK_TXS entries. */
+static void WriteTxRecords(AutoFile& file, const std::vector<PersistedTx>& txs)
+{
+    for (size_t offset{0}; offset < txs.size(); offset += DUMP_CHUNK_TXS) {
+        const auto end{txs.begin() + std::min(txs.size(), offset + DUMP_CHUNK_TXS)};
+        WriteRecord(file, DumpRecord::TXS, std::vector<PersistedTx>(txs.begin() + offset, end));
+    }
+}
+
+/**
+ * Verify the input scripts of a batch of transactions on the script check
+ * threads, storing successful signature checks in the signature cache, so
+ * that the serial AcceptToMemoryPool() calls that follow mostly hit the cache.
+ *
+ * Context-free checks are done first and transactions failing them, or with
+ * inputs that can't be found, are skipped. Any failure is ignored here:
+ * AcceptToMemoryPool() remains authoritative.
+ */
+static void PrevalidateBatch(const std::vector<PersistedTx>& batch, CTxMemPool& pool, Chainstate& active_chainstate)
+{
+    auto& queue{active_chainstate.m_chainman.GetCheckQueue()};
+    if (!queue.HasThreads()) return;
+
+    // Checks hold pointers into txdata, which must therefore not reallocate.
+    std::vector<PrecomputedTransactionData> txdata(batch.size());
+    std::vector<CScriptCheck> checks;
+    auto& signature_cache{active_chainstate.m_chainman.m_validation_cache.m_signature_cache};
+    {
+        // Outputs created by earlier transactions in this batch.
+        std::unordered_map<COutPoint, CTxOut, SaltedOutpointHasher> batch_outputs;
+        LOCK(cs_main);
+        for (size_t i{0}; i < batch.size(); ++i) {
+            const CTransaction& tx{*batch[i].tx};
+            TxValidationState state;
+            if (!CheckTransaction(tx, state) || tx.IsCoinBase()) continue;
+
+            std::vector<CTxOut> spent_outputs;
+            spent_outputs.reserve(tx.vin.size());
+            for (const CTxIn& txin : tx.vin) {
+                if (auto it{batch_outputs.find(txin.prevout)}; it != batch_outputs.end()) {
+                    spent_outputs.push_back(it->second);
+                } else if (auto parent{pool.get(txin.prevout.hash)}; parent && txin.prevout.n < parent->vout.size()) {
+                    spent_outputs.push_back(parent->vout[txin.prevout.n]);
+                } else if (auto coin{active_chainstate.CoinsTip().GetCoin(txin.prevout)}) {
+                    spent_outputs.push_back(coin->out);
+                } else {
+                    break;
+                }
+            }
+            for (uint32_t n{0}; n < tx.vout.size(); ++n) {
+                batch_outputs.emplace(COutPoint{tx.GetHash(), n}, tx.vout[n]);
+            }
+            if (spent_outputs.size() != tx.vin.size()) continue;
+
+            txdata[i].Init(tx, std::move(spent_outputs));
+            for (unsigned int n{0}; n < tx.vin.size(); ++n) {
+                checks.emplace_back(txdata[i].m_spent_outputs[n], tx, signature_cache, n,
+                                    STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheIn=*/true, &txdata[i]);
+            }
+        }
+    }
+
+    CCheckQueueControl<CScriptCheck> control(queue);
+    control.Add(std::move(checks));
+    (void)control.Complete();
+}
+
+/** Pre-validate and then accept a batch of transactions in file order, which
+ *  is topological. Return false if interrupted. */
+static bool LoadBatch(std::vector<PersistedTx>&& batch, CTxMemPool& pool, Chainstate& active_chainstate,
+                      const ImportMempoolOptions& opts, NodeClock::time_point now, LoadStats& stats)
+{
+    auto start{SteadyClock::now()};
+
+    std::vector<PersistedTx> unexpired;
+    unexpired.reserve(batch.size());
+    for (auto& entry : batch) {
+        if (opts.use_current_time) {
+            entry.time = TicksSinceEpoch<std::chrono::seconds>(now);
+        }
+
+        CAmount amountdelta = entry.fee_delta;
+        if (amountdelta && opts.apply_fee_delta_priority) {
+            pool.PrioritiseTransaction(entry.tx->GetHash(), amountdelta);
+        }
+        if (entry.time > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+            unexpired.push_back(std::move(entry));
+        } else {
+            ++stats.expired;
+        }
+    }
+
+    PrevalidateBatch(unexpired, pool, active_chainstate);
+    auto mid{SteadyClock::now()};
+    stats.prevalidate += mid - start;
+
+    for (const auto& entry : unexpired) {
+        LOCK(cs_main);
+        const auto& accepted = AcceptToMemoryPool(active_chainstate, entry.tx, entry.time, /*bypass_limits=*/false, /*test_accept=*/false);
+        if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
+            ++stats.count;
+        } else {
+            // mempool may contain the transaction already, e.g. from
+            // wallet(s) having loaded it while we were processing
+            // mempool transactions; consider these as valid, instead of
+            // failed, but mark them as 'already there'
+            if (pool.exists(entry.tx->GetHash())) {
+                ++stats.already_there;
+            } else {
+                ++stats.failed;
+            }
+        }
+        if (active_chainstate.m_chainman.m_interrupt) break;
+    }
+    stats.accept += SteadyClock::now() - mid;
+    return !active_chainstate.m_chainman.m_interrupt;
+}
 
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
@@ -50,10 +232,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         return false;
     }
 
-    int64_t count = 0;
-    int64_t expired = 0;
-    int64_t failed = 0;
-    int64_t already_there = 0;
+    LoadStats stats;
     int64_t unbroadcast = 0;
     const auto now{NodeClock::now()};
 
@@ -63,7 +242,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
 
         if (version == MEMPOOL_DUMP_VERSION_NO_XOR_KEY) {
             file.SetObfuscation({});
-        } else if (version == MEMPOOL_DUMP_VERSION) {
+        } else if (version == MEMPOOL_DUMP_VERSION_NO_CHUNKS || version == MEMPOOL_DUMP_VERSION) {
             Obfuscation obfuscation;
             file >> obfuscation;
             file.SetObfuscation(obfuscation);
@@ -71,59 +250,97 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             return false;
         }
 
-        uint64_t total_txns_to_load;
-        file >> total_txns_to_load;
-        uint64_t txns_tried = 0;
-        LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
-        int next_tenth_to_report = 0;
-        while (txns_tried < total_txns_to_load) {
-            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
-            if (next_tenth_to_report < percentage_done / 10) {
-                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
-                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
-                next_tenth_to_report = percentage_done / 10;
-            }
-            ++txns_tried;
-
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> TX_WITH_WITNESS(tx);
-            file >> nTime;
-            file >> nFeeDelta;
+        std::map<Txid, CAmount> mapDeltas;
+        std::set<Txid> unbroadcast_txids;
 
-            if (opts.use_current_time) {
-                nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+        if (version == MEMPOOL_DUMP_VERSION) {
+            std::error_code ec;
+            const uintmax_t file_size{fs::file_size(load_path, ec)};
+            LogInfo("Loading mempool transactions from file...\n");
+            int next_tenth_to_report = 0;
+            while (true) {
+                auto read_start{SteadyClock::now()};
+                uint8_t type;
+                try {
+                    file >> type;
+                } catch (const std::ios_base::failure&) {
+                    if (file.feof()) break;
+                    throw;
+                }
+                std::vector<std::byte> payload;
+                try {
+                    uint32_t size;
+                    file >> size;
+                    if (size > MAX_DUMP_RECORD_SIZE) throw std::ios_base::failure("record too large");
+                    payload.resize(size);
+                    file.read(payload);
+                } catch (const std::ios_base::failure&) {
+                    if (!file.feof()) throw;
+                    LogWarning("Ignoring truncated record at the end of the mempool file\n");
+                    break;
+                }
+                SpanReader reader{payload};
+                switch (DumpRecord(type)) {
+                case DumpRecord::TXS: {
+                    std::vector<PersistedTx> batch;
+                    reader >> batch;
+                    stats.read += SteadyClock::now() - read_start;
+                    if (!LoadBatch(std::move(batch), pool, active_chainstate, opts, now, stats)) return false;
+                    break;
+                }
+                case DumpRecord::DELTAS: {
+                    std::map<Txid, CAmount> deltas;
+                    reader >> deltas;
+                    for (const auto& [txid, delta] : deltas) mapDeltas[txid] = delta;
+                    stats.read += SteadyClock::now() - read_start;
+                    break;
+                }
+                case DumpRecord::UNBROADCAST: {
+                    std::set<Txid> txids;
+                    reader >> txids;
+                    unbroadcast_txids.merge(txids);
+                    stats.read += SteadyClock::now() - read_start;
+                    break;
+                }
+                default:
+                    // Unknown record types are skipped for forward compatibility.
+                    break;
+                }
+                if (file_size > 0) {
+                    const int percentage_done(100.0 * file.tell() / file_size);
+                    if (next_tenth_to_report < percentage_done / 10) {
+                        LogInfo("Progress loading mempool transactions from file: %d%% (tried %u)\n",
+                                percentage_done, stats.count + stats.failed + stats.expired + stats.already_there);
+                        next_tenth_to_report = percentage_done / 10;
+                    }
+                }
             }
+        } else {
+            uint64_t total_txns_to_load;
+            file >> total_txns_to_load;
+            uint64_t txns_tried = 0;
+            LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
+            int next_tenth_to_report = 0;
+            while (txns_tried < total_txns_to_load) {
+                const int percentage_done(100.0 * txns_tried / total_txns_to_load);
+                if (next_tenth_to_report < percentage_done / 10) {
+                    LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
+                            percentage_done, txns_tried, total_txns_to_load - txns_tried);
+                    next_tenth_to_report = percentage_done / 10;
+                }
 
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta && opts.apply_fee_delta_priority) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
-            }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
-                LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
-                if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
-                    ++count;
-                } else {
-                    // mempool may contain the transaction already, e.g. from
-                    // wallet(s) having loaded it while we were processing
-                    // mempool transactions; consider these as valid, instead of
-                    // failed, but mark them as 'already there'
-                    if (pool.exists(tx->GetHash())) {
-                        ++already_there;
-                    } else {
-                        ++failed;
-                    }
+                auto read_start{SteadyClock::now()};
+                std::vector<PersistedTx> batch;
+                while (txns_tried < total_txns_to_load && batch.size() < DUMP_CHUNK_TXS) {
+                    ++txns_tried;
+                    file >> batch.emplace_back();
                 }
-            } else {
-                ++expired;
+                stats.read += SteadyClock::now() - read_start;
+                if (!LoadBatch(std::move(batch), pool, active_chainstate, opts, now, stats)) return false;
             }
-            if (active_chainstate.m_chainman.m_interrupt)
-                return false;
+            file >> mapDeltas;
+            file >> unbroadcast_txids;
         }
-        std::map<Txid, CAmount> mapDeltas;
-        file >> mapDeltas;
 
         if (opts.apply_fee_delta_priority) {
             for (const auto& i : mapDeltas) {
@@ -131,8 +348,6 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             }
         }
 
-        std::set<Txid> unbroadcast_txids;
-        file >> unbroadcast_txids;
         if (opts.apply_unbroadcast_set) {
             unbroadcast = unbroadcast_txids.size();
             for (const auto& txid : unbroadcast_txids) {
@@ -146,29 +361,49 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         return false;
     }
 
-    LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", count, failed, expired, already_there, unbroadcast);
+    LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", stats.count, stats.failed, stats.expired, stats.already_there, unbroadcast);
+    LogInfo("Imported mempool: %.3fs to read, %.3fs to pre-validate, %.3fs to accept\n",
+            Ticks<SecondsDouble>(stats.read),
+            Ticks<SecondsDouble>(stats.prevalidate),
+            Ticks<SecondsDouble>(stats.accept));
     return true;
 }
 
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+/**
+ * Write the mempool to @p dump_path, see DumpMempool(). On success, set
+ * @p sequence to the mempool sequence of the snapshot that was written: all
+ * transactions added with a lower sequence are in the file.
+ */
+static bool DumpMempoolLocked(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function,
+                              bool skip_file_commit, uint64_t& sequence) EXCLUSIVE_LOCKS_REQUIRED(g_dump_mutex)
 {
     auto start = SteadyClock::now();
 
     std::map<Txid, CAmount> mapDeltas;
-    std::vector<TxMempoolInfo> vinfo;
+    std::vector<PersistedTx> txs;
     std::set<Txid> unbroadcast_txids;
 
-    static Mutex dump_mutex;
-    LOCK(dump_mutex);
-
+    {
+        // Read entries from a snapshot rather than copying them all while
+        // holding pool.cs.
+        const auto snapshot{pool.GetSnapshot()};
+        sequence = snapshot->GetStats().sequence;
+        const auto entries{snapshot->GetSortedDepthAndScore()};
+        txs.reserve(entries.size());
+        for (const auto& entry : entries) {
+            txs.push_back({entry->tx, count_seconds(entry->time), entry->modified_fee - entry->fee});
+        }
+    }
     {
         LOCK(pool.cs);
         for (const auto &i : pool.mapDeltas) {
             mapDeltas[i.first] = i.second;
         }
-        vinfo = pool.infoAll();
         unbroadcast_txids = pool.GetUnbroadcastTxs();
     }
+    for (const auto& entry : txs) {
+        mapDeltas.erase(entry.tx->GetHash());
+    }
 
     auto mid = SteadyClock::now();
 
@@ -190,20 +425,22 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
             file.SetObfuscation({});
         }
 
-        uint64_t mempool_transactions_to_write(vinfo.size());
-        file << mempool_transactions_to_write;
-        LogInfo("Writing %u mempool transactions to file...\n", mempool_transactions_to_write);
-        for (const auto& i : vinfo) {
-            file << TX_WITH_WITNESS(*(i.tx));
-            file << int64_t{count_seconds(i.m_time)};
-            file << int64_t{i.nFeeDelta};
-            mapDeltas.erase(i.tx->GetHash());
+        LogInfo("Writing %u mempool transactions to file...\n", txs.size());
+        if (version == MEMPOOL_DUMP_VERSION) {
+            WriteTxRecords(file, txs);
+            WriteRecord(file, DumpRecord::DELTAS, mapDeltas);
+        } else {
+            file << uint64_t{txs.size()};
+            for (const auto& entry : txs) file << entry;
+            file << mapDeltas;
         }
 
-        file << mapDeltas;
-
         LogInfo("Writing %d unbroadcast transactions to file.\n", unbroadcast_txids.size());
-        file << unbroadcast_txids;
+        if (version == MEMPOOL_DUMP_VERSION) {
+            WriteRecord(file, DumpRecord::UNBROADCAST, unbroadcast_txids);
+        } else {
+            file << unbroadcast_txids;
+        }
 
         if (!skip_file_commit && !file.Commit()) {
             (void)file.fclose();
@@ -216,6 +453,7 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
         if (!RenameOver(dump_path + ".new", dump_path)) {
             throw std::runtime_error("Rename failed");
         }
+        ++g_dump_generation;
         auto last = SteadyClock::now();
 
         LogInfo("Dumped mempool: %.3fs to copy, %.3fs to dump, %d bytes dumped to file\n",
@@ -230,4 +468,141 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
     return true;
 }
 
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+{
+    LOCK(g_dump_mutex);
+    uint64_t sequence;
+    return DumpMempoolLocked(pool, dump_path, mockable_fopen_function, skip_file_commit, sequence);
+}
+
+/**
+ * Append transactions to the file written by the DumpMempool() call of
+ * @p generation in the current format, after discarding anything beyond
+ * @p valid_size (e.g. a record that was only partially written). Return the
+ * new size of the file, or nullopt if the file can't be appended to and needs
+ * to be rewritten, e.g. because it was replaced by another dump since.
+ */
+static std::optional<uint64_t> AppendMempool(const fs::path& dump_path, uint64_t generation, uint64_t valid_size, const std::vector<PersistedTx>& txs)
+{
+    LOCK(g_dump_mutex);
+    if (generation != g_dump_generation) return std::nullopt;
+
+    std::error_code ec;
+    const uintmax_t file_size{fs::file_size(dump_path, ec)};
+    if (ec || file_size < valid_size) return std::nullopt;
+
+    AutoFile file{fsbridge::fopen(dump_path, "r+b")};
+    if (file.IsNull()) return std::nullopt;
+
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != MEMPOOL_DUMP_VERSION) {
+            (void)file.fclose();
+            return std::nullopt;
+        }
+        Obfuscation obfuscation;
+        file >> obfuscation;
+        file.SetObfuscation(obfuscation);
+
+        file.seek(valid_size, SEEK_SET);
+        if (!file.Truncate(valid_size)) throw std::runtime_error("Truncate failed");
+        WriteTxRecords(file, txs);
+        const uint64_t new_size(file.tell());
+        if (!file.Commit()) throw std::runtime_error("Commit failed");
+        if (file.fclose() != 0) {
+            throw std::runtime_error(
+                strprintf("Error closing %s: %s", fs::PathToString(dump_path), SysErrorString(errno)));
+        }
+        return new_size;
+    } catch (const std::exception& e) {
+        LogInfo("Failed to append to mempool file: %s. Continuing anyway.\n", e.what());
+        (void)file.fclose();
+        return std::nullopt;
+    }
+}
+
+MempoolJournal::MempoolJournal(const CTxMemPool& pool, fs::path dump_path)
+    : m_pool{pool}, m_dump_path{std::move(dump_path)} {}
+
+void MempoolJournal::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
+{
+    // Transactions added while the file is being loaded are already in it.
+    if (!m_pool.GetLoadTried()) return;
+    LOCK(m_mutex);
+    // Notifications are delivered asynchronously, so this one may be for a
+    // transaction that the last rewrite already wrote.
+    if (mempool_sequence < m_dumped_sequence) return;
+    m_pending.emplace_back(tx.info.m_tx->GetHash(), mempool_sequence);
+    if (m_pending.size() > MAX_PENDING) {
+        // Falling this far behind is cheaper to handle with a rewrite.
+        m_pending.clear();
+        m_valid_size.reset();
+    }
+}
+
+bool MempoolJournal::Flush()
+{
+    if (!m_pool.GetLoadTried()) return true;
+
+    std::vector<std::pair<Txid, uint64_t>> pending;
+    std::optional<uint64_t> valid_size;
+    uint64_t generation;
+    size_t appended;
+    {
+        LOCK(m_mutex);
+        pending.swap(m_pending);
+        valid_size = m_valid_size;
+        generation = m_generation;
+        appended = m_appended;
+    }
+
+    if (valid_size && appended < m_pool.size()) {
+        std::vector<PersistedTx> txs;
+        txs.reserve(pending.size());
+        for (const auto& [txid, sequence] : pending) {
+            // Skip transactions that already left the mempool again.
+            const auto info{m_pool.info(txid)};
+            if (!info.tx) continue;
+            txs.push_back({info.tx, count_seconds(info.m_time), info.nFeeDelta});
+        }
+        if (txs.empty()) return true;
+        if (const auto new_size{AppendMempool(m_dump_path, generation, *valid_size, txs)}) {
+            LOCK(m_mutex);
+            // A concurrent TransactionAddedToMempool() may have invalidated the file.
+            if (m_valid_size) {
+                m_valid_size = new_size;
+                m_appended += txs.size();
+                LogDebug(BCLog::MEMPOOL, "Appended %u transactions to mempool file\n", txs.size());
+                return true;
+            }
+        }
+    }
+
+    // Rewrite the whole file, which also drops transactions that have left
+    // the mempool since they were appended. The pending transactions taken
+    // above were added before the snapshot that is written, and so are in it.
+    LOCK(g_dump_mutex);
+    uint64_t sequence;
+    std::error_code ec;
+    if (!DumpMempoolLocked(m_pool, m_dump_path, fsbridge::fopen, /*skip_file_commit=*/false, sequence)) {
+        WITH_LOCK(m_mutex, m_valid_size.reset());
+        return false;
+    }
+    const uintmax_t size{fs::file_size(m_dump_path, ec)};
+    LOCK(m_mutex);
+    // Transactions added while the dump was in progress are appended by the
+    // next call, unless the snapshot already contained them.
+    m_dumped_sequence = sequence;
+    std::erase_if(m_pending, [&](const auto& entry) { return entry.second < sequence; });
+    if (ec) {
+        m_valid_size.reset();
+        return false;
+    }
+    m_valid_size = size;
+    m_generation = g_dump_generation;
+    m_appended = 0;
+    return true;
+}
+
 } // namespace node
@@ -5,7 +5,16 @@
 #ifndef BITCOIN_NODE_MEMPOOL_PERSIST_H
 #define BITCOIN_NODE_MEMPOOL_PERSIST_H
 
+#include <primitives/transaction_identifier.h>
+#include <sync.h>
 #include <util/fs.h>
+#include <validationinterface.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
 
 class Chainstate;
 class CTxMemPool;
@@ -28,6 +37,48 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path,
                  Chainstate& active_chainstate,
                  ImportMempoolOptions&& opts);
 
+/**
+ * Keeps the mempool file up to date while the node is running, so that little
+ * is lost on an unclean shutdown.
+ *
+ * Transactions added to the mempool are buffered and appended to the file by
+ * Flush(), which is cheap compared to rewriting it. The file is rewritten
+ * instead on the first call, once the number of appended transactions
+ * exceeds the mempool size (most of them will have been evicted or mined
+ * by then), or when too many transactions are pending.
+ */
+class MempoolJournal final : public CValidationInterface
+{
+public:
+    MempoolJournal(const CTxMemPool& pool, fs::path dump_path);
+
+    /** Append pending transactions to the file, or rewrite it. */
+    bool Flush() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    static constexpr size_t MAX_PENDING{100'000};
+
+    const CTxMemPool& m_pool;
+    const fs::path m_dump_path;
+
+    Mutex m_mutex;
+    //! Transactions to append, with their mempool sequence.
+    std::vector<std::pair<Txid, uint64_t>> m_pending GUARDED_BY(m_mutex);
+    //! Size of the file as last written by us, unset if it must be rewritten.
+    std::optional<uint64_t> m_valid_size GUARDED_BY(m_mutex);
+    //! Dump that m_valid_size refers to. Appends fail once another
+    //! DumpMempool() call, e.g. from savemempool, replaced it.
+    uint64_t m_generation GUARDED_BY(m_mutex){0};
+    //! Mempool sequence of the snapshot last rewritten to the file.
+    uint64_t m_dumped_sequence GUARDED_BY(m_mutex){0};
+    //! Number of transactions appended since the file was last rewritten.
+    size_t m_appended GUARDED_BY(m_mutex){0};
+};
+
 } // namespace node
 
 
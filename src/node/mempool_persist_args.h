@@ -7,6 +7,8 @@
 
 #include <util/fs.h>
 
+#include <cstdint>
+
 class ArgsManager;
 
 namespace node {
@@ -16,6 +18,8 @@ namespace node {
  * automatically load the mempool on start and save to disk on shutdown
  */
 static constexpr bool DEFAULT_PERSIST_MEMPOOL{true};
+/** Default for -persistmempoolinterval, in seconds; 0 only saves on shutdown */
+static constexpr int64_t DEFAULT_PERSIST_MEMPOOL_INTERVAL{0};
 
 bool ShouldPersistMempool(const ArgsManager& argsman);
 fs::path MempoolPath(const ArgsManager& argsman);
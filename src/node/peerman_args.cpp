@@ -20,6 +20,10 @@ void ApplyArgsManOptions(const ArgsManager& argsman, PeerManager::Options& optio
         options.max_extra_txs = uint32_t((std::clamp<int64_t>(*value, 0, std::numeric_limits<uint32_t>::max())));
     }
 
+    options.block_serve_threads = std::clamp<int64_t>(argsman.GetIntArg("-blockservethreads", DEFAULT_BLOCK_SERVE_THREADS), 0, MAX_BLOCK_SERVE_THREADS);
+    options.block_reconstruction_threads = std::clamp<int64_t>(argsman.GetIntArg("-blockreconstructionthreads", DEFAULT_BLOCK_RECONSTRUCTION_THREADS), 0, MAX_BLOCK_RECONSTRUCTION_THREADS);
+    options.headers_sync_peers = std::clamp<int64_t>(argsman.GetIntArg("-headerssyncpeers", DEFAULT_HEADERS_SYNC_PEERS), 1, MAX_HEADERS_SYNC_PEERS);
+
     if (auto value{argsman.GetBoolArg("-capturemessages")}) options.capture_messages = *value;
 
     if (auto value{argsman.GetBoolArg("-blocksonly")}) options.ignore_incoming_txs = *value;
@@ -0,0 +1,82 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/response_cache.h>
+
+#include <chain.h>
+#include <primitives/block.h>
+
+#include <utility>
+#include <vector>
+
+namespace node {
+
+ResponseCache::ResponseCache(size_t max_size) : m_max_size{max_size} {}
+
+std::shared_ptr<const std::string> ResponseCache::Get(const std::string& key)
+{
+    LOCK(m_mutex);
+    const auto it{m_by_key.find(key)};
+    if (it == m_by_key.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->response;
+}
+
+void ResponseCache::Put(const uint256& block_hash, std::string key, std::string response)
+{
+    Entry entry{std::move(key), block_hash, std::make_shared<const std::string>(std::move(response))};
+    if (entry.Size() > MaxResponseSize()) return;
+
+    LOCK(m_mutex);
+    if (const auto it{m_by_key.find(entry.key)}; it != m_by_key.end()) {
+        Erase(it->second);
+    }
+    while (!m_entries.empty() && m_size + entry.Size() > m_max_size) {
+        Erase(std::prev(m_entries.end()));
+    }
+    m_size += entry.Size();
+    m_entries.push_front(std::move(entry));
+    m_by_key.emplace(m_entries.front().key, m_entries.begin());
+    m_by_block.emplace(block_hash, m_entries.begin());
+}
+
+ResponseCache::Stats ResponseCache::GetStats() const
+{
+    LOCK(m_mutex);
+    return {.hits = m_hits, .misses = m_misses, .entries = m_entries.size(), .size = m_size};
+}
+
+void ResponseCache::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    LOCK(m_mutex);
+    auto [begin, end]{m_by_block.equal_range(pindex->GetBlockHash())};
+    std::vector<EntryList::iterator> disconnected;
+    for (auto it{begin}; it != end; ++it) {
+        disconnected.push_back(it->second);
+    }
+    for (const auto& entry : disconnected) {
+        Erase(entry);
+    }
+}
+
+void ResponseCache::Erase(EntryList::iterator it)
+{
+    AssertLockHeld(m_mutex);
+    auto [begin, end]{m_by_block.equal_range(it->block_hash)};
+    for (auto by_block{begin}; by_block != end; ++by_block) {
+        if (by_block->second == it) {
+            m_by_block.erase(by_block);
+            break;
+        }
+    }
+    m_by_key.erase(it->key);
+    m_size -= it->Size();
+    m_entries.erase(it);
+}
+
+} // namespace node
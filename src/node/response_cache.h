@@ -0,0 +1,97 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_RESPONSE_CACHE_H
+#define BITCOIN_NODE_RESPONSE_CACHE_H
+
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+#include <validationinterface.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class CBlock;
+class CBlockIndex;
+
+namespace node {
+
+//! Default for -responsecache, in MiB
+static constexpr int64_t DEFAULT_RESPONSE_CACHE_SIZE{32};
+
+/**
+ * Size-bounded cache of serialized responses to RPC and REST requests for
+ * data that does not change once a block was mined, such as the JSON of a
+ * block, so that clients asking for the same blocks over and over do not have
+ * them read from disk and converted every time.
+ *
+ * Every entry belongs to a block, and is evicted when that block is
+ * disconnected from the active chain. Responses that also depend on the tip,
+ * such as ones with a number of confirmations, must include the tip's hash in
+ * their key. Beyond that, the least recently used entries are evicted to keep
+ * the size of the keys and responses within the limit.
+ */
+class ResponseCache final : public CValidationInterface
+{
+public:
+    struct Stats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        size_t entries{0};
+        size_t size{0};
+    };
+
+    explicit ResponseCache(size_t max_size);
+
+    /** Get the response for a key, counting a hit or a miss. */
+    std::shared_ptr<const std::string> Get(const std::string& key) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Add the response for a key, belonging to the block @p block_hash.
+     * Responses larger than a quarter of the cache are not added, so that a
+     * single one cannot evict everything else.
+     */
+    void Put(const uint256& block_hash, std::string key, std::string response) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    size_t MaxSize() const { return m_max_size; }
+    /** Size of the largest response that Put() adds. */
+    size_t MaxResponseSize() const { return m_max_size / 4; }
+
+protected:
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        std::string key;
+        uint256 block_hash;
+        std::shared_ptr<const std::string> response;
+
+        size_t Size() const { return key.size() + response->size(); }
+    };
+    using EntryList = std::list<Entry>;
+
+    const size_t m_max_size;
+
+    mutable Mutex m_mutex;
+    //! Entries from the most to the least recently used
+    EntryList m_entries GUARDED_BY(m_mutex);
+    std::unordered_map<std::string, EntryList::iterator> m_by_key GUARDED_BY(m_mutex);
+    std::unordered_multimap<uint256, EntryList::iterator, BlockHasher> m_by_block GUARDED_BY(m_mutex);
+    size_t m_size GUARDED_BY(m_mutex){0};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    uint64_t m_misses GUARDED_BY(m_mutex){0};
+
+    void Erase(EntryList::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_RESPONSE_CACHE_H
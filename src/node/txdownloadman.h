@@ -11,6 +11,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
 
 class CBlock;
 class CRollingBloomFilter;
@@ -146,6 +147,10 @@ public:
     /** Respond to successful transaction submission to mempool */
     void MempoolAcceptedTx(const CTransactionRef& tx);
 
+    /** Respond to successful submission of several transactions to mempool, e.g. a package. Orphans spending any of
+     * them are reconsidered in a single pass, after the transactions themselves have left the orphanage. */
+    void MempoolAcceptedTxs(std::span<const CTransactionRef> txns);
+
     /** Respond to transaction rejected from mempool */
     RejectedTxTodo MempoolRejectedTx(const CTransactionRef& ptx, const TxValidationState& state, NodeId nodeid, bool first_time_failure);
 
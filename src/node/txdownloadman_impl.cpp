@@ -55,6 +55,10 @@ void TxDownloadManager::MempoolAcceptedTx(const CTransactionRef& tx)
 {
     m_impl->MempoolAcceptedTx(tx);
 }
+void TxDownloadManager::MempoolAcceptedTxs(std::span<const CTransactionRef> txns)
+{
+    m_impl->MempoolAcceptedTxs(txns);
+}
 RejectedTxTodo TxDownloadManager::MempoolRejectedTx(const CTransactionRef& ptx, const TxValidationState& state, NodeId nodeid, bool first_time_failure)
 {
     return m_impl->MempoolRejectedTx(ptx, state, nodeid, first_time_failure);
@@ -98,6 +102,8 @@ void TxDownloadManagerImpl::ActiveTipChange()
 void TxDownloadManagerImpl::BlockConnected(const std::shared_ptr<const CBlock>& pblock)
 {
     m_orphanage->EraseForBlock(*pblock);
+    // Orphans whose missing parents were confirmed may be valid now.
+    m_orphanage->AddChildrenToWorkSet(pblock->vtx, m_opts.m_rng);
 
     for (const auto& ptx : pblock->vtx) {
         RecentConfirmedTransactionsFilter().insert(ptx->GetHash().ToUint256());
@@ -322,14 +328,22 @@ std::optional<PackageToValidate> TxDownloadManagerImpl::Find1P1CPackage(const CT
 
 void TxDownloadManagerImpl::MempoolAcceptedTx(const CTransactionRef& tx)
 {
-    // As this version of the transaction was acceptable, we can forget about any requests for it.
-    // No-op if the tx is not in txrequest.
-    m_txrequest.ForgetTxHash(tx->GetHash().ToUint256());
-    m_txrequest.ForgetTxHash(tx->GetWitnessHash().ToUint256());
+    MempoolAcceptedTxs({&tx, 1});
+}
+
+void TxDownloadManagerImpl::MempoolAcceptedTxs(std::span<const CTransactionRef> txns)
+{
+    for (const auto& tx : txns) {
+        // As this version of the transaction was acceptable, we can forget about any requests for it.
+        // No-op if the tx is not in txrequest.
+        m_txrequest.ForgetTxHash(tx->GetHash().ToUint256());
+        m_txrequest.ForgetTxHash(tx->GetWitnessHash().ToUint256());
 
-    m_orphanage->AddChildrenToWorkSet(*tx, m_opts.m_rng);
-    // If it came from the orphanage, remove it. No-op if the tx is not in txorphanage.
-    m_orphanage->EraseTx(tx->GetWitnessHash());
+        // If it came from the orphanage, remove it. No-op if the tx is not in txorphanage. Doing so first keeps
+        // accepted descendants within txns out of the work sets.
+        m_orphanage->EraseTx(tx->GetWitnessHash());
+    }
+    m_orphanage->AddChildrenToWorkSet(txns, m_opts.m_rng);
 }
 
 std::vector<Txid> TxDownloadManagerImpl::GetUniqueParents(const CTransaction& tx)
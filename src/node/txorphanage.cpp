@@ -17,9 +17,11 @@
 #include <boost/multi_index/tag.hpp>
 #include <boost/multi_index_container.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace node {
 /** Minimum NodeId for lower_bound lookups (in practice, NodeIds start at 0). */
@@ -50,9 +52,9 @@ class TxOrphanageImpl final : public TxOrphanage {
         { }
 
         /** Get an approximation for "memory usage". The total memory is a function of the memory used to store the
-         * transaction itself, each entry in m_orphans, and each entry in m_outpoint_to_orphan_wtxids. We use weight because
+         * transaction itself, each entry in m_orphans, and each entry in m_parent_to_orphan_spends. We use weight because
          * it is often higher than the actual memory usage of the transaction. This metric conveniently encompasses
-         * m_outpoint_to_orphan_wtxids usage since input data does not get the witness discount, and makes it easier to
+         * m_parent_to_orphan_spends usage since input data does not get the witness discount, and makes it easier to
          * reason about each peer's limits using well-understood transaction attributes. */
         TxOrphanage::Usage GetMemUsage()  const {
             return GetTransactionWeight(*m_tx);
@@ -60,7 +62,7 @@ class TxOrphanageImpl final : public TxOrphanage {
 
         /** Get an approximation of how much this transaction contributes to latency in EraseForBlock and EraseForPeer.
          * The computation time is a function of the number of entries in m_orphans (thus 1 per announcement) and the
-         * number of entries in m_outpoint_to_orphan_wtxids (thus an additional 1 for every 10 inputs). Transactions with a
+         * number of entries in m_parent_to_orphan_spends (thus an additional 1 for every 10 inputs). Transactions with a
          * small number of inputs (9 or fewer) are counted as 1 to make it easier to reason about each peer's limits in
          * terms of "normal" transactions. */
         TxOrphanage::Count GetLatencyScore() const {
@@ -115,12 +117,15 @@ class TxOrphanageImpl final : public TxOrphanage {
      * the number of entries in m_orphans. */
     TxOrphanage::Count m_unique_rounded_input_scores{0};
 
-    /** Index from the parents' outputs to wtxids that exist in m_orphans. Used to find children of
-     * a transaction that can be reconsidered and to remove entries that conflict with a block.*/
-    std::unordered_map<COutPoint, std::set<Wtxid>, SaltedOutpointHasher> m_outpoint_to_orphan_wtxids;
+    /** The outputs of one parent spent by orphans, as (output index, wtxid) pairs. */
+    using OrphanSpends = std::set<std::pair<uint32_t, Wtxid>>;
+    /** Index from the parents' txids to the outputs spent by wtxids that exist in m_orphans. Used to find children of
+     * a transaction that can be reconsidered or packaged with it, and to remove entries that conflict with a block.
+     * Keying by txid finds all children of a parent with a single lookup, however many outputs it has. */
+    std::unordered_map<Txid, OrphanSpends, SaltedTxidHasher> m_parent_to_orphan_spends;
 
     /** Set of Wtxids for which (exactly) one announcement with m_reconsider=true exists. */
-    std::set<Wtxid> m_reconsiderable_wtxids;
+    std::unordered_set<Wtxid, SaltedWtxidHasher> m_reconsiderable_wtxids;
 
     struct PeerDoSInfo {
         TxOrphanage::Usage m_total_usage{0};
@@ -187,6 +192,9 @@ class TxOrphanageImpl final : public TxOrphanage {
     /** Limit the orphanage to MaxGlobalLatencyScore and MaxGlobalUsage. */
     void LimitOrphans();
 
+    /** Add the children of tx to a work set, appending them to ret. */
+    void AddChildrenToWorkSetInternal(const CTransaction& tx, FastRandomContext& rng, std::vector<std::pair<Wtxid, NodeId>>& ret);
+
 public:
     TxOrphanageImpl() = default;
     TxOrphanageImpl(Count max_global_latency_score, Usage reserved_peer_usage) :
@@ -227,6 +235,7 @@ public:
     void EraseForPeer(NodeId peer) override;
     void EraseForBlock(const CBlock& block) override;
     std::vector<std::pair<Wtxid, NodeId>> AddChildrenToWorkSet(const CTransaction& tx, FastRandomContext& rng) override;
+    std::vector<std::pair<Wtxid, NodeId>> AddChildrenToWorkSet(std::span<const CTransactionRef> txns, FastRandomContext& rng) override;
     bool HaveTxToReconsider(NodeId peer) override;
     std::vector<CTransactionRef> GetChildrenFromSamePeer(const CTransactionRef& parent, NodeId nodeid) const override;
     std::vector<OrphanInfo> GetOrphanTransactions() const override;
@@ -250,15 +259,15 @@ void TxOrphanageImpl::Erase(Iter<Tag> it)
         m_unique_rounded_input_scores -= it->GetLatencyScore() - 1;
         m_unique_orphan_usage -= it->GetMemUsage();
 
-        // Remove references in m_outpoint_to_orphan_wtxids
+        // Remove references in m_parent_to_orphan_spends
         const auto& wtxid{it->m_tx->GetWitnessHash()};
         for (const auto& input : it->m_tx->vin) {
-            auto it_prev = m_outpoint_to_orphan_wtxids.find(input.prevout);
-            if (it_prev != m_outpoint_to_orphan_wtxids.end()) {
-                it_prev->second.erase(wtxid);
+            auto it_parent = m_parent_to_orphan_spends.find(input.prevout.hash);
+            if (it_parent != m_parent_to_orphan_spends.end()) {
+                it_parent->second.erase({input.prevout.n, wtxid});
                 // Clean up keys if they point to an empty set.
-                if (it_prev->second.empty()) {
-                    m_outpoint_to_orphan_wtxids.erase(it_prev);
+                if (it_parent->second.empty()) {
+                    m_parent_to_orphan_spends.erase(it_parent);
                 }
             }
         }
@@ -326,19 +335,19 @@ bool TxOrphanageImpl::AddTx(const CTransactionRef& tx, NodeId peer)
     auto& peer_info = m_peer_orphanage_info.try_emplace(peer).first->second;
     peer_info.Add(*iter);
 
-    // Add links in m_outpoint_to_orphan_wtxids
+    // Add links in m_parent_to_orphan_spends
     if (brand_new) {
         for (const auto& input : tx->vin) {
-            auto& wtxids_for_prevout = m_outpoint_to_orphan_wtxids.try_emplace(input.prevout).first->second;
-            wtxids_for_prevout.emplace(wtxid);
+            auto& spends_of_parent = m_parent_to_orphan_spends.try_emplace(input.prevout.hash).first->second;
+            spends_of_parent.emplace(input.prevout.n, wtxid);
         }
 
         m_unique_orphans += 1;
         m_unique_orphan_usage += iter->GetMemUsage();
         m_unique_rounded_input_scores += iter->GetLatencyScore() - 1;
 
-        LogDebug(BCLog::TXPACKAGES, "stored orphan tx %s (wtxid=%s), weight: %u (mapsz %u outsz %u)\n",
-                    txid.ToString(), wtxid.ToString(), sz, m_orphans.size(), m_outpoint_to_orphan_wtxids.size());
+        LogDebug(BCLog::TXPACKAGES, "stored orphan tx %s (wtxid=%s), weight: %u (mapsz %u parentsz %u)\n",
+                    txid.ToString(), wtxid.ToString(), sz, m_orphans.size(), m_parent_to_orphan_spends.size());
         Assume(IsUnique(iter));
     } else {
         LogDebug(BCLog::TXPACKAGES, "added peer=%d as announcer of orphan tx %s (wtxid=%s)\n",
@@ -421,7 +430,7 @@ void TxOrphanageImpl::EraseForPeer(NodeId peer)
 
     unsigned int num_ann{0};
     while (it != index_by_peer.end() && it->m_announcer == peer) {
-        // Delete item, cleaning up m_outpoint_to_orphan_wtxids iff this entry is unique by wtxid.
+        // Delete item, cleaning up m_parent_to_orphan_spends iff this entry is unique by wtxid.
         Erase<ByPeer>(it++);
         num_ann += 1;
     }
@@ -524,42 +533,58 @@ void TxOrphanageImpl::LimitOrphans()
     LogDebug(BCLog::TXPACKAGES, "orphanage overflow, removed %u tx (%u announcements)\n", original_unique_txns - remaining_unique_orphans, num_erased);
 }
 
+void TxOrphanageImpl::AddChildrenToWorkSetInternal(const CTransaction& tx, FastRandomContext& rng, std::vector<std::pair<Wtxid, NodeId>>& ret)
+{
+    const auto it_parent = m_parent_to_orphan_spends.find(tx.GetHash());
+    if (it_parent == m_parent_to_orphan_spends.end()) return;
+
+    auto& index_by_wtxid = m_orphans.get<ByWtxid>();
+    // Spends are sorted by output index, so children are visited in the order of the outputs they spend.
+    for (const auto& [output_index, wtxid] : it_parent->second) {
+        // Orphans spending outputs the transaction doesn't have are not its children.
+        if (output_index >= tx.vout.size()) break;
+
+        // If a reconsiderable announcement for this wtxid already exists, skip it.
+        if (m_reconsiderable_wtxids.contains(wtxid)) continue;
+
+        // Belt and suspenders, each entry in m_parent_to_orphan_spends should always have at least 1 announcement.
+        auto it = index_by_wtxid.lower_bound(ByWtxidView{wtxid, MIN_PEER});
+        if (!Assume(it != index_by_wtxid.end() && it->m_tx->GetWitnessHash() == wtxid)) continue;
+
+        // Select a random peer to assign orphan processing, reducing wasted work if the orphan is still missing
+        // inputs. However, we don't want to create an issue in which the assigned peer can purposefully stop us
+        // from processing the orphan by disconnecting.
+        auto it_end = index_by_wtxid.upper_bound(ByWtxidView{wtxid, MAX_PEER});
+        const auto num_announcers{std::distance(it, it_end)};
+        if (!Assume(num_announcers > 0)) continue;
+        std::advance(it, rng.randrange(num_announcers));
+
+        if (!Assume(it->m_tx->GetWitnessHash() == wtxid)) break;
+
+        // Mark this orphan as ready to be reconsidered.
+        static constexpr auto mark_reconsidered_modifier = [](auto& ann) { ann.m_reconsider = true; };
+        Assume(!it->m_reconsider);
+        index_by_wtxid.modify(it, mark_reconsidered_modifier);
+        ret.emplace_back(wtxid, it->m_announcer);
+        m_reconsiderable_wtxids.insert(wtxid);
+
+        LogDebug(BCLog::TXPACKAGES, "added %s (wtxid=%s) to peer %d workset\n",
+                    it->m_tx->GetHash().ToString(), it->m_tx->GetWitnessHash().ToString(), it->m_announcer);
+    }
+}
+
 std::vector<std::pair<Wtxid, NodeId>> TxOrphanageImpl::AddChildrenToWorkSet(const CTransaction& tx, FastRandomContext& rng)
 {
     std::vector<std::pair<Wtxid, NodeId>> ret;
-    auto& index_by_wtxid = m_orphans.get<ByWtxid>();
-    for (unsigned int i = 0; i < tx.vout.size(); i++) {
-        const auto it_by_prev = m_outpoint_to_orphan_wtxids.find(COutPoint(tx.GetHash(), i));
-        if (it_by_prev != m_outpoint_to_orphan_wtxids.end()) {
-            for (const auto& wtxid : it_by_prev->second) {
-                // If a reconsiderable announcement for this wtxid already exists, skip it.
-                if (m_reconsiderable_wtxids.contains(wtxid)) continue;
-
-                // Belt and suspenders, each entry in m_outpoint_to_orphan_wtxids should always have at least 1 announcement.
-                auto it = index_by_wtxid.lower_bound(ByWtxidView{wtxid, MIN_PEER});
-                if (!Assume(it != index_by_wtxid.end() && it->m_tx->GetWitnessHash() == wtxid)) continue;
-
-                // Select a random peer to assign orphan processing, reducing wasted work if the orphan is still missing
-                // inputs. However, we don't want to create an issue in which the assigned peer can purposefully stop us
-                // from processing the orphan by disconnecting.
-                auto it_end = index_by_wtxid.upper_bound(ByWtxidView{wtxid, MAX_PEER});
-                const auto num_announcers{std::distance(it, it_end)};
-                if (!Assume(num_announcers > 0)) continue;
-                std::advance(it, rng.randrange(num_announcers));
-
-                if (!Assume(it->m_tx->GetWitnessHash() == wtxid)) break;
-
-                // Mark this orphan as ready to be reconsidered.
-                static constexpr auto mark_reconsidered_modifier = [](auto& ann) { ann.m_reconsider = true; };
-                Assume(!it->m_reconsider);
-                index_by_wtxid.modify(it, mark_reconsidered_modifier);
-                ret.emplace_back(wtxid, it->m_announcer);
-                m_reconsiderable_wtxids.insert(wtxid);
-
-                LogDebug(BCLog::TXPACKAGES, "added %s (wtxid=%s) to peer %d workset\n",
-                            it->m_tx->GetHash().ToString(), it->m_tx->GetWitnessHash().ToString(), it->m_announcer);
-            }
-        }
+    AddChildrenToWorkSetInternal(tx, rng, ret);
+    return ret;
+}
+
+std::vector<std::pair<Wtxid, NodeId>> TxOrphanageImpl::AddChildrenToWorkSet(std::span<const CTransactionRef> txns, FastRandomContext& rng)
+{
+    std::vector<std::pair<Wtxid, NodeId>> ret;
+    for (const auto& ptx : txns) {
+        AddChildrenToWorkSetInternal(*ptx, rng, ret);
     }
     return ret;
 }
@@ -611,19 +636,23 @@ void TxOrphanageImpl::EraseForBlock(const CBlock& block)
 {
     if (m_orphans.empty()) return;
 
-    std::set<Wtxid> wtxids_to_erase;
+    std::vector<Wtxid> wtxids_to_erase;
     for (const CTransactionRef& ptx : block.vtx) {
         const CTransaction& block_tx = *ptx;
 
         // Which orphan pool entries must we evict?
         for (const auto& input : block_tx.vin) {
-            auto it_prev = m_outpoint_to_orphan_wtxids.find(input.prevout);
-            if (it_prev != m_outpoint_to_orphan_wtxids.end()) {
-                // Copy all wtxids to wtxids_to_erase.
-                std::copy(it_prev->second.cbegin(), it_prev->second.cend(), std::inserter(wtxids_to_erase, wtxids_to_erase.end()));
+            auto it_parent = m_parent_to_orphan_spends.find(input.prevout.hash);
+            if (it_parent == m_parent_to_orphan_spends.end()) continue;
+            // Copy the wtxids of all orphans spending this output to wtxids_to_erase.
+            for (auto it_spend = it_parent->second.lower_bound({input.prevout.n, Wtxid{}});
+                 it_spend != it_parent->second.end() && it_spend->first == input.prevout.n; ++it_spend) {
+                wtxids_to_erase.push_back(it_spend->second);
             }
         }
     }
+    std::sort(wtxids_to_erase.begin(), wtxids_to_erase.end());
+    wtxids_to_erase.erase(std::unique(wtxids_to_erase.begin(), wtxids_to_erase.end()), wtxids_to_erase.end());
 
     unsigned int num_erased{0};
     for (const auto& wtxid : wtxids_to_erase) {
@@ -645,26 +674,30 @@ void TxOrphanageImpl::EraseForBlock(const CBlock& block)
 std::vector<CTransactionRef> TxOrphanageImpl::GetChildrenFromSamePeer(const CTransactionRef& parent, NodeId peer) const
 {
     std::vector<CTransactionRef> children_found;
-    const auto& parent_txid{parent->GetHash()};
+    const auto it_parent = m_parent_to_orphan_spends.find(parent->GetHash());
+    if (it_parent == m_parent_to_orphan_spends.end()) return children_found;
+
+    // Look up this peer's announcement of each child through the parent index, so the cost does not depend on how
+    // many other orphans the peer has sent.
+    std::vector<const Announcement*> announcements;
+    const auto& index_by_wtxid = m_orphans.get<ByWtxid>();
+    for (const auto& [_, wtxid] : it_parent->second) {
+        const auto it = index_by_wtxid.find(ByWtxidView{wtxid, peer});
+        if (it != index_by_wtxid.end()) announcements.push_back(&*it);
+    }
 
-    // Iterate through all orphans from this peer, in reverse order, so that more recent
-    // transactions are added first. Doing so helps avoid work when one of the orphans replaced
-    // an earlier one. Since we require the NodeId to match, one peer's announcement order does
-    // not bias how we process other peer's orphans.
-    auto& index_by_peer = m_orphans.get<ByPeer>();
-    auto it_upper = index_by_peer.upper_bound(ByPeerView{peer, true, std::numeric_limits<uint64_t>::max()});
-    auto it_lower = index_by_peer.lower_bound(ByPeerView{peer, false, 0});
-
-    while (it_upper != it_lower) {
-        --it_upper;
-        if (!Assume(it_upper->m_announcer == peer)) break;
-        // Check if this tx spends from parent.
-        for (const auto& input : it_upper->m_tx->vin) {
-            if (input.prevout.hash == parent_txid) {
-                children_found.emplace_back(it_upper->m_tx);
-                break;
-            }
-        }
+    // Return reconsiderable announcements first, then from most recent to least recent, as the ByPeer index would.
+    // Doing so helps avoid work when one of the orphans replaced an earlier one. Since we require the NodeId to
+    // match, one peer's announcement order does not bias how we process other peer's orphans.
+    std::sort(announcements.begin(), announcements.end(), [](const Announcement* a, const Announcement* b) {
+        return std::tie(a->m_reconsider, a->m_entry_sequence) > std::tie(b->m_reconsider, b->m_entry_sequence);
+    });
+    // A child spending multiple outputs of the parent was found once per output.
+    announcements.erase(std::unique(announcements.begin(), announcements.end()), announcements.end());
+
+    children_found.reserve(announcements.size());
+    for (const Announcement* ann : announcements) {
+        children_found.emplace_back(ann->m_tx);
     }
     return children_found;
 }
@@ -696,12 +729,12 @@ void TxOrphanageImpl::SanityCheck() const
 {
     std::unordered_map<NodeId, PeerDoSInfo> reconstructed_peer_info;
     std::map<Wtxid, std::pair<TxOrphanage::Usage, TxOrphanage::Count>> unique_wtxids_to_scores;
-    std::set<COutPoint> all_outpoints;
+    std::set<std::pair<COutPoint, Wtxid>> all_spends;
     std::set<Wtxid> reconstructed_reconsiderable_wtxids;
 
     for (auto it = m_orphans.begin(); it != m_orphans.end(); ++it) {
         for (const auto& input : it->m_tx->vin) {
-            all_outpoints.insert(input.prevout);
+            all_spends.emplace(input.prevout, it->m_tx->GetWitnessHash());
         }
         unique_wtxids_to_scores.emplace(it->m_tx->GetWitnessHash(), std::make_pair(it->GetMemUsage(), it->GetLatencyScore() - 1));
 
@@ -722,18 +755,24 @@ void TxOrphanageImpl::SanityCheck() const
     assert(reconstructed_peer_info == m_peer_orphanage_info);
 
     // Recalculated set of reconsiderable wtxids must match.
-    assert(m_reconsiderable_wtxids == reconstructed_reconsiderable_wtxids);
-
-    // All outpoints exist in m_outpoint_to_orphan_wtxids, all keys in m_outpoint_to_orphan_wtxids correspond to some
-    // orphan, and all wtxids referenced in m_outpoint_to_orphan_wtxids are also in m_orphans.
-    // This ensures m_outpoint_to_orphan_wtxids is cleaned up.
-    assert(all_outpoints.size() == m_outpoint_to_orphan_wtxids.size());
-    for (const auto& [outpoint, wtxid_set] : m_outpoint_to_orphan_wtxids) {
-        assert(all_outpoints.contains(outpoint));
-        for (const auto& wtxid : wtxid_set) {
+    assert(m_reconsiderable_wtxids.size() == reconstructed_reconsiderable_wtxids.size());
+    for (const auto& wtxid : m_reconsiderable_wtxids) {
+        assert(reconstructed_reconsiderable_wtxids.contains(wtxid));
+    }
+
+    // All spends exist in m_parent_to_orphan_spends, and all spends in m_parent_to_orphan_spends correspond to an
+    // input of some orphan in m_orphans. No key points to an empty set.
+    // This ensures m_parent_to_orphan_spends is cleaned up.
+    size_t num_indexed_spends{0};
+    for (const auto& [txid, spends] : m_parent_to_orphan_spends) {
+        assert(!spends.empty());
+        for (const auto& [output_index, wtxid] : spends) {
+            assert(all_spends.contains({COutPoint{txid, output_index}, wtxid}));
             assert(unique_wtxids_to_scores.contains(wtxid));
         }
+        num_indexed_spends += spends.size();
     }
+    assert(num_indexed_spends == all_spends.size());
 
     // Cached m_unique_orphans value is correct.
     assert(m_orphans.size() >= m_unique_orphans);
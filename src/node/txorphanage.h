@@ -14,6 +14,7 @@
 
 #include <map>
 #include <set>
+#include <span>
 
 namespace node {
 /** Default value for TxOrphanage::m_reserved_usage_per_peer. Helps limit the total amount of memory used by the orphanage. */
@@ -91,6 +92,10 @@ public:
     /** Add any orphans that list a particular tx as a parent into the from peer's work set */
     virtual std::vector<std::pair<Wtxid, NodeId>> AddChildrenToWorkSet(const CTransaction& tx, FastRandomContext& rng) = 0;
 
+    /** Add any orphans that list one of these txns as a parent into the from peer's work set, e.g. for all
+     * transactions of an accepted package or block. Each orphan is added to a work set at most once. */
+    virtual std::vector<std::pair<Wtxid, NodeId>> AddChildrenToWorkSet(std::span<const CTransactionRef> txns, FastRandomContext& rng) = 0;
+
     /** Does this peer have any work to do? */
     virtual bool HaveTxToReconsider(NodeId peer) = 0;
 
@@ -5,9 +5,18 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
 #include <logging.h>
+#include <node/minisketchwrapper.h>
 #include <util/check.h>
 
+#include <minisketch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <set>
 #include <unordered_map>
 #include <variant>
 
@@ -29,6 +38,29 @@ uint256 ComputeSalt(uint64_t salt1, uint64_t salt2)
     return (HashWriter(RECON_SALT_HASHER) << std::min(salt1, salt2) << std::max(salt1, salt2)).GetSHA256();
 }
 
+/**
+ * Coefficient q estimating how much the sets differ beyond their size difference, see BIP-330.
+ * It is sent in REQRECON as a fixed-point number with Q_PRECISION.
+ */
+constexpr double RECON_Q{0.25};
+constexpr double MAX_RECON_Q{2};
+constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+/** Headroom added to the estimated sketch capacity, see BIP-330. */
+constexpr size_t RECON_CAPACITY_HEADROOM{1};
+/** Minisketch field size, equal to the short ID size. */
+constexpr size_t SKETCH_BITS{32};
+
+/** Where a peer is in a reconciliation round. */
+enum class ReconciliationPhase {
+    NONE,
+    /** We sent REQRECON and wait for SKETCH. */
+    INIT_REQUESTED,
+    /** The peer sent REQRECON; we owe it a SKETCH. */
+    REQUESTED,
+    /** We sent SKETCH and wait for RECONCILDIFF. */
+    RESPONDED,
+};
+
 /**
  * Keeps track of txreconciliation-related per-peer state.
  */
@@ -36,9 +68,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,16 +76,67 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions we will announce to the peer through the next reconciliation round. */
+    std::set<Wtxid> m_local_set;
+
+    /**
+     * The set being reconciled in the ongoing round, put aside when the round starts: as an
+     * initiator, when we send REQRECON, so that it matches the set size we sent; as a responder,
+     * when we send the sketch, until the initiator tells us which of its transactions it is
+     * missing.
+     */
+    std::set<Wtxid> m_local_set_snapshot;
+
+    ReconciliationPhase m_phase{ReconciliationPhase::NONE};
+
+    /** As a responder, the set size and q the initiator sent in REQRECON. */
+    uint16_t m_remote_set_size{0};
+    double m_remote_q{RECON_Q};
+
+    /** As an initiator, q as estimated from the previous reconciliation. */
+    double m_q{RECON_Q};
+
+    /** As an initiator, when the peer must have answered the ongoing round. */
+    std::chrono::microseconds m_response_deadline{0};
+
+    /**
+     * As an initiator, whether the last round expired before the peer's SKETCH arrived. The
+     * peer still owes us that SKETCH, and would take a new REQRECON as a protocol violation.
+     */
+    bool m_sketch_overdue{false};
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /** Short ID of a transaction as specified by BIP-330. */
+    uint32_t ComputeShortID(const Wtxid& wtxid) const
+    {
+        const uint64_t s{SipHashUint256(m_k0, m_k1, wtxid.ToUint256())};
+        return 1 + (s % 0xFFFFFFFF);
+    }
+
+    Minisketch ComputeSketch(const std::set<Wtxid>& set, size_t capacity) const
+    {
+        Minisketch sketch{node::MakeMinisketch32(capacity)};
+        for (const Wtxid& wtxid : set) sketch.Add(ComputeShortID(wtxid));
+        return sketch;
+    }
 };
 
+/**
+ * Sketch capacity the responder uses for a set difference estimated from both set sizes and q,
+ * see BIP-330.
+ */
+size_t EstimateSketchCapacity(size_t local_set_size, size_t remote_set_size, double q)
+{
+    const size_t set_size_diff{local_set_size > remote_set_size ? local_set_size - remote_set_size : remote_set_size - local_set_size};
+    const size_t capacity{set_size_diff + size_t(q * std::min(local_set_size, remote_set_size)) + RECON_CAPACITY_HEADROOM};
+    return std::min(capacity, MAX_SKETCH_CAPACITY);
+}
+
 } // namespace
 
 /** Actual implementation for TxReconciliationTracker's data structure. */
@@ -76,6 +156,32 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Registered peers we initiate reconciliations with, in the order we do so. */
+    std::deque<NodeId> m_queue GUARDED_BY(m_txreconciliation_mutex);
+    /** When the peer at the front of m_queue is next due. */
+    std::chrono::microseconds m_next_recon_request GUARDED_BY(m_txreconciliation_mutex){0};
+
+    /** Number of registered peers we initiate reconciliations with (outbound), and of those we respond to. */
+    size_t m_initiator_peers GUARDED_BY(m_txreconciliation_mutex){0};
+    size_t m_responder_peers GUARDED_BY(m_txreconciliation_mutex){0};
+
+    /** Salt for choosing the peers a transaction is flooded to. */
+    const uint64_t m_fanout_k0{FastRandomContext().rand64()};
+    const uint64_t m_fanout_k1{FastRandomContext().rand64()};
+
+    TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
+    const TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) const EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        return const_cast<Impl*>(this)->GetRegisteredPeerState(peer_id);
+    }
+
 public:
     explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
 
@@ -122,6 +228,12 @@ public:
 
         const uint256 full_salt{ComputeSalt(local_salt, remote_salt)};
         recon_state->second = TxReconciliationState(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        if (is_peer_inbound) {
+            ++m_responder_peers;
+        } else {
+            ++m_initiator_peers;
+            m_queue.push_back(peer_id);
+        }
         return ReconciliationRegisterResult::SUCCESS;
     }
 
@@ -129,6 +241,14 @@ public:
     {
         AssertLockNotHeld(m_txreconciliation_mutex);
         LOCK(m_txreconciliation_mutex);
+        if (const auto* state{GetRegisteredPeerState(peer_id)}) {
+            if (state->m_we_initiate) {
+                --m_initiator_peers;
+                m_queue.erase(std::find(m_queue.begin(), m_queue.end(), peer_id));
+            } else {
+                --m_responder_peers;
+            }
+        }
         if (m_states.erase(peer_id)) {
             LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Forget txreconciliation state of peer=%d\n", peer_id);
         }
@@ -138,9 +258,197 @@ public:
     {
         AssertLockNotHeld(m_txreconciliation_mutex);
         LOCK(m_txreconciliation_mutex);
-        auto recon_state = m_states.find(peer_id);
-        return (recon_state != m_states.end() &&
-                std::holds_alternative<TxReconciliationState>(recon_state->second));
+        return GetRegisteredPeerState(peer_id) != nullptr;
+    }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_sketch_overdue || state->m_local_set.size() >= MAX_RECONSET_SIZE) return false;
+        state->m_local_set.insert(wtxid);
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        return state && state->m_local_set.erase(wtxid) > 0;
+    }
+
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        const auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state) return true;
+
+        // Flood to each peer with probability destinations / peers, decided by a salted hash of the
+        // transaction and the peer. Keeping the choice per transaction stateless avoids tracking
+        // it, at the cost of the number of destinations only being right on average.
+        const double destinations{state->m_we_initiate ? OUTBOUND_FANOUT_DESTINATIONS :
+                                                         INBOUND_FANOUT_DESTINATIONS_FRACTION * m_responder_peers};
+        const size_t peers{state->m_we_initiate ? m_initiator_peers : m_responder_peers};
+        const uint64_t h{SipHashUint256Extra(m_fanout_k0, m_fanout_k1, wtxid.ToUint256(), uint32_t(peer_id))};
+        return double(h) < std::ldexp(destinations / peers, 64);
+    }
+
+    bool IsPeerNextToReconcileWith(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        if (m_queue.empty() || m_queue.front() != peer_id || now < m_next_recon_request) return false;
+
+        m_queue.pop_front();
+        m_queue.push_back(peer_id);
+        m_next_recon_request = now + std::chrono::duration_cast<std::chrono::microseconds>(RECON_REQUEST_INTERVAL) / m_queue.size();
+        return true;
+    }
+
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || !state->m_we_initiate || state->m_phase != ReconciliationPhase::NONE || state->m_sketch_overdue) return std::nullopt;
+
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Initiate reconciliation with peer=%d (local set size=%d)\n",
+                      peer_id, state->m_local_set.size());
+        state->m_local_set_snapshot = std::move(state->m_local_set);
+        state->m_local_set.clear();
+        state->m_phase = ReconciliationPhase::INIT_REQUESTED;
+        state->m_response_deadline = now + RECON_RESPONSE_TIMEOUT;
+        const uint16_t set_size(std::min<size_t>(state->m_local_set_snapshot.size(), std::numeric_limits<uint16_t>::max()));
+        const uint16_t q(state->m_q * Q_PRECISION);
+        return std::make_pair(set_size, q);
+    }
+
+    std::vector<Wtxid> ExpireReconciliationRequest(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_phase != ReconciliationPhase::INIT_REQUESTED || now < state->m_response_deadline) return {};
+
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d timed out (to announce=%d)\n",
+                      peer_id, state->m_local_set_snapshot.size());
+        std::vector<Wtxid> announce(state->m_local_set_snapshot.begin(), state->m_local_set_snapshot.end());
+        state->m_local_set_snapshot.clear();
+        state->m_phase = ReconciliationPhase::NONE;
+        state->m_sketch_overdue = true;
+        return announce;
+    }
+
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_we_initiate || state->m_phase != ReconciliationPhase::NONE) return false;
+
+        state->m_phase = ReconciliationPhase::REQUESTED;
+        state->m_remote_set_size = peer_recon_set_size;
+        state->m_remote_q = double(peer_q) / Q_PRECISION;
+        return true;
+    }
+
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_phase != ReconciliationPhase::REQUESTED) return std::nullopt;
+
+        const size_t capacity{EstimateSketchCapacity(state->m_local_set.size(), state->m_remote_set_size, state->m_remote_q)};
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Send sketch to peer=%d (local set size=%d, capacity=%d)\n",
+                      peer_id, state->m_local_set.size(), capacity);
+        std::vector<uint8_t> skdata{state->ComputeSketch(state->m_local_set, capacity).Serialize()};
+        state->m_local_set_snapshot = std::move(state->m_local_set);
+        state->m_local_set.clear();
+        state->m_phase = ReconciliationPhase::RESPONDED;
+        return skdata;
+    }
+
+    std::optional<TxReconciliationTracker::ReconciliationDiff> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || !state->m_we_initiate) return std::nullopt;
+        if (state->m_phase != ReconciliationPhase::INIT_REQUESTED && !state->m_sketch_overdue) return std::nullopt;
+        const size_t capacity{skdata.size() * 8 / SKETCH_BITS};
+        if (skdata.size() * 8 % SKETCH_BITS != 0 || capacity > MAX_SKETCH_CAPACITY) return std::nullopt;
+
+        if (state->m_sketch_overdue) {
+            // We announced our set when the round expired. Failing the round makes the peer
+            // announce its set too, after which both can start new rounds.
+            LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Late sketch from peer=%d, failing the expired round\n", peer_id);
+            state->m_sketch_overdue = false;
+            return TxReconciliationTracker::ReconciliationDiff{.success = false, .ask_shortids = {}, .announce = {}};
+        }
+
+        state->m_phase = ReconciliationPhase::NONE;
+        TxReconciliationTracker::ReconciliationDiff diff;
+        std::optional<std::vector<uint64_t>> differences;
+        if (capacity > 0) {
+            Minisketch sketch{state->ComputeSketch(state->m_local_set_snapshot, capacity)};
+            sketch.Merge(node::MakeMinisketch32(capacity).Deserialize(skdata));
+            differences = sketch.Decode(capacity);
+        }
+        diff.success = differences.has_value();
+
+        if (diff.success) {
+            std::unordered_map<uint32_t, Wtxid> local_shortids;
+            for (const Wtxid& wtxid : state->m_local_set_snapshot) local_shortids.emplace(state->ComputeShortID(wtxid), wtxid);
+            for (const uint64_t shortid : *differences) {
+                if (const auto it{local_shortids.find(shortid)}; it != local_shortids.end()) {
+                    diff.announce.push_back(it->second);
+                } else {
+                    diff.ask_shortids.push_back(shortid);
+                }
+            }
+            // Estimate q for the next round from the part of the difference not explained by the set
+            // sizes. The peer's set size follows from ours and the difference.
+            const size_t remote_set_size{state->m_local_set_snapshot.size() - diff.announce.size() + diff.ask_shortids.size()};
+            const size_t min_set_size{std::min(state->m_local_set_snapshot.size(), remote_set_size)};
+            if (min_set_size > 0) {
+                state->m_q = std::clamp(2.0 * std::min(diff.announce.size(), diff.ask_shortids.size()) / min_set_size, RECON_Q, MAX_RECON_Q);
+            }
+        } else {
+            diff.announce.assign(state->m_local_set_snapshot.begin(), state->m_local_set_snapshot.end());
+            // A failure costs announcing both sets in full, while a larger sketch costs 4 bytes
+            // per element, so err on the large side next time.
+            state->m_q = MAX_RECON_Q;
+        }
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d %s (capacity=%d, to announce=%d, to request=%d)\n",
+                      peer_id, diff.success ? "succeeded" : "failed", capacity, diff.announce.size(), diff.ask_shortids.size());
+        state->m_local_set_snapshot.clear();
+        return diff;
+    }
+
+    std::optional<std::vector<Wtxid>> HandleReconcilDiff(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredPeerState(peer_id)};
+        if (!state || state->m_we_initiate || state->m_phase != ReconciliationPhase::RESPONDED) return std::nullopt;
+
+        std::vector<Wtxid> announce;
+        if (success) {
+            std::unordered_map<uint32_t, Wtxid> local_shortids;
+            for (const Wtxid& wtxid : state->m_local_set_snapshot) local_shortids.emplace(state->ComputeShortID(wtxid), wtxid);
+            for (const uint32_t shortid : ask_shortids) {
+                if (const auto it{local_shortids.find(shortid)}; it != local_shortids.end()) announce.push_back(it->second);
+            }
+        } else {
+            announce.assign(state->m_local_set_snapshot.begin(), state->m_local_set_snapshot.end());
+        }
+        state->m_local_set_snapshot.clear();
+        state->m_phase = ReconciliationPhase::NONE;
+        return announce;
     }
 };
 
@@ -168,3 +476,53 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const
+{
+    return m_impl->ShouldFanoutTo(wtxid, peer_id);
+}
+
+bool TxReconciliationTracker::IsPeerNextToReconcileWith(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->IsPeerNextToReconcileWith(peer_id, now);
+}
+
+std::optional<std::pair<uint16_t, uint16_t>> TxReconciliationTracker::InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->InitiateReconciliationRequest(peer_id, now);
+}
+
+std::vector<Wtxid> TxReconciliationTracker::ExpireReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->ExpireReconciliationRequest(peer_id, now);
+}
+
+bool TxReconciliationTracker::HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q)
+{
+    return m_impl->HandleReconciliationRequest(peer_id, peer_recon_set_size, peer_q);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::RespondToReconciliationRequest(NodeId peer_id)
+{
+    return m_impl->RespondToReconciliationRequest(peer_id);
+}
+
+std::optional<TxReconciliationTracker::ReconciliationDiff> TxReconciliationTracker::HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata)
+{
+    return m_impl->HandleSketch(peer_id, skdata);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::HandleReconcilDiff(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids)
+{
+    return m_impl->HandleReconcilDiff(peer_id, success, ask_shortids);
+}
@@ -6,14 +6,43 @@
 #define BITCOIN_NODE_TXRECONCILIATION_H
 
 #include <net.h>
+#include <primitives/transaction_identifier.h>
 #include <sync.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
 
+/**
+ * Maximum number of transactions waiting to be reconciled with a peer. Transactions which do not
+ * fit are announced to the peer via INV instead.
+ */
+static constexpr size_t MAX_RECONSET_SIZE{3000};
+/** Interval between the reconciliations we initiate with each of our outbound peers, see BIP-330. */
+static constexpr std::chrono::seconds RECON_REQUEST_INTERVAL{8};
+/**
+ * Time a peer has to answer our REQRECON with a SKETCH. Peers answer along with their next
+ * transaction announcements to us, which an inbound peer sends every 5 seconds on average.
+ */
+static constexpr std::chrono::seconds RECON_RESPONSE_TIMEOUT{30};
+/**
+ * Number of our outbound reconciling peers, and fraction of our inbound reconciling peers, a
+ * new transaction is flooded to (on average). The remaining reconciling peers learn about it
+ * through reconciliation.
+ */
+static constexpr double OUTBOUND_FANOUT_DESTINATIONS{1};
+static constexpr double INBOUND_FANOUT_DESTINATIONS_FRACTION{0.1};
+/** Largest sketch capacity we produce or accept. */
+static constexpr size_t MAX_SKETCH_CAPACITY{2 << 12};
+
 enum class ReconciliationRegisterResult {
     NOT_FOUND,
     SUCCESS,
@@ -84,6 +113,85 @@ public:
      * Check if a peer is registered to reconcile transactions with us.
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Add a new transaction to the set we will reconcile with the peer. Returns false if
+     * the peer is not registered, its set is full, or it has not answered our last request in
+     * time, in which case the transaction should be announced via INV.
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the set we will reconcile with the peer, e.g. because the peer
+     * announced it to us. Returns whether it was there.
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Whether a transaction should be flooded to the peer via INV rather than reconciled. Always
+     * true for peers we do not reconcile with. Otherwise, the choice is deterministic per
+     * transaction and peer, and selects OUTBOUND_FANOUT_DESTINATIONS of the outbound and
+     * INBOUND_FANOUT_DESTINATIONS_FRACTION of the inbound reconciling peers on average.
+     */
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) const;
+
+    /**
+     * Step 2. Whether it is time to request a sketch from the peer. We reconcile with the
+     * outbound peers in turn, with each of them once per RECON_REQUEST_INTERVAL.
+     */
+    bool IsPeerNextToReconcileWith(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. Start a reconciliation round with a peer we initiate reconciliations with. Returns
+     * the size of our set and the q parameter to send in REQRECON, or std::nullopt if the peer
+     * is not registered, is not ours to initiate with, a round is already ongoing, or the peer
+     * has not answered the last one. The set is put aside for the round, and transactions added
+     * from now on are left for the next round.
+     */
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. If the peer did not answer the round we initiated within RECON_RESPONSE_TIMEOUT,
+     * end the round and return the set put aside for it, to announce via INV. Until the peer's
+     * SKETCH arrives, no new round is started and new transactions are announced via INV.
+     */
+    std::vector<Wtxid> ExpireReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. Record a REQRECON received from the peer. Returns false if it violates the
+     * protocol (we are the initiator, or the previous round did not complete).
+     */
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q);
+
+    /**
+     * Step 2. If the peer requested a sketch, return the sketch of our set to send in SKETCH.
+     * The set is put aside until the peer tells us the result in RECONCILDIFF, and
+     * transactions added from now on are left for the next round.
+     */
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id);
+
+    struct ReconciliationDiff {
+        /** Whether the sketches could be decoded into the difference of the sets. */
+        bool success;
+        /** Short IDs of the transactions only the peer has, to ask for in RECONCILDIFF. */
+        std::vector<uint32_t> ask_shortids;
+        /** Transactions only we have (all of our set on failure), to announce via INV. */
+        std::vector<Wtxid> announce;
+    };
+
+    /**
+     * Step 3. Combine the peer's sketch with ours and find the difference of the sets. Returns
+     * std::nullopt if the sketch is malformed or was not requested. A sketch for a round that
+     * expired is answered as a failed reconciliation, with nothing left to announce.
+     */
+    std::optional<ReconciliationDiff> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata);
+
+    /**
+     * Step 4. Handle the RECONCILDIFF concluding a round we responded to. Returns the
+     * transactions to announce to the peer via INV (those it asked for, or the whole set on
+     * failure), or std::nullopt if the message was not expected.
+     */
+    std::optional<std::vector<Wtxid>> HandleReconcilDiff(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids);
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
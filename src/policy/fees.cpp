@@ -29,6 +29,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <stdexcept>
 #include <utility>
 
@@ -74,26 +75,38 @@ struct EncodedDoubleFormatter
  *
  * The tracking of unconfirmed (mempool) transactions is completely independent of the
  * historical tracking of transactions that have been confirmed in a block.
+ *
+ * All historical counters are exponential moving averages, decayed once per
+ * block. Instead of multiplying every counter by the decay on each block,
+ * counters are stored in units that grow by 1 / decay per block (m_unit), so
+ * that decaying is O(1) and only the counters touched by a transaction are
+ * updated. The stored counters are rescaled only once m_unit gets large.
+ * Confirmation and failure counts are stored per period rather than
+ * cumulatively, so that recording a transaction touches a single counter;
+ * EstimateMedianVal() sums them up as needed.
  */
 class TxConfirmStats
 {
 private:
     //Define the buckets we will group transactions into
     const std::vector<double>& buckets;              // The upper-bound of the range for the bucket (inclusive)
-    const std::map<double, unsigned int>& bucketMap; // Map of bucket upper-bound to index into all vectors by bucket
+
+    // Value of a single data point in the units the counters below are stored in
+    double m_unit{1};
 
     // For each bucket X:
     // Count the total # of txs in each bucket
     // Track the historical moving average of this total over blocks
     std::vector<double> txCtAvg;
 
-    // Count the total # of txs confirmed within Y blocks in each bucket
+    // Count the total # of txs confirmed within exactly Y periods in each bucket
     // Track the historical moving average of these totals over blocks
-    std::vector<std::vector<double>> confAvg; // confAvg[Y][X]
+    std::vector<double> m_conf; // m_conf[Y * buckets.size() + X]
 
     // Track moving avg of txs which have been evicted from the mempool
-    // after failing to be confirmed within Y blocks
-    std::vector<std::vector<double>> failAvg; // failAvg[Y][X]
+    // after failing to be confirmed within exactly Y periods (or more, for
+    // the last period)
+    std::vector<double> m_fail; // m_fail[Y * buckets.size() + X]
 
     // Sum the total feerate of all tx's in each bucket
     // Track the historical moving average of this total over blocks
@@ -107,15 +120,26 @@ private:
     // Resolution (# of blocks) with which confirmations are tracked
     unsigned int scale;
 
+    // Number of periods confirmations are tracked for
+    unsigned int m_periods;
+
     // Mempool counts of outstanding transactions
     // For each bucket X, track the number of transactions in the mempool
     // that are unconfirmed for each possible confirmation value Y
-    std::vector<std::vector<int> > unconfTxs;  //unconfTxs[Y][X]
+    std::vector<int> unconfTxs;  //unconfTxs[Y * buckets.size() + X]
     // transactions still unconfirmed after GetMaxConfirms for each bucket
     std::vector<int> oldUnconfTxs;
 
     void resizeInMemoryCounters(size_t newbuckets);
 
+    /** Divide all stored counters by m_unit and reset it to 1. */
+    void Rescale();
+
+    /** Moving average of txs confirmed within periodTarget periods. */
+    double ConfirmedWithin(unsigned int periodTarget, unsigned int bucket) const;
+    /** Moving average of txs that left the mempool unconfirmed after at least periodTarget periods. */
+    double FailedAfter(unsigned int periodTarget, unsigned int bucket) const;
+
 public:
     /**
      * Create new TxConfirmStats. This is called by BlockPolicyEstimator's
@@ -124,9 +148,12 @@ public:
      * @param maxPeriods max number of periods to track
      * @param decay how much to decay the historical moving average per block
      */
-    TxConfirmStats(const std::vector<double>& defaultBuckets, const std::map<double, unsigned int>& defaultBucketMap,
+    TxConfirmStats(const std::vector<double>& defaultBuckets,
                    unsigned int maxPeriods, double decay, unsigned int scale);
 
+    /** Index of the bucket a feerate falls into */
+    unsigned int BucketIndex(double feerate) const;
+
     /** Roll the circular buffer for unconfirmed txs*/
     void ClearCurrent(unsigned int nBlockHeight);
 
@@ -163,7 +190,7 @@ public:
                              EstimationResult *result = nullptr) const;
 
     /** Return the max number of confirms we're tracking */
-    unsigned int GetMaxConfirms() const { return scale * confAvg.size(); }
+    unsigned int GetMaxConfirms() const { return scale * m_periods; }
 
     /** Write state of estimation data to a file*/
     void Write(AutoFile& fileout) const;
@@ -177,17 +204,12 @@ public:
 
 
 TxConfirmStats::TxConfirmStats(const std::vector<double>& defaultBuckets,
-                                const std::map<double, unsigned int>& defaultBucketMap,
                                unsigned int maxPeriods, double _decay, unsigned int _scale)
-    : buckets(defaultBuckets), bucketMap(defaultBucketMap), decay(_decay), scale(_scale)
+    : buckets(defaultBuckets), decay(_decay), scale(_scale), m_periods(maxPeriods)
 {
     assert(_scale != 0 && "_scale must be non-zero");
-    confAvg.resize(maxPeriods);
-    failAvg.resize(maxPeriods);
-    for (unsigned int i = 0; i < maxPeriods; i++) {
-        confAvg[i].resize(buckets.size());
-        failAvg[i].resize(buckets.size());
-    }
+    m_conf.resize(size_t{maxPeriods} * buckets.size());
+    m_fail.resize(size_t{maxPeriods} * buckets.size());
 
     txCtAvg.resize(buckets.size());
     m_feerate_avg.resize(buckets.size());
@@ -197,19 +219,24 @@ TxConfirmStats::TxConfirmStats(const std::vector<double>& defaultBuckets,
 
 void TxConfirmStats::resizeInMemoryCounters(size_t newbuckets) {
     // newbuckets must be passed in because the buckets referred to during Read have not been updated yet.
-    unconfTxs.resize(GetMaxConfirms());
-    for (unsigned int i = 0; i < unconfTxs.size(); i++) {
-        unconfTxs[i].resize(newbuckets);
-    }
-    oldUnconfTxs.resize(newbuckets);
+    unconfTxs.assign(GetMaxConfirms() * newbuckets, 0);
+    oldUnconfTxs.assign(newbuckets, 0);
+}
+
+unsigned int TxConfirmStats::BucketIndex(double feerate) const
+{
+    // The last bucket is unbounded, so everything above the highest boundary goes there.
+    const auto it{std::lower_bound(buckets.begin(), buckets.end() - 1, feerate)};
+    return it - buckets.begin();
 }
 
 // Roll the unconfirmed txs circular buffer
 void TxConfirmStats::ClearCurrent(unsigned int nBlockHeight)
 {
+    const size_t offset{(nBlockHeight % GetMaxConfirms()) * buckets.size()};
     for (unsigned int j = 0; j < buckets.size(); j++) {
-        oldUnconfTxs[j] += unconfTxs[nBlockHeight % unconfTxs.size()][j];
-        unconfTxs[nBlockHeight%unconfTxs.size()][j] = 0;
+        oldUnconfTxs[j] += unconfTxs[offset + j];
+        unconfTxs[offset + j] = 0;
     }
 }
 
@@ -219,26 +246,51 @@ void TxConfirmStats::Record(int blocksToConfirm, double feerate)
     // blocksToConfirm is 1-based
     if (blocksToConfirm < 1)
         return;
-    int periodsToConfirm = (blocksToConfirm + scale - 1) / scale;
-    unsigned int bucketindex = bucketMap.lower_bound(feerate)->second;
-    for (size_t i = periodsToConfirm; i <= confAvg.size(); i++) {
-        confAvg[i - 1][bucketindex]++;
+    unsigned int periodsToConfirm = (blocksToConfirm + scale - 1) / scale;
+    unsigned int bucketindex = BucketIndex(feerate);
+    if (periodsToConfirm <= m_periods) {
+        m_conf[(periodsToConfirm - 1) * buckets.size() + bucketindex] += m_unit;
     }
-    txCtAvg[bucketindex]++;
-    m_feerate_avg[bucketindex] += feerate;
+    txCtAvg[bucketindex] += m_unit;
+    m_feerate_avg[bucketindex] += feerate * m_unit;
 }
 
 void TxConfirmStats::UpdateMovingAverages()
 {
-    assert(confAvg.size() == failAvg.size());
-    for (unsigned int j = 0; j < buckets.size(); j++) {
-        for (unsigned int i = 0; i < confAvg.size(); i++) {
-            confAvg[i][j] *= decay;
-            failAvg[i][j] *= decay;
-        }
-        m_feerate_avg[j] *= decay;
-        txCtAvg[j] *= decay;
+    m_unit /= decay;
+    // Keep well clear of the range of doubles; this only happens every few
+    // thousand blocks even for the shortest half-life.
+    if (m_unit > 1e64) Rescale();
+}
+
+void TxConfirmStats::Rescale()
+{
+    const auto rescale{[&](std::vector<double>& counters) {
+        for (double& counter : counters) counter /= m_unit;
+    }};
+    rescale(txCtAvg);
+    rescale(m_feerate_avg);
+    rescale(m_conf);
+    rescale(m_fail);
+    m_unit = 1;
+}
+
+double TxConfirmStats::ConfirmedWithin(unsigned int periodTarget, unsigned int bucket) const
+{
+    double sum{0};
+    for (unsigned int i = 0; i < periodTarget; i++) {
+        sum += m_conf[i * buckets.size() + bucket];
+    }
+    return sum / m_unit;
+}
+
+double TxConfirmStats::FailedAfter(unsigned int periodTarget, unsigned int bucket) const
+{
+    double sum{0};
+    for (unsigned int i = periodTarget - 1; i < m_periods; i++) {
+        sum += m_fail[i * buckets.size() + bucket];
     }
+    return sum / m_unit;
 }
 
 // returns -1 on error conditions
@@ -270,7 +322,7 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
     double partialNum = 0;
 
     bool foundAnswer = false;
-    unsigned int bins = unconfTxs.size();
+    unsigned int bins = GetMaxConfirms();
     bool newBucketRange = true;
     bool passing = true;
     EstimatorBucket passBucket;
@@ -283,12 +335,12 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
             newBucketRange = false;
         }
         curFarBucket = bucket;
-        nConf += confAvg[periodTarget - 1][bucket];
-        partialNum += txCtAvg[bucket];
-        totalNum += txCtAvg[bucket];
-        failNum += failAvg[periodTarget - 1][bucket];
+        nConf += ConfirmedWithin(periodTarget, bucket);
+        partialNum += txCtAvg[bucket] / m_unit;
+        totalNum += txCtAvg[bucket] / m_unit;
+        failNum += FailedAfter(periodTarget, bucket);
         for (unsigned int confct = confTarget; confct < GetMaxConfirms(); confct++)
-            extraNum += unconfTxs[(nBlockHeight - confct) % bins][bucket];
+            extraNum += unconfTxs[((nBlockHeight - confct) % bins) * buckets.size() + bucket];
         extraNum += oldUnconfTxs[bucket];
         // If we have enough transaction data points in this range of buckets,
         // we can test for success
@@ -410,18 +462,34 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
 
 void TxConfirmStats::Write(AutoFile& fileout) const
 {
+    // The file format stores plain, cumulative moving averages.
+    const size_t num_buckets{buckets.size()};
+    std::vector<double> feerate_avg(num_buckets), tx_ct_avg(num_buckets);
+    for (size_t j = 0; j < num_buckets; j++) {
+        feerate_avg[j] = m_feerate_avg[j] / m_unit;
+        tx_ct_avg[j] = txCtAvg[j] / m_unit;
+    }
+    std::vector<std::vector<double>> conf_avg(m_periods, std::vector<double>(num_buckets));
+    std::vector<std::vector<double>> fail_avg(m_periods, std::vector<double>(num_buckets));
+    for (unsigned int i = 0; i < m_periods; i++) {
+        for (size_t j = 0; j < num_buckets; j++) {
+            conf_avg[i][j] = ConfirmedWithin(i + 1, j);
+            fail_avg[i][j] = FailedAfter(i + 1, j);
+        }
+    }
+
     fileout << Using<EncodedDoubleFormatter>(decay);
     fileout << scale;
-    fileout << Using<VectorFormatter<EncodedDoubleFormatter>>(m_feerate_avg);
-    fileout << Using<VectorFormatter<EncodedDoubleFormatter>>(txCtAvg);
-    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(confAvg);
-    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(failAvg);
+    fileout << Using<VectorFormatter<EncodedDoubleFormatter>>(feerate_avg);
+    fileout << Using<VectorFormatter<EncodedDoubleFormatter>>(tx_ct_avg);
+    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(conf_avg);
+    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(fail_avg);
 }
 
 void TxConfirmStats::Read(AutoFile& filein, size_t numBuckets)
 {
     // Read data file and do some very basic sanity checking
-    // buckets and bucketMap are not updated yet, so don't access them
+    // buckets are not updated yet, so don't access them
     // If there is a read failure, we'll just discard this entire object anyway
     size_t maxConfirms, maxPeriods;
 
@@ -443,29 +511,43 @@ void TxConfirmStats::Read(AutoFile& filein, size_t numBuckets)
     if (txCtAvg.size() != numBuckets) {
         throw std::runtime_error("Corrupt estimates file. Mismatch in tx count bucket count");
     }
-    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(confAvg);
-    maxPeriods = confAvg.size();
+    std::vector<std::vector<double>> conf_avg;
+    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(conf_avg);
+    maxPeriods = conf_avg.size();
     maxConfirms = scale * maxPeriods;
 
     if (maxConfirms <= 0 || maxConfirms > 6 * 24 * 7) { // one week
         throw std::runtime_error("Corrupt estimates file.  Must maintain estimates for between 1 and 1008 (one week) confirms");
     }
     for (unsigned int i = 0; i < maxPeriods; i++) {
-        if (confAvg[i].size() != numBuckets) {
+        if (conf_avg[i].size() != numBuckets) {
             throw std::runtime_error("Corrupt estimates file. Mismatch in feerate conf average bucket count");
         }
     }
 
-    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(failAvg);
-    if (maxPeriods != failAvg.size()) {
+    std::vector<std::vector<double>> fail_avg;
+    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(fail_avg);
+    if (maxPeriods != fail_avg.size()) {
         throw std::runtime_error("Corrupt estimates file. Mismatch in confirms tracked for failures");
     }
     for (unsigned int i = 0; i < maxPeriods; i++) {
-        if (failAvg[i].size() != numBuckets) {
+        if (fail_avg[i].size() != numBuckets) {
             throw std::runtime_error("Corrupt estimates file. Mismatch in one of failure average bucket counts");
         }
     }
 
+    // Convert the cumulative averages from the file into per-period ones
+    m_periods = maxPeriods;
+    m_unit = 1;
+    m_conf.resize(maxPeriods * numBuckets);
+    m_fail.resize(maxPeriods * numBuckets);
+    for (size_t i = 0; i < maxPeriods; i++) {
+        for (size_t j = 0; j < numBuckets; j++) {
+            m_conf[i * numBuckets + j] = conf_avg[i][j] - (i > 0 ? conf_avg[i - 1][j] : 0);
+            m_fail[i * numBuckets + j] = fail_avg[i][j] - (i + 1 < maxPeriods ? fail_avg[i + 1][j] : 0);
+        }
+    }
+
     // Resize the current block variables which aren't stored in the data file
     // to match the number of confirms and buckets
     resizeInMemoryCounters(numBuckets);
@@ -476,9 +558,9 @@ void TxConfirmStats::Read(AutoFile& filein, size_t numBuckets)
 
 unsigned int TxConfirmStats::NewTx(unsigned int nBlockHeight, double val)
 {
-    unsigned int bucketindex = bucketMap.lower_bound(val)->second;
-    unsigned int blockIndex = nBlockHeight % unconfTxs.size();
-    unconfTxs[blockIndex][bucketindex]++;
+    unsigned int bucketindex = BucketIndex(val);
+    unsigned int blockIndex = nBlockHeight % GetMaxConfirms();
+    unconfTxs[blockIndex * buckets.size() + bucketindex]++;
     return bucketindex;
 }
 
@@ -493,7 +575,7 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
         return;  //This can't happen because we call this with our best seen height, no entries can have higher
     }
 
-    if (blocksAgo >= (int)unconfTxs.size()) {
+    if (blocksAgo >= (int)GetMaxConfirms()) {
         if (oldUnconfTxs[bucketindex] > 0) {
             oldUnconfTxs[bucketindex]--;
         } else {
@@ -502,9 +584,10 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
         }
     }
     else {
-        unsigned int blockIndex = entryHeight % unconfTxs.size();
-        if (unconfTxs[blockIndex][bucketindex] > 0) {
-            unconfTxs[blockIndex][bucketindex]--;
+        unsigned int blockIndex = entryHeight % GetMaxConfirms();
+        int& unconf{unconfTxs[blockIndex * buckets.size() + bucketindex]};
+        if (unconf > 0) {
+            unconf--;
         } else {
             LogDebug(BCLog::ESTIMATEFEE, "Blockpolicy error, mempool tx removed from blockIndex=%u,bucketIndex=%u already\n",
                      blockIndex, bucketindex);
@@ -512,10 +595,8 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
     }
     if (!inBlock && (unsigned int)blocksAgo >= scale) { // Only counts as a failure if not confirmed for entire period
         assert(scale != 0);
-        unsigned int periodsAgo = blocksAgo / scale;
-        for (size_t i = 0; i < periodsAgo && i < failAvg.size(); i++) {
-            failAvg[i][bucketindex]++;
-        }
+        unsigned int periodsAgo = std::min<unsigned int>(blocksAgo / scale, m_periods);
+        m_fail[(periodsAgo - 1) * buckets.size() + bucketindex] += m_unit;
     }
 }
 
@@ -528,12 +609,12 @@ bool CBlockPolicyEstimator::removeTx(Txid hash)
 bool CBlockPolicyEstimator::_removeTx(const Txid& hash, bool inBlock)
 {
     AssertLockHeld(m_cs_fee_estimator);
-    std::map<Txid, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
+    auto pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
-        mapMemPoolTxs.erase(hash);
+        mapMemPoolTxs.erase(pos);
         return true;
     } else {
         return false;
@@ -544,19 +625,15 @@ CBlockPolicyEstimator::CBlockPolicyEstimator(const fs::path& estimation_filepath
     : m_estimation_filepath{estimation_filepath}
 {
     static_assert(MIN_BUCKET_FEERATE > 0, "Min feerate must be nonzero");
-    size_t bucketIndex = 0;
 
-    for (double bucketBoundary = MIN_BUCKET_FEERATE; bucketBoundary <= MAX_BUCKET_FEERATE; bucketBoundary *= FEE_SPACING, bucketIndex++) {
+    for (double bucketBoundary = MIN_BUCKET_FEERATE; bucketBoundary <= MAX_BUCKET_FEERATE; bucketBoundary *= FEE_SPACING) {
         buckets.push_back(bucketBoundary);
-        bucketMap[bucketBoundary] = bucketIndex;
     }
     buckets.push_back(INF_FEERATE);
-    bucketMap[INF_FEERATE] = bucketIndex;
-    assert(bucketMap.size() == buckets.size());
 
-    feeStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
-    shortStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
-    longStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
+    feeStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
+    shortStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
+    longStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
 
     AutoFile est_file{fsbridge::fopen(m_estimation_filepath, "rb")};
 
@@ -598,7 +675,7 @@ void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo&
     LOCK(m_cs_fee_estimator);
     const unsigned int txHeight = tx.info.txHeight;
     const auto& hash = tx.info.m_tx->GetHash();
-    if (mapMemPoolTxs.count(hash)) {
+    if (mapMemPoolTxs.contains(hash)) {
         LogDebug(BCLog::ESTIMATEFEE, "Blockpolicy error mempool tx %s already being tracked\n",
                  hash.ToString());
         return;
@@ -629,9 +706,10 @@ void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo&
     // Feerates are stored and reported as BTC-per-kb:
     const CFeeRate feeRate(tx.info.m_fee, tx.info.m_virtual_transaction_size);
 
-    mapMemPoolTxs[hash].blockHeight = txHeight;
+    TxStatsInfo& info = mapMemPoolTxs[hash];
+    info.blockHeight = txHeight;
     unsigned int bucketIndex = feeStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
-    mapMemPoolTxs[hash].bucketIndex = bucketIndex;
+    info.bucketIndex = bucketIndex;
     unsigned int bucketIndex2 = shortStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
     assert(bucketIndex == bucketIndex2);
     unsigned int bucketIndex3 = longStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
@@ -1028,23 +1106,22 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             if (numBuckets <= 1 || numBuckets > 1000) {
                 throw std::runtime_error("Corrupt estimates file. Must have between 2 and 1000 feerate buckets");
             }
+            if (std::adjacent_find(fileBuckets.begin(), fileBuckets.end(), std::greater_equal<double>{}) != fileBuckets.end()) {
+                throw std::runtime_error("Corrupt estimates file. Feerate buckets must be strictly increasing");
+            }
 
-            std::unique_ptr<TxConfirmStats> fileFeeStats(new TxConfirmStats(buckets, bucketMap, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
-            std::unique_ptr<TxConfirmStats> fileShortStats(new TxConfirmStats(buckets, bucketMap, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
-            std::unique_ptr<TxConfirmStats> fileLongStats(new TxConfirmStats(buckets, bucketMap, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
+            std::unique_ptr<TxConfirmStats> fileFeeStats(new TxConfirmStats(buckets, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
+            std::unique_ptr<TxConfirmStats> fileShortStats(new TxConfirmStats(buckets, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
+            std::unique_ptr<TxConfirmStats> fileLongStats(new TxConfirmStats(buckets, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
             fileFeeStats->Read(filein, numBuckets);
             fileShortStats->Read(filein, numBuckets);
             fileLongStats->Read(filein, numBuckets);
 
             // Fee estimates file parsed correctly
-            // Copy buckets from file and refresh our bucketmap
+            // Copy buckets from file
             buckets = fileBuckets;
-            bucketMap.clear();
-            for (unsigned int i = 0; i < buckets.size(); i++) {
-                bucketMap[buckets[i]] = i;
-            }
 
-            // Destroy old TxConfirmStats and point to new ones that already reference buckets and bucketMap
+            // Destroy old TxConfirmStats and point to new ones that already reference buckets
             feeStats = std::move(fileFeeStats);
             shortStats = std::move(fileShortStats);
             longStats = std::move(fileLongStats);
@@ -15,8 +15,12 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
+#include <logging.h>
+#include <netaddress.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
+#include <node/event_subscriber.h>
+#include <node/response_cache.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
@@ -31,9 +35,18 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <validation.h>
+#include <validationinterface.h>
 
 #include <any>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <set>
 #include <vector>
 
 #include <univalue.h>
@@ -44,6 +57,26 @@ using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+static constexpr unsigned int MAX_REST_BLOCKS_RESULTS = 1000;
+//! Blocks read from disk ahead of the one being sent by the range endpoints
+static constexpr size_t REST_BLOCKS_READ_AHEAD = 8;
+//! Threads reading blocks for the range endpoints
+static constexpr int REST_READ_THREADS = 2;
+
+//! Subscriptions to /rest/events at the same time, each of which occupies an
+//! HTTP worker thread for as long as it lasts
+static constexpr size_t MAX_REST_EVENT_SUBSCRIBERS = 4;
+//! Time without events after which an empty line is sent to a subscriber, to
+//! find out whether it went away
+static constexpr std::chrono::seconds REST_EVENTS_KEEPALIVE{15};
+
+/* Reads the blocks of range requests, while the HTTP worker sends the ones before */
+static util::ThreadPool g_read_pool{"restread"};
+
+static Mutex g_event_subscribers_mutex;
+static std::set<std::shared_ptr<node::EventSubscriber>> g_event_subscribers GUARDED_BY(g_event_subscribers_mutex);
+//! Whether new subscriptions are rejected because the server is shutting down
+static bool g_events_interrupted GUARDED_BY(g_event_subscribers_mutex){false};
 
 static const struct {
     RESTResponseFormat rf;
@@ -185,6 +218,47 @@ static bool CheckWarmup(HTTPRequest* req)
     return true;
 }
 
+/**
+ * Reply with the response for the key from the cache, if it is there.
+ *
+ * @param[in] cache The response cache, or nullptr to not use it.
+ * @returns         Whether there was a response to reply with.
+ */
+static bool ReplyFromCache(HTTPRequest* req, node::ResponseCache* cache, const std::string& key, RESTResponseFormat rf)
+{
+    if (!cache) return false;
+    const auto cached{cache->Get(key)};
+    if (!cached) return false;
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        break;
+    case RESTResponseFormat::HEX:
+        req->WriteHeader("Content-Type", "text/plain");
+        break;
+    default:
+        req->WriteHeader("Content-Type", "application/json");
+        break;
+    }
+    req->WriteReply(HTTP_OK, *cached);
+    return true;
+}
+
+/**
+ * Add the response about a transaction confirmed in @p block_hash to the
+ * cache, unless that block is no longer in the active chain. Its eviction may
+ * have happened already then, as indexes lag behind the chain.
+ */
+static void CacheConfirmedTx(const NodeContext& node, node::ResponseCache& cache, const uint256& block_hash, std::string key, std::string response)
+{
+    // Holding cs_main, the block cannot be disconnected before the response
+    // is added, so that the eviction is only notified after it.
+    LOCK(cs_main);
+    const CBlockIndex* const block_index{node.chainman->m_blockman.LookupBlockIndex(block_hash)};
+    if (!block_index || !node.chainman->ActiveChain().Contains(block_index)) return;
+    cache.Put(block_hash, std::move(key), std::move(response));
+}
+
 static bool rest_headers(const std::any& context,
                          HTTPRequest* req,
                          const std::string& uri_part)
@@ -243,6 +317,12 @@ static bool rest_headers(const std::any& context,
         }
     }
 
+    // The JSON format is cached, the others take little to produce. The
+    // headers returned and their confirmations depend on the tip.
+    node::ResponseCache* const cache{rf == RESTResponseFormat::JSON && !headers.empty() ? GetAnyResponseCache(context) : nullptr};
+    const std::string cache_key{strprintf("rest/headers/%s/%u/%s", hash->GetHex(), *parsed_count, tip->GetBlockHash().GetHex())};
+    if (ReplyFromCache(req, cache, cache_key, rf)) return true;
+
     switch (rf) {
     case RESTResponseFormat::BINARY: {
         DataStream ssHeader{};
@@ -274,6 +354,7 @@ static bool rest_headers(const std::any& context,
         std::string strJSON = jsonHeaders.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
+        if (cache) cache->Put(*hash, cache_key, std::move(strJSON));
         return true;
     }
     default: {
@@ -319,6 +400,120 @@ static void BlockUndoToJSON(const CBlockUndo& block_undo, UniValue& result)
     }
 }
 
+/**
+ * Parse the <start_height>/<count> of a range endpoint and look up the blocks
+ * of the active chain from there on, up to count of them or up to the tip.
+ * Replies with an error if the range is invalid or if the block data, or undo
+ * data if @p undo, of any of the blocks is not available.
+ */
+static std::optional<std::vector<const CBlockIndex*>> GetBlockRange(HTTPRequest* req, ChainstateManager& chainman,
+                                                                    const std::string& height_str, const std::string& count_str, bool undo)
+{
+    const auto start_height{ToIntegral<int32_t>(height_str)};
+    if (!start_height || *start_height < 0) {
+        RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(height_str, SAFE_CHARS_URI));
+        return std::nullopt;
+    }
+    const auto count{ToIntegral<unsigned int>(count_str)};
+    if (!count || *count < 1 || *count > MAX_REST_BLOCKS_RESULTS) {
+        RESTERR(req, HTTP_BAD_REQUEST, strprintf("Block count is invalid or out of acceptable range (1-%u): %s", MAX_REST_BLOCKS_RESULTS, SanitizeString(count_str, SAFE_CHARS_URI)));
+        return std::nullopt;
+    }
+
+    LOCK(cs_main);
+    const CChain& active_chain{chainman.ActiveChain()};
+    if (*start_height > active_chain.Height()) {
+        RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
+        return std::nullopt;
+    }
+    const int end_height{static_cast<int>(std::min<int64_t>(int64_t{*start_height} + *count - 1, active_chain.Height()))};
+    std::vector<const CBlockIndex*> blocks;
+    blocks.reserve(end_height - *start_height + 1);
+    for (int height{*start_height}; height <= end_height; ++height) {
+        const CBlockIndex* pindex{active_chain[height]};
+        if (undo) {
+            // The genesis block spends nothing, so it has no undo data
+            if (height > 0 && !(pindex->nStatus & BLOCK_HAVE_UNDO)) {
+                RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " undo not available");
+                return std::nullopt;
+            }
+        } else if (!(pindex->nStatus & BLOCK_HAVE_DATA)) {
+            if (chainman.m_blockman.IsBlockPruned(*pindex)) {
+                RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " not available (pruned data)");
+            } else {
+                RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " not available (not fully downloaded)");
+            }
+            return std::nullopt;
+        }
+        blocks.push_back(pindex);
+    }
+    return blocks;
+}
+
+/**
+ * Stream the data of a range of blocks, as returned by @p read for each of
+ * them, in binary or hex format with one line per block.
+ *
+ * The blocks are read on g_read_pool, up to REST_BLOCKS_READ_AHEAD of them
+ * ahead of the one being sent, so that reading from disk overlaps with
+ * sending. A block that cannot be read once part of the reply was sent cuts
+ * the reply short, as its status cannot be taken back.
+ */
+static bool StreamBlockRange(HTTPRequest* req, RESTResponseFormat rf, const std::vector<const CBlockIndex*>& blocks,
+                             const std::function<std::optional<std::vector<std::byte>>(const CBlockIndex&)>& read)
+{
+    if (rf != RESTResponseFormat::BINARY && rf != RESTResponseFormat::HEX) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: .bin, .hex)");
+    }
+
+    using ReadResult = std::optional<std::vector<std::byte>>;
+    std::deque<std::future<ReadResult>> pending;
+    size_t next{0};
+    const auto read_ahead{[&] {
+        while (next < blocks.size() && pending.size() < REST_BLOCKS_READ_AHEAD) {
+            const CBlockIndex& index{*blocks[next++]};
+            try {
+                pending.push_back(g_read_pool.Submit([&read, &index] { return read(index); }));
+            } catch (const std::runtime_error&) {
+                // The pool is not running, read the block here.
+                std::promise<ReadResult> result;
+                result.set_value(read(index));
+                pending.push_back(result.get_future());
+            }
+        }
+    }};
+
+    bool started{false};
+    for (const CBlockIndex* pindex : blocks) {
+        read_ahead();
+        const ReadResult data{pending.front().get()};
+        pending.pop_front();
+        if (!data) {
+            if (!started) {
+                for (const auto& result : pending) result.wait();
+                return RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " not found");
+            }
+            LogPrintf("REST: failed to read block %s, cutting the reply short\n", pindex->GetBlockHash().ToString());
+            break;
+        }
+        if (!started) {
+            req->WriteHeader("Content-Type", rf == RESTResponseFormat::BINARY ? "application/octet-stream" : "text/plain");
+            req->StartReply(HTTP_OK);
+            started = true;
+        }
+        if (rf == RESTResponseFormat::BINARY) {
+            req->WriteReplyChunk(*data);
+        } else {
+            req->WriteReplyChunk(HexStr(*data) + "\n");
+        }
+        // Stop reading once nothing more reaches the client.
+        if (req->ConnectionLost()) break;
+    }
+    for (const auto& result : pending) result.wait();
+    req->EndReply();
+    return true;
+}
+
 static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const std::string& uri_part)
 {
     if (!CheckWarmup(req)) {
@@ -332,13 +527,8 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
     if (path.size() == 1) {
         // path with query parameter: /rest/spenttxouts/<hash>
         hashStr = path[0];
-    } else {
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/spenttxouts/<hash>.<ext>");
-    }
-
-    auto hash{uint256::FromHex(hashStr)};
-    if (!hash) {
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+    } else if (path.size() != 2) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/spenttxouts/<hash>.<ext> or /rest/spenttxouts/<start_height>/<count>.<ext>");
     }
 
     ChainstateManager* chainman = GetChainman(context, req);
@@ -346,6 +536,26 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         return false;
     }
 
+    if (path.size() == 2) {
+        // range path: /rest/spenttxouts/<start_height>/<count>
+        const auto blocks{GetBlockRange(req, *chainman, path[0], path[1], /*undo=*/true)};
+        if (!blocks) return false;
+        return StreamBlockRange(req, rf, *blocks, [chainman](const CBlockIndex& index) -> std::optional<std::vector<std::byte>> {
+            CBlockUndo block_undo;
+            if (index.nHeight > 0 && !chainman->m_blockman.ReadBlockUndo(block_undo, index)) {
+                return std::nullopt;
+            }
+            DataStream ssSpentResponse{};
+            SerializeBlockUndo(ssSpentResponse, block_undo);
+            return std::vector<std::byte>{ssSpentResponse.begin(), ssSpentResponse.end()};
+        });
+    }
+
+    auto hash{uint256::FromHex(hashStr)};
+    if (!hash) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+    }
+
     const CBlockIndex* pblockindex = WITH_LOCK(cs_main, return chainman->m_blockman.LookupBlockIndex(*hash));
     if (!pblockindex) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
@@ -426,6 +636,12 @@ static bool rest_block(const std::any& context,
         pos = pblockindex->GetBlockPos();
     }
 
+    // The JSON format is cached, the others are the block as it is on disk.
+    // Its confirmations and next block hash depend on the tip.
+    node::ResponseCache* const cache{rf == RESTResponseFormat::JSON ? GetAnyResponseCache(context) : nullptr};
+    const std::string cache_key{strprintf("rest/block/%d/%s/%s", int(tx_verbosity), hash->GetHex(), tip->GetBlockHash().GetHex())};
+    if (ReplyFromCache(req, cache, cache_key, rf)) return true;
+
     std::vector<std::byte> block_data{};
     if (!chainman.m_blockman.ReadRawBlock(block_data, pos)) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
@@ -453,6 +669,7 @@ static bool rest_block(const std::any& context,
         std::string strJSON = objBlock.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
+        if (cache) cache->Put(*hash, cache_key, std::move(strJSON));
         return true;
     }
 
@@ -462,6 +679,34 @@ static bool rest_block(const std::any& context,
     }
 }
 
+static bool rest_blocks(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) {
+        return false;
+    }
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+    const std::vector<std::string> path = SplitString(param, '/');
+    if (path.size() != 2) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/blocks/<start_height>/<count>.<ext>");
+    }
+
+    ChainstateManager* chainman = GetChainman(context, req);
+    if (!chainman) {
+        return false;
+    }
+    const auto blocks{GetBlockRange(req, *chainman, path[0], path[1], /*undo=*/false)};
+    if (!blocks) return false;
+    return StreamBlockRange(req, rf, *blocks, [chainman](const CBlockIndex& index) -> std::optional<std::vector<std::byte>> {
+        const FlatFilePos pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
+        std::vector<std::byte> block_data{};
+        if (!chainman->m_blockman.ReadRawBlock(block_data, pos)) {
+            return std::nullopt;
+        }
+        return block_data;
+    });
+}
+
 static bool rest_block_extended(const std::any& context, HTTPRequest* req, const std::string& uri_part)
 {
     return rest_block(context, req, uri_part, TxVerbosity::SHOW_DETAILS_AND_PREVOUT);
@@ -622,6 +867,10 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
         return RESTERR(req, HTTP_BAD_REQUEST, "Index is not enabled for filtertype " + uri_parts[0]);
     }
 
+    node::ResponseCache* const cache{GetAnyResponseCache(context)};
+    const std::string cache_key{strprintf("rest/blockfilter/%s/%s/%d", uri_parts[0], block_hash->GetHex(), int(rf))};
+    if (ReplyFromCache(req, cache, cache_key, rf)) return true;
+
     const CBlockIndex* block_index;
     bool block_was_connected;
     {
@@ -660,6 +909,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
 
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, ssResp);
+        if (cache) cache->Put(*block_hash, cache_key, ssResp.str());
         return true;
     }
     case RESTResponseFormat::HEX: {
@@ -669,6 +919,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
         std::string strHex = HexStr(ssResp) + "\n";
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
+        if (cache) cache->Put(*block_hash, cache_key, std::move(strHex));
         return true;
     }
     case RESTResponseFormat::JSON: {
@@ -677,6 +928,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
         std::string strJSON = ret.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
+        if (cache) cache->Put(*block_hash, cache_key, std::move(strJSON));
         return true;
     }
     default: {
@@ -810,6 +1062,69 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
     }
 }
 
+/**
+ * Stream chain and mempool events to the client as they happen, as lines of
+ * JSON in the format of node::EventSubscriber, until it goes away or the node
+ * shuts down. A client that does not keep up with the events gets a last line
+ * of {"type":"overflow"} once they overflow its queue.
+ */
+static bool rest_events(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+    if (!param.empty()) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/events.json");
+    }
+    if (rf != RESTResponseFormat::JSON) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+
+    NodeContext* node = GetNodeContext(context, req);
+    if (!node) return false;
+    ValidationSignals& validation_signals{*Assert(node->validation_signals)};
+
+    const auto subscriber{std::make_shared<node::EventSubscriber>()};
+    {
+        LOCK(g_event_subscribers_mutex);
+        if (g_events_interrupted) {
+            return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Shutting down");
+        }
+        if (g_event_subscribers.size() >= MAX_REST_EVENT_SUBSCRIBERS) {
+            return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, strprintf("Too many event subscriptions (maximum: %u)", MAX_REST_EVENT_SUBSCRIBERS));
+        }
+        g_event_subscribers.insert(subscriber);
+    }
+    // Subscribe before replying, so that the client gets every event after
+    // the reply started.
+    validation_signals.RegisterSharedValidationInterface(subscriber);
+
+    req->WriteHeader("Content-Type", "application/x-ndjson");
+    req->StartReply(HTTP_OK);
+    while (!req->ConnectionLost()) {
+        const std::vector<std::string> events{subscriber->Wait(REST_EVENTS_KEEPALIVE)};
+        std::string chunk;
+        for (const std::string& event : events) {
+            chunk += event + "\n";
+        }
+        if (subscriber->Overflowed()) {
+            LogDebug(BCLog::HTTP, "Events overflowed the queue of subscriber %s\n", req->GetPeer().ToStringAddrPort());
+            req->WriteReplyChunk(chunk + "{\"type\":\"overflow\"}\n");
+            break;
+        }
+        if (subscriber->Interrupted()) {
+            req->WriteReplyChunk(chunk);
+            break;
+        }
+        req->WriteReplyChunk(chunk.empty() ? "\n" : chunk);
+    }
+    validation_signals.UnregisterSharedValidationInterface(subscriber);
+    WITH_LOCK(g_event_subscribers_mutex, g_event_subscribers.erase(subscriber));
+    req->EndReply();
+    return true;
+}
+
 static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string& uri_part)
 {
     if (!CheckWarmup(req))
@@ -822,6 +1137,11 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
     }
 
+    // Only transactions in blocks are cached, and evicted when the block is
+    // disconnected.
+    const std::string cache_key{strprintf("rest/tx/%s/%d", hash->GetHex(), int(rf))};
+    if (ReplyFromCache(req, GetAnyResponseCache(context), cache_key, rf)) return true;
+
     if (g_txindex) {
         g_txindex->BlockUntilSyncedToCurrentChain();
     }
@@ -833,6 +1153,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
     if (!tx) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
+    node::ResponseCache* const cache{hashBlock.IsNull() ? nullptr : node->response_cache.get()};
 
     switch (rf) {
     case RESTResponseFormat::BINARY: {
@@ -841,6 +1162,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
 
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, ssTx);
+        if (cache) CacheConfirmedTx(*node, *cache, hashBlock, cache_key, ssTx.str());
         return true;
     }
 
@@ -851,6 +1173,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         std::string strHex = HexStr(ssTx) + "\n";
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
+        if (cache) CacheConfirmedTx(*node, *cache, hashBlock, cache_key, std::move(strHex));
         return true;
     }
 
@@ -860,6 +1183,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         std::string strJSON = objTx.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
+        if (cache) CacheConfirmedTx(*node, *cache, hashBlock, cache_key, std::move(strJSON));
         return true;
     }
 
@@ -1120,6 +1444,7 @@ static const struct {
       {"/rest/tx/", rest_tx},
       {"/rest/block/notxdetails/", rest_block_notxdetails},
       {"/rest/block/", rest_block_extended},
+      {"/rest/blocks/", rest_blocks},
       {"/rest/blockfilter/", rest_block_filter},
       {"/rest/blockfilterheaders/", rest_filter_header},
       {"/rest/chaininfo", rest_chaininfo},
@@ -1130,6 +1455,7 @@ static const struct {
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
       {"/rest/spenttxouts/", rest_spent_txouts},
+      {"/rest/events", rest_events},
 };
 
 void StartREST(const std::any& context)
@@ -1138,10 +1464,18 @@ void StartREST(const std::any& context)
         auto handler = [context, up](HTTPRequest* req, const std::string& prefix) { return up.handler(context, req, prefix); };
         RegisterHTTPHandler(up.prefix, false, handler);
     }
+    g_read_pool.Start(REST_READ_THREADS);
+    WITH_LOCK(g_event_subscribers_mutex, g_events_interrupted = false);
 }
 
 void InterruptREST()
 {
+    // End the event streams, so that their worker threads can exit.
+    LOCK(g_event_subscribers_mutex);
+    g_events_interrupted = true;
+    for (const auto& subscriber : g_event_subscribers) {
+        subscriber->Interrupt();
+    }
 }
 
 void StopREST()
@@ -1149,4 +1483,5 @@ void StopREST()
     for (const auto& up : uri_prefixes) {
         UnregisterHTTPHandler(up.prefix, false);
     }
+    g_read_pool.Stop();
 }
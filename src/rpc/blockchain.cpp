@@ -29,6 +29,7 @@
 #include <net_processing.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
+#include <node/response_cache.h>
 #include <node/transaction.h>
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
@@ -47,6 +48,7 @@
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/syserror.h>
 #include <util/translation.h>
 #include <validation.h>
@@ -56,6 +58,7 @@
 #include <cstdint>
 
 #include <condition_variable>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -178,20 +181,24 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+/** Block fields other than the transactions, which are small even for verbose blocks. */
+static UniValue BlockSummaryToJSON(const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit)
 {
     UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
 
     result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
     result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
     result.pushKV("weight", (int)::GetBlockWeight(block));
-    UniValue txs(UniValue::VARR);
-    txs.reserve(block.vtx.size());
+    return result;
+}
 
+/** Call fn with the "tx" entry of every transaction of the block, in order. */
+static void BlockTxsToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& blockindex, TxVerbosity verbosity, const std::function<void(UniValue)>& fn)
+{
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                fn(tx->GetHash().GetHex());
             }
             break;
 
@@ -209,16 +216,39 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
-                txs.push_back(std::move(objTx));
+                fn(std::move(objTx));
             }
             break;
     }
+}
+
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    UniValue result = BlockSummaryToJSON(block, tip, blockindex, pow_limit);
 
+    UniValue txs(UniValue::VARR);
+    txs.reserve(block.vtx.size());
+    BlockTxsToJSON(blockman, block, blockindex, verbosity, [&](UniValue tx) { txs.push_back(std::move(tx)); });
     result.pushKV("tx", std::move(txs));
 
     return result;
 }
 
+void blockToJSON(UniValueWriter& writer, BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    const UniValue summary{BlockSummaryToJSON(block, tip, blockindex, pow_limit)};
+    writer.beginObject();
+    for (size_t i{0}; i < summary.size(); ++i) {
+        writer.key(summary.getKeys()[i]);
+        writer.value(summary.getValues()[i]);
+    }
+    writer.key("tx");
+    writer.beginArray();
+    BlockTxsToJSON(blockman, block, blockindex, verbosity, [&](UniValue tx) { writer.value(tx); });
+    writer.endArray();
+    writer.endObject();
+}
+
 static RPCHelpMan getblockcount()
 {
     return RPCHelpMan{
@@ -262,6 +292,46 @@ static RPCHelpMan getbestblockhash()
     };
 }
 
+/** The block of @p tip as returned by the wait* methods. */
+static UniValue TipToJSON(const BlockRef& tip)
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("hash", tip.hash.GetHex());
+    ret.pushKV("height", tip.height);
+    return ret;
+}
+
+/**
+ * Continuation of the wait* methods: returns the tip once @p done is true
+ * for it, the deadline passed or the node is shutting down, and waits for
+ * the tip to change again otherwise.
+ */
+struct TipWaiter {
+    Mining& miner;
+    std::function<bool(const BlockRef&)> done;
+    std::optional<SteadyClock::time_point> deadline;
+
+    UniValue operator()(bool interrupted) const
+    {
+        const BlockRef tip{CHECK_NONFATAL(miner.getTip()).value()};
+        if (interrupted || done(tip) || (deadline && SteadyClock::now() >= *deadline)) return TipToJSON(tip);
+        throw RPCTipWait{.tip = tip.hash, .deadline = deadline, .resume = *this};
+    }
+};
+
+/** Wait for @p done to be true for the tip, for up to @p timeout milliseconds unless it is 0. */
+static UniValue WaitForTip(const JSONRPCRequest& request, Mining& miner, std::function<bool(const BlockRef&)> done, int timeout)
+{
+    std::optional<SteadyClock::time_point> deadline;
+    if (timeout) deadline = SteadyClock::now() + 1ms * timeout;
+    const TipWaiter waiter{miner, std::move(done), deadline};
+    try {
+        return waiter(/*interrupted=*/false);
+    } catch (RPCTipWait& wait) {
+        return AwaitTipChange(request, std::move(wait));
+    }
+}
+
 static RPCHelpMan waitfornewblock()
 {
     return RPCHelpMan{
@@ -293,30 +363,18 @@ static RPCHelpMan waitfornewblock()
     NodeContext& node = EnsureAnyNodeContext(request.context);
     Mining& miner = EnsureMining(node);
 
-    // If the caller provided a current_tip value, pass it to waitTipChanged().
+    // If the caller did not provide a current tip hash, wait for the tip to be
+    // different from the current one. This mode is less reliable because if
+    // the tip changed between waitfornewblock calls, it will need to change a
+    // second time before this call returns.
     //
-    // If the caller did not provide a current tip hash, call getTip() to get
-    // one and wait for the tip to be different from this value. This mode is
-    // less reliable because if the tip changed between waitfornewblock calls,
-    // it will need to change a second time before this call returns.
-    BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
-
-    uint256 tip_hash{request.params[1].isNull()
-        ? current_block.hash
-        : ParseHashV(request.params[1], "current_tip")};
-
     // If the user provided an invalid current_tip then this call immediately
     // returns the current tip.
-    std::optional<BlockRef> block = timeout ? miner.waitTipChanged(tip_hash, std::chrono::milliseconds(timeout)) :
-                                              miner.waitTipChanged(tip_hash);
-
-    // Return current block upon shutdown
-    if (block) current_block = *block;
+    const uint256 tip_hash{request.params[1].isNull()
+        ? CHECK_NONFATAL(miner.getTip()).value().hash
+        : ParseHashV(request.params[1], "current_tip")};
 
-    UniValue ret(UniValue::VOBJ);
-    ret.pushKV("hash", current_block.hash.GetHex());
-    ret.pushKV("height", current_block.height);
-    return ret;
+    return WaitForTip(request, miner, [tip_hash](const BlockRef& tip) { return tip.hash != tip_hash; }, timeout);
 },
     };
 }
@@ -355,29 +413,7 @@ static RPCHelpMan waitforblock()
     NodeContext& node = EnsureAnyNodeContext(request.context);
     Mining& miner = EnsureMining(node);
 
-    // Abort if RPC came out of warmup too early
-    BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
-
-    const auto deadline{std::chrono::steady_clock::now() + 1ms * timeout};
-    while (current_block.hash != hash) {
-        std::optional<BlockRef> block;
-        if (timeout) {
-            auto now{std::chrono::steady_clock::now()};
-            if (now >= deadline) break;
-            const MillisecondsDouble remaining{deadline - now};
-            block = miner.waitTipChanged(current_block.hash, remaining);
-        } else {
-            block = miner.waitTipChanged(current_block.hash);
-        }
-        // Return current block upon shutdown
-        if (!block) break;
-        current_block = *block;
-    }
-
-    UniValue ret(UniValue::VOBJ);
-    ret.pushKV("hash", current_block.hash.GetHex());
-    ret.pushKV("height", current_block.height);
-    return ret;
+    return WaitForTip(request, miner, [hash](const BlockRef& tip) { return tip.hash == hash; }, timeout);
 },
     };
 }
@@ -417,30 +453,7 @@ static RPCHelpMan waitforblockheight()
     NodeContext& node = EnsureAnyNodeContext(request.context);
     Mining& miner = EnsureMining(node);
 
-    // Abort if RPC came out of warmup too early
-    BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
-
-    const auto deadline{std::chrono::steady_clock::now() + 1ms * timeout};
-
-    while (current_block.height < height) {
-        std::optional<BlockRef> block;
-        if (timeout) {
-            auto now{std::chrono::steady_clock::now()};
-            if (now >= deadline) break;
-            const MillisecondsDouble remaining{deadline - now};
-            block = miner.waitTipChanged(current_block.hash, remaining);
-        } else {
-            block = miner.waitTipChanged(current_block.hash);
-        }
-        // Return current block on shutdown
-        if (!block) break;
-        current_block = *block;
-    }
-
-    UniValue ret(UniValue::VOBJ);
-    ret.pushKV("hash", current_block.hash.GetHex());
-    ret.pushKV("height", current_block.height);
-    return ret;
+    return WaitForTip(request, miner, [height](const BlockRef& tip) { return tip.height >= height; }, timeout);
 },
     };
 }
@@ -827,6 +840,15 @@ static RPCHelpMan getblock()
         }
     }
 
+    // The confirmations and next block hash of the result depend on the tip.
+    node::ResponseCache* const cache{verbosity > 0 ? GetAnyResponseCache(request.context) : nullptr};
+    const std::string cache_key{strprintf("getblock/%s/%d/%s", hash.GetHex(), verbosity, tip->GetBlockHash().GetHex())};
+    if (cache) {
+        // Pruned blocks are not served from the cache either.
+        WITH_LOCK(cs_main, CheckBlockDataAvailability(chainman.m_blockman, *pblockindex, /*check_for_undo=*/false));
+        if (const auto cached{cache->Get(cache_key)}) return SerializedResult(request, *cached);
+    }
+
     const std::vector<std::byte> block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
 
     if (verbosity <= 0) {
@@ -846,7 +868,35 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
-    return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+    if (request.m_result_writer && cache) {
+        // Write the result out as it is serialized, keeping a copy for the
+        // cache only as long as it is small enough to be added to it.
+        std::optional<std::string> json{std::in_place};
+        bool first{true};
+        UniValueWriter writer{[&](std::string_view chunk) {
+            if (first) {
+                request.m_result_writer->raw(chunk);
+                first = false;
+            } else {
+                request.m_result_writer->rawContinued(chunk);
+            }
+            if (json && json->size() + chunk.size() > cache->MaxResponseSize()) json.reset();
+            if (json) json->append(chunk);
+        }};
+        blockToJSON(writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        writer.flush();
+        if (json) cache->Put(hash, cache_key, std::move(*json));
+        return NullUniValue;
+    }
+    if (request.m_result_writer && tx_verbosity != TxVerbosity::SHOW_TXID) {
+        // Write the transactions out one at a time rather than holding the
+        // details of all of them at once.
+        blockToJSON(*request.m_result_writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        return NullUniValue;
+    }
+    UniValue result{blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit)};
+    if (cache) cache->Put(hash, cache_key, result.write());
+    return result;
 },
     };
 }
@@ -1984,6 +2034,19 @@ static RPCHelpMan getblockstats()
         }
     }
 
+    node::ResponseCache* const cache{GetAnyResponseCache(request.context)};
+    const std::string cache_key{strprintf("getblockstats/%s/%s", pindex.GetBlockHash().GetHex(), util::Join(stats, ","))};
+    if (cache) {
+        {
+            // Pruned blocks are not served from the cache either.
+            LOCK(cs_main);
+            CheckBlockDataAvailability(chainman.m_blockman, pindex, /*check_for_undo=*/false);
+            // The genesis block has no undo data
+            if (pindex.nHeight > 0) CheckBlockDataAvailability(chainman.m_blockman, pindex, /*check_for_undo=*/true);
+        }
+        if (const auto cached{cache->Get(cache_key)}) return SerializedResult(request, *cached);
+    }
+
     const CBlock& block = GetBlockChecked(chainman.m_blockman, pindex);
     const CBlockUndo& blockUndo = GetUndoChecked(chainman.m_blockman, pindex);
 
@@ -2147,18 +2210,19 @@ static RPCHelpMan getblockstats()
     ret_all.pushKV("utxo_increase_actual", utxos - inputs);
     ret_all.pushKV("utxo_size_inc_actual", utxo_size_inc_actual);
 
-    if (do_all) {
-        return ret_all;
-    }
-
     UniValue ret(UniValue::VOBJ);
-    for (const std::string& stat : stats) {
-        const UniValue& value = ret_all[stat];
-        if (value.isNull()) {
-            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid selected statistic '%s'", stat));
+    if (do_all) {
+        ret = std::move(ret_all);
+    } else {
+        for (const std::string& stat : stats) {
+            const UniValue& value = ret_all[stat];
+            if (value.isNull()) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid selected statistic '%s'", stat));
+            }
+            ret.pushKV(stat, value);
         }
-        ret.pushKV(stat, value);
     }
+    if (cache) cache->Put(pindex.GetBlockHash(), cache_key, ret.write());
     return ret;
 },
     };
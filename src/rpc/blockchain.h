@@ -20,6 +20,7 @@ class CBlock;
 class CBlockIndex;
 class Chainstate;
 class UniValue;
+class UniValueWriter;
 namespace node {
 class BlockManager;
 struct NodeContext;
@@ -37,6 +38,8 @@ double GetDifficulty(const CBlockIndex& blockindex);
 
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
+/** Block description to JSON, written to writer one transaction at a time */
+void blockToJSON(UniValueWriter& writer, node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
@@ -0,0 +1,483 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cbor.h>
+
+#include <rpc/util.h>
+#include <span.h>
+#include <tinyformat.h>
+#include <univalue.h>
+#include <util/check.h>
+#include <util/strencodings.h>
+#include <util/string.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+/** Major types of CBOR data items, the top three bits of their first byte. */
+enum class Major : uint8_t {
+    UNSIGNED = 0,
+    NEGATIVE = 1,
+    BYTES = 2,
+    TEXT = 3,
+    ARRAY = 4,
+    MAP = 5,
+    TAG = 6,
+    SIMPLE = 7,
+};
+
+constexpr uint8_t SIMPLE_FALSE{20};
+constexpr uint8_t SIMPLE_TRUE{21};
+constexpr uint8_t SIMPLE_NULL{22};
+constexpr uint8_t SIMPLE_UNDEFINED{23};
+constexpr uint8_t FLOAT16{25};
+constexpr uint8_t FLOAT32{26};
+constexpr uint8_t FLOAT64{27};
+/** Tag of a decimal fraction: an array of a base 10 exponent and a mantissa. */
+constexpr uint64_t TAG_DECIMAL_FRACTION{4};
+/** Nesting limit of decoded values, the same as for JSON. */
+constexpr size_t MAX_DEPTH{512};
+/** Largest decimal exponent that is decoded, so that numbers stay short. */
+constexpr int64_t MAX_EXPONENT{1024};
+
+void WriteHead(std::string& out, Major major, uint64_t arg)
+{
+    const uint8_t type = uint8_t(major) << 5;
+    if (arg < 24) {
+        out.push_back(char(type | arg));
+        return;
+    }
+    const int len{arg <= 0xff ? 1 : arg <= 0xffff ? 2 : arg <= 0xffffffff ? 4 : 8};
+    out.push_back(char(type | (24 + std::countr_zero(unsigned(len)))));
+    for (int i{len - 1}; i >= 0; --i) out.push_back(char(arg >> (8 * i)));
+}
+
+void WriteSimple(std::string& out, uint8_t value)
+{
+    out.push_back(char(uint8_t(Major::SIMPLE) << 5 | value));
+}
+
+/** Write the integer that is -@p magnitude if @p negative, and @p magnitude otherwise. */
+void WriteInt(std::string& out, bool negative, uint64_t magnitude)
+{
+    if (negative && magnitude > 0) {
+        WriteHead(out, Major::NEGATIVE, magnitude - 1);
+    } else {
+        WriteHead(out, Major::UNSIGNED, magnitude);
+    }
+}
+
+void WriteText(std::string& out, std::string_view str)
+{
+    WriteHead(out, Major::TEXT, str.size());
+    out.append(str);
+}
+
+/** Values of lower case hex digits, and -1 for every other character. */
+constexpr auto HEX_VALUES{[] {
+    std::array<int8_t, 256> values{};
+    values.fill(-1);
+    for (int i{0}; i < 16; ++i) values["0123456789abcdef"[i]] = i;
+    return values;
+}()};
+
+/** Write a string as bytes if it is lower case hex, which decodes back to the same string. */
+void WriteHex(std::string& out, std::string_view str)
+{
+    const size_t start{out.size()};
+    if (str.size() % 2 == 0) {
+        WriteHead(out, Major::BYTES, str.size() / 2);
+        const size_t bytes_start{out.size()};
+        out.resize(bytes_start + str.size() / 2);
+        char* bytes{out.data() + bytes_start};
+        int invalid{0};
+        for (size_t i{0}; i < str.size(); i += 2) {
+            const int high{HEX_VALUES[uint8_t(str[i])]};
+            const int low{HEX_VALUES[uint8_t(str[i + 1])]};
+            invalid |= high | low;
+            bytes[i / 2] = char(high << 4 | low);
+        }
+        if (invalid >= 0) return;
+        out.resize(start);
+    }
+    WriteText(out, str);
+}
+
+/**
+ * Write a JSON number exactly: as an integer if it has neither a fraction nor
+ * an exponent, and as a decimal fraction otherwise. Numbers with more digits
+ * than fit into 64 bits are written as doubles.
+ */
+void WriteNumber(std::string& out, const UniValue& value)
+{
+    std::string_view num{value.getValStr()};
+    const bool negative{num.starts_with('-')};
+    if (negative) num.remove_prefix(1);
+
+    constexpr uint64_t max{std::numeric_limits<uint64_t>::max()};
+    uint64_t mantissa{0};
+    // Whether the mantissa is -2^64, the one magnitude that does not fit into
+    // 64 bits but does into a CBOR negative integer.
+    bool min_mantissa{false};
+    int64_t exponent{0};
+    bool integer{true};
+    bool exact{true};
+    const auto read_digits{[&](bool fraction) {
+        while (!num.empty() && IsDigit(num.front())) {
+            const uint64_t digit(num.front() - '0');
+            if (min_mantissa) {
+                exact = false;
+            } else if (mantissa > (max - digit) / 10) {
+                if (negative && mantissa == max / 10 && digit == max % 10 + 1) {
+                    min_mantissa = true;
+                } else {
+                    exact = false;
+                }
+            }
+            mantissa = mantissa * 10 + digit;
+            if (fraction) --exponent;
+            num.remove_prefix(1);
+        }
+    }};
+    read_digits(/*fraction=*/false);
+    if (num.starts_with('.')) {
+        integer = false;
+        num.remove_prefix(1);
+        read_digits(/*fraction=*/true);
+    }
+    if (num.starts_with('e') || num.starts_with('E')) {
+        integer = false;
+        num.remove_prefix(1);
+        if (num.starts_with('+')) num.remove_prefix(1);
+        int64_t e{0};
+        const auto [end, ec]{std::from_chars(num.data(), num.data() + num.size(), e)};
+        if (ec != std::errc{} || end != num.data() + num.size() || e < -MAX_EXPONENT || e > MAX_EXPONENT) exact = false;
+        exponent += e;
+        num = {};
+    }
+    if (!num.empty() || !exact || exponent < -MAX_EXPONENT || exponent > MAX_EXPONENT) {
+        WriteSimple(out, FLOAT64);
+        const uint64_t bits{std::bit_cast<uint64_t>(value.get_real())};
+        for (int i{7}; i >= 0; --i) out.push_back(char(bits >> (8 * i)));
+        return;
+    }
+    if (!integer) {
+        WriteHead(out, Major::TAG, TAG_DECIMAL_FRACTION);
+        WriteHead(out, Major::ARRAY, 2);
+        WriteInt(out, exponent < 0, exponent < 0 ? uint64_t(-exponent) : uint64_t(exponent));
+    }
+    if (min_mantissa) {
+        WriteHead(out, Major::NEGATIVE, max);
+    } else {
+        WriteInt(out, negative, mantissa);
+    }
+}
+
+/**
+ * Write @p value as described by @p doc, mirroring RPCResult::MatchesType.
+ *
+ * @returns false if the value does not match the documentation, in which case
+ *          @p out is left partially written.
+ */
+// NOLINTNEXTLINE(misc-no-recursion)
+bool EncodeDocumented(std::string& out, const UniValue& value, const RPCResult& doc)
+{
+    using Type = RPCResult::Type;
+    if (doc.m_skip_type_check) {
+        EncodeCBOR(out, value);
+        return true;
+    }
+    switch (doc.m_type) {
+    case Type::ANY:
+    case Type::ELISION:
+        break;
+    case Type::NONE:
+        if (!value.isNull()) return false;
+        break;
+    case Type::STR:
+        if (!value.isStr()) return false;
+        break;
+    case Type::STR_HEX:
+        if (!value.isStr()) return false;
+        WriteHex(out, value.get_str());
+        return true;
+    case Type::NUM:
+    case Type::STR_AMOUNT:
+    case Type::NUM_TIME:
+        if (!value.isNum()) return false;
+        break;
+    case Type::BOOL:
+        if (!value.isBool()) return false;
+        break;
+    case Type::ARR:
+    case Type::ARR_FIXED: {
+        if (!value.isArray()) return false;
+        WriteHead(out, Major::ARRAY, value.size());
+        for (size_t i{0}; i < value.size(); ++i) {
+            // If there are more entries than documented, reuse the last doc.
+            if (!EncodeDocumented(out, value[i], doc.m_inner.at(std::min(doc.m_inner.size() - 1, i)))) return false;
+        }
+        return true;
+    }
+    case Type::OBJ_DYN: {
+        if (!value.isObject()) return false;
+        WriteHead(out, Major::MAP, value.size());
+        for (size_t i{0}; i < value.size(); ++i) {
+            WriteText(out, value.getKeys()[i]);
+            if (!EncodeDocumented(out, value[i], doc.m_inner.at(0))) return false;
+        }
+        return true;
+    }
+    case Type::OBJ: {
+        if (!value.isObject()) return false;
+        // The members of an elided object are not checked, but the ones that
+        // are documented are still encoded as such.
+        const bool elided{!doc.m_inner.empty() && doc.m_inner.front().m_type == Type::ELISION};
+        size_t required{0};
+        WriteHead(out, Major::MAP, value.size());
+        for (size_t i{0}; i < value.size(); ++i) {
+            WriteText(out, value.getKeys()[i]);
+            const auto inner{std::ranges::find(doc.m_inner, value.getKeys()[i], &RPCResult::m_key_name)};
+            const size_t start{out.size()};
+            if (inner != doc.m_inner.end() && EncodeDocumented(out, value[i], *inner)) {
+                if (!inner->m_optional) ++required;
+                continue;
+            }
+            if (!elided) return false;
+            out.resize(start);
+            EncodeCBOR(out, value[i]);
+        }
+        return elided || required == size_t(std::ranges::count_if(doc.m_inner, [](const RPCResult& inner) { return !inner.m_optional; }));
+    }
+    } // no default case, so the compiler can warn about missing cases
+    EncodeCBOR(out, value);
+    return true;
+}
+
+std::string NegativeDigits(uint64_t arg)
+{
+    // The CBOR negative integer -1 - arg, as decimal digits without the sign.
+    return arg == std::numeric_limits<uint64_t>::max() ? "18446744073709551616" : util::ToString(arg + 1);
+}
+
+class Decoder
+{
+public:
+    explicit Decoder(std::string_view data) : m_data{data} {}
+
+    // NOLINTNEXTLINE(misc-no-recursion)
+    UniValue Read(size_t depth)
+    {
+        if (depth > MAX_DEPTH) throw std::runtime_error{"CBOR value nested too deeply"};
+        const uint8_t initial{Byte()};
+        const Major major{Major(initial >> 5)};
+        const uint8_t info = initial & 0x1f;
+        if (major == Major::SIMPLE) return ReadSimple(info);
+        const uint64_t arg{Arg(info)};
+        switch (major) {
+        case Major::UNSIGNED:
+            return UniValue{arg};
+        case Major::NEGATIVE:
+            if (arg <= uint64_t(std::numeric_limits<int64_t>::max())) return UniValue{-1 - int64_t(arg)};
+            return UniValue{UniValue::VNUM, "-" + NegativeDigits(arg)};
+        case Major::BYTES:
+            return UniValue{HexStr(MakeUCharSpan(Take(arg)))};
+        case Major::TEXT:
+            return UniValue{std::string{Take(arg)}};
+        case Major::ARRAY: {
+            // Every value takes at least one byte.
+            if (arg > Remaining()) throw std::runtime_error{"Unexpected end of CBOR data"};
+            UniValue array{UniValue::VARR};
+            for (uint64_t i{0}; i < arg; ++i) array.push_back(Read(depth + 1));
+            return array;
+        }
+        case Major::MAP: {
+            if (arg > Remaining() / 2) throw std::runtime_error{"Unexpected end of CBOR data"};
+            UniValue object{UniValue::VOBJ};
+            for (uint64_t i{0}; i < arg; ++i) {
+                if (m_pos < m_data.size() && Major(uint8_t(m_data[m_pos]) >> 5) != Major::TEXT) {
+                    throw std::runtime_error{"CBOR map keys must be text strings"};
+                }
+                UniValue key{Read(depth + 1)};
+                object.pushKVEnd(key.get_str(), Read(depth + 1));
+            }
+            return object;
+        }
+        case Major::TAG:
+            if (arg != TAG_DECIMAL_FRACTION) throw std::runtime_error{strprintf("Unsupported CBOR tag %u", arg)};
+            return ReadDecimalFraction();
+        case Major::SIMPLE:
+            break;
+        } // no default case, so the compiler can warn about missing cases
+        NONFATAL_UNREACHABLE();
+    }
+
+    size_t Remaining() const { return m_data.size() - m_pos; }
+
+private:
+    std::string_view m_data;
+    size_t m_pos{0};
+
+    uint8_t Byte()
+    {
+        if (m_pos >= m_data.size()) throw std::runtime_error{"Unexpected end of CBOR data"};
+        return uint8_t(m_data[m_pos++]);
+    }
+
+    std::string_view Take(uint64_t size)
+    {
+        if (size > Remaining()) throw std::runtime_error{"Unexpected end of CBOR data"};
+        const std::string_view taken{m_data.substr(m_pos, size)};
+        m_pos += size;
+        return taken;
+    }
+
+    uint64_t ReadBigEndian(int len)
+    {
+        uint64_t value{0};
+        for (int i{0}; i < len; ++i) value = value << 8 | Byte();
+        return value;
+    }
+
+    uint64_t Arg(uint8_t info)
+    {
+        if (info < 24) return info;
+        if (info <= 27) return ReadBigEndian(1 << (info - 24));
+        throw std::runtime_error{"Indefinite length CBOR items are not supported"};
+    }
+
+    UniValue ReadSimple(uint8_t info)
+    {
+        double value;
+        switch (info) {
+        case SIMPLE_FALSE: return UniValue{false};
+        case SIMPLE_TRUE: return UniValue{true};
+        case SIMPLE_NULL:
+        case SIMPLE_UNDEFINED: return NullUniValue;
+        case FLOAT16: {
+            const uint64_t half{ReadBigEndian(2)};
+            const int exponent((half >> 10) & 0x1f);
+            const int mantissa(half & 0x3ff);
+            value = exponent == 0 ? std::ldexp(mantissa, -24) :
+                    exponent == 0x1f ? std::numeric_limits<double>::infinity() :
+                                       std::ldexp(mantissa + 0x400, exponent - 25);
+            if (half & 0x8000) value = -value;
+            break;
+        }
+        case FLOAT32:
+            value = std::bit_cast<float>(uint32_t(ReadBigEndian(4)));
+            break;
+        case FLOAT64:
+            value = std::bit_cast<double>(ReadBigEndian(8));
+            break;
+        default:
+            throw std::runtime_error{strprintf("Unsupported CBOR simple value %u", info)};
+        }
+        if (!std::isfinite(value)) throw std::runtime_error{"CBOR number is not finite"};
+        return UniValue{value};
+    }
+
+    /** Read an integer as its sign and decimal digits. */
+    std::pair<bool, std::string> ReadIntDigits()
+    {
+        const uint8_t initial{Byte()};
+        const uint64_t arg{Arg(initial & 0x1f)};
+        switch (Major(initial >> 5)) {
+        case Major::UNSIGNED: return {false, util::ToString(arg)};
+        case Major::NEGATIVE: return {true, NegativeDigits(arg)};
+        default: throw std::runtime_error{"CBOR decimal fraction must consist of integers"};
+        }
+    }
+
+    UniValue ReadDecimalFraction()
+    {
+        if (Byte() != (uint8_t(Major::ARRAY) << 5 | 2)) throw std::runtime_error{"CBOR decimal fraction must be an array of two integers"};
+        const auto [exp_negative, exp_digits]{ReadIntDigits()};
+        auto [negative, digits]{ReadIntDigits()};
+        int64_t exponent{0};
+        if (exp_digits.size() > 4 || (exponent = LocaleIndependentAtoi<int64_t>(exp_digits)) > MAX_EXPONENT) {
+            throw std::runtime_error{"CBOR decimal fraction exponent out of range"};
+        }
+        std::string num{negative ? "-" : ""};
+        if (!exp_negative) {
+            num += digits;
+            if (exponent > 0) num += "e" + exp_digits;
+        } else {
+            // Keep the digits of the fraction, including trailing zeros.
+            if (digits.size() <= size_t(exponent)) digits.insert(0, exponent + 1 - digits.size(), '0');
+            num += digits.substr(0, digits.size() - exponent) + "." + digits.substr(digits.size() - exponent);
+        }
+        return UniValue{UniValue::VNUM, std::move(num)};
+    }
+};
+} // namespace
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void EncodeCBOR(std::string& out, const UniValue& value)
+{
+    switch (value.getType()) {
+    case UniValue::VNULL:
+        WriteSimple(out, SIMPLE_NULL);
+        return;
+    case UniValue::VBOOL:
+        WriteSimple(out, value.get_bool() ? SIMPLE_TRUE : SIMPLE_FALSE);
+        return;
+    case UniValue::VNUM:
+        WriteNumber(out, value);
+        return;
+    case UniValue::VSTR:
+        WriteText(out, value.get_str());
+        return;
+    case UniValue::VARR:
+        WriteHead(out, Major::ARRAY, value.size());
+        for (const UniValue& entry : value.getValues()) EncodeCBOR(out, entry);
+        return;
+    case UniValue::VOBJ:
+        WriteHead(out, Major::MAP, value.size());
+        for (size_t i{0}; i < value.size(); ++i) {
+            WriteText(out, value.getKeys()[i]);
+            EncodeCBOR(out, value[i]);
+        }
+        return;
+    } // no default case, so the compiler can warn about missing cases
+}
+
+void EncodeCBOR(std::string& out, const UniValue& value, const RPCResults& doc)
+{
+    const size_t start{out.size()};
+    for (const RPCResult& result : doc.m_results) {
+        if (EncodeDocumented(out, value, result)) return;
+        out.resize(start);
+    }
+    EncodeCBOR(out, value);
+}
+
+void EncodeCBORMapHead(std::string& out, size_t size)
+{
+    WriteHead(out, Major::MAP, size);
+}
+
+void EncodeCBORArrayHead(std::string& out, size_t size)
+{
+    WriteHead(out, Major::ARRAY, size);
+}
+
+UniValue DecodeCBOR(std::string_view data)
+{
+    Decoder decoder{data};
+    UniValue value{decoder.Read(/*depth=*/0)};
+    if (decoder.Remaining() > 0) throw std::runtime_error{"Trailing data after CBOR value"};
+    return value;
+}
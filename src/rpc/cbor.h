@@ -0,0 +1,50 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_CBOR_H
+#define BITCOIN_RPC_CBOR_H
+
+#include <string>
+#include <string_view>
+
+class UniValue;
+struct RPCResult;
+struct RPCResults;
+
+/**
+ * Binary encoding of RPC requests and replies in CBOR (RFC 8949), as sent with
+ * "Content-Type: application/cbor".
+ *
+ * JSON values map to their CBOR counterparts. Numbers are encoded as integers,
+ * or as decimal fractions (tag 4) so that amounts keep their exact digits.
+ * Strings that the method's RPCResult documents as hex are encoded as byte
+ * strings, which halves their size and spares the client decoding them. In
+ * requests, byte strings may be passed wherever a hex string is expected.
+ */
+
+/** Append the encoding of a value without documentation: strings stay text. */
+void EncodeCBOR(std::string& out, const UniValue& value);
+
+/**
+ * Append the encoding of an RPC result, as described by the first of the
+ * documented results that it matches. Results that match none of them are
+ * encoded without documentation.
+ */
+void EncodeCBOR(std::string& out, const UniValue& value, const RPCResults& doc);
+
+/** Append the head of a map of @p size key/value pairs. */
+void EncodeCBORMapHead(std::string& out, size_t size);
+/** Append the head of an array of @p size values. */
+void EncodeCBORArrayHead(std::string& out, size_t size);
+
+/**
+ * Decode a single value, which must span all of @p data. Byte strings are
+ * decoded to hex strings.
+ *
+ * @throws std::runtime_error if the data is not valid CBOR, or uses features
+ * that have no JSON counterpart, such as non-text map keys.
+ */
+UniValue DecodeCBOR(std::string_view data);
+
+#endif // BITCOIN_RPC_CBOR_H
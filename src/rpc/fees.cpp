@@ -6,6 +6,7 @@
 #include <common/messages.h>
 #include <core_io.h>
 #include <node/context.h>
+#include <node/mempool_forecast.h>
 #include <policy/feerate.h>
 #include <policy/fees.h>
 #include <rpc/protocol.h>
@@ -15,6 +16,7 @@
 #include <rpc/util.h>
 #include <txmempool.h>
 #include <univalue.h>
+#include <util/string.h>
 #include <validationinterface.h>
 
 #include <algorithm>
@@ -25,7 +27,9 @@
 using common::FeeModeFromString;
 using common::FeeModesDetail;
 using common::InvalidEstimateModeErrorMessage;
+using node::MAX_FORECAST_BLOCKS;
 using node::NodeContext;
+using util::ToString;
 
 static RPCHelpMan estimatesmartfee()
 {
@@ -95,6 +99,48 @@ static RPCHelpMan estimatesmartfee()
     };
 }
 
+static RPCHelpMan estimatemempoolfee()
+{
+    return RPCHelpMan{
+        "estimatemempoolfee",
+        "Estimates the fee per kilobyte needed for a transaction to be mined within conf_target\n"
+        "blocks, by simulating the selection of the next blocks from the current mempool.\n"
+        "Unlike estimatesmartfee this reacts immediately to changes in the mempool, but does not\n"
+        "account for transactions that will arrive before those blocks are found.\n"
+        "The forecast is cached and may be up to a second old.\n",
+        {
+            {"conf_target", RPCArg::Type::NUM, RPCArg::Optional::NO, "Confirmation target in blocks (1 - " + ToString(MAX_FORECAST_BLOCKS) + ")"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "feerate", "estimate fee rate in " + CURRENCY_UNIT + "/kvB, at least the mempool minimum fee"},
+                {RPCResult::Type::NUM, "blocks", "block number the estimate is for"},
+                {RPCResult::Type::NUM, "mempool_sequence", "mempool sequence number the forecast was made at"},
+        }},
+        RPCExamples{
+            HelpExampleCli("estimatemempoolfee", "2") +
+            HelpExampleRpc("estimatemempoolfee", "2")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+        {
+            const NodeContext& node = EnsureAnyNodeContext(request.context);
+            const CTxMemPool& mempool = EnsureMemPool(node);
+            node::MempoolForecaster& forecaster = EnsureMempoolForecaster(node);
+
+            const unsigned int conf_target = ParseConfirmTarget(request.params[0], MAX_FORECAST_BLOCKS);
+            const auto forecast{forecaster.GetForecast()};
+            const CFeeRate feerate{std::max({forecast->EstimateFee(conf_target), mempool.GetMinFee(), mempool.m_opts.min_relay_feerate})};
+
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("feerate", ValueFromAmount(feerate.GetFeePerK()));
+            result.pushKV("blocks", conf_target);
+            result.pushKV("mempool_sequence", forecast->sequence);
+            return result;
+        },
+    };
+}
+
 static RPCHelpMan estimaterawfee()
 {
     return RPCHelpMan{
@@ -220,6 +266,7 @@ void RegisterFeeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"util", &estimatesmartfee},
+        {"util", &estimatemempoolfee},
         {"hidden", &estimaterawfee},
     };
     for (const auto& c : commands) {
@@ -10,11 +10,10 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <core_io.h>
-#include <kernel/mempool_entry.h>
+#include <kernel/mempool_snapshot.h>
 #include <net_processing.h>
 #include <node/mempool_persist_args.h>
 #include <node/types.h>
-#include <policy/rbf.h>
 #include <policy/settings.h>
 #include <primitives/transaction.h>
 #include <rpc/server.h>
@@ -286,33 +285,29 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+static void entryToJSON(const kernel::MempoolSnapshot& snapshot, UniValue& info, const kernel::MempoolSnapshotEntry& e)
 {
-    AssertLockHeld(pool.cs);
-
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    info.pushKV("vsize", e.vsize);
+    info.pushKV("weight", e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", (int)e.height);
+    info.pushKV("descendantcount", e.count_with_descendants);
+    info.pushKV("descendantsize", e.size_with_descendants);
+    info.pushKV("ancestorcount", e.count_with_ancestors);
+    info.pushKV("ancestorsize", e.size_with_ancestors);
+    info.pushKV("wtxid", e.tx->GetWitnessHash().ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.mod_fees_with_ancestors));
+    fees.pushKV("descendant", ValueFromAmount(e.mod_fees_with_descendants));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
+    // Sort by hex string to match the historical output order.
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(txin.prevout.hash))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& parent : e.parents) {
+        setDepends.insert(parent.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -324,63 +319,65 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.children) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
 
     // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
-    }
-
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+    info.pushKV("bip125-replaceable", snapshot.IsRBFOptIn(e));
+    info.pushKV("unbroadcast", e.unbroadcast);
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
 {
+    if (verbose && include_mempool_sequence) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
+    }
+    // Serialize from a snapshot so that large mempools can be dumped without
+    // holding pool.cs and delaying transaction acceptance.
+    const auto snapshot{pool.GetSnapshot()};
     if (verbose) {
-        if (include_mempool_sequence) {
-            throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
-        }
-        LOCK(pool.cs);
         UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+        for (const auto& e : snapshot->GetSortedDepthAndScore()) {
             UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
+            entryToJSON(*snapshot, info, *e);
             // Mempool has unique entries so there is no advantage in using
             // UniValue::pushKV, which checks if the key already exists in O(N).
             // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
+            o.pushKVEnd(e->GetHash().ToString(), std::move(info));
         }
         return o;
     } else {
         UniValue a(UniValue::VARR);
-        uint64_t mempool_sequence;
-        {
-            LOCK(pool.cs);
-            for (const CTxMemPoolEntry& e : pool.entryAll()) {
-                a.push_back(e.GetTx().GetHash().ToString());
-            }
-            mempool_sequence = pool.GetSequence();
+        for (const auto& e : snapshot->GetSortedDepthAndScore()) {
+            a.push_back(e->GetHash().ToString());
         }
         if (!include_mempool_sequence) {
             return a;
         } else {
             UniValue o(UniValue::VOBJ);
             o.pushKV("txids", std::move(a));
-            o.pushKV("mempool_sequence", mempool_sequence);
+            o.pushKV("mempool_sequence", snapshot->GetStats().sequence);
             return o;
         }
     }
 }
 
+void MempoolToJSON(UniValueWriter& writer, const CTxMemPool& pool)
+{
+    const auto snapshot{pool.GetSnapshot()};
+    writer.beginObject();
+    for (const auto& e : snapshot->GetSortedDepthAndScore()) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(*snapshot, info, *e);
+        writer.key(e->GetHash().ToString());
+        writer.value(info);
+    }
+    writer.endObject();
+}
+
 static RPCHelpMan getrawmempool()
 {
     return RPCHelpMan{
@@ -427,7 +424,14 @@ static RPCHelpMan getrawmempool()
         include_mempool_sequence = request.params[1].get_bool();
     }
 
-    return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
+    const CTxMemPool& mempool{EnsureAnyMemPool(request.context)};
+    if (fVerbose && !include_mempool_sequence && request.m_result_writer) {
+        // Write the entries out one at a time rather than holding all of them
+        // at once.
+        MempoolToJSON(*request.m_result_writer, mempool);
+        return NullUniValue;
+    }
+    return MempoolToJSON(mempool, fVerbose, include_mempool_sequence);
 },
     };
 }
@@ -464,28 +468,27 @@ static RPCHelpMan getmempoolancestors()
     auto txid{Txid::FromUint256(ParseHashV(request.params[0], "txid"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    const auto snapshot{mempool.GetSnapshot()};
 
-    const auto entry{mempool.GetEntry(txid)};
+    const auto entry{snapshot->Find(txid)};
     if (entry == nullptr) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
     }
 
-    auto ancestors{mempool.AssumeCalculateMemPoolAncestors(self.m_name, *entry, CTxMemPool::Limits::NoLimits(), /*fSearchForParents=*/false)};
+    const auto ancestors{snapshot->CalculateAncestors(*entry)};
 
     if (!fVerbose) {
         UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter ancestorIt : ancestors) {
-            o.push_back(ancestorIt->GetTx().GetHash().ToString());
+        for (const auto& ancestor : ancestors) {
+            o.push_back(ancestor->GetHash().ToString());
         }
         return o;
     } else {
         UniValue o(UniValue::VOBJ);
-        for (CTxMemPool::txiter ancestorIt : ancestors) {
-            const CTxMemPoolEntry &e = *ancestorIt;
+        for (const auto& ancestor : ancestors) {
             UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(e.GetTx().GetHash().ToString(), std::move(info));
+            entryToJSON(*snapshot, info, *ancestor);
+            o.pushKVEnd(ancestor->GetHash().ToString(), std::move(info));
         }
         return o;
     }
@@ -525,32 +528,28 @@ static RPCHelpMan getmempooldescendants()
     auto txid{Txid::FromUint256(ParseHashV(request.params[0], "txid"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    const auto snapshot{mempool.GetSnapshot()};
 
-    const auto it{mempool.GetIter(txid)};
-    if (!it) {
+    const auto entry{snapshot->Find(txid)};
+    if (entry == nullptr) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
     }
 
-    CTxMemPool::setEntries setDescendants;
-    mempool.CalculateDescendants(*it, setDescendants);
-    // CTxMemPool::CalculateDescendants will include the given tx
-    setDescendants.erase(*it);
+    const auto descendants{snapshot->CalculateDescendants(*entry)};
 
     if (!fVerbose) {
         UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter descendantIt : setDescendants) {
-            o.push_back(descendantIt->GetTx().GetHash().ToString());
+        for (const auto& descendant : descendants) {
+            o.push_back(descendant->GetHash().ToString());
         }
 
         return o;
     } else {
         UniValue o(UniValue::VOBJ);
-        for (CTxMemPool::txiter descendantIt : setDescendants) {
-            const CTxMemPoolEntry &e = *descendantIt;
+        for (const auto& descendant : descendants) {
             UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(e.GetTx().GetHash().ToString(), std::move(info));
+            entryToJSON(*snapshot, info, *descendant);
+            o.pushKVEnd(descendant->GetHash().ToString(), std::move(info));
         }
         return o;
     }
@@ -577,15 +576,15 @@ static RPCHelpMan getmempoolentry()
     auto txid{Txid::FromUint256(ParseHashV(request.params[0], "txid"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    const auto snapshot{mempool.GetSnapshot()};
 
-    const auto entry{mempool.GetEntry(txid)};
+    const auto entry{snapshot->Find(txid)};
     if (entry == nullptr) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
     }
 
     UniValue info(UniValue::VOBJ);
-    entryToJSON(mempool, info, *entry);
+    entryToJSON(*snapshot, info, *entry);
     return info;
 },
     };
@@ -675,19 +674,21 @@ static RPCHelpMan gettxspendingprevout()
 
 UniValue MempoolInfoToJSON(const CTxMemPool& pool)
 {
-    // Make sure this call is atomic in the pool.
-    LOCK(pool.cs);
+    // Take all aggregates from one snapshot so they are consistent with each
+    // other without holding pool.cs.
+    const auto snapshot{pool.GetSnapshot()};
+    const auto& stats{snapshot->GetStats()};
     UniValue ret(UniValue::VOBJ);
-    ret.pushKV("loaded", pool.GetLoadTried());
-    ret.pushKV("size", (int64_t)pool.size());
-    ret.pushKV("bytes", (int64_t)pool.GetTotalTxSize());
-    ret.pushKV("usage", (int64_t)pool.DynamicMemoryUsage());
-    ret.pushKV("total_fee", ValueFromAmount(pool.GetTotalFee()));
+    ret.pushKV("loaded", stats.load_tried);
+    ret.pushKV("size", (int64_t)snapshot->size());
+    ret.pushKV("bytes", (int64_t)stats.total_tx_size);
+    ret.pushKV("usage", (int64_t)stats.dynamic_usage);
+    ret.pushKV("total_fee", ValueFromAmount(stats.total_fee));
     ret.pushKV("maxmempool", pool.m_opts.max_size_bytes);
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(), pool.m_opts.min_relay_feerate).GetFeePerK()));
     ret.pushKV("minrelaytxfee", ValueFromAmount(pool.m_opts.min_relay_feerate.GetFeePerK()));
     ret.pushKV("incrementalrelayfee", ValueFromAmount(pool.m_opts.incremental_relay_feerate.GetFeePerK()));
-    ret.pushKV("unbroadcastcount", uint64_t{pool.GetUnbroadcastTxs().size()});
+    ret.pushKV("unbroadcastcount", uint64_t{stats.unbroadcast_count});
     ret.pushKV("fullrbf", true);
     ret.pushKV("permitbaremultisig", pool.m_opts.permit_bare_multisig);
     ret.pushKV("maxdatacarriersize", pool.m_opts.max_datacarrier_bytes.value_or(0));
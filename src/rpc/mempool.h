@@ -7,11 +7,14 @@
 
 class CTxMemPool;
 class UniValue;
+class UniValueWriter;
 
 /** Mempool information to JSON */
 UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
+/** Verbose mempool to JSON, written to writer one entry at a time */
+void MempoolToJSON(UniValueWriter& writer, const CTxMemPool& pool);
 
 #endif // BITCOIN_RPC_MEMPOOL_H
@@ -44,6 +44,7 @@
 #include <validationinterface.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 using interfaces::BlockRef;
@@ -468,7 +469,10 @@ static RPCHelpMan getmininginfo()
     obj.pushKV("bits", strprintf("%08x", tip.nBits));
     obj.pushKV("difficulty", GetDifficulty(tip));
     obj.pushKV("target", GetTarget(tip, chainman.GetConsensus().powLimit).GetHex());
-    obj.pushKV("networkhashps",    getnetworkhashps().HandleRequest(request));
+    // The hash rate is returned as part of this result, not encoded on its own.
+    JSONRPCRequest networkhashps_request{request};
+    networkhashps_request.m_cbor_result = nullptr;
+    obj.pushKV("networkhashps",    getnetworkhashps().HandleRequest(networkhashps_request));
     obj.pushKV("pooledtx",         (uint64_t)mempool.size());
     BlockAssembler::Options assembler_options;
     ApplyArgsManOptions(*node.args, assembler_options);
@@ -611,6 +615,30 @@ static std::string gbt_rule_value(const std::string& name, bool gbt_optional_rul
     return s;
 }
 
+/**
+ * Continuation of a getblocktemplate long poll: waits until either the best
+ * block changes, or there are more transactions when they are checked, and
+ * then calls @p rerun to build the template.
+ */
+struct LongPollWaiter {
+    Mining& miner;
+    const CTxMemPool& mempool;
+    uint256 watched_tip;
+    unsigned int transactions_updated;
+    std::function<UniValue()> rerun;
+
+    UniValue operator()(bool interrupted) const
+    {
+        if (interrupted || !IsRPCRunning()) throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
+        // If watched_tip is not a real block hash, this returns right away.
+        if (CHECK_NONFATAL(miner.getTip()).value().hash != watched_tip) return rerun();
+        // Check transactions for update without holding the mempool lock to
+        // avoid deadlocks.
+        if (mempool.GetTransactionsUpdated() != transactions_updated) return rerun();
+        throw RPCTipWait{.tip = watched_tip, .deadline = SteadyClock::now() + 10s, .resume = *this};
+    }
+};
+
 static RPCHelpMan getblocktemplate()
 {
     return RPCHelpMan{
@@ -815,32 +843,24 @@ static RPCHelpMan getblocktemplate()
             nTransactionsUpdatedLastLP = nTransactionsUpdatedLast;
         }
 
-        // Release lock while waiting
-        {
-            REVERSE_LOCK(cs_main_lock, cs_main);
-            MillisecondsDouble checktxtime{std::chrono::minutes(1)};
-            while (IsRPCRunning()) {
-                // If hashWatchedChain is not a real block hash, this will
-                // return immediately.
-                std::optional<BlockRef> maybe_tip{miner.waitTipChanged(hashWatchedChain, checktxtime)};
-                // Node is shutting down
-                if (!maybe_tip) break;
-                tip = maybe_tip->hash;
-                if (tip != hashWatchedChain) break;
-
-                // Check transactions for update without holding the mempool
-                // lock to avoid deadlocks.
-                if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLastLP) {
-                    break;
-                }
-                checktxtime = std::chrono::seconds(10);
-            }
+        // Once the wait is over, build the template as if no long poll had
+        // been asked for. That also rechecks connections and IBD.
+        JSONRPCRequest rerun_request{request};
+        UniValue template_request{UniValue::VOBJ};
+        const UniValue& oparam{request.params[0].get_obj()};
+        for (size_t i{0}; i < oparam.size(); ++i) {
+            if (oparam.getKeys()[i] != "longpollid") template_request.pushKV(oparam.getKeys()[i], oparam[i]);
         }
-        tip = CHECK_NONFATAL(miner.getTip()).value().hash;
+        rerun_request.params = UniValue{UniValue::VARR};
+        rerun_request.params.push_back(std::move(template_request));
+        rerun_request.m_result_writer = nullptr;
+        rerun_request.m_allow_park = false;
 
-        if (!IsRPCRunning())
-            throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
-        // TODO: Maybe recheck connections/IBD and (if something wrong) send an expires-immediately template to stop miners?
+        const LongPollWaiter waiter{miner, mempool, hashWatchedChain, nTransactionsUpdatedLastLP,
+                                    [rerun_request] { return getblocktemplate().HandleRequest(rerun_request); }};
+        // Release lock while waiting
+        REVERSE_LOCK(cs_main_lock, cs_main);
+        return AwaitTipChange(request, {.tip = hashWatchedChain, .deadline = SteadyClock::now() + 1min, .resume = waiter});
     }
 
     const Consensus::Params& consensusParams = chainman.GetParams().GetConsensus();
@@ -168,6 +168,9 @@ static RPCHelpMan getpeerinfo()
                     {
                         {RPCResult::Type::NUM, "n", "The heights of blocks we're currently asking from this peer"},
                     }},
+                    {RPCResult::Type::NUM, "inflight_limit", "The number of blocks we may ask from this peer at once, based on its measured block download speed"},
+                    {RPCResult::Type::NUM, "block_download_rate", "The average rate in bytes per second at which this peer delivers requested blocks, or 0 if not measured yet"},
+                    {RPCResult::Type::NUM, "block_latency", "The average time in seconds from requesting a block from this peer to receiving it, or 0 if not measured yet"},
                     {RPCResult::Type::BOOL, "addr_relay_enabled", "Whether we participate in address relay with this peer"},
                     {RPCResult::Type::NUM, "addr_processed", "The total number of addresses processed, excluding those dropped due to rate limiting"},
                     {RPCResult::Type::NUM, "addr_rate_limited", "The total number of addresses dropped due to rate limiting"},
@@ -276,6 +279,9 @@ static RPCHelpMan getpeerinfo()
             heights.push_back(height);
         }
         obj.pushKV("inflight", std::move(heights));
+        obj.pushKV("inflight_limit", statestats.m_max_blocks_in_transit);
+        obj.pushKV("block_download_rate", statestats.m_block_download_rate);
+        obj.pushKV("block_latency", Ticks<SecondsDouble>(statestats.m_block_latency));
         obj.pushKV("addr_relay_enabled", statestats.m_addr_relay_enabled);
         obj.pushKV("addr_processed", statestats.m_addr_processed);
         obj.pushKV("addr_rate_limited", statestats.m_addr_rate_limited);
@@ -580,6 +586,15 @@ static RPCHelpMan getnettotals()
                            {RPCResult::Type::NUM, "bytes_left_in_cycle", "Bytes left in current time cycle"},
                            {RPCResult::Type::NUM, "time_left_in_cycle", "Seconds left in current time cycle"},
                         }},
+                       {RPCResult::Type::OBJ, "sendpath", "Work done writing messages out to peers",
+                       {
+                           {RPCResult::Type::NUM, "syscalls", "Send system calls made"},
+                           {RPCResult::Type::NUM, "messages", "Messages written"},
+                           {RPCResult::Type::NUM, "bytes", "Bytes written"},
+                           {RPCResult::Type::NUM, "messages_per_syscall", "Average number of messages written per system call"},
+                           {RPCResult::Type::NUM, "cputime", "Thread CPU time spent writing messages, in seconds (0 where not measurable)"},
+                           {RPCResult::Type::NUM, "bytes_per_cpu_second", "Bytes written per second of CPU time spent (0 when not measured)"},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -604,6 +619,17 @@ static RPCHelpMan getnettotals()
     outboundLimit.pushKV("bytes_left_in_cycle", connman.GetOutboundTargetBytesLeft());
     outboundLimit.pushKV("time_left_in_cycle", count_seconds(connman.GetMaxOutboundTimeLeftInCycle()));
     obj.pushKV("uploadtarget", std::move(outboundLimit));
+
+    const SendPathStats send_stats{connman.GetSendPathStats()};
+    const double cpu_seconds{Ticks<SecondsDouble>(send_stats.cpu_time)};
+    UniValue send_path(UniValue::VOBJ);
+    send_path.pushKV("syscalls", send_stats.syscalls);
+    send_path.pushKV("messages", send_stats.messages);
+    send_path.pushKV("bytes", send_stats.bytes);
+    send_path.pushKV("messages_per_syscall", send_stats.syscalls ? double(send_stats.messages) / send_stats.syscalls : 0.0);
+    send_path.pushKV("cputime", cpu_seconds);
+    send_path.pushKV("bytes_per_cpu_second", cpu_seconds > 0 ? send_stats.bytes / cpu_seconds : 0.0);
+    obj.pushKV("sendpath", std::move(send_path));
     return obj;
 },
     };
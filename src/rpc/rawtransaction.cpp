@@ -276,7 +276,7 @@ static RPCHelpMan getrawtransaction()
                 },
                 {
                     RPCResult{"if verbosity is not set or set to 0",
-                         RPCResult::Type::STR, "data", "The serialized transaction as a hex-encoded string for 'txid'"
+                         RPCResult::Type::STR_HEX, "data", "The serialized transaction as a hex-encoded string for 'txid'"
                      },
                      RPCResult{"if verbosity is set to 1",
                          RPCResult::Type::OBJ, "", "",
@@ -61,6 +61,23 @@ public:
     std::string peerAddr;
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    /**
+     * Set by transports that can send a result while it is being produced.
+     * Methods with potentially large results may write the result here, as
+     * a single JSON value, instead of returning it. Writing may block on a
+     * slow client, so no locks should be held while doing so.
+     */
+    UniValueWriter* m_result_writer{nullptr};
+    /**
+     * Set by transports that reply in CBOR. Methods encode their result here,
+     * as described by their documented results, and return null instead.
+     */
+    std::string* m_cbor_result{nullptr};
+    /**
+     * Set by transports that can park a request until the tip changes. Methods
+     * that wait for that may throw RPCTipWait then, see AwaitTipChange.
+     */
+    bool m_allow_park{false};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
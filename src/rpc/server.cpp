@@ -12,6 +12,7 @@
 #include <logging.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
+#include <node/response_cache.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <sync.h>
@@ -22,8 +23,11 @@
 #include <validation.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -42,10 +46,29 @@ struct RPCCommandExecutionInfo
     SteadyClock::time_point start;
 };
 
+/** Completed calls of a method and how long they took. */
+struct RPCMethodStats
+{
+    uint64_t count{0};
+    std::chrono::microseconds total_duration{0};
+    //! Bucket i counts the calls that took less than 2^i microseconds and at
+    //! least 2^(i-1) of them.
+    std::array<uint64_t, 48> duration_histogram{};
+
+    void Add(std::chrono::microseconds duration)
+    {
+        ++count;
+        total_duration += duration;
+        const auto bucket{std::bit_width(uint64_t(std::max<int64_t>(duration.count(), 0)))};
+        ++duration_histogram[std::min<size_t>(bucket, duration_histogram.size() - 1)];
+    }
+};
+
 struct RPCServerInfo
 {
     Mutex mutex;
     std::list<RPCCommandExecutionInfo> active_commands GUARDED_BY(mutex);
+    std::map<std::string, RPCMethodStats> method_stats GUARDED_BY(mutex);
 };
 
 static RPCServerInfo g_rpc_server_info;
@@ -61,6 +84,7 @@ struct RPCCommandExecution
     ~RPCCommandExecution()
     {
         LOCK(g_rpc_server_info.mutex);
+        g_rpc_server_info.method_stats[it->method].Add(std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - it->start));
         g_rpc_server_info.active_commands.erase(it);
     }
 };
@@ -208,6 +232,30 @@ static RPCHelpMan getrpcinfo()
                                  {RPCResult::Type::NUM, "duration", "The running time in microseconds"},
                             }},
                         }},
+                        {RPCResult::Type::OBJ_DYN, "commands", "The calls completed since startup, by method",
+                        {
+                            {RPCResult::Type::OBJ, "method", "",
+                            {
+                                {RPCResult::Type::NUM, "count", "The number of calls"},
+                                {RPCResult::Type::NUM, "total_duration", "The total running time of the calls in microseconds"},
+                                {RPCResult::Type::ARR, "histogram", "The number of calls by running time, leaving out running times that did not occur",
+                                {
+                                    {RPCResult::Type::OBJ, "", "",
+                                    {
+                                        {RPCResult::Type::NUM, "duration", "The calls took less than this many microseconds, and at least half as many"},
+                                        {RPCResult::Type::NUM, "count", "The number of calls"},
+                                    }},
+                                }},
+                            }},
+                        }},
+                        {RPCResult::Type::OBJ, "response_cache", /*optional=*/true, "The cache of responses for block data (only present if -responsecache is not 0)",
+                        {
+                            {RPCResult::Type::NUM, "entries", "The number of cached responses"},
+                            {RPCResult::Type::NUM, "size", "The size of the cached responses and their keys in bytes"},
+                            {RPCResult::Type::NUM, "max_size", "The maximum size in bytes"},
+                            {RPCResult::Type::NUM, "hits", "The number of requests replied to from the cache since startup"},
+                            {RPCResult::Type::NUM, "misses", "The number of requests since startup for responses that were not in the cache"},
+                        }},
                         {RPCResult::Type::STR, "logpath", "The complete file path to the debug log"},
                     }
                 },
@@ -225,8 +273,37 @@ static RPCHelpMan getrpcinfo()
         active_commands.push_back(std::move(entry));
     }
 
+    UniValue commands(UniValue::VOBJ);
+    for (const auto& [method, stats] : g_rpc_server_info.method_stats) {
+        UniValue histogram(UniValue::VARR);
+        for (size_t i{0}; i < stats.duration_histogram.size(); ++i) {
+            if (stats.duration_histogram[i] == 0) continue;
+            UniValue bucket(UniValue::VOBJ);
+            bucket.pushKV("duration", uint64_t{1} << i);
+            bucket.pushKV("count", stats.duration_histogram[i]);
+            histogram.push_back(std::move(bucket));
+        }
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("count", stats.count);
+        entry.pushKV("total_duration", int64_t{stats.total_duration.count()});
+        entry.pushKV("histogram", std::move(histogram));
+        commands.pushKV(method, std::move(entry));
+    }
+
     UniValue result(UniValue::VOBJ);
     result.pushKV("active_commands", std::move(active_commands));
+    result.pushKV("commands", std::move(commands));
+
+    if (const node::ResponseCache* cache{GetAnyResponseCache(request.context)}) {
+        const node::ResponseCache::Stats stats{cache->GetStats()};
+        UniValue response_cache(UniValue::VOBJ);
+        response_cache.pushKV("entries", uint64_t{stats.entries});
+        response_cache.pushKV("size", uint64_t{stats.size});
+        response_cache.pushKV("max_size", uint64_t{cache->MaxSize()});
+        response_cache.pushKV("hits", stats.hits);
+        response_cache.pushKV("misses", stats.misses);
+        result.pushKV("response_cache", std::move(response_cache));
+    }
 
     const std::string path = LogInstance().m_file_path.utf8string();
     UniValue log_path(UniValue::VSTR, path);
@@ -8,10 +8,13 @@
 
 #include <rpc/request.h>
 #include <rpc/util.h>
+#include <uint256.h>
+#include <util/time.h>
 
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <optional>
 #include <string>
 
 #include <univalue.h>
@@ -24,6 +27,21 @@ bool IsRPCRunning();
 /** Throw JSONRPCError if RPC is not running */
 void RpcInterruptionPoint();
 
+/**
+ * Thrown by methods waiting for the chain tip to change, so that the transport
+ * can park the request without occupying a thread. Once the tip differs from
+ * @p tip, @p deadline passed or the node is shutting down, @p resume is called
+ * from any thread to continue the method. It returns the result, or throws
+ * another RPCTipWait to keep waiting unless @p interrupted is set.
+ *
+ * Only thrown for requests with JSONRPCRequest::m_allow_park set.
+ */
+struct RPCTipWait {
+    uint256 tip;
+    std::optional<SteadyClock::time_point> deadline;
+    std::function<UniValue(bool interrupted)> resume;
+};
+
 /**
  * Set the RPC warmup status.  When this is done, all RPC calls will error out
  * immediately with RPC_IN_WARMUP.
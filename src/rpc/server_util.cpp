@@ -6,18 +6,26 @@
 
 #include <chain.h>
 #include <common/args.h>
+#include <interfaces/mining.h>
 #include <net_processing.h>
 #include <node/context.h>
+#include <node/mempool_forecast.h>
 #include <node/miner.h>
+#include <node/response_cache.h>
 #include <policy/fees.h>
 #include <pow.h>
 #include <rpc/protocol.h>
 #include <rpc/request.h>
+#include <rpc/server.h>
 #include <txmempool.h>
+#include <univalue.h>
 #include <util/any.h>
 #include <validation.h>
 
 #include <any>
+#include <optional>
+#include <stdexcept>
+#include <utility>
 
 using node::NodeContext;
 using node::UpdateTime;
@@ -97,6 +105,14 @@ CBlockPolicyEstimator& EnsureAnyFeeEstimator(const std::any& context)
     return EnsureFeeEstimator(EnsureAnyNodeContext(context));
 }
 
+node::MempoolForecaster& EnsureMempoolForecaster(const NodeContext& node)
+{
+    if (!node.mempool_forecaster) {
+        throw JSONRPCError(RPC_CLIENT_MEMPOOL_DISABLED, "Mempool disabled or instance not found");
+    }
+    return *node.mempool_forecaster;
+}
+
 CConnman& EnsureConnman(const NodeContext& node)
 {
     if (!node.connman) {
@@ -134,6 +150,44 @@ AddrMan& EnsureAnyAddrman(const std::any& context)
     return EnsureAddrman(EnsureAnyNodeContext(context));
 }
 
+node::ResponseCache* GetAnyResponseCache(const std::any& context)
+{
+    auto node_context = util::AnyPtr<NodeContext>(context);
+    return node_context ? node_context->response_cache.get() : nullptr;
+}
+
+UniValue SerializedResult(const JSONRPCRequest& request, std::string_view json)
+{
+    if (request.m_result_writer) {
+        request.m_result_writer->raw(json);
+        return NullUniValue;
+    }
+    UniValue result;
+    if (!result.read(json)) {
+        throw std::runtime_error("Invalid JSON in serialized result");
+    }
+    return result;
+}
+
+UniValue AwaitTipChange(const JSONRPCRequest& request, RPCTipWait wait)
+{
+    if (request.m_allow_park) throw wait;
+    interfaces::Mining& miner{EnsureMining(EnsureAnyNodeContext(request.context))};
+    while (true) {
+        bool interrupted{false};
+        if (!wait.deadline) {
+            interrupted = !miner.waitTipChanged(wait.tip);
+        } else if (const auto now{SteadyClock::now()}; now < *wait.deadline) {
+            interrupted = !miner.waitTipChanged(wait.tip, *wait.deadline - now);
+        }
+        try {
+            return wait.resume(interrupted);
+        } catch (RPCTipWait& next) {
+            wait = std::move(next);
+        }
+    }
+}
+
 void NextEmptyBlockIndex(CBlockIndex& tip, const Consensus::Params& consensusParams, CBlockIndex& next_index)
 {
     CBlockHeader next_header{};
@@ -6,6 +6,7 @@
 #define BITCOIN_RPC_SERVER_UTIL_H
 
 #include <any>
+#include <string_view>
 
 #include <consensus/params.h>
 
@@ -16,10 +17,15 @@ class CBlockPolicyEstimator;
 class CConnman;
 class CTxMemPool;
 class ChainstateManager;
+class JSONRPCRequest;
 class PeerManager;
 class BanMan;
+class UniValue;
+struct RPCTipWait;
 namespace node {
+class MempoolForecaster;
 struct NodeContext;
+class ResponseCache;
 } // namespace node
 namespace interfaces {
 class Mining;
@@ -36,12 +42,29 @@ ChainstateManager& EnsureChainman(const node::NodeContext& node);
 ChainstateManager& EnsureAnyChainman(const std::any& context);
 CBlockPolicyEstimator& EnsureFeeEstimator(const node::NodeContext& node);
 CBlockPolicyEstimator& EnsureAnyFeeEstimator(const std::any& context);
+node::MempoolForecaster& EnsureMempoolForecaster(const node::NodeContext& node);
 CConnman& EnsureConnman(const node::NodeContext& node);
 interfaces::Mining& EnsureMining(const node::NodeContext& node);
 PeerManager& EnsurePeerman(const node::NodeContext& node);
 AddrMan& EnsureAddrman(const node::NodeContext& node);
 AddrMan& EnsureAnyAddrman(const std::any& context);
 
+/** The cache of responses for block data, or nullptr if it is disabled. */
+node::ResponseCache* GetAnyResponseCache(const std::any& context);
+/**
+ * Return a result that was serialized before, such as one from the response
+ * cache: write it out as it is if the transport of the request takes results
+ * written to JSONRPCRequest::m_result_writer, or parse it back.
+ */
+UniValue SerializedResult(const JSONRPCRequest& request, std::string_view json);
+/**
+ * Wait for the chain tip to change as described by @p wait, and return the
+ * result of the method waiting. Requests that can be parked throw @p wait for
+ * the transport; others block here, calling RPCTipWait::resume until it no
+ * longer throws another wait.
+ */
+UniValue AwaitTipChange(const JSONRPCRequest& request, RPCTipWait wait);
+
 /** Return an empty block index on top of the tip, with height, time and nBits set */
 void NextEmptyBlockIndex(CBlockIndex& tip, const Consensus::Params& consensusParams, CBlockIndex& next_index);
 
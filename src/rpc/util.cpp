@@ -15,6 +15,7 @@
 #include <node/types.h>
 #include <outputtype.h>
 #include <pow.h>
+#include <rpc/cbor.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
 #include <script/interpreter.h>
@@ -660,9 +661,12 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
     }
     CHECK_NONFATAL(m_req == nullptr);
     m_req = &request;
+    const size_t written{request.m_result_writer ? request.m_result_writer->size() : 0};
     UniValue ret = m_fun(*this, request);
     m_req = nullptr;
-    if (gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
+    // A result written to m_result_writer is gone and cannot be checked.
+    const bool streamed{request.m_result_writer && request.m_result_writer->size() != written};
+    if (!streamed && gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
         UniValue mismatch{UniValue::VARR};
         for (const auto& res : m_results.m_results) {
             UniValue match{res.MatchesType(ret)};
@@ -684,6 +688,10 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
                           CLIENT_BUGREPORT)};
         }
     }
+    if (request.m_cbor_result && !streamed) {
+        EncodeCBOR(*request.m_cbor_result, ret, m_results);
+        return NullUniValue;
+    }
     return ret;
 }
 
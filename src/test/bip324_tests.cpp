@@ -94,6 +94,18 @@ void TestBIP324PacketVector(
         BOOST_CHECK(std::ranges::equal(out_ciphertext_endswith, std::span{ciphertext}.last(out_ciphertext_endswith.size())));
     }
 
+    // Encrypting contents that are already in the output buffer must give the same ciphertext.
+    BIP324Cipher inplace_cipher(key, ellswift_ours);
+    inplace_cipher.Initialize(ellswift_theirs, in_initiating);
+    for (uint32_t i = 0; i < in_idx; ++i) {
+        std::vector<std::byte> dummy(cipher.EXPANSION);
+        inplace_cipher.EncryptInPlace(dummy, {}, true);
+    }
+    std::vector<std::byte> inplace(contents.size() + cipher.EXPANSION);
+    std::ranges::copy(contents, inplace.begin() + cipher.LENGTH_LEN + cipher.HEADER_LEN);
+    inplace_cipher.EncryptInPlace(inplace, in_aad, in_ignore);
+    BOOST_CHECK(inplace == ciphertext);
+
     for (unsigned error = 0; error <= 12; ++error) {
         // error selects a type of error introduced:
         // - error=0: no errors, decryption should be successful
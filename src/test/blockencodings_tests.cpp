@@ -9,6 +9,7 @@
 #include <streams.h>
 #include <test/util/random.h>
 #include <test/util/txmempool.h>
+#include <util/threadpool.h>
 
 #include <test/util/setup_common.h>
 
@@ -354,6 +355,47 @@ BOOST_AUTO_TEST_CASE(ReceiveWithExtraTransactions) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(ParallelMempoolScan)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+    auto rand_ctx(FastRandomContext(uint256{42}));
+
+    // A mempool large enough to be split over several scanning tasks, and a block containing
+    // some of its transactions as well as some that are not in it.
+    CBlock block;
+    block.nVersion = 42;
+    block.hashPrevBlock = rand_ctx.rand256();
+    block.nBits = 0x207fffff;
+    block.vtx.push_back(MakeTransactionRef(BuildTransactionTestCase()));
+    size_t expected_available{1};
+    LOCK2(cs_main, pool.cs);
+    for (size_t i = 0; i < 3 * SHORTID_SCAN_MIN_PER_TASK; ++i) {
+        CMutableTransaction mtx = BuildTransactionTestCase();
+        mtx.vin[0].prevout.hash = Txid::FromUint256(rand_ctx.rand256());
+        const CTransactionRef tx = MakeTransactionRef(std::move(mtx));
+        const bool in_pool{i % 20 != 1};
+        if (in_pool) AddToMempool(pool, entry.FromTx(tx));
+        if (i % 100 == 0 || !in_pool) block.vtx.push_back(tx);
+        if (i % 100 == 0) ++expected_available;
+    }
+    const CBlockHeaderAndShortTxIDs cmpctblock{block, rand_ctx.rand64()};
+
+    util::ThreadPool workers{"test"};
+    workers.Start(3);
+    PartiallyDownloadedBlock sequential(&pool);
+    PartiallyDownloadedBlock parallel(&pool);
+    BOOST_REQUIRE(sequential.InitData(cmpctblock, empty_extra_txn) == READ_STATUS_OK);
+    BOOST_REQUIRE(parallel.InitData(cmpctblock, empty_extra_txn, &workers) == READ_STATUS_OK);
+    size_t available{0};
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        BOOST_CHECK_EQUAL(parallel.IsTxAvailable(i), sequential.IsTxAvailable(i));
+        available += parallel.IsTxAvailable(i);
+    }
+    // The coinbase is prefilled, and all others that are in the mempool were found.
+    BOOST_CHECK_EQUAL(available, expected_available);
+}
+
 BOOST_AUTO_TEST_CASE(TransactionsRequestSerializationTest) {
     BlockTransactionsRequest req1;
     req1.blockhash = m_rng.rand256();
@@ -531,4 +531,81 @@ BOOST_AUTO_TEST_CASE(rolling_bloom)
     }
 }
 
+BOOST_AUTO_TEST_CASE(rolling_cuckoo)
+{
+    SeedRandomForTest(SeedRand::ZEROS);
+
+    // last-100-entry, 1% false positive:
+    RollingCuckooFilter<uint16_t> rc1(100, 0.01);
+
+    // Overfill:
+    static const int DATASIZE=399;
+    std::vector<unsigned char> data[DATASIZE];
+    for (int i = 0; i < DATASIZE; i++) {
+        data[i] = RandomData();
+        rc1.insert(data[i]);
+    }
+    // Last 100 guaranteed to be remembered:
+    for (int i = 299; i < DATASIZE; i++) {
+        BOOST_CHECK(rc1.contains(data[i]));
+    }
+
+    // Same worst case as for the rolling bloom filter above.
+    unsigned int nHits = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (rc1.contains(RandomData()))
+            ++nHits;
+    }
+    // Expect about 100 hits
+    BOOST_CHECK_EQUAL(nHits, 69U);
+
+    BOOST_CHECK(rc1.contains(data[DATASIZE-1]));
+    rc1.reset();
+    BOOST_CHECK(!rc1.contains(data[DATASIZE-1]));
+
+    // Now roll through data, make sure last 100 entries
+    // are always remembered:
+    for (int i = 0; i < DATASIZE; i++) {
+        if (i >= 100)
+            BOOST_CHECK(rc1.contains(data[i-100]));
+        rc1.insert(data[i]);
+        BOOST_CHECK(rc1.contains(data[i]));
+    }
+
+    // Insert 999 more random entries:
+    for (int i = 0; i < 999; i++) {
+        std::vector<unsigned char> d = RandomData();
+        rc1.insert(d);
+        BOOST_CHECK(rc1.contains(d));
+    }
+    // Sanity check to make sure the filter isn't just filling up:
+    nHits = 0;
+    for (int i = 0; i < DATASIZE; i++) {
+        if (rc1.contains(data[i]))
+            ++nHits;
+    }
+    // Expect about 5 false positives
+    BOOST_CHECK_EQUAL(nHits, 2U);
+
+    // The parameters of the per-peer known transaction filter. Every one of
+    // the last 50000 entries is remembered, and the table is smaller than
+    // the rolling bloom filter's.
+    RollingCuckooFilter<uint32_t> rc2(50000, 0.000001);
+    std::vector<std::vector<unsigned char>> tx_data;
+    for (int i = 0; i < 100000; i++) {
+        tx_data.push_back(RandomData());
+        rc2.insert(tx_data.back());
+    }
+    for (int i = 50000; i < 100000; i++) {
+        BOOST_CHECK(rc2.contains(tx_data[i]));
+    }
+    nHits = 0;
+    for (int i = 0; i < 100000; i++) {
+        if (rc2.contains(RandomData()))
+            ++nHits;
+    }
+    BOOST_CHECK_EQUAL(nHits, 0U);
+    BOOST_CHECK_LT(rc2.DynamicMemoryUsage(), CRollingBloomFilter(50000, 0.000001).DynamicMemoryUsage() * 2 / 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
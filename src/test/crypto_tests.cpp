@@ -848,6 +848,37 @@ BOOST_AUTO_TEST_CASE(chacha20_midblock)
     BOOST_CHECK(std::ranges::equal(std::span{block}.last(52), b3));
 }
 
+BOOST_AUTO_TEST_CASE(chacha20poly1305_implementations)
+{
+    // Compare whichever implementations are available to the standard ones.
+    for (int i = 0; i < 100; ++i) {
+        const auto key{m_rng.randbytes<std::byte>(32)};
+        const auto msg{m_rng.randbytes<std::byte>(m_rng.randrange(4096))};
+        // Sometimes start right before the block counter overflows.
+        const ChaCha20::Nonce96 nonce{m_rng.rand32(), m_rng.rand64()};
+        const uint32_t counter{m_rng.randbool() ? m_rng.rand32() : uint32_t(-1 - m_rng.randrange(16))};
+
+        std::vector<std::byte> crypted[2], keystream[2];
+        std::byte tag[2][Poly1305::TAGLEN];
+        for (int standard = 0; standard < 2; ++standard) {
+            ChaCha20AutoDetect(standard ? chacha20_implementation::STANDARD : chacha20_implementation::USE_ALL);
+            Poly1305AutoDetect(standard ? poly1305_implementation::STANDARD : poly1305_implementation::USE_ALL);
+            ChaCha20 c20{key};
+            c20.Seek(nonce, counter);
+            crypted[standard].resize(msg.size());
+            c20.Crypt(msg, crypted[standard]);
+            keystream[standard].resize(msg.size());
+            c20.Keystream(keystream[standard]);
+            Poly1305{key}.Update(msg).Finalize(tag[standard]);
+        }
+        BOOST_CHECK(crypted[0] == crypted[1]);
+        BOOST_CHECK(keystream[0] == keystream[1]);
+        BOOST_CHECK(std::ranges::equal(tag[0], tag[1]));
+    }
+    ChaCha20AutoDetect();
+    Poly1305AutoDetect();
+}
+
 BOOST_AUTO_TEST_CASE(poly1305_testvector)
 {
     // RFC 7539, section 2.5.2.
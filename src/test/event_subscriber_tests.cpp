@@ -0,0 +1,126 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <chain.h>
+#include <kernel/chain.h>
+#include <kernel/mempool_entry.h>
+#include <kernel/mempool_removal_reason.h>
+#include <node/event_subscriber.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+#include <univalue.h>
+#include <validationinterface.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using node::EventSubscriber;
+
+BOOST_FIXTURE_TEST_SUITE(event_subscriber_tests, ChainTestingSetup)
+
+static UniValue ParseEvent(const std::string& line)
+{
+    UniValue event;
+    BOOST_REQUIRE(event.read(line));
+    return event;
+}
+
+BOOST_AUTO_TEST_CASE(events)
+{
+    const auto subscriber{std::make_shared<EventSubscriber>()};
+    m_node.validation_signals->RegisterSharedValidationInterface(subscriber);
+
+    // Nothing happened yet.
+    BOOST_CHECK(subscriber->Wait(std::chrono::milliseconds{1}).empty());
+
+    const CBlock block;
+    const uint256 block_hash{block.GetHash()};
+    CBlockIndex index{block};
+    index.phashBlock = &block_hash;
+    index.nHeight = 7;
+    const auto pblock{std::make_shared<const CBlock>(block)};
+    CMutableTransaction mtx;
+    mtx.vin.resize(1);
+    mtx.vout.resize(1);
+    const CTransactionRef tx{MakeTransactionRef(mtx)};
+
+    m_node.validation_signals->BlockConnected(ChainstateRole::NORMAL, pblock, &index);
+    // Blocks of a background chainstate are not reported.
+    m_node.validation_signals->BlockConnected(ChainstateRole::BACKGROUND, pblock, &index);
+    m_node.validation_signals->TransactionAddedToMempool(NewMempoolTransactionInfo{tx, /*fee=*/0, /*vsize=*/100, /*height=*/7,
+                                                                                   /*mempool_limit_bypassed=*/false, /*submitted_in_package=*/false,
+                                                                                   /*chainstate_is_current=*/true, /*has_no_mempool_parents=*/true},
+                                                         /*mempool_sequence=*/1);
+    m_node.validation_signals->TransactionRemovedFromMempool(tx, MemPoolRemovalReason::EXPIRY, /*mempool_sequence=*/2);
+    m_node.validation_signals->BlockDisconnected(pblock, &index);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    const std::vector<std::string> events{subscriber->Wait(std::chrono::milliseconds{1})};
+    BOOST_REQUIRE_EQUAL(events.size(), 4U);
+    UniValue event{ParseEvent(events[0])};
+    BOOST_CHECK_EQUAL(event["type"].get_str(), "blockconnected");
+    BOOST_CHECK_EQUAL(event["hash"].get_str(), block_hash.GetHex());
+    BOOST_CHECK_EQUAL(event["height"].getInt<int>(), 7);
+    event = ParseEvent(events[1]);
+    BOOST_CHECK_EQUAL(event["type"].get_str(), "txadded");
+    BOOST_CHECK_EQUAL(event["txid"].get_str(), tx->GetHash().GetHex());
+    BOOST_CHECK_EQUAL(event["wtxid"].get_str(), tx->GetWitnessHash().GetHex());
+    BOOST_CHECK_EQUAL(event["sequence"].getInt<int>(), 1);
+    event = ParseEvent(events[2]);
+    BOOST_CHECK_EQUAL(event["type"].get_str(), "txremoved");
+    BOOST_CHECK_EQUAL(event["reason"].get_str(), "expiry");
+    BOOST_CHECK_EQUAL(event["sequence"].getInt<int>(), 2);
+    event = ParseEvent(events[3]);
+    BOOST_CHECK_EQUAL(event["type"].get_str(), "blockdisconnected");
+    BOOST_CHECK_EQUAL(event["height"].getInt<int>(), 7);
+    // Events are taken only once.
+    BOOST_CHECK(subscriber->Wait(std::chrono::milliseconds{1}).empty());
+    BOOST_CHECK(!subscriber->Overflowed());
+
+    m_node.validation_signals->UnregisterSharedValidationInterface(subscriber);
+}
+
+BOOST_AUTO_TEST_CASE(overflow)
+{
+    const auto subscriber{std::make_shared<EventSubscriber>(/*max_queued=*/2)};
+    m_node.validation_signals->RegisterSharedValidationInterface(subscriber);
+
+    const CBlock block;
+    const uint256 block_hash{block.GetHash()};
+    CBlockIndex index{block};
+    index.phashBlock = &block_hash;
+    const auto pblock{std::make_shared<const CBlock>(block)};
+    for (int i{0}; i < 3; ++i) {
+        m_node.validation_signals->BlockConnected(ChainstateRole::NORMAL, pblock, &index);
+    }
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    // The events queued before the overflow are kept, later ones are dropped.
+    BOOST_CHECK(subscriber->Overflowed());
+    BOOST_CHECK_EQUAL(subscriber->Wait(std::chrono::milliseconds{1}).size(), 2U);
+    m_node.validation_signals->BlockConnected(ChainstateRole::NORMAL, pblock, &index);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(subscriber->Wait(std::chrono::milliseconds{1}).empty());
+
+    m_node.validation_signals->UnregisterSharedValidationInterface(subscriber);
+}
+
+BOOST_AUTO_TEST_CASE(interrupt)
+{
+    EventSubscriber subscriber;
+    BOOST_CHECK(!subscriber.Interrupted());
+    subscriber.Interrupt();
+    BOOST_CHECK(subscriber.Interrupted());
+    // Returns right away instead of waiting for the timeout.
+    BOOST_CHECK(subscriber.Wait(std::chrono::hours{1}).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
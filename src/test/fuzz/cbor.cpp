@@ -0,0 +1,29 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cbor.h>
+#include <test/fuzz/fuzz.h>
+#include <univalue.h>
+
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+FUZZ_TARGET(cbor)
+{
+    const std::string_view data{reinterpret_cast<const char*>(buffer.data()), buffer.size()};
+    UniValue value;
+    try {
+        value = DecodeCBOR(data);
+    } catch (const std::runtime_error&) {
+        return;
+    }
+    // Once decoded, values are encoded and decoded without change.
+    std::string encoded;
+    EncodeCBOR(encoded, value);
+    std::string reencoded;
+    EncodeCBOR(reencoded, DecodeCBOR(encoded));
+    assert(encoded == reencoded);
+}
@@ -4,52 +4,74 @@
 
 #include <httpserver.h>
 #include <netaddress.h>
+#include <rpc/protocol.h>
 #include <test/fuzz/FuzzedDataProvider.h>
 #include <test/fuzz/fuzz.h>
 #include <test/fuzz/util.h>
 #include <util/signalinterrupt.h>
-#include <util/strencodings.h>
-
-#include <event2/buffer.h>
-#include <event2/event.h>
-#include <event2/http.h>
-#include <event2/http_struct.h>
 
 #include <cassert>
 #include <cstdint>
+#include <optional>
 #include <string>
-#include <vector>
-
-extern "C" int evhttp_parse_firstline_(struct evhttp_request*, struct evbuffer*);
-extern "C" int evhttp_parse_headers_(struct evhttp_request*, struct evbuffer*);
+#include <string_view>
 
 std::string RequestMethodString(HTTPRequest::RequestMethod m);
 
+namespace {
+struct ParseResult {
+    size_t consumed{0};
+    std::optional<int> error;
+};
+
+ParseResult Parse(HTTPRequestParser& parser, std::string_view data, FuzzedDataProvider* split)
+{
+    ParseResult result;
+    try {
+        while (result.consumed < data.size() && !parser.Complete()) {
+            const size_t part{split ? split->ConsumeIntegralInRange<size_t>(1, data.size() - result.consumed) : data.size()};
+            result.consumed += parser.Feed(data.substr(result.consumed, part));
+        }
+    } catch (const HTTPParseError& e) {
+        result.error = e.status;
+    }
+    return result;
+}
+} // namespace
+
 FUZZ_TARGET(http_request)
 {
     FuzzedDataProvider fuzzed_data_provider{buffer.data(), buffer.size()};
-    evhttp_request* evreq = evhttp_request_new(nullptr, nullptr);
-    assert(evreq != nullptr);
-    evreq->kind = EVHTTP_REQUEST;
-    evbuffer* evbuf = evbuffer_new();
-    assert(evbuf != nullptr);
-    const std::vector<uint8_t> http_buffer = ConsumeRandomLengthByteVector(fuzzed_data_provider, 4096);
-    evbuffer_add(evbuf, http_buffer.data(), http_buffer.size());
-    // Avoid constructing requests that will be interpreted by libevent as PROXY requests to avoid triggering
-    // a nullptr dereference. The dereference (req->evcon->http_server) takes place in evhttp_parse_request_line
-    // and is a consequence of our hacky but necessary use of the internal function evhttp_parse_firstline_ in
-    // this fuzzing harness. The workaround is not aesthetically pleasing, but it successfully avoids the troublesome
-    // code path. " http:// HTTP/1.1\n" was a crashing input prior to this workaround.
-    const std::string http_buffer_str = ToLower(std::string{http_buffer.begin(), http_buffer.end()});
-    if (http_buffer_str.find(" http://") != std::string::npos || http_buffer_str.find(" https://") != std::string::npos ||
-        evhttp_parse_firstline_(evreq, evbuf) != 1 || evhttp_parse_headers_(evreq, evbuf) != 1) {
-        evbuffer_free(evbuf);
-        evhttp_request_free(evreq);
+    const std::string http_buffer{fuzzed_data_provider.ConsumeRandomLengthString(4096)};
+
+    // Bytes are parsed the same whether they are received at once or in parts.
+    HTTPRequestParser parser;
+    const ParseResult result{Parse(parser, http_buffer, nullptr)};
+    HTTPRequestParser split_parser;
+    const ParseResult split_result{Parse(split_parser, http_buffer, &fuzzed_data_provider)};
+    assert(result.error == split_result.error);
+    if (result.error) {
+        assert(*result.error == HTTP_BAD_REQUEST || *result.error == HTTP_PAYLOAD_TOO_LARGE);
         return;
     }
+    assert(result.consumed == split_result.consumed);
+    assert(parser.Complete() == split_parser.Complete());
+    if (!parser.Complete()) {
+        assert(result.consumed == http_buffer.size());
+        return;
+    }
+    HTTPRequestData data{parser.Take()};
+    const HTTPRequestData split_data{split_parser.Take()};
+    assert(data.method == split_data.method);
+    assert(data.uri == split_data.uri);
+    assert(data.minor_version == split_data.minor_version);
+    assert(data.headers == split_data.headers);
+    assert(data.body == split_data.body);
+    assert(!parser.Complete() && !parser.HeadComplete());
+    (void)data.KeepAlive();
 
     util::SignalInterrupt interrupt;
-    HTTPRequest http_request{evreq, interrupt, true};
+    HTTPRequest http_request{/*connection=*/nullptr, std::move(data), interrupt};
     const HTTPRequest::RequestMethod request_method = http_request.GetRequestMethod();
     (void)RequestMethodString(request_method);
     (void)http_request.GetURI();
@@ -58,11 +80,9 @@ FUZZ_TARGET(http_request)
     (void)http_request.GetHeader(header);
     (void)http_request.WriteHeader(header, fuzzed_data_provider.ConsumeRandomLengthString(16));
     (void)http_request.GetHeader(header);
-    const std::string body = http_request.ReadBody();
-    assert(body.empty());
+    (void)http_request.ReadBody();
+    assert(http_request.ReadBody().empty());
     const CService service = http_request.GetPeer();
     assert(service.ToStringAddrPort() == "[::]:0");
-
-    evbuffer_free(evbuf);
-    evhttp_request_free(evreq);
+    http_request.WriteReply(HTTP_OK);
 }
@@ -46,3 +46,41 @@ FUZZ_TARGET(rolling_bloom_filter)
             });
     }
 }
+
+FUZZ_TARGET(rolling_cuckoo_filter)
+{
+    SeedRandomStateForTest(SeedRand::ZEROS);
+    FuzzedDataProvider fuzzed_data_provider(buffer.data(), buffer.size());
+
+    const unsigned int n_elements{fuzzed_data_provider.ConsumeIntegralInRange<unsigned int>(1, 1000)};
+    const double fp_rate{0.999 / fuzzed_data_provider.ConsumeIntegralInRange<unsigned int>(1, std::numeric_limits<unsigned int>::max())};
+    RollingCuckooFilter<uint16_t> filter16{n_elements, fp_rate};
+    RollingCuckooFilter<uint32_t> filter32{n_elements, fp_rate};
+    LIMITED_WHILE(fuzzed_data_provider.remaining_bytes() > 0, 3000)
+    {
+        CallOneOf(
+            fuzzed_data_provider,
+            [&] {
+                const std::vector<unsigned char> b = ConsumeRandomLengthByteVector(fuzzed_data_provider);
+                (void)filter16.contains(b);
+                (void)filter32.contains(b);
+                filter16.insert(b);
+                filter32.insert(b);
+                assert(filter16.contains(b));
+                assert(filter32.contains(b));
+            },
+            [&] {
+                const uint256 u256{ConsumeUInt256(fuzzed_data_provider)};
+                (void)filter16.contains(u256);
+                (void)filter32.contains(u256);
+                filter16.insert(u256);
+                filter32.insert(u256);
+                assert(filter16.contains(u256));
+                assert(filter32.contains(u256));
+            },
+            [&] {
+                filter16.reset();
+                filter32.reset();
+            });
+    }
+}
@@ -14,6 +14,7 @@
 #include <util/sock.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cerrno>
@@ -172,6 +173,16 @@ ssize_t FuzzedSock::Send(const void* data, size_t len, int flags) const
     return r;
 }
 
+ssize_t FuzzedSock::SendMany(std::span<const std::span<const uint8_t>> data, int flags) const
+{
+    // Like sendmsg(2), send the buffers in one call, with one fuzzed outcome.
+    std::vector<uint8_t> buffer;
+    for (const auto& buf : data.first(std::min(data.size(), SEND_MANY_MAX_BUFFERS))) {
+        buffer.insert(buffer.end(), buf.begin(), buf.end());
+    }
+    return Send(buffer.data(), buffer.size(), flags);
+}
+
 ssize_t FuzzedSock::Recv(void* buf, size_t len, int flags) const
 {
     // Have a permanent error at recv_errnos[0] because when the fuzzed data is exhausted
@@ -444,6 +455,11 @@ bool FuzzedSock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& even
     return true;
 }
 
+std::unique_ptr<SockWaitSet> FuzzedSock::CreateWaitSet() const
+{
+    return std::make_unique<SockWaitSet>();
+}
+
 bool FuzzedSock::IsConnected(std::string& errmsg) const
 {
     if (m_fuzzed_data_provider.ConsumeBool()) {
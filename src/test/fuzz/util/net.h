@@ -195,6 +195,8 @@ public:
 
     ssize_t Send(const void* data, size_t len, int flags) const override;
 
+    ssize_t SendMany(std::span<const std::span<const uint8_t>> data, int flags) const override;
+
     ssize_t Recv(void* buf, size_t len, int flags) const override;
 
     int Connect(const sockaddr*, socklen_t) const override;
@@ -219,6 +221,8 @@ public:
 
     bool WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per_sock) const override;
 
+    std::unique_ptr<SockWaitSet> CreateWaitSet() const override;
+
     bool IsConnected(std::string& errmsg) const override;
 };
 
@@ -3,10 +3,37 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <httpserver.h>
+#include <rpc/protocol.h>
 #include <test/util/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <string>
+#include <string_view>
+
+/** Parse a request fed one byte at a time, as a slow client would send it. */
+static HTTPRequestData ParseBytewise(std::string_view data)
+{
+    HTTPRequestParser parser;
+    for (size_t i{0}; i < data.size(); ++i) {
+        BOOST_REQUIRE(!parser.Complete());
+        BOOST_REQUIRE_EQUAL(parser.Feed(data.substr(i, 1)), 1U);
+    }
+    BOOST_REQUIRE(parser.Complete());
+    return parser.Take();
+}
+
+static int ParseError(std::string_view data)
+{
+    HTTPRequestParser parser;
+    try {
+        parser.Feed(data);
+    } catch (const HTTPParseError& e) {
+        return e.status;
+    }
+    return 0;
+}
+
 BOOST_FIXTURE_TEST_SUITE(httpserver_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(test_query_parameters)
@@ -39,4 +66,102 @@ BOOST_AUTO_TEST_CASE(test_query_parameters)
     uri = "/rest/endpoint/someresource.json&p1=v1&p2=v2%";
     BOOST_CHECK_EXCEPTION(GetQueryParameterFromUri(uri.c_str(), "p1"), std::runtime_error, HasReason("URI parsing failed, it likely contained RFC 3986 invalid characters"));
 }
+
+BOOST_AUTO_TEST_CASE(parse_request)
+{
+    const std::string request{"POST /wallet/w1?x=1 HTTP/1.1\r\nHost: localhost\r\ncontent-length: 5\r\nX-Folded: a\r\n  b\r\n\r\nhello"};
+    HTTPRequestParser parser;
+    BOOST_CHECK_EQUAL(parser.Feed(request), request.size());
+    BOOST_REQUIRE(parser.Complete());
+    const HTTPRequestData data{parser.Take()};
+    BOOST_CHECK_EQUAL(data.method, "POST");
+    BOOST_CHECK_EQUAL(data.uri, "/wallet/w1?x=1");
+    BOOST_CHECK_EQUAL(data.minor_version, 1);
+    BOOST_CHECK_EQUAL(data.body, "hello");
+    BOOST_CHECK_EQUAL(data.FindHeader("HOST").value(), "localhost");
+    BOOST_CHECK_EQUAL(data.FindHeader("Content-Length").value(), "5");
+    BOOST_CHECK_EQUAL(data.FindHeader("x-folded").value(), "a b");
+    BOOST_CHECK(!data.FindHeader("Connection"));
+    BOOST_CHECK(!parser.Complete());
+
+    const HTTPRequestData bytewise{ParseBytewise(request)};
+    BOOST_CHECK(bytewise.headers == data.headers);
+    BOOST_CHECK_EQUAL(bytewise.body, data.body);
+
+    // Lines may end with a bare LF, and requests without a length have no body.
+    const HTTPRequestData get{ParseBytewise("GET / HTTP/1.0\nConnection: Keep-Alive\n\n")};
+    BOOST_CHECK_EQUAL(get.method, "GET");
+    BOOST_CHECK_EQUAL(get.minor_version, 0);
+    BOOST_CHECK(get.body.empty());
+}
+
+BOOST_AUTO_TEST_CASE(parse_pipelined_requests)
+{
+    const std::string first{"POST / HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"};
+    const std::string second{"\r\nGET /rest/chaininfo.json HTTP/1.1\r\n\r\n"};
+    const std::string received{first + second + "GET /rest/"};
+    HTTPRequestParser parser;
+    // Bytes past the end of a request are left for the next one.
+    BOOST_CHECK_EQUAL(parser.Feed(received), first.size());
+    BOOST_CHECK_EQUAL(parser.Take().body, "{}");
+    BOOST_CHECK_EQUAL(parser.Feed(std::string_view{received}.substr(first.size())), second.size());
+    BOOST_CHECK_EQUAL(parser.Take().uri, "/rest/chaininfo.json");
+    BOOST_CHECK_EQUAL(parser.Feed("GET /rest/"), 10U);
+    BOOST_CHECK(!parser.HeadComplete());
+}
+
+BOOST_AUTO_TEST_CASE(parse_chunked_request)
+{
+    const std::string request{"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                              "5;ext=1\r\nhello\r\nA\r\n, world!!!\r\n0\r\nX-Trailer: 1\r\n\r\nGET"};
+    HTTPRequestParser parser;
+    BOOST_CHECK_EQUAL(parser.Feed(request), request.size() - 3);
+    BOOST_CHECK_EQUAL(parser.Take().body, "hello, world!!!");
+    BOOST_CHECK_EQUAL(ParseBytewise(request.substr(0, request.size() - 3)).body, "hello, world!!!");
+
+    // The head is complete before the body was received.
+    HTTPRequestParser head_parser;
+    head_parser.Feed("POST / HTTP/1.1\r\nExpect: 100-continue\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhel");
+    BOOST_CHECK(head_parser.HeadComplete());
+    BOOST_CHECK(!head_parser.Complete());
+    BOOST_CHECK(head_parser.ExpectsContinue());
+
+    // "100 Continue" is only sent to HTTP/1.1 clients that ask for it.
+    HTTPRequestParser plain_parser;
+    plain_parser.Feed("POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nhel");
+    BOOST_CHECK(!plain_parser.ExpectsContinue());
+    HTTPRequestParser http10_parser;
+    http10_parser.Feed("POST / HTTP/1.0\r\nExpect: 100-continue\r\nContent-Length: 5\r\n\r\nhel");
+    BOOST_CHECK(!http10_parser.ExpectsContinue());
+}
+
+BOOST_AUTO_TEST_CASE(parse_errors)
+{
+    BOOST_CHECK_EQUAL(ParseError("GET /\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("GET / HTTP/2.0\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("GET / HTTP/1.1\r\nno colon\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("GET / HTTP/1.1\r\n folded: first\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nab\r\n"), HTTP_BAD_REQUEST);
+    // The request line and headers are limited to 8 kB, also while they are incomplete.
+    BOOST_CHECK_EQUAL(ParseError("GET /" + std::string(10000, 'x') + " HTTP/1.1\r\n\r\n"), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("GET /" + std::string(10000, 'x')), HTTP_BAD_REQUEST);
+    BOOST_CHECK_EQUAL(ParseError("GET /" + std::string(1000, 'x') + " HTTP/1.1\r\n\r\n"), 0);
+    // The body is limited to 32 MB.
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nContent-Length: 33554433\r\n\r\n"), HTTP_PAYLOAD_TOO_LARGE);
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nContent-Length: 33554432\r\n\r\n"), 0);
+    BOOST_CHECK_EQUAL(ParseError("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nffffffffffffffffffff\r\n"), HTTP_PAYLOAD_TOO_LARGE);
+}
+
+BOOST_AUTO_TEST_CASE(keep_alive)
+{
+    const auto keep_alive{[](std::string_view request) { return ParseBytewise(request).KeepAlive(); }};
+    BOOST_CHECK(keep_alive("GET / HTTP/1.1\r\n\r\n"));
+    BOOST_CHECK(!keep_alive("GET / HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    BOOST_CHECK(!keep_alive("GET / HTTP/1.1\r\nconnection: Upgrade, Close\r\n\r\n"));
+    BOOST_CHECK(!keep_alive("GET / HTTP/1.0\r\n\r\n"));
+    BOOST_CHECK(keep_alive("GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"));
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <kernel/mempool_snapshot.h>
+#include <node/mempool_forecast.h>
+#include <policy/feerate.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <txmempool.h>
+
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <optional>
+
+using node::ForecastBlocks;
+using node::MempoolForecaster;
+
+BOOST_FIXTURE_TEST_SUITE(mempool_forecast_tests, TestingSetup)
+
+static CTransactionRef MakeTx(const std::optional<CTransactionRef>& parent)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = parent ? COutPoint{(*parent)->GetHash(), 0} : COutPoint{Txid::FromUint256(GetRandHash()), 0};
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx.vout[0].nValue = COIN;
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(forecast_blocks)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+
+    // All transactions have the same shape, and thus the same size.
+    const CTransactionRef parent{MakeTx(std::nullopt)};
+    const CTransactionRef child{MakeTx(parent)};
+    const CTransactionRef tx1{MakeTx(std::nullopt)};
+    const CTransactionRef tx2{MakeTx(std::nullopt)};
+    const CTransactionRef tx3{MakeTx(std::nullopt)};
+    const CTransactionRef tx4{MakeTx(std::nullopt)};
+    {
+        LOCK2(::cs_main, pool.cs);
+        // The child pays for its parent, making it the best package.
+        AddToMempool(pool, entry.Fee(0).FromTx(parent));
+        AddToMempool(pool, entry.Fee(10000).FromTx(child));
+        AddToMempool(pool, entry.Fee(4000).FromTx(tx1));
+        AddToMempool(pool, entry.Fee(3000).FromTx(tx2));
+        AddToMempool(pool, entry.Fee(2000).FromTx(tx3));
+        AddToMempool(pool, entry.Fee(1000).FromTx(tx4));
+    }
+    const auto snapshot{pool.GetSnapshot()};
+    const int32_t vsize(Assert(snapshot->Find(tx1->GetHash()))->vsize);
+
+    // Blocks fit two transactions each: {parent, child}, {tx1, tx2}, {tx3, tx4}.
+    const auto forecast{ForecastBlocks(*snapshot, /*num_blocks=*/5, /*block_vsize=*/2 * vsize)};
+    BOOST_CHECK(forecast.exhausted);
+    BOOST_CHECK_EQUAL(forecast.sequence, snapshot->GetStats().sequence);
+    BOOST_REQUIRE_EQUAL(forecast.blocks.size(), 3U);
+    BOOST_CHECK(forecast.blocks[0].min_feerate == CFeeRate(10000, 2 * vsize));
+    BOOST_CHECK(forecast.blocks[0].max_feerate == CFeeRate(10000, 2 * vsize));
+    BOOST_CHECK_EQUAL(forecast.blocks[0].tx_count, 2U);
+    BOOST_CHECK_EQUAL(forecast.blocks[0].vsize, 2 * vsize);
+    BOOST_CHECK(forecast.blocks[1].min_feerate == CFeeRate(3000, vsize));
+    BOOST_CHECK(forecast.blocks[1].max_feerate == CFeeRate(4000, vsize));
+    BOOST_CHECK(forecast.blocks[2].min_feerate == CFeeRate(1000, vsize));
+    BOOST_CHECK_EQUAL(forecast.blocks[2].tx_count, 2U);
+
+    BOOST_CHECK(forecast.EstimateFee(1) == CFeeRate(10000, 2 * vsize));
+    BOOST_CHECK(forecast.EstimateFee(2) == CFeeRate(3000, vsize));
+    // The last block still has room to spare, as does any block after it.
+    BOOST_CHECK(forecast.EstimateFee(3) == CFeeRate(0));
+    BOOST_CHECK(forecast.EstimateFee(10) == CFeeRate(0));
+
+    // Only the requested number of blocks is simulated. Beyond that, the
+    // feerate of the last simulated block is the best guess.
+    const auto partial{ForecastBlocks(*snapshot, /*num_blocks=*/2, /*block_vsize=*/2 * vsize)};
+    BOOST_CHECK(!partial.exhausted);
+    BOOST_REQUIRE_EQUAL(partial.blocks.size(), 2U);
+    BOOST_CHECK(partial.EstimateFee(2) == CFeeRate(3000, vsize));
+    BOOST_CHECK(partial.EstimateFee(3) == CFeeRate(3000, vsize));
+
+    // Everything fits into the first block.
+    const auto roomy{ForecastBlocks(*snapshot, /*num_blocks=*/5, /*block_vsize=*/100 * vsize)};
+    BOOST_CHECK(roomy.exhausted);
+    BOOST_REQUIRE_EQUAL(roomy.blocks.size(), 1U);
+    BOOST_CHECK_EQUAL(roomy.blocks[0].tx_count, 6U);
+    BOOST_CHECK(roomy.blocks[0].min_feerate == CFeeRate(1000, vsize));
+    BOOST_CHECK(roomy.EstimateFee(1) == CFeeRate(0));
+
+    // An empty mempool needs no fee at all.
+    const auto empty{ForecastBlocks(kernel::MempoolSnapshot{}, /*num_blocks=*/5, /*block_vsize=*/2 * vsize)};
+    BOOST_CHECK(empty.exhausted);
+    BOOST_CHECK(empty.blocks.empty());
+    BOOST_CHECK(empty.EstimateFee(1) == CFeeRate(0));
+}
+
+BOOST_AUTO_TEST_CASE(forecaster_cache)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+
+    // A forecast is served from the cache until it is too old.
+    MempoolForecaster cached{pool, /*max_age=*/std::chrono::hours{1}};
+    const auto first{cached.GetForecast()};
+    BOOST_CHECK(first->blocks.empty());
+    {
+        LOCK2(::cs_main, pool.cs);
+        AddToMempool(pool, entry.Fee(1000).FromTx(MakeTx(std::nullopt)));
+    }
+    BOOST_CHECK_EQUAL(cached.GetForecast(), first);
+
+    // Without a maximum age, every call observes the current mempool.
+    MempoolForecaster fresh{pool, /*max_age=*/std::chrono::milliseconds{0}};
+    const auto second{fresh.GetForecast()};
+    BOOST_REQUIRE_EQUAL(second->blocks.size(), 1U);
+    BOOST_CHECK_EQUAL(second->sequence, WITH_LOCK(pool.cs, return pool.GetSequence()));
+    // An unchanged mempool only renews the forecast.
+    const auto third{fresh.GetForecast()};
+    BOOST_CHECK(third->time >= second->time);
+    BOOST_CHECK_EQUAL(third->blocks.size(), 1U);
+    {
+        LOCK2(::cs_main, pool.cs);
+        AddToMempool(pool, entry.Fee(2000).FromTx(MakeTx(std::nullopt)));
+    }
+    BOOST_CHECK_EQUAL(fresh.GetForecast()->blocks[0].tx_count, 2U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
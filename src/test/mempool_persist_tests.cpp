@@ -0,0 +1,119 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <node/mempool_persist.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <script/solver.h>
+#include <sync.h>
+#include <txmempool.h>
+#include <util/fs.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using node::DumpMempool;
+using node::LoadMempool;
+using node::MempoolJournal;
+
+struct MempoolPersistSetup : public TestChain100Setup {
+    const fs::path m_dump_path{m_args.GetDataDirNet() / "mempool.dat"};
+
+    /** Submit a transaction spending the coinbase output of block @p height. */
+    CTransactionRef Spend(int height)
+    {
+        return MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[height - 1], /*input_vout=*/0, height, coinbaseKey,
+                                                                GetScriptForRawPubKey(coinbaseKey.GetPubKey()), /*output_amount=*/49 * COIN));
+    }
+
+    /** Start of the file, which only changes when the file is rewritten,
+     *  because every dump gets a new obfuscation key. */
+    std::string ReadHead() const
+    {
+        std::ifstream file{m_dump_path, std::ios::binary};
+        std::string head(32, '\0');
+        file.read(head.data(), head.size());
+        return head;
+    }
+
+    void RemoveFromMempool(const std::vector<CTransactionRef>& txs)
+    {
+        CTxMemPool& pool{*Assert(m_node.mempool)};
+        LOCK(pool.cs);
+        for (const auto& tx : txs) pool.removeRecursive(*tx, MemPoolRemovalReason::REPLACED);
+        BOOST_CHECK_EQUAL(pool.size(), 0U);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(mempool_persist_tests, MempoolPersistSetup)
+
+BOOST_AUTO_TEST_CASE(journal_append)
+{
+    CTxMemPool& pool{*Assert(m_node.mempool)};
+    pool.SetLoadTried(true);
+    auto journal{std::make_shared<MempoolJournal>(pool, m_dump_path)};
+    m_node.validation_signals->RegisterSharedValidationInterface(journal);
+
+    // The first flush writes the whole file.
+    const CTransactionRef tx1{Spend(1)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(journal->Flush());
+    const std::string head{ReadHead()};
+    const auto size{fs::file_size(m_dump_path)};
+
+    // Later ones append to it.
+    const CTransactionRef tx2{Spend(2)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(journal->Flush());
+    BOOST_CHECK(ReadHead() == head);
+    BOOST_CHECK_GT(fs::file_size(m_dump_path), size);
+
+    // A dump written elsewhere, as by savemempool, is not appended to but
+    // rewritten, after which appends continue.
+    BOOST_CHECK(DumpMempool(pool, m_dump_path));
+    const std::string dumped_head{ReadHead()};
+    const CTransactionRef tx3{Spend(3)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(journal->Flush());
+    const std::string rewritten_head{ReadHead()};
+    BOOST_CHECK(rewritten_head != dumped_head);
+
+    const CTransactionRef tx4{Spend(4)};
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(journal->Flush());
+    BOOST_CHECK(ReadHead() == rewritten_head);
+
+    m_node.validation_signals->UnregisterSharedValidationInterface(journal);
+
+    const std::vector<CTransactionRef> txs{tx1, tx2, tx3, tx4};
+    RemoveFromMempool(txs);
+    BOOST_CHECK(LoadMempool(pool, m_dump_path, m_node.chainman->ActiveChainstate(), {}));
+    BOOST_CHECK_EQUAL(pool.size(), txs.size());
+    for (const auto& tx : txs) BOOST_CHECK(pool.exists(tx->GetHash()));
+}
+
+BOOST_AUTO_TEST_CASE(load_truncated_record)
+{
+    CTxMemPool& pool{*Assert(m_node.mempool)};
+    const std::vector<CTransactionRef> txs{Spend(1), Spend(2)};
+    BOOST_CHECK(DumpMempool(pool, m_dump_path));
+
+    // Cut the last record, which holds the unbroadcast set, short. The
+    // records before it still load.
+    fs::resize_file(m_dump_path, fs::file_size(m_dump_path) - 1);
+    RemoveFromMempool(txs);
+    BOOST_CHECK(LoadMempool(pool, m_dump_path, m_node.chainman->ActiveChainstate(), {}));
+    BOOST_CHECK_EQUAL(pool.size(), txs.size());
+    for (const auto& tx : txs) BOOST_CHECK(pool.exists(tx->GetHash()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 #include <test/util/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(mempool_tests, TestingSetup)
@@ -804,4 +805,87 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTestsDiamond)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolSnapshotTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+
+    // [ta] <- [tb] <- [tc], and an unrelated [tx]
+    CTransactionRef ta = make_tx(/*output_values=*/{10 * COIN});
+    CTransactionRef tb = make_tx(/*output_values=*/{5 * COIN}, /*inputs=*/{ta});
+    CTransactionRef tc = make_tx(/*output_values=*/{2 * COIN}, /*inputs=*/{tb});
+    CTransactionRef tx = make_tx(/*output_values=*/{1 * COIN});
+
+    const auto empty{pool.GetSnapshot()};
+    BOOST_CHECK_EQUAL(empty->size(), 0U);
+    // Nothing changed, so the same snapshot is handed out again.
+    BOOST_CHECK_EQUAL(pool.GetSnapshot(), empty);
+
+    {
+        LOCK2(::cs_main, pool.cs);
+        AddToMempool(pool, entry.Fee(1000LL).FromTx(ta));
+        AddToMempool(pool, entry.Fee(2000LL).FromTx(tb));
+        AddToMempool(pool, entry.Fee(3000LL).FromTx(tc));
+        AddToMempool(pool, entry.Fee(4000LL).FromTx(tx));
+    }
+
+    const auto first{pool.GetSnapshot()};
+    BOOST_CHECK_EQUAL(empty->size(), 0U);
+    BOOST_CHECK_EQUAL(first->size(), 4U);
+    BOOST_CHECK_EQUAL(first->GetStats().total_fee, 10000);
+    BOOST_CHECK_EQUAL(first->GetStats().total_tx_size, WITH_LOCK(pool.cs, return pool.GetTotalTxSize()));
+    BOOST_CHECK_EQUAL(first->GetStats().sequence, WITH_LOCK(pool.cs, return pool.GetSequence()));
+
+    const auto snap_b{first->Find(tb->GetHash())};
+    BOOST_REQUIRE(snap_b);
+    BOOST_CHECK_EQUAL(snap_b->count_with_ancestors, 2U);
+    BOOST_CHECK_EQUAL(snap_b->count_with_descendants, 2U);
+    BOOST_CHECK_EQUAL(snap_b->mod_fees_with_descendants, 5000);
+    BOOST_CHECK(snap_b->parents == std::vector<Txid>{ta->GetHash()});
+    BOOST_CHECK(snap_b->children == std::vector<Txid>{tc->GetHash()});
+    BOOST_CHECK_EQUAL(first->CalculateAncestors(*Assert(first->Find(tc->GetHash()))).size(), 2U);
+    BOOST_CHECK_EQUAL(first->CalculateDescendants(*Assert(first->Find(ta->GetHash()))).size(), 2U);
+    BOOST_CHECK(first->CalculateDescendants(*Assert(first->Find(tx->GetHash()))).empty());
+    // Relatives are sorted by txid, like the setEntries of CTxMemPool.
+    const auto by_txid{[](const kernel::MempoolSnapshotEntryRef& a, const kernel::MempoolSnapshotEntryRef& b) { return a->GetHash() < b->GetHash(); }};
+    BOOST_CHECK(std::ranges::is_sorted(first->CalculateAncestors(*Assert(first->Find(tc->GetHash()))), by_txid));
+    BOOST_CHECK(std::ranges::is_sorted(first->CalculateDescendants(*Assert(first->Find(ta->GetHash()))), by_txid));
+
+    // Parents are sorted before their children, like CTxMemPool::entryAll().
+    std::vector<Txid> expected_order, snapshot_order;
+    {
+        LOCK(pool.cs);
+        for (const CTxMemPoolEntry& e : pool.entryAll()) expected_order.push_back(e.GetTx().GetHash());
+    }
+    for (const auto& e : first->GetSortedDepthAndScore()) snapshot_order.push_back(e->GetHash());
+    BOOST_CHECK(snapshot_order == expected_order);
+
+    // Prioritising a transaction updates its ancestors and descendants in the
+    // next snapshot, while the previous one stays untouched.
+    pool.PrioritiseTransaction(tb->GetHash(), 500);
+    const auto second{pool.GetSnapshot()};
+    BOOST_CHECK(second != first);
+    BOOST_CHECK_EQUAL(Assert(second->Find(ta->GetHash()))->mod_fees_with_descendants, 6500);
+    BOOST_CHECK_EQUAL(Assert(second->Find(tc->GetHash()))->mod_fees_with_ancestors, 6500);
+    BOOST_CHECK_EQUAL(Assert(first->Find(ta->GetHash()))->mod_fees_with_descendants, 6000);
+    // Entries that did not change are shared between snapshots.
+    BOOST_CHECK_EQUAL(second->Find(tx->GetHash()), first->Find(tx->GetHash()));
+
+    // Removing the chain is reflected incrementally.
+    WITH_LOCK(pool.cs, pool.removeRecursive(*ta, REMOVAL_REASON_DUMMY));
+    const auto third{pool.GetSnapshot()};
+    BOOST_CHECK_EQUAL(third->size(), 1U);
+    BOOST_CHECK(!third->Find(ta->GetHash()));
+    BOOST_CHECK(!third->Find(tc->GetHash()));
+    BOOST_CHECK_EQUAL(third->GetStats().total_fee, 4000);
+    BOOST_CHECK_EQUAL(second->size(), 4U);
+
+    // Unbroadcast state is part of the entry.
+    pool.AddUnbroadcastTx(tx->GetHash());
+    const auto fourth{pool.GetSnapshot()};
+    BOOST_CHECK(Assert(fourth->Find(tx->GetHash()))->unbroadcast);
+    BOOST_CHECK_EQUAL(fourth->GetStats().unbroadcast_count, 1U);
+    BOOST_CHECK(!Assert(third->Find(tx->GetHash()))->unbroadcast);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
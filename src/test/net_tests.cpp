@@ -1555,4 +1555,94 @@ BOOST_AUTO_TEST_CASE(v2transport_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(transport_send_batch)
+{
+    // Move all bytes one transport has to send to the other, until neither has anything left.
+    auto exchange = [](Transport& a, Transport& b) {
+        for (bool progress{true}; progress;) {
+            progress = false;
+            for (auto [from, to] : {std::pair{&a, &b}, std::pair{&b, &a}}) {
+                const auto& [bytes, _more, _msg_type] = from->GetBytesToSend(false);
+                if (bytes.empty()) continue;
+                std::span<const uint8_t> received{bytes};
+                BOOST_REQUIRE(to->ReceivedBytes(received));
+                BOOST_REQUIRE(received.empty());
+                from->MarkBytesSent(bytes.size());
+                progress = true;
+            }
+        }
+    };
+
+    auto test = [&](Transport& sender, Transport& receiver) {
+        // Several small messages are accepted at once.
+        std::vector<CSerializedNetMsg> expected;
+        for (int i = 0; i < 20; ++i) {
+            CSerializedNetMsg msg;
+            msg.m_type = i % 2 ? NetMsgType::INV : NetMsgType::TX;
+            msg.data = m_rng.randbytes<uint8_t>(m_rng.randrange(200));
+            expected.push_back(msg.Copy());
+            BOOST_CHECK(sender.SetMessageToSend(msg));
+        }
+        // So is a large one, but then the batch is full.
+        CSerializedNetMsg msg;
+        msg.m_type = NetMsgType::BLOCK;
+        msg.data = m_rng.randbytes<uint8_t>(TRANSPORT_SEND_BATCH_BYTES);
+        expected.push_back(msg.Copy());
+        BOOST_CHECK(sender.SetMessageToSend(msg));
+        CSerializedNetMsg ping;
+        ping.m_type = NetMsgType::PING;
+        BOOST_CHECK(!sender.SetMessageToSend(ping));
+
+        // Hand out the bytes in batches, and send a random part of each, spanning chunks.
+        std::vector<CNetMessage> received;
+        std::vector<Transport::BytesToSend> chunks;
+        while (true) {
+            chunks.clear();
+            sender.GetBytesToSendBatch(/*have_next_message=*/false, chunks, 1 + m_rng.randrange(8));
+            BOOST_REQUIRE(!chunks.empty());
+            for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+                BOOST_CHECK(std::get<1>(chunks[i]));
+                BOOST_CHECK(!std::get<0>(chunks[i + 1]).empty());
+            }
+            if (std::get<0>(chunks.front()).empty()) break;
+            std::vector<uint8_t> wire;
+            std::vector<size_t> sizes;
+            for (const auto& [bytes, _more, _msg_type] : chunks) {
+                wire.insert(wire.end(), bytes.begin(), bytes.end());
+                sizes.push_back(bytes.size());
+            }
+            size_t sent{1 + m_rng.randrange(wire.size())};
+            wire.resize(sent);
+            for (size_t size : sizes) {
+                if (sent == 0) break;
+                sender.MarkBytesSent(std::min(sent, size));
+                sent -= std::min(sent, size);
+            }
+            std::span<const uint8_t> to_receive{wire};
+            while (!to_receive.empty()) {
+                BOOST_REQUIRE(receiver.ReceivedBytes(to_receive));
+                if (receiver.ReceivedMessageComplete()) {
+                    bool reject{false};
+                    received.push_back(receiver.GetReceivedMessage({}, reject));
+                    BOOST_CHECK(!reject);
+                }
+            }
+        }
+        BOOST_REQUIRE_EQUAL(received.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            BOOST_CHECK_EQUAL(received[i].m_type, expected[i].m_type);
+            BOOST_CHECK(std::ranges::equal(received[i].m_recv, MakeByteSpan(expected[i].data)));
+        }
+        // With everything sent, new messages are accepted again.
+        BOOST_CHECK(sender.SetMessageToSend(ping));
+    };
+
+    V1Transport v1_sender{0}, v1_receiver{1};
+    test(v1_sender, v1_receiver);
+
+    V2Transport v2_sender{0, /*initiating=*/true}, v2_receiver{1, /*initiating=*/false};
+    exchange(v2_sender, v2_receiver);
+    test(v2_sender, v2_receiver);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -870,4 +870,43 @@ BOOST_AUTO_TEST_CASE(peer_worksets)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(batch_worksets)
+{
+    const NodeId node0{0};
+    const NodeId node1{1};
+    FastRandomContext det_rand{true};
+    std::unique_ptr<node::TxOrphanage> orphanage{node::MakeTxOrphanage()};
+
+    // parent <- child <- grandchild, plus a second child spending both outputs of the parent, and an orphan spending
+    // an output the parent doesn't have.
+    auto parent = MakeTransactionSpending({}, det_rand);
+    auto child = MakeTransactionSpending({COutPoint{parent->GetHash(), 0}}, det_rand);
+    auto child_both = MakeTransactionSpending({COutPoint{parent->GetHash(), 0}, COutPoint{parent->GetHash(), 1}}, det_rand);
+    auto not_a_child = MakeTransactionSpending({COutPoint{parent->GetHash(), 2}}, det_rand);
+    auto grandchild = MakeTransactionSpending({COutPoint{child->GetHash(), 1}}, det_rand);
+    BOOST_CHECK(orphanage->AddTx(child, node0));
+    BOOST_CHECK(orphanage->AddTx(child_both, node1));
+    BOOST_CHECK(orphanage->AddTx(not_a_child, node1));
+    BOOST_CHECK(orphanage->AddTx(grandchild, node0));
+
+    // Parent and child accepted together: the child leaves the orphanage first, so only the remaining
+    // children of either are added to work sets, each of them once.
+    BOOST_CHECK(orphanage->EraseTx(child->GetWitnessHash()));
+    const std::vector<CTransactionRef> accepted{parent, child};
+    const auto newly_reconsiderable{orphanage->AddChildrenToWorkSet(accepted, det_rand)};
+    const std::vector<std::pair<Wtxid, NodeId>> expected{{child_both->GetWitnessHash(), node1}, {grandchild->GetWitnessHash(), node0}};
+    BOOST_CHECK(newly_reconsiderable == expected);
+    BOOST_CHECK(orphanage->AddChildrenToWorkSet(accepted, det_rand).empty());
+    orphanage->SanityCheck();
+
+    BOOST_CHECK_EQUAL(orphanage->GetTxToReconsider(node0), grandchild);
+    BOOST_CHECK_EQUAL(orphanage->GetTxToReconsider(node1), child_both);
+    BOOST_CHECK(!orphanage->HaveTxToReconsider(node0));
+    BOOST_CHECK(!orphanage->HaveTxToReconsider(node1));
+
+    // Children are found by txid, so not_a_child is included here, while the child spending both outputs is
+    // returned once.
+    BOOST_CHECK_EQUAL(orphanage->GetChildrenFromSamePeer(parent, node1).size(), 2U);
+}
 BOOST_AUTO_TEST_SUITE_END()
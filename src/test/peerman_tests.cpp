@@ -2,15 +2,31 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or https://www.opensource.org/licenses/mit-license.php.
 
+#include <chain.h>
 #include <chainparams.h>
+#include <net.h>
+#include <netmessagemaker.h>
 #include <node/miner.h>
 #include <net_processing.h>
 #include <pow.h>
+#include <primitives/block.h>
+#include <protocol.h>
+#include <streams.h>
+#include <test/util/mining.h>
+#include <test/util/net.h>
 #include <test/util/setup_common.h>
+#include <util/time.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(peerman_tests, RegTestingSetup)
 
 /** Window, in blocks, for connecting to NODE_NETWORK_LIMITED peers */
@@ -73,4 +89,308 @@ BOOST_AUTO_TEST_CASE(connections_desirable_service_flags)
     BOOST_CHECK(peerman->GetDesirableServiceFlags(peer_flags) == ServiceFlags(NODE_NETWORK | NODE_WITNESS));
 }
 
+/** Types of the messages queued for sending to the node, in order. */
+static std::vector<std::string> QueuedMessageTypes(CNode& node)
+{
+    LOCK(node.cs_vSend);
+    std::vector<std::string> msg_types;
+    const auto& [to_send, _more, msg_type] = node.m_transport->GetBytesToSend(/*have_next_message=*/false);
+    if (!to_send.empty()) msg_types.push_back(msg_type);
+    for (const auto& msg : node.vSendMsg) msg_types.push_back(msg.m_type);
+    return msg_types;
+}
+
+BOOST_FIXTURE_TEST_CASE(block_serve_threads, TestChain100Setup)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    PeerManager::Options opts;
+    opts.block_serve_threads = 1;
+    auto peerman{PeerManager::make(connman, *m_node.addrman, nullptr, *m_node.chainman, *m_node.mempool, *m_node.warnings, opts)};
+    connman.SetMsgProc(peerman.get());
+
+    CNode node{/*id=*/0,
+               /*sock=*/nullptr,
+               CAddress{},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               /*network_key=*/0};
+    connman.Handshake(node,
+                      /*successfully_connected=*/true,
+                      /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                      /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                      /*version=*/PROTOCOL_VERSION,
+                      /*relay_txs=*/true);
+    connman.FlushSendBuffer(node);
+
+    // Request a block, followed by a ping.
+    const uint256 hash{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[50]->GetBlockHash())};
+    (void)connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::GETDATA, std::vector<CInv>{CInv{MSG_WITNESS_BLOCK, hash}}));
+    (void)connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::PING, uint64_t{1}));
+
+    // The block is sent by the block serving thread, and the ping is only
+    // answered after it.
+    for (int i{0}; i < 10000 && std::ranges::count(QueuedMessageTypes(node), NetMsgType::PONG) == 0; ++i) {
+        // Nothing drains the send buffer here, so don't let it pause processing.
+        node.fPauseSend = false;
+        connman.ProcessMessagesOnce(node);
+        UninterruptibleSleep(1ms);
+    }
+    BOOST_CHECK(QueuedMessageTypes(node) == (std::vector<std::string>{NetMsgType::BLOCK, NetMsgType::PONG}));
+
+    peerman->FinalizeNode(node);
+    connman.SetMsgProc(m_node.peerman.get());
+}
+
+/** Number of headers the replaying peers send in one getheaders result. */
+static constexpr unsigned int REPLAY_MAX_HEADERS_RESULTS{100};
+/** Rounds it takes the peer that is asked for headers first, and the other peer, to answer a request. */
+static constexpr std::array<int, 2> REPLAY_PEER_LATENCY{3, 1};
+
+static CService ip(uint32_t i)
+{
+    struct in_addr s;
+    s.s_addr = i;
+    return CService{CNetAddr{s}, Params().GetDefaultPort()};
+}
+
+/** Record a chain of headers building on the genesis block, as it is stored to be replayed. */
+static DataStream RecordHeaderChain(const ChainstateManager& chainman, int count)
+{
+    CBlockHeader prev{WITH_LOCK(::cs_main, return chainman.ActiveChain().Genesis()->GetBlockHeader())};
+    std::vector<CBlockHeader> headers;
+    for (int i{0}; i < count; ++i) {
+        CBlockHeader header;
+        header.nVersion = 4;
+        header.hashPrevBlock = prev.GetHash();
+        header.nTime = prev.nTime + chainman.GetConsensus().nPowTargetSpacing;
+        header.nBits = prev.nBits;
+        while (!CheckProofOfWork(header.GetHash(), header.nBits, chainman.GetConsensus())) ++header.nNonce;
+        headers.push_back(header);
+        prev = header;
+    }
+    DataStream recorded;
+    recorded << headers;
+    return recorded;
+}
+
+/**
+ * Replay a recorded header chain to a node syncing headers from two outbound
+ * peers, which answer getheaders requests after REPLAY_PEER_LATENCY rounds.
+ * Returns the number of rounds until the node knows the tip of the chain, and
+ * the number of requests each peer received.
+ */
+static int ReplayHeadersSync(node::NodeContext& node, const DataStream& recorded, int headers_sync_peers, std::array<int, 2>& num_requests)
+    EXCLUSIVE_LOCKS_REQUIRED(NetEventsInterface::g_msgproc_mutex)
+{
+    std::vector<CBlockHeader> chain;
+    DataStream{recorded} >> chain;
+    std::vector<uint256> hashes;
+    for (const auto& header : chain) hashes.push_back(header.GetHash());
+
+    // Stay more than a day ahead of the chain, so that headers are only
+    // requested from the initial headers sync peers.
+    SetMockTime(chain.back().GetBlockTime() + 2 * 24 * 60 * 60);
+
+    auto& connman{static_cast<ConnmanTestMsg&>(*node.connman)};
+    PeerManager::Options opts;
+    opts.headers_sync_peers = headers_sync_peers;
+    opts.max_headers_result = REPLAY_MAX_HEADERS_RESULTS;
+    auto peerman{PeerManager::make(connman, *node.addrman, nullptr, *node.chainman, *node.mempool, *node.warnings, opts)};
+    connman.SetMsgProc(peerman.get());
+
+    std::vector<std::unique_ptr<CNode>> peers;
+    std::array<std::deque<CBlockLocator>, 2> requests;
+    num_requests = {};
+    const auto capture_orig{CaptureMessage};
+    node.args->ForceSetArg("-capturemessages", "1");
+    CaptureMessage = [&](const CAddress& addr, const std::string& msg_type, std::span<const unsigned char> data, bool is_incoming) {
+        if (is_incoming || msg_type != NetMsgType::GETHEADERS) return;
+        DataStream s{data};
+        CBlockLocator locator;
+        s >> locator;
+        for (size_t i{0}; i < peers.size(); ++i) {
+            if (peers[i]->addr != addr) continue;
+            requests[i].push_back(locator);
+            ++num_requests[i];
+        }
+    };
+
+    for (int i{0}; i < 2; ++i) {
+        peers.push_back(std::make_unique<CNode>(/*id=*/i,
+                                                /*sock=*/nullptr,
+                                                CAddress{ip(0xa0b0c001 + i), NODE_NONE},
+                                                /*nKeyedNetGroupIn=*/0,
+                                                /*nLocalHostNonceIn=*/0,
+                                                CAddress{},
+                                                /*addrNameIn=*/"",
+                                                ConnectionType::OUTBOUND_FULL_RELAY,
+                                                /*inbound_onion=*/false,
+                                                /*network_key=*/0));
+        connman.Handshake(*peers.back(),
+                          /*successfully_connected=*/true,
+                          /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*version=*/PROTOCOL_VERSION,
+                          /*relay_txs=*/true);
+        connman.FlushSendBuffer(*peers.back());
+    }
+
+    int rounds{0};
+    while (WITH_LOCK(::cs_main, return node.chainman->m_best_header->GetBlockHash()) != hashes.back() && rounds < 1000) {
+        ++rounds;
+        for (size_t i{0}; i < peers.size(); ++i) {
+            CNode& peer{*peers[i]};
+            peerman->SendMessages(&peer);
+            // Nothing drains the send buffer here, so don't let it pause processing.
+            connman.FlushSendBuffer(peer);
+            peer.fPauseSend = false;
+            if (rounds % REPLAY_PEER_LATENCY[i] != 0 || requests[i].empty()) continue;
+
+            // Answer like a node having the recorded chain: continue after the
+            // first locator entry found in it, or after the genesis block.
+            const CBlockLocator locator{requests[i].front()};
+            requests[i].pop_front();
+            size_t start{0};
+            for (const uint256& hash : locator.vHave) {
+                const auto it{std::ranges::find(hashes, hash)};
+                if (it == hashes.end()) continue;
+                start = it - hashes.begin() + 1;
+                break;
+            }
+            std::vector<CBlock> headers;
+            for (size_t j{start}; j < chain.size() && headers.size() < REPLAY_MAX_HEADERS_RESULTS; ++j) {
+                headers.emplace_back(chain[j]);
+            }
+            (void)connman.ReceiveMsgFrom(peer, NetMsg::Make(NetMsgType::HEADERS, TX_WITH_WITNESS(headers)));
+            connman.ProcessMessagesOnce(peer);
+        }
+    }
+
+    for (const auto& peer : peers) peerman->FinalizeNode(*peer);
+    CaptureMessage = capture_orig;
+    node.args->ForceSetArg("-capturemessages", "0");
+    connman.SetMsgProc(node.peerman.get());
+    return rounds;
+}
+
+BOOST_AUTO_TEST_CASE(headers_sync_single_peer)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+    const DataStream recorded{RecordHeaderChain(*m_node.chainman, 10 * REPLAY_MAX_HEADERS_RESULTS)};
+    std::array<int, 2> num_requests;
+    const int rounds{ReplayHeadersSync(m_node, recorded, /*headers_sync_peers=*/1, num_requests)};
+
+    // Only the first peer is asked, so the sync goes at its pace.
+    BOOST_CHECK_EQUAL(rounds, 10 * REPLAY_PEER_LATENCY[0]);
+    BOOST_CHECK_EQUAL(num_requests[0], 1 + 10);
+    BOOST_CHECK_EQUAL(num_requests[1], 0);
+}
+
+BOOST_AUTO_TEST_CASE(headers_sync_parallel_peers)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+    const DataStream recorded{RecordHeaderChain(*m_node.chainman, 10 * REPLAY_MAX_HEADERS_RESULTS)};
+    std::array<int, 2> num_requests;
+    const int rounds{ReplayHeadersSync(m_node, recorded, /*headers_sync_peers=*/2, num_requests)};
+
+    // Both peers are asked, and the faster one drives the sync. The slower
+    // one is asked to continue from the best header each time it answers,
+    // instead of repeating headers that were received in the meantime.
+    BOOST_CHECK_EQUAL(rounds, 10 * REPLAY_PEER_LATENCY[1]);
+    BOOST_CHECK_EQUAL(num_requests[1], 1 + 10);
+    BOOST_CHECK_EQUAL(num_requests[0], 1 + rounds / REPLAY_PEER_LATENCY[0]);
+}
+
+BOOST_AUTO_TEST_CASE(block_download_speed)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+    // Two blocks beyond the download window of 1024 blocks, so that it can be held up.
+    const auto blocks{CreateBlockChain(1024 + 2, Params())};
+    SetMockTime(blocks.back()->GetBlockTime() + 60);
+
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    auto peerman{PeerManager::make(connman, *m_node.addrman, nullptr, *m_node.chainman, *m_node.mempool, *m_node.warnings, {})};
+    connman.SetMsgProc(peerman.get());
+
+    std::vector<std::unique_ptr<CNode>> peers;
+    std::vector<CBlock> headers;
+    for (const auto& block : blocks) headers.emplace_back(block->GetBlockHeader());
+    for (int i{0}; i < 2; ++i) {
+        peers.push_back(std::make_unique<CNode>(/*id=*/i,
+                                                /*sock=*/nullptr,
+                                                CAddress{ip(0xa0b0c001 + i), NODE_NONE},
+                                                /*nKeyedNetGroupIn=*/0,
+                                                /*nLocalHostNonceIn=*/0,
+                                                CAddress{},
+                                                /*addrNameIn=*/"",
+                                                ConnectionType::OUTBOUND_FULL_RELAY,
+                                                /*inbound_onion=*/false,
+                                                /*network_key=*/0));
+        connman.Handshake(*peers.back(),
+                          /*successfully_connected=*/true,
+                          /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                          /*version=*/PROTOCOL_VERSION,
+                          /*relay_txs=*/true);
+        connman.FlushSendBuffer(*peers.back());
+        peers.back()->fPauseSend = false;
+        (void)connman.ReceiveMsgFrom(*peers.back(), NetMsg::Make(NetMsgType::HEADERS, TX_WITH_WITNESS(headers)));
+        connman.ProcessMessagesOnce(*peers.back());
+    }
+    CNode& slow{*peers[0]};
+    CNode& fast{*peers[1]};
+    const auto stats{[&](const CNode& node) {
+        CNodeStateStats stats;
+        BOOST_REQUIRE(peerman->GetNodeStateStats(node.GetId(), stats));
+        return stats;
+    }};
+
+    // The slow peer is asked for the first blocks, and never delivers them.
+    peerman->SendMessages(&slow);
+    connman.FlushSendBuffer(slow);
+    BOOST_CHECK_EQUAL(stats(slow).vHeightInFlight.size(), 16U);
+    BOOST_CHECK_EQUAL(stats(slow).m_max_blocks_in_transit, 16);
+
+    // The fast peer delivers a block per second, until the download window
+    // is held up by the slow peer.
+    bool requested_lagging_block{false};
+    for (int i{0}; i < 2000 && !requested_lagging_block; ++i) {
+        peerman->SendMessages(&fast);
+        connman.FlushSendBuffer(fast);
+        fast.fPauseSend = false;
+        const auto in_flight{stats(fast).vHeightInFlight};
+        BOOST_REQUIRE(!in_flight.empty());
+        requested_lagging_block = std::ranges::count(in_flight, 1) > 0;
+
+        SetMockTime(GetMockTime() + 1s);
+        (void)connman.ReceiveMsgFrom(fast, NetMsg::Make(NetMsgType::BLOCK, TX_WITH_WITNESS(*blocks[in_flight.front() - 1])));
+        connman.ProcessMessagesOnce(fast);
+    }
+
+    // Instead of waiting for the slow peer, its oldest block was requested
+    // from the fast one, which is only asked for as many blocks as it can
+    // deliver in 4 seconds.
+    BOOST_CHECK(requested_lagging_block);
+    BOOST_CHECK_EQUAL(stats(fast).m_max_blocks_in_transit, 4);
+    BOOST_CHECK_EQUAL(Ticks<std::chrono::seconds>(stats(fast).m_block_latency), 4);
+    BOOST_CHECK_GT(stats(fast).m_block_download_rate, 0U);
+    BOOST_CHECK_EQUAL(stats(slow).m_block_download_rate, 0U);
+
+    // Receiving it from the fast peer moves the window, and releases the
+    // slow peer's request.
+    (void)connman.ReceiveMsgFrom(fast, NetMsg::Make(NetMsgType::BLOCK, TX_WITH_WITNESS(*blocks[0])));
+    connman.ProcessMessagesOnce(fast);
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight()), 1);
+    BOOST_CHECK_EQUAL(std::ranges::count(stats(slow).vHeightInFlight, 1), 0);
+    BOOST_CHECK(!slow.fDisconnect);
+
+    for (const auto& peer : peers) peerman->FinalizeNode(*peer);
+    connman.SetMsgProc(m_node.peerman.get());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
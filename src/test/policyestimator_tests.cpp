@@ -5,6 +5,8 @@
 #include <policy/fees.h>
 #include <policy/fees_args.h>
 #include <policy/policy.h>
+#include <random.h>
+#include <streams.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
 #include <uint256.h>
@@ -262,4 +264,63 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BlockPolicyEstimatesWriteRead)
+{
+    // Estimates must survive a round trip through the file format, which
+    // stores plain cumulative averages rather than the in-memory representation.
+    CBlockPolicyEstimator feeEst{m_path_root / "fee_estimates_a.dat", DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+    std::vector<std::vector<RemovedMempoolTransactionInfo>> blocks(400);
+    TestMemPoolEntryHelper entry;
+    for (unsigned int height = 0; height < 300; height++) {
+        if (height > 0) feeEst.processBlock(blocks[height], height);
+        for (int i = 0; i < 20; i++) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+            mtx.vout.emplace_back(0, CScript{});
+            const CAmount fee{1000 * (1 + i)};
+            const CTxMemPoolEntry tx_entry{entry.Fee(fee).Height(height).FromTx(mtx)};
+            feeEst.processTransaction(NewMempoolTransactionInfo{tx_entry.GetSharedTx(), fee, tx_entry.GetTxSize(), height,
+                                                                /*mempool_limit_bypassed=*/false,
+                                                                /*submitted_in_package=*/false,
+                                                                /*chainstate_is_current=*/true,
+                                                                /*has_no_mempool_parents=*/true});
+            if (i < 3) {
+                // Low feerate transactions never confirm.
+                if (height >= 50) feeEst.removeTx(tx_entry.GetTx().GetHash());
+            } else {
+                blocks[height + 1 + det_rand.randrange(40 / i)].emplace_back(tx_entry);
+            }
+        }
+    }
+
+    // Transactions still in the mempool aren't written, so record them as
+    // failures first, like on shutdown.
+    feeEst.FlushUnconfirmed();
+
+    const fs::path path{m_path_root / "fee_estimates_test.dat"};
+    {
+        AutoFile file{fsbridge::fopen(path, "wb")};
+        BOOST_REQUIRE(feeEst.Write(file));
+        BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+    }
+    CBlockPolicyEstimator feeEstRead{m_path_root / "fee_estimates_b.dat", DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+    {
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        BOOST_REQUIRE(feeEstRead.Read(file));
+    }
+
+    for (const auto horizon : ALL_FEE_ESTIMATE_HORIZONS) {
+        for (unsigned int target = 1; target <= feeEst.HighestTargetTracked(horizon); target++) {
+            EstimationResult result, result_read;
+            const CFeeRate fee{feeEst.estimateRawFee(target, 0.85, horizon, &result)};
+            const CFeeRate fee_read{feeEstRead.estimateRawFee(target, 0.85, horizon, &result_read)};
+            BOOST_CHECK_EQUAL(fee.GetFeePerK(), fee_read.GetFeePerK());
+            BOOST_CHECK_CLOSE(result.pass.totalConfirmed, result_read.pass.totalConfirmed, 0.0001);
+            BOOST_CHECK_CLOSE(result.pass.withinTarget, result_read.pass.withinTarget, 0.0001);
+            BOOST_CHECK_CLOSE(result.pass.leftMempool, result_read.pass.leftMempool, 0.0001);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <chain.h>
+#include <node/response_cache.h>
+#include <primitives/block.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+
+using node::ResponseCache;
+
+BOOST_FIXTURE_TEST_SUITE(response_cache_tests, ChainTestingSetup)
+
+BOOST_AUTO_TEST_CASE(get_put)
+{
+    ResponseCache cache{1000};
+    const uint256 block_hash{uint256::ONE};
+
+    BOOST_CHECK(!cache.Get("a"));
+    cache.Put(block_hash, "a", "response a");
+    BOOST_CHECK_EQUAL(*cache.Get("a"), "response a");
+    // Replacing a response keeps the size right.
+    cache.Put(block_hash, "a", "response");
+    BOOST_CHECK_EQUAL(*cache.Get("a"), "response");
+
+    ResponseCache::Stats stats{cache.GetStats()};
+    BOOST_CHECK_EQUAL(stats.hits, 2U);
+    BOOST_CHECK_EQUAL(stats.misses, 1U);
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.size, std::string{"a"}.size() + std::string{"response"}.size());
+
+    // Responses larger than a quarter of the cache are not added.
+    cache.Put(block_hash, "b", std::string(250, 'b'));
+    BOOST_CHECK(!cache.Get("b"));
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    ResponseCache cache{1000};
+    const uint256 block_hash{uint256::ONE};
+
+    // Four entries of 200 bytes fill the cache but for 200 bytes.
+    for (const std::string key : {"0", "1", "2", "3"}) {
+        cache.Put(block_hash, key, std::string(199, 'x'));
+    }
+    BOOST_CHECK(cache.Get("0"));
+    cache.Put(block_hash, "4", std::string(199, 'x'));
+    BOOST_CHECK_EQUAL(cache.GetStats().size, 1000U);
+    // The next one evicts the least recently used, which is "1" as "0" was used.
+    cache.Put(block_hash, "5", std::string(199, 'x'));
+    BOOST_CHECK(!cache.Get("1"));
+    for (const std::string key : {"0", "2", "3", "4", "5"}) {
+        BOOST_CHECK(cache.Get(key));
+    }
+    BOOST_CHECK_EQUAL(cache.GetStats().size, 1000U);
+}
+
+BOOST_AUTO_TEST_CASE(evict_disconnected)
+{
+    ResponseCache cache{1000};
+    m_node.validation_signals->RegisterValidationInterface(&cache);
+
+    CBlock block;
+    const uint256 disconnected_hash{block.GetHash()};
+    const uint256 other_hash{uint256::ONE};
+    cache.Put(disconnected_hash, "a", "response a");
+    cache.Put(other_hash, "b", "response b");
+    cache.Put(disconnected_hash, "c", "response c");
+
+    CBlockIndex index{block};
+    index.phashBlock = &disconnected_hash;
+    m_node.validation_signals->BlockDisconnected(std::make_shared<const CBlock>(block), &index);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    BOOST_CHECK(!cache.Get("a"));
+    BOOST_CHECK_EQUAL(*cache.Get("b"), "response b");
+    BOOST_CHECK(!cache.Get("c"));
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 1U);
+    BOOST_CHECK_EQUAL(cache.GetStats().size, std::string{"b"}.size() + std::string{"response b"}.size());
+
+    m_node.validation_signals->UnregisterValidationInterface(&cache);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,11 +6,13 @@
 #include <interfaces/chain.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
+#include <rpc/cbor.h>
 #include <rpc/client.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <test/util/setup_common.h>
 #include <univalue.h>
+#include <util/strencodings.h>
 #include <util/time.h>
 
 #include <any>
@@ -45,7 +47,7 @@ class RPCTestingSetup : public TestingSetup
 {
 public:
     UniValue TransformParams(const UniValue& params, std::vector<std::pair<std::string, bool>> arg_names) const;
-    UniValue CallRPC(std::string args);
+    UniValue CallRPC(std::string args, UniValueWriter* result_writer = nullptr, std::string* cbor_result = nullptr);
 };
 
 UniValue RPCTestingSetup::TransformParams(const UniValue& params, std::vector<std::pair<std::string, bool>> arg_names) const
@@ -62,7 +64,7 @@ UniValue RPCTestingSetup::TransformParams(const UniValue& params, std::vector<st
     return transformed_params;
 }
 
-UniValue RPCTestingSetup::CallRPC(std::string args)
+UniValue RPCTestingSetup::CallRPC(std::string args, UniValueWriter* result_writer, std::string* cbor_result)
 {
     std::vector<std::string> vArgs{SplitString(args, ' ')};
     std::string strMethod = vArgs[0];
@@ -71,6 +73,8 @@ UniValue RPCTestingSetup::CallRPC(std::string args)
     request.context = &m_node;
     request.strMethod = strMethod;
     request.params = RPCConvertValues(strMethod, vArgs);
+    request.m_result_writer = result_writer;
+    request.m_cbor_result = cbor_result;
     if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
     try {
         UniValue result = tableRPC.execute(request);
@@ -168,6 +172,131 @@ BOOST_AUTO_TEST_CASE(rpc_rawparams)
     BOOST_CHECK_THROW(CallRPC(std::string("sendrawtransaction ")+rawtx+" extra"), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_result_writer)
+{
+    const std::string genesis{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Genesis()->GetBlockHash().GetHex())};
+    const std::vector<std::pair<std::string, bool>> calls{
+        {"getblock " + genesis + " 1", false},
+        {"getblock " + genesis + " 2", true},
+        {"getblock " + genesis + " 3", true},
+        {"getrawmempool false", false},
+        {"getrawmempool true", true},
+    };
+    for (const auto& [args, streamed] : calls) {
+        // Methods that support it write the same result as they return
+        // without a writer.
+        std::string written;
+        UniValueWriter writer{[&](std::string_view chunk) { written += chunk; }, /*chunk_size=*/16};
+        const UniValue result{CallRPC(args, &writer)};
+        writer.flush();
+        BOOST_CHECK_EQUAL(!written.empty(), streamed);
+        BOOST_CHECK_EQUAL(streamed ? written : result.write(), CallRPC(args).write());
+    }
+}
+
+static std::string CBOR(std::string_view hex)
+{
+    const auto bytes{ParseHex(hex)};
+    return {bytes.begin(), bytes.end()};
+}
+
+static std::string EncodeCBOR(std::string_view json)
+{
+    std::string out;
+    EncodeCBOR(out, JSON(json));
+    return HexStr(out);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cbor)
+{
+    BOOST_CHECK_EQUAL(EncodeCBOR("null"), "f6");
+    BOOST_CHECK_EQUAL(EncodeCBOR("[true,false]"), "82f5f4");
+    BOOST_CHECK_EQUAL(EncodeCBOR("23"), "17");
+    BOOST_CHECK_EQUAL(EncodeCBOR("24"), "1818");
+    BOOST_CHECK_EQUAL(EncodeCBOR("-1"), "20");
+    BOOST_CHECK_EQUAL(EncodeCBOR("1000000"), "1a000f4240");
+    BOOST_CHECK_EQUAL(EncodeCBOR("18446744073709551615"), "1bffffffffffffffff");
+    BOOST_CHECK_EQUAL(EncodeCBOR("-18446744073709551616"), "3bffffffffffffffff");
+    // Numbers with a fraction or an exponent keep their digits.
+    BOOST_CHECK_EQUAL(EncodeCBOR("0.00100000"), "c482271a000186a0");
+    BOOST_CHECK_EQUAL(EncodeCBOR("1.5e-5"), "c482250f");
+    // Numbers with more digits than fit into 64 bits are written as doubles.
+    BOOST_CHECK_EQUAL(EncodeCBOR("18446744073709551616"), "fb43f0000000000000");
+    // Without documentation, hex strings are text.
+    BOOST_CHECK_EQUAL(EncodeCBOR(R"({"a":"00ff"})"), "a161616430306666");
+
+    for (const std::string_view json : {"null", "[]", "{}", "-9223372036854775809", "0.00100000", "-0.5", "1e30", "-1844674407370955161.6",
+                                        R"({"amount":21000000.00000000,"list":[1,-2,"text",{"":true}]})"}) {
+        BOOST_CHECK_EQUAL(DecodeCBOR(CBOR(EncodeCBOR(json))).write(), JSON(json).write());
+    }
+    BOOST_CHECK_EQUAL(DecodeCBOR(CBOR("c4820102")).write(), "2e1");
+    BOOST_CHECK_EQUAL(DecodeCBOR(CBOR("c482250f")).write(), "0.000015");
+    // Byte strings are decoded to hex.
+    BOOST_CHECK_EQUAL(DecodeCBOR(CBOR("4200ff")).write(), R"("00ff")");
+    BOOST_CHECK_EQUAL(DecodeCBOR(CBOR("f93e00")).get_real(), 1.5);
+    BOOST_CHECK_EQUAL(DecodeCBOR(CBOR("fa3fc00000")).get_real(), 1.5);
+    BOOST_CHECK(DecodeCBOR(CBOR("f7")).isNull());
+
+    for (const std::string_view hex : {
+             "",               // nothing
+             "0000",           // trailing data
+             "18",             // truncated integer
+             "6261",           // truncated text
+             "9bffffffffffffffff", // array larger than the data
+             "5f",             // indefinite length
+             "a10101",         // map key that is not text
+             "c101",           // unsupported tag
+             "c48201",         // truncated decimal fraction
+             "c4821a0000ffff01", // decimal fraction exponent out of range
+             "f97c00",         // infinity
+             "f8ff",           // unsupported simple value
+         }) {
+        BOOST_CHECK_THROW(DecodeCBOR(CBOR(hex)), std::runtime_error);
+    }
+    BOOST_CHECK_THROW(DecodeCBOR(std::string(1000, '\x81') + '\x00'), std::runtime_error);
+}
+
+//! Check that two values are the same, with numbers compared by value rather than by digits.
+static void CheckSameValue(const UniValue& value, const UniValue& expected)
+{
+    BOOST_CHECK_EQUAL(value.getType(), expected.getType());
+    if (value.isNum()) {
+        BOOST_CHECK_EQUAL(value.get_real(), expected.get_real());
+    } else if (value.getType() == expected.getType() && (value.isArray() || value.isObject())) {
+        if (value.isObject()) BOOST_CHECK(value.getKeys() == expected.getKeys());
+        BOOST_REQUIRE_EQUAL(value.size(), expected.size());
+        for (size_t i{0}; i < value.size(); ++i) CheckSameValue(value[i], expected[i]);
+    } else {
+        BOOST_CHECK_EQUAL(value.write(), expected.write());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cbor_result)
+{
+    const std::string genesis{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Genesis()->GetBlockHash().GetHex())};
+    // A raw block is documented as hex, so it is sent as bytes.
+    const std::string raw_block{CallRPC("getblock " + genesis + " 0").get_str()};
+    std::string cbor;
+    BOOST_CHECK(CallRPC("getblock " + genesis + " 0", nullptr, &cbor).isNull());
+    BOOST_CHECK_EQUAL(HexStr(cbor), strprintf("59%04x", raw_block.size() / 2) + raw_block);
+
+    for (const std::string& args : {"getblock " + genesis + " 1", "getblock " + genesis + " 2", "getblockheader " + genesis, std::string{"getmininginfo"}}) {
+        // The result decodes to the same value as it is returned in.
+        const UniValue result{CallRPC(args)};
+        cbor.clear();
+        BOOST_CHECK(CallRPC(args, nullptr, &cbor).isNull());
+        CheckSameValue(DecodeCBOR(cbor), result);
+        BOOST_CHECK_LT(cbor.size(), result.write().size());
+    }
+
+    // Hex strings are sent as bytes at any depth of the documented result.
+    cbor.clear();
+    CallRPC("getblock " + genesis + " 1", nullptr, &cbor);
+    const std::string txid{CallRPC("getblock " + genesis + " 1")["tx"][0].get_str()};
+    BOOST_CHECK_NE(cbor.find("\x58\x20" + CBOR(txid)), std::string::npos);
+    BOOST_CHECK_EQUAL(cbor.find(txid), std::string::npos);
+}
+
 BOOST_AUTO_TEST_CASE(rpc_togglenetwork)
 {
     UniValue r;
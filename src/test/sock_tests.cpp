@@ -4,6 +4,7 @@
 
 #include <common/system.h>
 #include <compat/compat.h>
+#include <span.h>
 #include <test/util/setup_common.h>
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
@@ -11,7 +12,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include <cassert>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -125,6 +128,22 @@ BOOST_AUTO_TEST_CASE(send_and_receive)
     BOOST_CHECK(SocketIsClosed(s[1]));
 }
 
+BOOST_AUTO_TEST_CASE(send_many)
+{
+    int s[2];
+    CreateSocketPair(s);
+    Sock sender(s[0]);
+    Sock receiver(s[1]);
+
+    const std::string parts[]{"ab", "", "cde", "f"};
+    std::vector<std::span<const uint8_t>> buffers;
+    for (const auto& part : parts) buffers.push_back(MakeUCharSpan(part));
+    BOOST_CHECK_EQUAL(sender.SendMany(buffers, 0), 6);
+    char recv_buf[10];
+    BOOST_CHECK_EQUAL(receiver.Recv(recv_buf, sizeof(recv_buf), 0), 6);
+    BOOST_CHECK_EQUAL(std::string(recv_buf, 6), "abcdef");
+}
+
 BOOST_AUTO_TEST_CASE(wait)
 {
     int s[2];
@@ -169,6 +188,58 @@ BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
     receiver.join();
 }
 
+static void CheckWaitSet(SockWaitSet& wait_set)
+{
+    int s[2];
+    CreateSocketPair(s);
+    const auto sock0{std::make_shared<const Sock>(s[0])};
+    const auto sock1{std::make_shared<const Sock>(s[1])};
+
+    Sock::EventsPerSock events_per_sock;
+    const auto occurred{[&](const std::shared_ptr<const Sock>& sock) -> Sock::Event {
+        const auto it{events_per_sock.find(sock)};
+        return it == events_per_sock.end() ? 0 : it->second.occurred;
+    }};
+
+    // Nothing to wait on.
+    BOOST_CHECK(!wait_set.Wait(0ms, events_per_sock));
+
+    // Nothing to receive yet.
+    wait_set.Add(sock0, Sock::RECV);
+    BOOST_REQUIRE(wait_set.Wait(0ms, events_per_sock));
+    BOOST_CHECK(occurred(sock0) == 0);
+
+    BOOST_REQUIRE_EQUAL(sock1->Send("a", 1, 0), 1);
+    wait_set.Add(sock0, Sock::RECV);
+    wait_set.Add(sock1, Sock::RECV | Sock::SEND);
+    BOOST_REQUIRE(wait_set.Wait(1min, events_per_sock));
+    BOOST_CHECK(occurred(sock0) == Sock::RECV);
+    BOOST_CHECK(occurred(sock1) == Sock::SEND);
+
+    // Requested events can change between waits, and data that was not received is reported again.
+    wait_set.Add(sock0, Sock::RECV | Sock::SEND);
+    BOOST_REQUIRE(wait_set.Wait(1min, events_per_sock));
+    BOOST_CHECK(occurred(sock0) == (Sock::RECV | Sock::SEND));
+    BOOST_CHECK(occurred(sock1) == 0);
+
+    // Sockets that are not added again are released.
+    BOOST_CHECK(!wait_set.Wait(0ms, events_per_sock));
+    BOOST_CHECK_EQUAL(sock0.use_count(), 1);
+    BOOST_CHECK_EQUAL(sock1.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(wait_set)
+{
+    // The implementation based on WaitMany().
+    SockWaitSet wait_many_set;
+    CheckWaitSet(wait_many_set);
+
+    // The implementation for real sockets on this platform.
+    Sock sock{INVALID_SOCKET};
+    const auto wait_set{sock.CreateWaitSet()};
+    CheckWaitSet(*wait_set);
+}
+
 #endif /* WIN32 */
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <util/threadpool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <semaphore>
+#include <stdexcept>
+#include <vector>
+
+using util::ThreadPool;
+
+BOOST_AUTO_TEST_SUITE(threadpool_tests)
+
+BOOST_AUTO_TEST_CASE(submit_and_stop)
+{
+    ThreadPool pool{"test"};
+    // Nothing runs tasks before the pool is started.
+    BOOST_CHECK_THROW((void)pool.Submit([] {}), std::runtime_error);
+
+    pool.Start(/*num_workers=*/3);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 3U);
+
+    std::vector<std::future<int>> futures;
+    for (int i{0}; i < 100; ++i) {
+        futures.push_back(pool.Submit([i] { return i * i; }));
+    }
+    for (int i{0}; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+    }
+
+    // Exceptions are passed on to the future.
+    auto failing{pool.Submit([]() -> int { throw std::runtime_error{"failed"}; })};
+    BOOST_CHECK_THROW(failing.get(), std::runtime_error);
+
+    // All tasks submitted before stopping are run, even if the workers are busy.
+    std::binary_semaphore blocker{0};
+    std::atomic<int> count{0};
+    std::vector<std::future<void>> blocked;
+    for (int i{0}; i < 3; ++i) {
+        blocked.push_back(pool.Submit([&] { blocker.acquire(); blocker.release(); ++count; }));
+    }
+    std::vector<std::future<void>> queued;
+    for (int i{0}; i < 10; ++i) {
+        queued.push_back(pool.Submit([&] { ++count; }));
+    }
+    blocker.release();
+    pool.Stop();
+    BOOST_CHECK_EQUAL(count, 13);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 0U);
+    BOOST_CHECK_EQUAL(pool.WorkQueueSize(), 0U);
+    BOOST_CHECK_THROW((void)pool.Submit([] {}), std::runtime_error);
+
+    // The pool can be started again.
+    pool.Start(/*num_workers=*/1);
+    BOOST_CHECK_EQUAL(pool.Submit([] { return 7; }).get(), 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
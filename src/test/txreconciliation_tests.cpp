@@ -8,8 +8,23 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
 
+/** Register peer 0 with both trackers, as an outbound peer of the initiator. */
+static void RegisterPair(TxReconciliationTracker& initiator, TxReconciliationTracker& responder)
+{
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(0)};
+    BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(0, /*is_peer_inbound=*/false, 1, responder_salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(responder.RegisterPeer(0, /*is_peer_inbound=*/true, 1, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+}
+
 BOOST_AUTO_TEST_CASE(RegisterPeerTest)
 {
     TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
@@ -81,4 +96,209 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+BOOST_AUTO_TEST_CASE(ReconciliationSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Unregistered peers have no set.
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    tracker.PreRegisterPeer(0);
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(tracker.AddToSet(0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(0, wtxid));
+
+    // The set is bounded.
+    for (size_t i = 0; i < MAX_RECONSET_SIZE; ++i) {
+        BOOST_CHECK(tracker.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationRoundTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    std::vector<Wtxid> shared, initiator_only, responder_only;
+    for (int i = 0; i < 20; ++i) shared.push_back(Wtxid::FromUint256(m_rng.rand256()));
+    for (int i = 0; i < 3; ++i) initiator_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+    for (int i = 0; i < 2; ++i) responder_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+    for (const auto& wtxid : shared) {
+        BOOST_REQUIRE(initiator.AddToSet(0, wtxid));
+        BOOST_REQUIRE(responder.AddToSet(0, wtxid));
+    }
+    for (const auto& wtxid : initiator_only) BOOST_REQUIRE(initiator.AddToSet(0, wtxid));
+    for (const auto& wtxid : responder_only) BOOST_REQUIRE(responder.AddToSet(0, wtxid));
+
+    // Only the initiator requests sketches, once per interval.
+    BOOST_CHECK(!responder.IsPeerNextToReconcileWith(0, 1s));
+    BOOST_CHECK(initiator.IsPeerNextToReconcileWith(0, 1s));
+    BOOST_CHECK(!initiator.IsPeerNextToReconcileWith(0, 2s));
+    BOOST_CHECK(!responder.InitiateReconciliationRequest(0, 1s));
+    const auto request{initiator.InitiateReconciliationRequest(0, 1s)};
+    BOOST_REQUIRE(request);
+    BOOST_CHECK_EQUAL(request->first, 23);
+    // A round is already ongoing.
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(0, 1s));
+
+    BOOST_CHECK(!responder.RespondToReconciliationRequest(0));
+    BOOST_REQUIRE(responder.HandleReconciliationRequest(0, request->first, request->second));
+    const auto skdata{responder.RespondToReconciliationRequest(0)};
+    BOOST_REQUIRE(skdata);
+    // Set size difference, plus q * the smaller set, plus one.
+    BOOST_CHECK_EQUAL(skdata->size(), (1 + 22 / 4 + 1) * 4U);
+    // Transactions added from now on are left for the next round.
+    const Wtxid late{Wtxid::FromUint256(m_rng.rand256())};
+    BOOST_REQUIRE(responder.AddToSet(0, late));
+
+    const auto diff{initiator.HandleSketch(0, *skdata)};
+    BOOST_REQUIRE(diff);
+    BOOST_CHECK(diff->success);
+    BOOST_CHECK_EQUAL(diff->ask_shortids.size(), responder_only.size());
+    auto announce{diff->announce};
+    std::sort(announce.begin(), announce.end());
+    std::sort(initiator_only.begin(), initiator_only.end());
+    BOOST_CHECK(announce == initiator_only);
+    // The set was emptied, so a second sketch is unexpected.
+    BOOST_CHECK(!initiator.HandleSketch(0, *skdata));
+
+    auto responder_announce{responder.HandleReconcilDiff(0, diff->success, diff->ask_shortids)};
+    BOOST_REQUIRE(responder_announce);
+    std::sort(responder_announce->begin(), responder_announce->end());
+    std::sort(responder_only.begin(), responder_only.end());
+    BOOST_CHECK(*responder_announce == responder_only);
+    BOOST_CHECK(!responder.HandleReconcilDiff(0, diff->success, diff->ask_shortids));
+    BOOST_CHECK(responder.TryRemovingFromSet(0, late));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationFailureTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    // Equally sized, disjoint sets differ by more than a sketch with capacity for q * 10 + 1
+    // elements can decode.
+    std::vector<Wtxid> initiator_set, responder_set;
+    for (int i = 0; i < 10; ++i) {
+        initiator_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        responder_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_REQUIRE(initiator.AddToSet(0, initiator_set.back()));
+        BOOST_REQUIRE(responder.AddToSet(0, responder_set.back()));
+    }
+
+    BOOST_REQUIRE(initiator.IsPeerNextToReconcileWith(0, 1s));
+    const auto request{initiator.InitiateReconciliationRequest(0, 1s)};
+    BOOST_REQUIRE(request);
+    BOOST_REQUIRE(responder.HandleReconciliationRequest(0, request->first, request->second));
+    // A second request before the round completed violates the protocol.
+    BOOST_CHECK(!responder.HandleReconciliationRequest(0, request->first, request->second));
+    const auto skdata{responder.RespondToReconciliationRequest(0)};
+    BOOST_REQUIRE(skdata);
+
+    // Sketches must contain whole 32-bit elements.
+    BOOST_CHECK(!initiator.HandleSketch(0, std::span{*skdata}.first(skdata->size() - 1)));
+    const auto diff{initiator.HandleSketch(0, *skdata)};
+    BOOST_REQUIRE(diff);
+    BOOST_CHECK(!diff->success);
+    BOOST_CHECK(diff->ask_shortids.empty());
+    auto announce{diff->announce};
+    std::sort(announce.begin(), announce.end());
+    std::sort(initiator_set.begin(), initiator_set.end());
+    BOOST_CHECK(announce == initiator_set);
+
+    // On failure, the responder announces its whole set.
+    auto responder_announce{responder.HandleReconcilDiff(0, diff->success, diff->ask_shortids)};
+    BOOST_REQUIRE(responder_announce);
+    std::sort(responder_announce->begin(), responder_announce->end());
+    std::sort(responder_set.begin(), responder_set.end());
+    BOOST_CHECK(*responder_announce == responder_set);
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationTimeoutTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    std::vector<Wtxid> initiator_set, responder_set;
+    for (int i = 0; i < 5; ++i) {
+        initiator_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        responder_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_REQUIRE(initiator.AddToSet(0, initiator_set.back()));
+        BOOST_REQUIRE(responder.AddToSet(0, responder_set.back()));
+    }
+
+    const auto request{initiator.InitiateReconciliationRequest(0, 1s)};
+    BOOST_REQUIRE(request);
+    BOOST_REQUIRE(responder.HandleReconciliationRequest(0, request->first, request->second));
+
+    // Nothing expires before the peer had time to answer.
+    BOOST_CHECK(initiator.ExpireReconciliationRequest(0, 1s + RECON_RESPONSE_TIMEOUT - 1us).empty());
+    BOOST_CHECK(responder.ExpireReconciliationRequest(0, 1s + RECON_RESPONSE_TIMEOUT).empty());
+
+    // Then the set put aside for the round is announced.
+    auto announce{initiator.ExpireReconciliationRequest(0, 1s + RECON_RESPONSE_TIMEOUT)};
+    std::sort(announce.begin(), announce.end());
+    std::sort(initiator_set.begin(), initiator_set.end());
+    BOOST_CHECK(announce == initiator_set);
+    BOOST_CHECK(initiator.ExpireReconciliationRequest(0, 1s + RECON_RESPONSE_TIMEOUT).empty());
+
+    // Until the peer answers, no new round is started, and new transactions are announced
+    // via INV instead of being held back.
+    BOOST_CHECK(!initiator.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(0, 1s + RECON_REQUEST_INTERVAL + RECON_RESPONSE_TIMEOUT));
+
+    // A late sketch fails the round, so that the responder announces its set too.
+    const auto skdata{responder.RespondToReconciliationRequest(0)};
+    BOOST_REQUIRE(skdata);
+    const auto diff{initiator.HandleSketch(0, *skdata)};
+    BOOST_REQUIRE(diff);
+    BOOST_CHECK(!diff->success);
+    BOOST_CHECK(diff->ask_shortids.empty());
+    BOOST_CHECK(diff->announce.empty());
+    auto responder_announce{responder.HandleReconcilDiff(0, diff->success, diff->ask_shortids)};
+    BOOST_REQUIRE(responder_announce);
+    std::sort(responder_announce->begin(), responder_announce->end());
+    std::sort(responder_set.begin(), responder_set.end());
+    BOOST_CHECK(*responder_announce == responder_set);
+
+    // After that, a second sketch is unexpected again, and reconciliation resumes.
+    BOOST_CHECK(!initiator.HandleSketch(0, *skdata));
+    BOOST_CHECK(initiator.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    BOOST_CHECK(initiator.InitiateReconciliationRequest(0, 1min));
+}
+
+BOOST_AUTO_TEST_CASE(FanoutTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+
+    // Transactions are flooded to peers we do not reconcile with.
+    BOOST_CHECK(tracker.ShouldFanoutTo(Wtxid::FromUint256(m_rng.rand256()), 0));
+
+    // With 8 outbound and 20 inbound reconciling peers, each transaction is flooded to one
+    // outbound and two inbound peers on average.
+    for (NodeId peer_id = 0; peer_id < 28; ++peer_id) {
+        tracker.PreRegisterPeer(peer_id);
+        BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/peer_id >= 8, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    }
+    int outbound_fanouts{0}, inbound_fanouts{0};
+    for (int i = 0; i < 1000; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        for (NodeId peer_id = 0; peer_id < 28; ++peer_id) {
+            const bool fanout{tracker.ShouldFanoutTo(wtxid, peer_id)};
+            // The choice is deterministic.
+            BOOST_CHECK_EQUAL(fanout, tracker.ShouldFanoutTo(wtxid, peer_id));
+            (peer_id < 8 ? outbound_fanouts : inbound_fanouts) += fanout;
+        }
+    }
+    BOOST_CHECK(outbound_fanouts > 800 && outbound_fanouts < 1200);
+    BOOST_CHECK(inbound_fanouts > 1700 && inbound_fanouts < 2300);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -162,6 +162,18 @@ ZeroSock::~ZeroSock() { m_socket = INVALID_SOCKET; }
 
 ssize_t ZeroSock::Send(const void*, size_t len, int) const { return len; }
 
+ssize_t ZeroSock::SendMany(std::span<const std::span<const uint8_t>> data, int flags) const
+{
+    ssize_t sent{0};
+    for (const auto& buf : data) {
+        const ssize_t ret{Send(buf.data(), buf.size(), flags)};
+        if (ret < 0) return sent > 0 ? sent : ret;
+        sent += ret;
+        if (static_cast<size_t>(ret) < buf.size()) break;
+    }
+    return sent;
+}
+
 ssize_t ZeroSock::Recv(void* buf, size_t len, int flags) const
 {
     memset(buf, 0x0, len);
@@ -226,6 +238,12 @@ bool ZeroSock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events
     return true;
 }
 
+std::unique_ptr<SockWaitSet> ZeroSock::CreateWaitSet() const
+{
+    // Wait through WaitMany(), which is mocked, instead of on the made-up file descriptors.
+    return std::make_unique<SockWaitSet>();
+}
+
 ZeroSock& ZeroSock::operator=(Sock&& other)
 {
     assert(false && "Move of Sock into ZeroSock not allowed.");
@@ -45,6 +45,11 @@ struct ConnmanTestMsg : public CConnman {
         m_peer_connect_timeout = timeout;
     }
 
+    void StartIOThreads(int num_threads)
+    {
+        m_io_pool.Start(num_threads);
+    }
+
     void ResetAddrCache();
     void ResetMaxOutboundCycle();
 
@@ -168,6 +173,9 @@ public:
 
     ssize_t Send(const void*, size_t len, int) const override;
 
+    /** Passes the buffers to Send() one by one, so mocks only need to override Send(). */
+    ssize_t SendMany(std::span<const std::span<const uint8_t>> data, int flags) const override;
+
     ssize_t Recv(void* buf, size_t len, int flags) const override;
 
     int Connect(const sockaddr*, socklen_t) const override;
@@ -194,6 +202,8 @@ public:
 
     bool WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per_sock) const override;
 
+    std::unique_ptr<SockWaitSet> CreateWaitSet() const override;
+
 private:
     ZeroSock& operator=(Sock&& other) override;
 };
@@ -94,6 +94,7 @@ void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap& cachedDescendan
             mapTx.modify(mapTx.iterator_to(descendant), [=](CTxMemPoolEntry& e) {
               e.UpdateAncestorState(updateIt->GetTxSize(), updateIt->GetModifiedFee(), 1, updateIt->GetSigOpCost());
             });
+            MarkSnapshotDirty(descendant.GetTx().GetHash());
             // Don't directly remove the transaction here -- doing so would
             // invalidate iterators in cachedDescendants. Mark it for removal
             // by inserting into descendants_to_remove.
@@ -103,6 +104,7 @@ void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap& cachedDescendan
         }
     }
     mapTx.modify(updateIt, [=](CTxMemPoolEntry& e) { e.UpdateDescendantState(modifySize, modifyFee, modifyCount); });
+    MarkSnapshotDirty(updateIt->GetTx().GetHash());
 }
 
 void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<Txid>& vHashesToUpdate)
@@ -298,6 +300,7 @@ void CTxMemPool::UpdateAncestorsOf(bool add, txiter it, setEntries &setAncestors
     const CAmount updateFee = updateCount * it->GetModifiedFee();
     for (txiter ancestorIt : setAncestors) {
         mapTx.modify(ancestorIt, [=](CTxMemPoolEntry& e) { e.UpdateDescendantState(updateSize, updateFee, updateCount); });
+        MarkSnapshotDirty(ancestorIt->GetTx().GetHash());
     }
 }
 
@@ -313,6 +316,7 @@ void CTxMemPool::UpdateEntryForAncestors(txiter it, const setEntries &setAncesto
         updateSigOpsCost += ancestorIt->GetSigOpCost();
     }
     mapTx.modify(it, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(updateSize, updateFee, updateCount, updateSigOpsCost); });
+    MarkSnapshotDirty(it->GetTx().GetHash());
 }
 
 void CTxMemPool::UpdateChildrenForRemoval(txiter it)
@@ -343,6 +347,7 @@ void CTxMemPool::UpdateForRemoveFromMempool(const setEntries &entriesToRemove, b
             int modifySigOps = -removeIt->GetSigOpCost();
             for (txiter dit : setDescendants) {
                 mapTx.modify(dit, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(modifySize, modifyFee, -1, modifySigOps); });
+                MarkSnapshotDirty(dit->GetTx().GetHash());
             }
         }
     }
@@ -506,6 +511,7 @@ void CTxMemPool::addNewTransaction(CTxMemPool::txiter newit, CTxMemPool::setEntr
     nTransactionsUpdated++;
     totalTxSize += entry.GetTxSize();
     m_total_fee += entry.GetFee();
+    MarkSnapshotDirty(tx.GetHash());
 
     txns_randomized.emplace_back(tx.GetWitnessHash(), newit);
     newit->idx_randomized = txns_randomized.size() - 1;
@@ -557,6 +563,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 
     totalTxSize -= it->GetTxSize();
     m_total_fee -= it->GetFee();
+    MarkSnapshotDirty(it->GetTx().GetHash());
     cachedInnerUsage -= it->DynamicMemoryUsage();
     cachedInnerUsage -= memusage::DynamicUsage(it->GetMemPoolParentsConst()) + memusage::DynamicUsage(it->GetMemPoolChildrenConst());
     mapTx.erase(it);
@@ -889,15 +896,18 @@ void CTxMemPool::PrioritiseTransaction(const Txid& hash, const CAmount& nFeeDelt
 {
     {
         LOCK(cs);
+        m_snapshot_stale = true;
         CAmount &delta = mapDeltas[hash];
         delta = SaturatingAdd(delta, nFeeDelta);
         txiter it = mapTx.find(hash);
         if (it != mapTx.end()) {
             mapTx.modify(it, [&nFeeDelta](CTxMemPoolEntry& e) { e.UpdateModifiedFee(nFeeDelta); });
+            MarkSnapshotDirty(hash);
             // Now update all ancestors' modified fees with descendants
             auto ancestors{AssumeCalculateMemPoolAncestors(__func__, *it, Limits::NoLimits(), /*fSearchForParents=*/false)};
             for (txiter ancestorIt : ancestors) {
                 mapTx.modify(ancestorIt, [=](CTxMemPoolEntry& e){ e.UpdateDescendantState(0, nFeeDelta, 0);});
+                MarkSnapshotDirty(ancestorIt->GetTx().GetHash());
             }
             // Now update all descendants' modified fees with ancestors
             setEntries setDescendants;
@@ -905,6 +915,7 @@ void CTxMemPool::PrioritiseTransaction(const Txid& hash, const CAmount& nFeeDelt
             setDescendants.erase(it);
             for (txiter descendantIt : setDescendants) {
                 mapTx.modify(descendantIt, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(0, nFeeDelta, 0, 0); });
+                MarkSnapshotDirty(descendantIt->GetTx().GetHash());
             }
             ++nTransactionsUpdated;
         }
@@ -934,6 +945,7 @@ void CTxMemPool::ApplyDelta(const Txid& hash, CAmount &nFeeDelta) const
 void CTxMemPool::ClearPrioritisation(const Txid& hash)
 {
     AssertLockHeld(cs);
+    m_snapshot_stale = true;
     mapDeltas.erase(hash);
 }
 
@@ -1053,6 +1065,7 @@ void CTxMemPool::RemoveUnbroadcastTx(const Txid& txid, const bool unchecked) {
 
     if (m_unbroadcast_txids.erase(txid))
     {
+        MarkSnapshotDirty(txid);
         LogDebug(BCLog::MEMPOOL, "Removed %i from set of unbroadcast txns%s\n", txid.GetHex(), (unchecked ? " before confirmation that txn was sent out" : ""));
     }
 }
@@ -1089,8 +1102,10 @@ void CTxMemPool::UpdateChild(txiter entry, txiter child, bool add)
     CTxMemPoolEntry::Children s;
     if (add && entry->GetMemPoolChildren().insert(*child).second) {
         cachedInnerUsage += memusage::IncrementalDynamicUsage(s);
+        MarkSnapshotDirty(entry->GetTx().GetHash());
     } else if (!add && entry->GetMemPoolChildren().erase(*child)) {
         cachedInnerUsage -= memusage::IncrementalDynamicUsage(s);
+        MarkSnapshotDirty(entry->GetTx().GetHash());
     }
 }
 
@@ -1100,8 +1115,10 @@ void CTxMemPool::UpdateParent(txiter entry, txiter parent, bool add)
     CTxMemPoolEntry::Parents s;
     if (add && entry->GetMemPoolParents().insert(*parent).second) {
         cachedInnerUsage += memusage::IncrementalDynamicUsage(s);
+        MarkSnapshotDirty(entry->GetTx().GetHash());
     } else if (!add && entry->GetMemPoolParents().erase(*parent)) {
         cachedInnerUsage -= memusage::IncrementalDynamicUsage(s);
+        MarkSnapshotDirty(entry->GetTx().GetHash());
     }
 }
 
@@ -1225,6 +1242,107 @@ void CTxMemPool::SetLoadTried(bool load_tried)
 {
     LOCK(cs);
     m_load_tried = load_tried;
+    m_snapshot_stale = true;
+}
+
+void CTxMemPool::MarkSnapshotDirty(const Txid& txid) const
+{
+    AssertLockHeld(cs);
+    m_snapshot_stale = true;
+    // Nothing to track until a snapshot has been taken, or while a full
+    // rebuild is pending anyway.
+    if (m_snapshot_rebuild) return;
+    m_snapshot_dirty.insert(txid);
+    // Once more entries have changed than the mempool holds, rebuilding from
+    // scratch is cheaper than applying the changes one by one, and stops the
+    // tracked set from growing without bound if no snapshot is requested.
+    if (m_snapshot_dirty.size() > mapTx.size()) {
+        m_snapshot_dirty.clear();
+        m_snapshot_rebuild = true;
+    }
+}
+
+kernel::MempoolSnapshotEntryRef CTxMemPool::MakeSnapshotEntry(const CTxMemPoolEntry& entry) const
+{
+    AssertLockHeld(cs);
+    auto ret{std::make_shared<kernel::MempoolSnapshotEntry>()};
+    ret->tx = entry.GetSharedTx();
+    ret->fee = entry.GetFee();
+    ret->modified_fee = entry.GetModifiedFee();
+    ret->vsize = entry.GetTxSize();
+    ret->weight = entry.GetTxWeight();
+    ret->time = entry.GetTime();
+    ret->height = entry.GetHeight();
+    ret->count_with_ancestors = entry.GetCountWithAncestors();
+    ret->size_with_ancestors = entry.GetSizeWithAncestors();
+    ret->mod_fees_with_ancestors = entry.GetModFeesWithAncestors();
+    ret->count_with_descendants = entry.GetCountWithDescendants();
+    ret->size_with_descendants = entry.GetSizeWithDescendants();
+    ret->mod_fees_with_descendants = entry.GetModFeesWithDescendants();
+    ret->parents.reserve(entry.GetMemPoolParentsConst().size());
+    for (const CTxMemPoolEntry& parent : entry.GetMemPoolParentsConst()) {
+        ret->parents.push_back(parent.GetTx().GetHash());
+    }
+    std::sort(ret->parents.begin(), ret->parents.end());
+    ret->children.reserve(entry.GetMemPoolChildrenConst().size());
+    for (const CTxMemPoolEntry& child : entry.GetMemPoolChildrenConst()) {
+        ret->children.push_back(child.GetTx().GetHash());
+    }
+    std::sort(ret->children.begin(), ret->children.end());
+    ret->unbroadcast = IsUnbroadcastTx(entry.GetTx().GetHash());
+    return ret;
+}
+
+std::shared_ptr<const kernel::MempoolSnapshot> CTxMemPool::GetSnapshot() const
+{
+    LOCK(m_snapshot_mutex);
+    if (m_snapshot && !m_snapshot_stale) return m_snapshot;
+
+    std::vector<kernel::MempoolSnapshotEntryRef> updated;
+    std::vector<Txid> removed;
+    kernel::MempoolSnapshotStats stats;
+    bool rebuild;
+    {
+        // Only the entries that changed since the last refresh are copied
+        // while holding cs, so writers are never blocked on a full walk of
+        // mapTx except for the very first snapshot.
+        LOCK(cs);
+        m_snapshot_stale = false;
+        rebuild = m_snapshot_rebuild || !m_snapshot;
+        if (rebuild) {
+            updated.reserve(mapTx.size());
+            for (const CTxMemPoolEntry& entry : mapTx) {
+                updated.push_back(MakeSnapshotEntry(entry));
+            }
+        } else {
+            updated.reserve(m_snapshot_dirty.size());
+            for (const Txid& txid : m_snapshot_dirty) {
+                const auto it{mapTx.find(txid)};
+                if (it == mapTx.end()) {
+                    removed.push_back(txid);
+                } else {
+                    updated.push_back(MakeSnapshotEntry(*it));
+                }
+            }
+        }
+        m_snapshot_dirty.clear();
+        m_snapshot_rebuild = false;
+
+        stats.total_tx_size = totalTxSize;
+        stats.total_fee = m_total_fee;
+        stats.dynamic_usage = DynamicMemoryUsage();
+        stats.sequence = m_sequence_number;
+        stats.unbroadcast_count = m_unbroadcast_txids.size();
+        stats.load_tried = m_load_tried;
+    }
+
+    if (rebuild) {
+        const kernel::MempoolSnapshot base{m_snapshot ? m_snapshot->Clear() : kernel::MempoolSnapshot{}};
+        m_snapshot = std::make_shared<const kernel::MempoolSnapshot>(base.Update(updated, {}, stats));
+    } else {
+        m_snapshot = std::make_shared<const kernel::MempoolSnapshot>(m_snapshot->Update(updated, removed, stats));
+    }
+    return m_snapshot;
 }
 
 std::vector<CTxMemPool::txiter> CTxMemPool::GatherClusters(const std::vector<Txid>& txids) const
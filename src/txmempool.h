@@ -14,6 +14,7 @@
 #include <kernel/mempool_limits.h>         // IWYU pragma: export
 #include <kernel/mempool_options.h>        // IWYU pragma: export
 #include <kernel/mempool_removal_reason.h> // IWYU pragma: export
+#include <kernel/mempool_snapshot.h>       // IWYU pragma: export
 #include <policy/feerate.h>
 #include <policy/packages.h>
 #include <primitives/transaction.h>
@@ -34,10 +35,12 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -300,6 +303,19 @@ protected:
 
     bool m_load_tried GUARDED_BY(cs){false};
 
+    //! Txids of entries added, modified or removed since the last snapshot refresh.
+    mutable std::unordered_set<Txid, SaltedTxidHasher> m_snapshot_dirty GUARDED_BY(cs);
+    //! Whether the next refresh must rebuild the snapshot from all of mapTx.
+    mutable bool m_snapshot_rebuild GUARDED_BY(cs){true};
+    //! Set by writers whenever anything captured by the snapshot changes.
+    mutable std::atomic<bool> m_snapshot_stale{true};
+    //! Serializes snapshot refreshes. Must be acquired before cs.
+    mutable Mutex m_snapshot_mutex;
+    mutable std::shared_ptr<const kernel::MempoolSnapshot> m_snapshot GUARDED_BY(m_snapshot_mutex);
+
+    void MarkSnapshotDirty(const Txid& txid) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+    kernel::MempoolSnapshotEntryRef MakeSnapshotEntry(const CTxMemPoolEntry& entry) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     CFeeRate GetMinFee(size_t sizelimit) const;
 
 public:
@@ -663,6 +679,17 @@ public:
     std::vector<CTxMemPoolEntryRef> entryAll() const EXCLUSIVE_LOCKS_REQUIRED(cs);
     std::vector<TxMempoolInfo> infoAll() const;
 
+    /**
+     * Return a read-only snapshot of all entries and pool-wide aggregates that
+     * reflects every change made before this call. Callers can query the
+     * returned snapshot for as long as they like without holding cs.
+     *
+     * Refreshing is incremental: only entries that changed since the previous
+     * call are copied while cs is held, and the snapshot shares unchanged
+     * data with its predecessor. If nothing changed, cs is not taken at all.
+     */
+    std::shared_ptr<const kernel::MempoolSnapshot> GetSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(!cs, !m_snapshot_mutex);
+
     size_t DynamicMemoryUsage() const;
 
     /** Adds a transaction to the unbroadcast set */
@@ -671,7 +698,7 @@ public:
         LOCK(cs);
         // Sanity check the transaction is in the mempool & insert into
         // unbroadcast set.
-        if (exists(txid)) m_unbroadcast_txids.insert(txid);
+        if (exists(txid) && m_unbroadcast_txids.insert(txid).second) MarkSnapshotDirty(txid);
     };
 
     /** Removes a transaction from the unbroadcast set */
@@ -693,6 +720,7 @@ public:
 
     /** Guards this internal counter for external reporting */
     uint64_t GetAndIncrementSequence() const EXCLUSIVE_LOCKS_REQUIRED(cs) {
+        m_snapshot_stale = true;
         return m_sequence_number++;
     }
 
@@ -9,6 +9,7 @@
 #include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -109,6 +110,7 @@ private:
 
     void checkType(const VType& expected) const;
     bool findKey(const std::string& key, size_t& retIdx) const;
+    void write(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
     void writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
     void writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
 
@@ -127,6 +129,61 @@ public:
 
     enum VType type() const { return getType(); }
     const UniValue& find_value(std::string_view key) const;
+
+    friend class UniValueWriter;
+};
+
+/**
+ * Writes compact JSON text piece by piece, handing it to a sink whenever more
+ * than chunk_size bytes have been buffered. Large documents can be produced
+ * this way without ever holding all of them as a UniValue tree or a string:
+ * only the containers that are still open and the value being written need
+ * to be in memory.
+ *
+ * Throws std::runtime_error when the calls would not form a single valid JSON
+ * value, such as a key outside of an object or an unbalanced end.
+ */
+class UniValueWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+    static constexpr size_t DEFAULT_CHUNK_SIZE{64 << 10};
+
+    explicit UniValueWriter(Sink sink, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    //! Start a member of the current object. Must be followed by its value.
+    void key(std::string_view key);
+    void value(const UniValue& val);
+    //! Write a value that was serialized before, such as by UniValue::write(), as it is.
+    void raw(std::string_view json);
+    //! Continue the value written with raw(), for values handed over in pieces.
+    void rawContinued(std::string_view json);
+
+    //! Hand the buffered text to the sink, even if it is less than a chunk.
+    void flush();
+
+    //! Number of bytes written so far, including the ones still buffered.
+    size_t size() const { return m_flushed + m_buf.size(); }
+    //! Number of bytes handed to the sink so far.
+    size_t flushed() const { return m_flushed; }
+
+private:
+    Sink m_sink;
+    const size_t m_chunk_size;
+    std::string m_buf;
+    size_t m_flushed{0};
+    //! For every open container, whether nothing was written to it yet.
+    std::vector<bool> m_empty;
+    //! For every open container, whether it is an object.
+    std::vector<bool> m_in_object;
+    //! Whether a key was written whose value has not been yet.
+    bool m_after_key{false};
+
+    void separate();
+    void close(bool object);
 };
 
 template <class It>
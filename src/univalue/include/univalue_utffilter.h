@@ -5,6 +5,7 @@
 #define BITCOIN_UNIVALUE_INCLUDE_UNIVALUE_UTFFILTER_H
 
 #include <string>
+#include <string_view>
 
 /**
  * Filter that generates and validates UTF-8, as well as collates UTF-16
@@ -45,6 +46,13 @@ public:
                 push_back_u(codepoint);
         }
     }
+    // Write a run of 7-bit ASCII chars, equivalent to push_back() of each
+    void append_ascii(std::string_view ascii)
+    {
+        if (state) // Not a continuation, invalid
+            is_valid = false;
+        str.append(ascii);
+    }
     // Write codepoint directly, possibly collating surrogate pairs
     void push_back_u(unsigned int codepoint_)
     {
@@ -6,16 +6,15 @@
 #include <univalue_escapes.h>
 
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-static std::string json_escape(const std::string& inS)
+static void json_escape(std::string_view inS, std::string& outS)
 {
-    std::string outS;
-    outS.reserve(inS.size() * 2);
-
-    for (unsigned int i = 0; i < inS.size(); i++) {
-        unsigned char ch = static_cast<unsigned char>(inS[i]);
+    for (unsigned char ch : inS) {
         const char *escStr = escapes[ch];
 
         if (escStr)
@@ -23,17 +22,20 @@ static std::string json_escape(const std::string& inS)
         else
             outS += static_cast<char>(ch);
     }
-
-    return outS;
 }
 
-// NOLINTNEXTLINE(misc-no-recursion)
 std::string UniValue::write(unsigned int prettyIndent,
                             unsigned int indentLevel) const
 {
     std::string s;
     s.reserve(1024);
+    write(prettyIndent, indentLevel, s);
+    return s;
+}
 
+// NOLINTNEXTLINE(misc-no-recursion)
+void UniValue::write(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const
+{
     unsigned int modIndent = indentLevel;
     if (modIndent == 0)
         modIndent = 1;
@@ -49,7 +51,9 @@ std::string UniValue::write(unsigned int prettyIndent,
         writeArray(prettyIndent, modIndent, s);
         break;
     case VSTR:
-        s += "\"" + json_escape(val) + "\"";
+        s += '"';
+        json_escape(val, s);
+        s += '"';
         break;
     case VNUM:
         s += val;
@@ -58,8 +62,6 @@ std::string UniValue::write(unsigned int prettyIndent,
         s += (val == "1" ? "true" : "false");
         break;
     }
-
-    return s;
 }
 
 static void indentStr(unsigned int prettyIndent, unsigned int indentLevel, std::string& s)
@@ -77,7 +79,7 @@ void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, s
     for (unsigned int i = 0; i < values.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += values[i].write(prettyIndent, indentLevel + 1);
+        values[i].write(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1)) {
             s += ",";
         }
@@ -100,10 +102,12 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
     for (unsigned int i = 0; i < keys.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += "\"" + json_escape(keys[i]) + "\":";
+        s += '"';
+        json_escape(keys[i], s);
+        s += "\":";
         if (prettyIndent)
             s += " ";
-        s += values.at(i).write(prettyIndent, indentLevel + 1);
+        values.at(i).write(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1))
             s += ",";
         if (prettyIndent)
@@ -115,3 +119,107 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
     s += "}";
 }
 
+
+UniValueWriter::UniValueWriter(Sink sink, size_t chunk_size)
+    : m_sink{std::move(sink)}, m_chunk_size{chunk_size}
+{
+    m_buf.reserve(m_chunk_size);
+}
+
+void UniValueWriter::separate()
+{
+    if (m_after_key) {
+        m_after_key = false;
+        return;
+    }
+    if (m_empty.empty()) {
+        if (size() > 0) throw std::runtime_error("JSON writer: more than one top-level value");
+        return;
+    }
+    if (m_in_object.back()) throw std::runtime_error("JSON writer: object member without key");
+    if (!m_empty.back()) m_buf += ',';
+    m_empty.back() = false;
+}
+
+void UniValueWriter::close(bool object)
+{
+    if (m_empty.empty() || m_in_object.back() != object || m_after_key) {
+        throw std::runtime_error("JSON writer: unbalanced container");
+    }
+    m_buf += object ? '}' : ']';
+    m_empty.pop_back();
+    m_in_object.pop_back();
+    if (m_buf.size() >= m_chunk_size) flush();
+}
+
+void UniValueWriter::beginObject()
+{
+    separate();
+    m_buf += '{';
+    m_empty.push_back(true);
+    m_in_object.push_back(true);
+}
+
+void UniValueWriter::endObject()
+{
+    close(/*object=*/true);
+}
+
+void UniValueWriter::beginArray()
+{
+    separate();
+    m_buf += '[';
+    m_empty.push_back(true);
+    m_in_object.push_back(false);
+}
+
+void UniValueWriter::endArray()
+{
+    close(/*object=*/false);
+}
+
+void UniValueWriter::key(std::string_view key)
+{
+    if (m_empty.empty() || !m_in_object.back() || m_after_key) {
+        throw std::runtime_error("JSON writer: key outside of an object");
+    }
+    if (!m_empty.back()) m_buf += ',';
+    m_empty.back() = false;
+    m_buf += '"';
+    json_escape(key, m_buf);
+    m_buf += "\":";
+    m_after_key = true;
+}
+
+void UniValueWriter::value(const UniValue& val)
+{
+    separate();
+    val.write(/*prettyIndent=*/0, /*indentLevel=*/0, m_buf);
+    if (m_buf.size() >= m_chunk_size) flush();
+}
+
+void UniValueWriter::raw(std::string_view json)
+{
+    separate();
+    rawContinued(json);
+}
+
+void UniValueWriter::rawContinued(std::string_view json)
+{
+    if (m_buf.size() + json.size() < m_chunk_size) {
+        m_buf += json;
+        return;
+    }
+    // Hand large values to the sink as they are rather than copying them.
+    flush();
+    m_sink(json);
+    m_flushed += json.size();
+}
+
+void UniValueWriter::flush()
+{
+    if (m_buf.empty()) return;
+    m_sink(m_buf);
+    m_flushed += m_buf.size();
+    m_buf.clear();
+}
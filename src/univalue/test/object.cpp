@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -455,6 +456,96 @@ void univalue_readwrite()
     BOOST_CHECK(!v.read("{} 42"));
 }
 
+void univalue_read_strings()
+{
+    // Strings are scanned several characters at a time, so place each kind
+    // of character that ends a plain run at every offset of such a scan.
+    const std::string specials[]{"\"", "\\", "\n", "\x7f", "\xc3\xa9", "\xf0\x9d\x84\x9e"};
+    for (const auto& special : specials) {
+        for (size_t len{0}; len < 20; ++len) {
+            for (size_t pos{0}; pos <= len; ++pos) {
+                const std::string str{std::string(pos, 'a') + special + std::string(len - pos, 'b')};
+                UniValue v;
+                BOOST_CHECK(v.read(UniValue{str}.write()));
+                BOOST_CHECK_EQUAL(v.get_str(), str);
+
+                // Raw control characters and broken UTF-8 are rejected wherever they are.
+                BOOST_CHECK(!v.read("\"" + std::string(pos, 'a') + "\x01" + std::string(len - pos, 'b') + "\""));
+                BOOST_CHECK(!v.read("\"" + std::string(pos, 'a') + "\xc3" + std::string(len - pos, 'b') + "\""));
+                BOOST_CHECK(!v.read("\"" + std::string(pos, 'a') + "\xc3" + "\\n" + std::string(len - pos, 'b') + "\""));
+            }
+            // Unterminated
+            BOOST_CHECK(!UniValue{}.read("\"" + std::string(len, 'a')));
+        }
+    }
+}
+
+void univalue_writer()
+{
+    UniValue v;
+    BOOST_CHECK(v.read(json1));
+
+    // Written piece by piece, the text is the same as written at once.
+    std::string out;
+    size_t chunks{0};
+    UniValueWriter writer{[&](std::string_view chunk) {
+        out += chunk;
+        ++chunks;
+    }, /*chunk_size=*/8};
+    writer.beginArray();
+    writer.value(v[0]);
+    writer.beginObject();
+    for (size_t i{0}; i < v[1].size(); ++i) {
+        writer.key(v[1].getKeys()[i]);
+        writer.value(v[1].getValues()[i]);
+    }
+    writer.endObject();
+    writer.endArray();
+    BOOST_CHECK_EQUAL(writer.size(), strlen(json1));
+    writer.flush();
+    BOOST_CHECK_EQUAL(out, json1);
+    BOOST_CHECK_EQUAL(writer.flushed(), strlen(json1));
+    BOOST_CHECK(chunks > 1);
+
+    // A value written before can be handed over in pieces.
+    std::string pieces;
+    UniValueWriter piecewise{[&](std::string_view chunk) { pieces += chunk; }, /*chunk_size=*/8};
+    piecewise.beginArray();
+    piecewise.raw("[1,");
+    piecewise.rawContinued("2]");
+    piecewise.raw("{\"a\":");
+    piecewise.rawContinued("\"long enough to be handed over\"}");
+    piecewise.endArray();
+    piecewise.flush();
+    BOOST_CHECK_EQUAL(pieces, "[[1,2],{\"a\":\"long enough to be handed over\"}]");
+
+    // Nothing reaches the sink before a chunk is full.
+    UniValueWriter buffered{[&](std::string_view) { assert(0); }};
+    buffered.beginObject();
+    buffered.key("a");
+    buffered.beginArray();
+    buffered.endArray();
+    buffered.key("b");
+    buffered.value(UniValue{});
+    buffered.endObject();
+    BOOST_CHECK_EQUAL(buffered.size(), strlen("{\"a\":[],\"b\":null}"));
+    BOOST_CHECK_EQUAL(buffered.flushed(), 0);
+
+    // Calls that would not make valid JSON throw.
+    UniValueWriter invalid{[](std::string_view) {}};
+    BOOST_CHECK_THROW(invalid.key("a"), std::runtime_error);
+    BOOST_CHECK_THROW(invalid.endArray(), std::runtime_error);
+    invalid.beginObject();
+    BOOST_CHECK_THROW(invalid.value(UniValue{}), std::runtime_error);
+    BOOST_CHECK_THROW(invalid.endArray(), std::runtime_error);
+    invalid.key("a");
+    BOOST_CHECK_THROW(invalid.key("b"), std::runtime_error);
+    BOOST_CHECK_THROW(invalid.endObject(), std::runtime_error);
+    invalid.value(UniValue{});
+    invalid.endObject();
+    BOOST_CHECK_THROW(invalid.value(UniValue{}), std::runtime_error);
+}
+
 int main(int argc, char* argv[])
 {
     univalue_constructor();
@@ -464,5 +555,7 @@ int main(int argc, char* argv[])
     univalue_array();
     univalue_object();
     univalue_readwrite();
+    univalue_read_strings();
+    univalue_writer();
     return 0;
 }
@@ -11,14 +11,21 @@
 #include <util/threadinterrupt.h>
 #include <util/time.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #ifdef USE_POLL
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 static inline bool IOErrorIsPermanent(int err)
 {
     return err != WSAEAGAIN && err != WSAEINTR && err != WSAEWOULDBLOCK && err != WSAEINPROGRESS;
@@ -47,6 +54,25 @@ ssize_t Sock::Send(const void* data, size_t len, int flags) const
     return send(m_socket, static_cast<const char*>(data), len, flags);
 }
 
+ssize_t Sock::SendMany(std::span<const std::span<const uint8_t>> data, int flags) const
+{
+#ifdef WIN32
+    if (data.empty()) return 0;
+    return Send(data.front().data(), data.front().size(), flags);
+#else
+    std::array<iovec, SEND_MANY_MAX_BUFFERS> iov;
+    const size_t count{std::min(data.size(), iov.size())};
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<uint8_t*>(data[i].data());
+        iov[i].iov_len = data[i].size();
+    }
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = count;
+    return sendmsg(m_socket, &msg, flags);
+#endif
+}
+
 ssize_t Sock::Recv(void* buf, size_t len, int flags) const
 {
     return recv(m_socket, static_cast<char*>(buf), len, flags);
@@ -242,6 +268,126 @@ bool Sock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per
 #endif /* USE_POLL */
 }
 
+#ifdef USE_EPOLL
+/**
+ * `SockWaitSet` backed by epoll(7). Sockets are registered with the kernel once and only updated when
+ * the events requested for them change, so the cost of a wait is proportional to the number of ready
+ * sockets rather than to the number of sockets waited on. Level-triggered, because callers do not
+ * necessarily drain a socket each time it is ready.
+ */
+class EpollSockWaitSet final : public SockWaitSet
+{
+public:
+    explicit EpollSockWaitSet(int epoll_fd) : m_epoll_fd{epoll_fd} {}
+    ~EpollSockWaitSet() override { close(m_epoll_fd); }
+
+    void Add(const std::shared_ptr<const Sock>& sock, Sock::Event requested) override
+    {
+        auto& registration{m_registrations[sock->m_socket]};
+        if (!registration.sock) registration.sock = sock;
+        registration.requested = requested;
+        registration.round = m_round;
+    }
+
+    bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock) override
+    {
+        events_per_sock.clear();
+        for (auto it{m_registrations.begin()}; it != m_registrations.end();) {
+            auto& [fd, registration] = *it;
+            if (registration.round != m_round || registration.requested == 0) {
+                // Not added for this wait. Unregister before releasing the socket, which may close it.
+                if (registration.registered != 0) epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                it = m_registrations.erase(it);
+                continue;
+            }
+            if (registration.requested != registration.registered) {
+                epoll_event event{};
+                if (registration.requested & Sock::RECV) {
+                    event.events |= EPOLLIN;
+                }
+                if (registration.requested & Sock::SEND) {
+                    event.events |= EPOLLOUT;
+                }
+                event.data.fd = fd;
+                const int op{registration.registered == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD};
+                if (epoll_ctl(m_epoll_fd, op, fd, &event) == SOCKET_ERROR) {
+                    LogDebug(BCLog::NET, "Cannot wait on socket %d: %s\n", fd, NetworkErrorString(WSAGetLastError()));
+                    if (registration.registered != 0) epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                    it = m_registrations.erase(it);
+                    continue;
+                }
+                registration.registered = registration.requested;
+            }
+            ++it;
+        }
+        ++m_round;
+        if (m_registrations.empty()) return false;
+
+        m_ready.resize(m_registrations.size());
+        const int num_ready{epoll_wait(m_epoll_fd, m_ready.data(), m_ready.size(), count_milliseconds(timeout))};
+        if (num_ready == SOCKET_ERROR) return false;
+
+        for (int i{0}; i < num_ready; ++i) {
+            const auto it{m_registrations.find(m_ready[i].data.fd)};
+            if (it == m_registrations.end()) continue;
+            Sock::Events events{it->second.registered};
+            if (m_ready[i].events & EPOLLIN) {
+                events.occurred |= Sock::RECV;
+            }
+            if (m_ready[i].events & EPOLLOUT) {
+                events.occurred |= Sock::SEND;
+            }
+            if (m_ready[i].events & (EPOLLERR | EPOLLHUP)) {
+                events.occurred |= Sock::ERR;
+            }
+            events_per_sock.emplace(it->second.sock, events);
+        }
+        return true;
+    }
+
+private:
+    struct Registration {
+        //! Keeps the socket open while it is registered, so that its file descriptor is not reused
+        std::shared_ptr<const Sock> sock;
+        //! Events registered with the kernel, 0 if not registered
+        Sock::Event registered{0};
+        //! Events requested by the last `Add()`
+        Sock::Event requested{0};
+        //! Wait for which the socket was last added
+        uint64_t round{0};
+    };
+
+    const int m_epoll_fd;
+    //! Number of the next wait
+    uint64_t m_round{0};
+    std::unordered_map<SOCKET, Registration> m_registrations;
+    std::vector<epoll_event> m_ready;
+};
+#endif // USE_EPOLL
+
+std::unique_ptr<SockWaitSet> Sock::CreateWaitSet() const
+{
+#ifdef USE_EPOLL
+    const int epoll_fd{epoll_create1(EPOLL_CLOEXEC)};
+    if (epoll_fd != SOCKET_ERROR) return std::make_unique<EpollSockWaitSet>(epoll_fd);
+    LogDebug(BCLog::NET, "Cannot create epoll instance, falling back to WaitMany(): %s\n", NetworkErrorString(WSAGetLastError()));
+#endif
+    return std::make_unique<SockWaitSet>();
+}
+
+void SockWaitSet::Add(const std::shared_ptr<const Sock>& sock, Sock::Event requested)
+{
+    m_requested.insert_or_assign(sock, Sock::Events{requested});
+}
+
+bool SockWaitSet::Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock)
+{
+    events_per_sock = std::move(m_requested);
+    m_requested.clear();
+    if (events_per_sock.empty()) return false;
+    return events_per_sock.begin()->first->WaitMany(timeout, events_per_sock);
+}
+
 void Sock::SendComplete(std::span<const unsigned char> data,
                         std::chrono::milliseconds timeout,
                         CThreadInterrupt& interrupt) const
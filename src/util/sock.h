@@ -10,7 +10,9 @@
 #include <util/time.h>
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 
@@ -20,6 +22,14 @@
  */
 static constexpr auto MAX_WAIT_FOR_IO = 1s;
 
+/**
+ * Maximum number of buffers Sock::SendMany() passes to the kernel in one call. This is well
+ * below IOV_MAX on all supported platforms.
+ */
+static constexpr size_t SEND_MANY_MAX_BUFFERS{64};
+
+class SockWaitSet;
+
 /**
  * RAII helper class that manages a socket and closes it automatically when it goes out of scope.
  */
@@ -64,6 +74,14 @@ public:
      */
     [[nodiscard]] virtual ssize_t Send(const void* data, size_t len, int flags) const;
 
+    /**
+     * sendmsg(2) wrapper, sending the concatenation of the given buffers in a single call, like
+     * writev(2). Only the first SEND_MANY_MAX_BUFFERS buffers are used, and on platforms without
+     * sendmsg(2) only the first one; callers must handle partial sends anyway. Code that uses
+     * this wrapper can be unit tested if this method is overridden by a mock Sock implementation.
+     */
+    [[nodiscard]] virtual ssize_t SendMany(std::span<const std::span<const uint8_t>> data, int flags) const;
+
     /**
      * recv(2) wrapper. Equivalent to `recv(m_socket, buf, len, flags);`. Code that uses this
      * wrapper can be unit tested if this method is overridden by a mock Sock implementation.
@@ -218,6 +236,13 @@ public:
     [[nodiscard]] virtual bool WaitMany(std::chrono::milliseconds timeout,
                                         EventsPerSock& events_per_sock) const;
 
+    /**
+     * Create a set of sockets to wait on repeatedly, for sockets of the same kind as this one.
+     * Where supported (epoll(7) on Linux), the sockets stay registered with the kernel between
+     * waits, instead of all of them being passed on every wait as `WaitMany()` does.
+     */
+    [[nodiscard]] virtual std::unique_ptr<SockWaitSet> CreateWaitSet() const;
+
     /* Higher level, convenience, methods. These may throw. */
 
     /**
@@ -275,12 +300,44 @@ protected:
     SOCKET m_socket;
 
 private:
+    friend class EpollSockWaitSet;
+
     /**
      * Close `m_socket` if it is not `INVALID_SOCKET`.
      */
     void Close();
 };
 
+/**
+ * Sockets to wait on repeatedly, as in an event loop. Before each `Wait()`, every socket to wait
+ * on is added with the events requested for it. Sockets not added again are no longer waited on.
+ * This implementation passes all sockets to `Sock::WaitMany()` of one of them, so it works for any
+ * `Sock`, including mocked ones.
+ */
+class SockWaitSet
+{
+public:
+    virtual ~SockWaitSet() = default;
+
+    /**
+     * Wait for the requested events on `sock` in the next `Wait()`, replacing any events requested
+     * for it before. The socket is kept open until it is no longer waited on.
+     */
+    virtual void Add(const std::shared_ptr<const Sock>& sock, Sock::Event requested);
+
+    /**
+     * Wait for the events requested since the previous call.
+     * @param[in] timeout Wait this long for at least one of the requested events to occur.
+     * @param[out] events_per_sock The sockets on which events occurred, with `occurred` set. May
+     * also contain sockets on which no event occurred.
+     * @return true on success (or timeout), false if no socket was added or waiting failed
+     */
+    [[nodiscard]] virtual bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock);
+
+private:
+    Sock::EventsPerSock m_requested;
+};
+
 /** Return readable error string for a network error code */
 std::string NetworkErrorString(int err);
 
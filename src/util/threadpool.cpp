@@ -0,0 +1,68 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <util/threadpool.h>
+
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/thread.h>
+
+namespace util {
+
+ThreadPool::ThreadPool(std::string name) : m_name{std::move(name)} {}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+void ThreadPool::Start(int num_workers)
+{
+    LOCK(m_mutex);
+    Assume(m_workers.empty());
+    m_stopping = false;
+    for (int i{0}; i < num_workers; ++i) {
+        m_workers.emplace_back(&util::TraceThread, strprintf("%s.%i", m_name, i), [this] { WorkerThread(); });
+    }
+}
+
+void ThreadPool::Stop()
+{
+    std::vector<std::thread> workers;
+    {
+        LOCK(m_mutex);
+        m_stopping = true;
+        workers.swap(m_workers);
+    }
+    m_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::WorkQueueSize() const
+{
+    return WITH_LOCK(m_mutex, return m_work_queue.size());
+}
+
+size_t ThreadPool::WorkersCount() const
+{
+    return WITH_LOCK(m_mutex, return m_workers.size());
+}
+
+void ThreadPool::WorkerThread()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (true) {
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stopping || !m_work_queue.empty(); });
+        // Only exit once all submitted tasks were run.
+        if (m_work_queue.empty()) return;
+        auto task{std::move(m_work_queue.front())};
+        m_work_queue.pop();
+        REVERSE_LOCK(lock, m_mutex);
+        task();
+    }
+}
+
+} // namespace util
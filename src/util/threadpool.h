@@ -0,0 +1,86 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#ifndef BITCOIN_UTIL_THREADPOOL_H
+#define BITCOIN_UTIL_THREADPOOL_H
+
+#include <sync.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/**
+ * A fixed number of worker threads running submitted tasks in the order they
+ * were submitted. Tasks submitted before Stop() are all run before it returns,
+ * so callers can wait on the futures of their tasks without further
+ * coordination.
+ */
+class ThreadPool
+{
+public:
+    /** @param[in] name Prefix of the names of the worker threads. */
+    explicit ThreadPool(std::string name);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Start the worker threads. Must not be called while they are running. */
+    void Start(int num_workers) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Run the remaining tasks and join the worker threads. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Queue a task to be run by a worker thread.
+     *
+     * @returns the future result of the task.
+     * @throws std::runtime_error if the worker threads are not running.
+     */
+    template <typename F>
+    [[nodiscard]] std::future<std::invoke_result_t<F>> Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        // std::function must be copyable, std::packaged_task is not.
+        auto task{std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(fn))};
+        auto future{task->get_future()};
+        {
+            LOCK(m_mutex);
+            if (m_workers.empty() || m_stopping) throw std::runtime_error("Thread pool " + m_name + " is not running");
+            m_work_queue.emplace([task] { (*task)(); });
+        }
+        m_cv.notify_one();
+        return future;
+    }
+
+    /** Number of tasks not yet picked up by a worker thread. */
+    size_t WorkQueueSize() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Number of worker threads. */
+    size_t WorkersCount() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    const std::string m_name;
+    mutable Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<std::function<void()>> m_work_queue GUARDED_BY(m_mutex);
+    std::vector<std::thread> m_workers GUARDED_BY(m_mutex);
+    bool m_stopping GUARDED_BY(m_mutex){false};
+};
+
+} // namespace util
+
+#endif // BITCOIN_UTIL_THREADPOOL_H
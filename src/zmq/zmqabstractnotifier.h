@@ -9,10 +9,13 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 
 class CBlockIndex;
 class CTransaction;
 class CZMQAbstractNotifier;
+class CZMQPublisher;
+class CZMQReplayBuffer;
 
 using CZMQNotifierFactory = std::function<std::unique_ptr<CZMQAbstractNotifier>()>;
 
@@ -40,6 +43,9 @@ public:
             outbound_message_high_water_mark = sndhwm;
         }
     }
+    void SetPublisher(CZMQPublisher* p) { publisher = p; }
+    std::shared_ptr<CZMQReplayBuffer> GetReplayBuffer() const { return replay_buffer; }
+    void SetReplayBuffer(std::shared_ptr<CZMQReplayBuffer> b) { replay_buffer = std::move(b); }
 
     virtual bool Initialize(void *pcontext) = 0;
     virtual void Shutdown() = 0;
@@ -62,6 +68,8 @@ protected:
     std::string type;
     std::string address;
     int outbound_message_high_water_mark; // aka SNDHWM
+    CZMQPublisher* publisher{nullptr}; //!< sends the messages, if set
+    std::shared_ptr<CZMQReplayBuffer> replay_buffer; //!< recent messages, if replay is enabled
 };
 
 #endif // BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
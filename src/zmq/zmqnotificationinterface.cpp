@@ -5,25 +5,37 @@
 #include <zmq/zmqnotificationinterface.h>
 
 #include <common/args.h>
+#include <crypto/common.h>
 #include <kernel/chain.h>
 #include <kernel/mempool_entry.h>
 #include <logging.h>
 #include <netbase.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <util/thread.h>
 #include <validationinterface.h>
 #include <zmq/zmqabstractnotifier.h>
+#include <zmq/zmqpublisher.h>
 #include <zmq/zmqpublishnotifier.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
 #include <map>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+//! How often, and how far apart, binding a new replay socket is tried after
+//! the old one failed
+static constexpr int REPLAY_REBIND_ATTEMPTS{10};
+static constexpr std::chrono::milliseconds REPLAY_REBIND_DELAY{100};
+
 CZMQNotificationInterface::CZMQNotificationInterface() = default;
 
 CZMQNotificationInterface::~CZMQNotificationInterface()
@@ -51,6 +63,12 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubsequence"] = CZMQAbstractNotifier::Create<CZMQPublishSequenceNotifier>;
 
+    std::string replay_address{gArgs.GetArg("-zmqreplay", "")};
+    if (replay_address.starts_with(ADDR_PREFIX_UNIX)) {
+        replay_address.replace(0, ADDR_PREFIX_UNIX.length(), ADDR_PREFIX_IPC);
+    }
+    const size_t replay_size{static_cast<size_t>(std::max<int64_t>(gArgs.GetIntArg("-zmqreplaysize", DEFAULT_ZMQ_REPLAY_SIZE), 0)) << 20};
+
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
     for (const auto& entry : factories)
     {
@@ -66,6 +84,9 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
             notifier->SetType(entry.first);
             notifier->SetAddress(address);
             notifier->SetOutboundMessageHighWaterMark(static_cast<int>(gArgs.GetIntArg(arg + "hwm", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM)));
+            if (!replay_address.empty()) {
+                notifier->SetReplayBuffer(std::make_shared<CZMQReplayBuffer>(replay_size));
+            }
             notifiers.push_back(std::move(notifier));
         }
     }
@@ -74,6 +95,14 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
     {
         std::unique_ptr<CZMQNotificationInterface> notificationInterface(new CZMQNotificationInterface());
         notificationInterface->notifiers = std::move(notifiers);
+        notificationInterface->m_replay_address = std::move(replay_address);
+        for (auto& notifier : notificationInterface->notifiers) {
+            notifier->SetPublisher(&notificationInterface->m_publisher);
+            // The topic is the type without the "pub" prefix
+            if (auto replay_buffer{notifier->GetReplayBuffer()}) {
+                notificationInterface->m_replay_buffers.emplace(notifier->GetType().substr(3), std::move(replay_buffer));
+            }
+        }
 
         if (notificationInterface->Initialize()) {
             return notificationInterface;
@@ -110,6 +139,14 @@ bool CZMQNotificationInterface::Initialize()
         }
     }
 
+    if (!m_replay_address.empty()) {
+        if (!BindReplaySocket()) return false;
+        LogDebug(BCLog::ZMQ, "Replay ready (address = %s)\n", m_replay_address);
+        m_replay_thread = std::thread(&util::TraceThread, "zmqreplay", [this] { ThreadReplay(); });
+    }
+
+    m_publisher.Start();
+
     return true;
 }
 
@@ -123,12 +160,138 @@ void CZMQNotificationInterface::Shutdown()
             LogDebug(BCLog::ZMQ, "Shutdown notifier %s at %s\n", notifier->GetType(), notifier->GetAddress());
             notifier->Shutdown();
         }
+        // Send what is still queued and close the notifiers' sockets
+        m_publisher.Stop();
+        if (m_replay_thread.joinable()) {
+            // Makes the replay thread's blocking receive fail, so it closes its socket
+            zmq_ctx_shutdown(pcontext);
+            m_replay_thread.join();
+        } else if (m_replay_socket) {
+            zmq_close(m_replay_socket);
+        }
+        m_replay_socket = nullptr;
         zmq_ctx_term(pcontext);
 
         pcontext = nullptr;
     }
 }
 
+bool CZMQNotificationInterface::BindReplaySocket()
+{
+    m_replay_socket = zmq_socket(pcontext, ZMQ_REP);
+    if (!m_replay_socket) {
+        zmqError("Failed to create replay socket");
+        return false;
+    }
+    const int enable_ipv6{IsZMQAddressIPV6(m_replay_address) ? 1 : 0};
+    if (zmq_setsockopt(m_replay_socket, ZMQ_IPV6, &enable_ipv6, sizeof(enable_ipv6)) != 0 ||
+        zmq_bind(m_replay_socket, m_replay_address.c_str()) != 0) {
+        zmqError("Failed to bind replay address");
+        zmq_close(m_replay_socket);
+        m_replay_socket = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CZMQNotificationInterface::CloseReplaySocket()
+{
+    int linger = 0;
+    zmq_setsockopt(m_replay_socket, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_close(m_replay_socket);
+    m_replay_socket = nullptr;
+}
+
+bool CZMQNotificationInterface::SendReplay(const std::vector<CZMQMessageRef>& messages)
+{
+    const auto send{[&](const void* data, size_t size, int flags) {
+        while (zmq_send(m_replay_socket, data, size, flags) == -1) {
+            if (errno != EINTR) return false;
+        }
+        return true;
+    }};
+    // The reply consists of the messages as they were published, or of a
+    // single empty part if there are none.
+    if (messages.empty()) return send(nullptr, 0, 0);
+    for (size_t i{0}; i < messages.size(); ++i) {
+        const CZMQMessage& message{*messages[i]};
+        unsigned char msgseq[sizeof(uint32_t)];
+        WriteLE32(msgseq, message.sequence);
+        if (!send(message.topic.data(), message.topic.size(), ZMQ_SNDMORE) ||
+            !send(message.body.data(), message.body.size(), ZMQ_SNDMORE) ||
+            !send(msgseq, sizeof(msgseq), i + 1 < messages.size() ? ZMQ_SNDMORE : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CZMQNotificationInterface::ThreadReplay()
+{
+    while (true) {
+        // A request consists of a topic and the 4-byte LE sequence number of
+        // the first message to replay.
+        std::vector<std::string> request;
+        bool failed{false};
+        int more{0};
+        do {
+            zmq_msg_t part;
+            zmq_msg_init(&part);
+            if (zmq_msg_recv(&part, m_replay_socket, 0) == -1) {
+                zmq_msg_close(&part);
+                if (errno == EINTR) {
+                    more = 1;
+                    continue;
+                }
+                if (errno == ETERM) {
+                    CloseReplaySocket();
+                    return;
+                }
+                zmqError("Unable to receive replay request");
+                failed = true;
+                break;
+            }
+            request.emplace_back(static_cast<const char*>(zmq_msg_data(&part)), zmq_msg_size(&part));
+            more = zmq_msg_more(&part);
+            zmq_msg_close(&part);
+        } while (more);
+
+        if (!failed) {
+            // Invalid requests are answered with no messages.
+            std::vector<CZMQMessageRef> messages;
+            if (request.size() == 2 && request[1].size() == sizeof(uint32_t)) {
+                const auto it{m_replay_buffers.find(request[0])};
+                if (it != m_replay_buffers.end()) {
+                    messages = it->second->GetFrom(ReadLE32(reinterpret_cast<const unsigned char*>(request[1].data())));
+                }
+            }
+            LogDebug(BCLog::ZMQ, "Replay %d messages of %s\n", messages.size(), request.empty() ? "" : request[0]);
+            if (!SendReplay(messages)) {
+                if (errno == ETERM) {
+                    CloseReplaySocket();
+                    return;
+                }
+                zmqError("Unable to send replay");
+                failed = true;
+            }
+        }
+        if (!failed) continue;
+
+        // A REP socket that failed partway through a request or a reply
+        // rejects everything after it, so start over with a new one. The
+        // address may take a moment to be released by the old one.
+        CloseReplaySocket();
+        for (int attempt{1}; !BindReplaySocket(); ++attempt) {
+            if (errno == ETERM) return;
+            if (attempt == REPLAY_REBIND_ATTEMPTS) {
+                LogPrintf("Unable to recreate the ZMQ replay socket at %s, replay disabled\n", m_replay_address);
+                return;
+            }
+            std::this_thread::sleep_for(REPLAY_REBIND_DELAY);
+        }
+    }
+}
+
 namespace {
 
 template <typename Function>
@@ -7,11 +7,15 @@
 
 #include <primitives/transaction.h>
 #include <validationinterface.h>
+#include <zmq/zmqpublisher.h>
 
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 class CBlock;
@@ -42,8 +46,25 @@ protected:
 private:
     CZMQNotificationInterface();
 
+    /** Answer replay requests on the replay socket until the context is shut down. */
+    void ThreadReplay();
+    /** Create the replay socket and bind it to the replay address. */
+    bool BindReplaySocket();
+    /** Close the replay socket, dropping requests and replies in flight. */
+    void CloseReplaySocket();
+    /** Send a reply on the replay socket, retrying parts that were interrupted. */
+    bool SendReplay(const std::vector<CZMQMessageRef>& messages);
+
     void* pcontext{nullptr};
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
+    CZMQPublisher m_publisher;
+
+    //! Address of the replay socket, if replay is enabled
+    std::string m_replay_address;
+    void* m_replay_socket{nullptr};
+    //! Replay buffer of the first notifier of every topic
+    std::map<std::string, std::shared_ptr<CZMQReplayBuffer>> m_replay_buffers;
+    std::thread m_replay_thread;
 };
 
 extern std::unique_ptr<CZMQNotificationInterface> g_zmq_notification_interface;
@@ -0,0 +1,156 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <zmq/zmqpublisher.h>
+
+#include <crypto/common.h>
+#include <logging.h>
+#include <util/thread.h>
+#include <zmq/zmqutil.h>
+
+#include <zmq.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+void CZMQReplayBuffer::Add(CZMQMessageRef message)
+{
+    LOCK(m_mutex);
+    m_size += message->Size();
+    m_messages.push_back(std::move(message));
+    while (m_size > m_max_size && !m_messages.empty()) {
+        m_size -= m_messages.front()->Size();
+        m_messages.pop_front();
+    }
+}
+
+std::vector<CZMQMessageRef> CZMQReplayBuffer::GetFrom(uint32_t sequence) const
+{
+    LOCK(m_mutex);
+    if (m_messages.empty()) return {};
+    // Sequence numbers are consecutive, so the requested message can be found
+    // by its offset from the oldest one. The subtraction also copes with the
+    // sequence number having wrapped around.
+    const uint32_t offset{sequence - m_messages.front()->sequence};
+    const uint32_t newer{m_messages.back()->sequence - sequence};
+    size_t start{0};
+    if (offset < m_messages.size()) {
+        start = offset;
+    } else if (newer < (uint32_t{1} << 31)) {
+        // Dropped already, return everything that is still kept
+        start = 0;
+    } else {
+        // Not published yet
+        return {};
+    }
+    return {m_messages.begin() + start, m_messages.end()};
+}
+
+CZMQPublisher::~CZMQPublisher()
+{
+    Stop();
+}
+
+void CZMQPublisher::Start()
+{
+    LOCK(m_mutex);
+    assert(!m_running);
+    m_running = true;
+    m_stop = false;
+    m_thread = std::thread(&util::TraceThread, "zmqpub", [this] { ThreadPublish(); });
+}
+
+void CZMQPublisher::Stop()
+{
+    {
+        LOCK(m_mutex);
+        if (!m_running) return;
+        m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+}
+
+void CZMQPublisher::Send(void* socket, CZMQMessageRef message)
+{
+    Push({socket, std::move(message)});
+}
+
+void CZMQPublisher::Close(void* socket)
+{
+    Push({socket, nullptr});
+}
+
+bool CZMQPublisher::TakeSendFailure(void* socket)
+{
+    LOCK(m_mutex);
+    return m_failed.erase(socket) > 0;
+}
+
+/** Send a message, or close the socket if there is none. Returns false if sending failed. */
+static bool SendItem(void* socket, const CZMQMessage* message)
+{
+    if (!message) {
+        int linger = 0;
+        zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+        zmq_close(socket);
+        return true;
+    }
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(msgseq, message->sequence);
+    if (zmq_send(socket, message->topic.data(), message->topic.size(), ZMQ_SNDMORE) == -1 ||
+        zmq_send(socket, message->body.data(), message->body.size(), ZMQ_SNDMORE) == -1 ||
+        zmq_send(socket, msgseq, sizeof(msgseq), 0) == -1) {
+        zmqError("Unable to send ZMQ msg");
+        return false;
+    }
+    return true;
+}
+
+void CZMQPublisher::Push(Item item)
+{
+    {
+        LOCK(m_mutex);
+        if (m_running) {
+            m_queue.push_back(std::move(item));
+            // Only the first item of a batch needs to wake up the thread
+            if (m_queue.size() > 1) return;
+        } else {
+            // Not started or stopped already, so the sockets are ours to use
+            if (!SendItem(item.socket, item.message.get())) m_failed.insert(item.socket);
+            if (!item.message) m_failed.erase(item.socket);
+            return;
+        }
+    }
+    m_cond.notify_one();
+}
+
+void CZMQPublisher::ThreadPublish()
+{
+    std::vector<Item> batch;
+    std::vector<void*> failed;
+    while (true) {
+        {
+            WAIT_LOCK(m_mutex, lock);
+            for (void* socket : failed) m_failed.insert(socket);
+            for (const Item& item : batch) {
+                if (!item.message) m_failed.erase(item.socket);
+            }
+            batch.clear();
+            failed.clear();
+            m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                // Items pushed from now on are sent by the pushing thread.
+                m_running = false;
+                return;
+            }
+            std::swap(batch, m_queue);
+        }
+        LogDebug(BCLog::ZMQ, "Send batch of %d messages\n", batch.size());
+        for (const Item& item : batch) {
+            if (!SendItem(item.socket, item.message.get())) failed.push_back(item.socket);
+        }
+    }
+}
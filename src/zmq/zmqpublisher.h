@@ -0,0 +1,113 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#ifndef BITCOIN_ZMQ_ZMQPUBLISHER_H
+#define BITCOIN_ZMQ_ZMQPUBLISHER_H
+
+#include <sync.h>
+#include <threadsafety.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Default for -zmqreplaysize, in MiB
+static constexpr int64_t DEFAULT_ZMQ_REPLAY_SIZE{4};
+
+/** A message of a publish notifier: topic, body and message sequence number. */
+struct CZMQMessage {
+    std::string topic;
+    std::vector<unsigned char> body;
+    uint32_t sequence;
+
+    size_t Size() const { return topic.size() + body.size() + sizeof(sequence); }
+};
+
+using CZMQMessageRef = std::shared_ptr<const CZMQMessage>;
+
+/**
+ * The most recent messages of a publish notifier, kept so that subscribers that
+ * missed some of them, e.g. because the high water mark was hit, can ask for
+ * them again instead of having to fall back to polling over RPC. The oldest
+ * messages are dropped to keep the total size within the limit.
+ */
+class CZMQReplayBuffer
+{
+public:
+    explicit CZMQReplayBuffer(size_t max_size) : m_max_size{max_size} {}
+
+    void Add(CZMQMessageRef message) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Get the messages from sequence number @p sequence on, oldest first. If
+     * that one was dropped already, they start at the oldest one still kept.
+     */
+    std::vector<CZMQMessageRef> GetFrom(uint32_t sequence) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const size_t m_max_size;
+
+    mutable Mutex m_mutex;
+    std::deque<CZMQMessageRef> m_messages GUARDED_BY(m_mutex);
+    size_t m_size GUARDED_BY(m_mutex){0};
+};
+
+/**
+ * Sends the messages of the publish notifiers from a background thread, so
+ * that the validation interface callbacks only have to queue them. Every
+ * wakeup sends everything that was queued in the meantime as one batch, in the
+ * order the messages were queued.
+ *
+ * ZMQ sockets must not be used from more than one thread at a time, so once
+ * the publisher was started, the sockets it sends to are only used and closed
+ * from its thread.
+ */
+class CZMQPublisher
+{
+public:
+    ~CZMQPublisher();
+
+    void Start() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Send everything that is still queued, close the sockets and stop the thread. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void Send(void* socket, CZMQMessageRef message) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Close a socket once the messages queued for it were sent. */
+    void Close(void* socket) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /**
+     * Whether sending a message to @p socket failed since the last call. As
+     * messages are sent in the background, this is how the notifiers find out
+     * about failures.
+     */
+    bool TakeSendFailure(void* socket) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Item {
+        void* socket;
+        //! Message to send, or nullptr to close the socket
+        CZMQMessageRef message;
+    };
+
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector<Item> m_queue GUARDED_BY(m_mutex);
+    //! Sockets that sending to failed, see TakeSendFailure()
+    std::set<void*> m_failed GUARDED_BY(m_mutex);
+    //! Whether the thread is running. It is the last thing the thread clears,
+    //! so that items pushed after it returned are handled right away.
+    bool m_running GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread;
+
+    void Push(Item item) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void ThreadPublish() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+#endif // BITCOIN_ZMQ_ZMQPUBLISHER_H
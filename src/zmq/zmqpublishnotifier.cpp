@@ -9,8 +9,6 @@
 #include <crypto/common.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
-#include <netaddress.h>
-#include <netbase.h>
 #include <node/blockstorage.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -19,16 +17,16 @@
 #include <streams.h>
 #include <sync.h>
 #include <uint256.h>
+#include <zmq/zmqpublisher.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
 
 #include <cassert>
-#include <cstdarg>
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -46,62 +44,6 @@ static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
 
-// Internal function to send multipart message
-static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
-{
-    va_list args;
-    va_start(args, size);
-
-    while (1)
-    {
-        zmq_msg_t msg;
-
-        int rc = zmq_msg_init_size(&msg, size);
-        if (rc != 0)
-        {
-            zmqError("Unable to initialize ZMQ msg");
-            va_end(args);
-            return -1;
-        }
-
-        void *buf = zmq_msg_data(&msg);
-        memcpy(buf, data, size);
-
-        data = va_arg(args, const void*);
-
-        rc = zmq_msg_send(&msg, sock, data ? ZMQ_SNDMORE : 0);
-        if (rc == -1)
-        {
-            zmqError("Unable to send ZMQ msg");
-            zmq_msg_close(&msg);
-            va_end(args);
-            return -1;
-        }
-
-        zmq_msg_close(&msg);
-
-        if (!data)
-            break;
-
-        size = va_arg(args, size_t);
-    }
-    va_end(args);
-    return 0;
-}
-
-static bool IsZMQAddressIPV6(const std::string &zmq_address)
-{
-    const std::string tcp_prefix = "tcp://";
-    const size_t tcp_index = zmq_address.rfind(tcp_prefix);
-    const size_t colon_index = zmq_address.rfind(':');
-    if (tcp_index == 0 && colon_index != std::string::npos) {
-        const std::string ip = zmq_address.substr(tcp_prefix.length(), colon_index - tcp_prefix.length());
-        const std::optional<CNetAddr> addr{LookupHost(ip, false)};
-        if (addr.has_value() && addr.value().IsIPv6()) return true;
-    }
-    return false;
-}
-
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 {
     assert(!psocket);
@@ -192,9 +134,7 @@ void CZMQAbstractPublishNotifier::Shutdown()
     if (count == 1)
     {
         LogDebug(BCLog::ZMQ, "Close socket at address %s\n", address);
-        int linger = 0;
-        zmq_setsockopt(psocket, ZMQ_LINGER, &linger, sizeof(linger));
-        zmq_close(psocket);
+        publisher->Close(psocket);
     }
 
     psocket = nullptr;
@@ -203,15 +143,22 @@ void CZMQAbstractPublishNotifier::Shutdown()
 bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size)
 {
     assert(psocket);
-
-    /* send three parts, command & data & a LE 4byte sequence number */
-    unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(msgseq, nSequence);
-    int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
-    if (rc == -1)
-        return false;
-
-    /* increment memory only sequence number after sending */
+    assert(publisher);
+
+    // Messages are sent in the background, so a failure to send an earlier
+    // one is reported here, to have the notifier shut down.
+    if (publisher->TakeSendFailure(psocket)) return false;
+
+    const unsigned char* begin{static_cast<const unsigned char*>(data)};
+    auto message{std::make_shared<const CZMQMessage>(CZMQMessage{
+        .topic = command,
+        .body = {begin, begin + size},
+        .sequence = nSequence,
+    })};
+    if (replay_buffer) replay_buffer->Add(message);
+    publisher->Send(psocket, std::move(message));
+
+    /* increment memory only sequence number after queueing */
     nSequence++;
 
     return true;
@@ -22,7 +22,7 @@ private:
 
 public:
 
-    /* send zmq multipart message
+    /* queue zmq multipart message for the publisher, and keep it for replay
        parts:
           * command
           * data
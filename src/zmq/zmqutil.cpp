@@ -5,12 +5,28 @@
 #include <zmq/zmqutil.h>
 
 #include <logging.h>
+#include <netaddress.h>
+#include <netbase.h>
 #include <zmq.h>
 
 #include <cerrno>
+#include <optional>
 #include <string>
 
 void zmqError(const std::string& str)
 {
     LogDebug(BCLog::ZMQ, "Error: %s, msg: %s\n", str, zmq_strerror(errno));
 }
+
+bool IsZMQAddressIPV6(const std::string &zmq_address)
+{
+    const std::string tcp_prefix = "tcp://";
+    const size_t tcp_index = zmq_address.rfind(tcp_prefix);
+    const size_t colon_index = zmq_address.rfind(':');
+    if (tcp_index == 0 && colon_index != std::string::npos) {
+        const std::string ip = zmq_address.substr(tcp_prefix.length(), colon_index - tcp_prefix.length());
+        const std::optional<CNetAddr> addr{LookupHost(ip, false)};
+        if (addr.has_value() && addr.value().IsIPv6()) return true;
+    }
+    return false;
+}
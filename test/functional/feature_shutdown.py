@@ -23,9 +23,9 @@ class ShutdownTest(BitcoinTestFramework):
         node = get_rpc_proxy(self.nodes[0].url, 1, timeout=600, coveragedir=self.nodes[0].coverage_dir)
         # Force connection establishment by executing a dummy command.
         node.getblockcount()
-        Thread(target=test_long_call, args=(node,)).start()
-        # Wait until the server is executing the above `waitfornewblock`.
-        self.wait_until(lambda: len(self.nodes[0].getrpcinfo()['active_commands']) == 2)
+        # Wait until the server parked the `waitfornewblock` below.
+        with self.nodes[0].busy_wait_for_debug_log([b"Parking waitfornewblock request"]):
+            Thread(target=test_long_call, args=(node,)).start()
         # Wait 1 second after requesting shutdown but not before the `stop` call
         # finishes. This is to ensure event loop waits for current connections
         # to close.
@@ -6,8 +6,12 @@
 
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import assert_equal, str_to_b64str
+from test_framework.wallet import MiniWallet
 
+from decimal import Decimal
 import http.client
+import json
+import socket
 import time
 import urllib.parse
 
@@ -179,6 +183,44 @@ class HTTPBasicsTest (BitcoinTestFramework):
         assert_equal(out1, b'{"result":"high-hash","error":null}\n')
 
 
+        self.log.info("Check large results are sent in chunks as they are produced")
+        # A verbose block with a transaction of many outputs is larger than
+        # a chunk of the reply.
+        wallet = MiniWallet(self.nodes[2])
+        wallet.send_self_transfer_multi(from_node=self.nodes[2], num_outputs=1000)
+        blockhash = self.generate(self.nodes[2], 1, sync_fun=self.no_op)[0]
+        block = self.nodes[2].getblock(blockhash, 2)
+        assert_equal(len(block["tx"][1]["vout"]), 1000)
+        body = json.dumps({"method": "getblock", "params": [blockhash, 2], "id": 1})
+        conn = http.client.HTTPConnection(urlNode2.hostname, urlNode2.port)
+        conn.connect()
+        conn.request('POST', '/', body, headers)
+        out1 = conn.getresponse()
+        assert_equal(out1.status, http.client.OK)
+        assert_equal(out1.getheader('Transfer-Encoding'), 'chunked')
+        assert_equal(out1.getheader('Content-Type'), 'application/json')
+        reply = json.loads(out1.read(), parse_float=Decimal)
+        assert_equal(reply, {"result": block, "error": None, "id": 1})
+        # The connection stays usable after a chunked reply.
+        conn.request('POST', '/', '{"method": "getblockcount"}', headers)
+        assert b'"error":null' in conn.getresponse().read()
+        conn.close()
+
+        # HTTP/1.0 clients get the reply without chunked encoding, ended by
+        # the connection closing.
+        sock = socket.create_connection((urlNode2.hostname, urlNode2.port))
+        sock.sendall((f"POST / HTTP/1.0\r\nAuthorization: Basic {str_to_b64str(authpair)}\r\n"
+                      f"Content-Length: {len(body)}\r\n\r\n{body}").encode())
+        res = b""
+        while chunk := sock.recv(65536):
+            res += chunk
+        sock.close()
+        head, _, payload = res.partition(b"\r\n\r\n")
+        assert head.startswith(b"HTTP/1.0 200")
+        assert b"chunked" not in head.lower()
+        assert_equal(json.loads(payload, parse_float=Decimal), {"result": block, "error": None, "id": 1})
+
+
         self.log.info("Check -rpcservertimeout")
         # The test framework typically reuses a single persistent HTTP connection
         # for all RPCs to a TestNode. Because we are setting -rpcservertimeout
@@ -53,7 +53,7 @@ def filter_output_indices_by_value(vouts, value):
 class RESTTest (BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 2
-        self.extra_args = [["-rest", "-blockfilterindex=1"], []]
+        self.extra_args = [["-rest", "-blockfilterindex=1"], ["-responsecache=0"]]
         # whitelist peers to speed up tx relay / mempool sync
         self.noban_tx_relay = True
         self.supports_cli = False
@@ -455,6 +455,31 @@ class RESTTest (BitcoinTestFramework):
                 expected = [(p["scriptPubKey"], p["value"]) for p in prevouts]
                 assert_equal(expected, actual)
 
+        self.log.info("Test the /blocks and /spenttxouts range URIs")
+
+        blockhashes = [self.nodes[0].getblockhash(height) for height in range(0, block_count + 1)]
+        blocks_bin = [self.test_rest_request(f"/block/{h}", req_type=ReqType.BIN, ret_type=RetType.BYTES) for h in blockhashes]
+        spent_bin = [self.test_rest_request(f"/spenttxouts/{h}", req_type=ReqType.BIN, ret_type=RetType.BYTES) for h in blockhashes]
+        for start, count in [(0, 1), (0, 10), (150, 50), (block_count, 1)]:
+            assert_equal(self.test_rest_request(f"/blocks/{start}/{count}", req_type=ReqType.BIN, ret_type=RetType.BYTES), b"".join(blocks_bin[start:start + count]))
+            assert_equal(self.test_rest_request(f"/blocks/{start}/{count}", req_type=ReqType.HEX, ret_type=RetType.BYTES).decode().split(), [b.hex() for b in blocks_bin[start:start + count]])
+            assert_equal(self.test_rest_request(f"/spenttxouts/{start}/{count}", req_type=ReqType.BIN, ret_type=RetType.BYTES), b"".join(spent_bin[start:start + count]))
+            assert_equal(self.test_rest_request(f"/spenttxouts/{start}/{count}", req_type=ReqType.HEX, ret_type=RetType.BYTES).decode().split(), [b.hex() for b in spent_bin[start:start + count]])
+        # The range is cut at the tip
+        assert_equal(self.test_rest_request(f"/blocks/{block_count - 2}/1000", req_type=ReqType.BIN, ret_type=RetType.BYTES), b"".join(blocks_bin[-3:]))
+        assert_equal(self.test_rest_request(f"/spenttxouts/{block_count - 2}/1000", req_type=ReqType.BIN, ret_type=RetType.BYTES), b"".join(spent_bin[-3:]))
+
+        # Check invalid range requests
+        resp = self.test_rest_request(f"/blocks/{block_count + 1}/1", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block height out of range")
+        resp = self.test_rest_request(f"/blocks/{INVALID_PARAM}/1", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), f"Invalid height: {INVALID_PARAM}")
+        for num in ['5a', '-5', '0', '1001']:
+            resp = self.test_rest_request(f"/spenttxouts/0/{num}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+            assert_equal(resp.read().decode('utf-8').rstrip(), f"Block count is invalid or out of acceptable range (1-1000): {num}")
+        resp = self.test_rest_request("/blocks/0/1", req_type=ReqType.JSON, ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "output format not found (available: .bin, .hex)")
+        self.test_rest_request("/blocks/0", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
 
         self.log.info("Test the /deploymentinfo URI")
 
@@ -472,5 +497,98 @@ class RESTTest (BitcoinTestFramework):
         resp = self.test_rest_request(f"/deploymentinfo/{INVALID_PARAM}", ret_type=RetType.OBJ, status=400)
         assert_equal(resp.read().decode('utf-8').rstrip(), f"Invalid hash: {INVALID_PARAM}")
 
+        self.test_response_cache()
+        self.test_events()
+
+    def test_response_cache(self):
+        self.log.info("Test the response cache")
+        node = self.nodes[0]
+        assert "response_cache" not in self.nodes[1].getrpcinfo()
+
+        def cache_stats():
+            return node.getrpcinfo()["response_cache"]
+
+        def check_cached(request):
+            """Check that a second request is replied to from the cache, with the same response."""
+            response = request()
+            hits = cache_stats()["hits"]
+            assert_equal(request(), response)
+            assert_equal(cache_stats()["hits"], hits + 1)
+            return response
+
+        blockhash = node.getbestblockhash()
+        block_json = check_cached(lambda: self.test_rest_request(f"/block/{blockhash}"))
+        block_rpc = check_cached(lambda: node.getblock(blockhash, 2))
+        check_cached(lambda: node.getblock(blockhash, 1))
+        check_cached(lambda: self.test_rest_request(f"/blockfilter/basic/{blockhash}"))
+        check_cached(lambda: self.test_rest_request(f"/headers/{blockhash}", req_type=ReqType.JSON))
+        block_stats = check_cached(lambda: node.getblockstats(blockhash, ["height", "txs"]))
+        hits = cache_stats()["hits"]
+        assert_equal(node.getblockstats(node.getblockcount(), ["txs", "height"]), block_stats)
+        assert_equal(cache_stats()["hits"], hits + 1)
+        stats = cache_stats()
+        assert_greater_than(stats["entries"], 0)
+        assert_greater_than_or_equal(stats["max_size"], stats["size"])
+
+        self.log.info("Check that cached responses follow the tip")
+        self.generate(node, 1, sync_fun=self.no_op)
+        assert_equal(self.test_rest_request(f"/block/{blockhash}")["confirmations"], block_json["confirmations"] + 1)
+        assert_equal(node.getblock(blockhash, 2)["confirmations"], block_rpc["confirmations"] + 1)
+        tip = node.getbestblockhash()
+        node.getblock(tip)
+        node.invalidateblock(tip)
+        assert_equal(node.getblock(tip)["confirmations"], -1)
+        assert_equal(self.test_rest_request(f"/block/{blockhash}"), block_json)
+        assert_equal(node.getblock(blockhash, 2), block_rpc)
+        node.reconsiderblock(tip)
+
+    def test_events(self):
+        self.log.info("Test the /events URI")
+        node = self.nodes[0]
+        self.test_rest_request("/events", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+        self.test_rest_request("/events/foo", ret_type=RetType.OBJ, status=400)
+
+        def subscribe():
+            conn = http.client.HTTPConnection(self.url.hostname, self.url.port, timeout=60)
+            conn.request('GET', '/rest/events.json')
+            return conn.getresponse()
+
+        resp = subscribe()
+        assert_equal(resp.status, 200)
+        assert_equal(resp.getheader('Content-Type'), 'application/x-ndjson')
+
+        def next_event(event_type):
+            while True:
+                line = resp.readline()
+                # The stream does not end, and empty lines only keep it alive.
+                assert line
+                if not line.strip():
+                    continue
+                event = json.loads(line)
+                if event["type"] == event_type:
+                    return event
+
+        tx = self.wallet.send_self_transfer(from_node=node)
+        event = next_event("txadded")
+        assert_equal(event["txid"], tx["txid"])
+        assert_equal(event["wtxid"], tx["wtxid"])
+        assert_equal(event["sequence"], node.getrawmempool(mempool_sequence=True)["mempool_sequence"] - 1)
+
+        blockhash = self.generate(node, 1, sync_fun=self.no_op)[0]
+        height = node.getblockcount()
+        assert_equal(next_event("blockconnected"), {"type": "blockconnected", "hash": blockhash, "height": height})
+        node.invalidateblock(blockhash)
+        assert_equal(next_event("blockdisconnected"), {"type": "blockdisconnected", "hash": blockhash, "height": height})
+        node.reconsiderblock(blockhash)
+        assert_equal(next_event("blockconnected"), {"type": "blockconnected", "hash": blockhash, "height": height})
+
+        self.log.info("Check that the number of subscriptions is limited")
+        others = [subscribe() for _ in range(3)]
+        for other in others:
+            assert_equal(other.status, 200)
+        resp_rejected = subscribe()
+        assert_equal(resp_rejected.status, 503)
+        assert_equal(resp_rejected.read().decode('utf-8').rstrip(), "Too many event subscriptions (maximum: 4)")
+
 if __name__ == '__main__':
     RESTTest(__file__).main()
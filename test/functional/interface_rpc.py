@@ -4,14 +4,18 @@
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 """Tests some generic aspects of the RPC interface."""
 
+import http.client
 import json
 import os
+import struct
+import urllib.parse
 from dataclasses import dataclass
+from decimal import Decimal
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal, assert_greater_than_or_equal
+from test_framework.util import assert_equal, assert_greater_than, assert_greater_than_or_equal, get_rpc_proxy, str_to_b64str
 from threading import Thread
 from typing import Optional
-import subprocess
+import time
 
 
 RPC_INVALID_PARAMETER      = -8
@@ -69,6 +73,86 @@ def send_json_rpc(node, body: object) -> tuple[object, int]:
     return send_raw_rpc(node, raw)
 
 
+def cbor_head(major, arg):
+    if arg < 24:
+        return bytes([major << 5 | arg])
+    for info, size in ((24, 1), (25, 2), (26, 4), (27, 8)):
+        if arg < 1 << (8 * size):
+            return bytes([major << 5 | info]) + arg.to_bytes(size, "big")
+    raise NotImplementedError("Integer too large")
+
+
+def cbor_encode(value):
+    """Minimal CBOR encoder for the values of RPC requests."""
+    if value is None:
+        return b"\xf6"
+    if isinstance(value, bool):
+        return b"\xf5" if value else b"\xf4"
+    if isinstance(value, int):
+        return cbor_head(0, value) if value >= 0 else cbor_head(1, -1 - value)
+    if isinstance(value, Decimal):
+        sign, digits, exponent = value.as_tuple()
+        mantissa = int("".join(map(str, digits))) * (-1 if sign else 1)
+        return cbor_head(6, 4) + cbor_head(4, 2) + cbor_encode(exponent) + cbor_encode(mantissa)
+    if isinstance(value, bytes):
+        return cbor_head(2, len(value)) + value
+    if isinstance(value, str):
+        return cbor_head(3, len(value.encode())) + value.encode()
+    if isinstance(value, list):
+        return cbor_head(4, len(value)) + b"".join(cbor_encode(v) for v in value)
+    if isinstance(value, dict):
+        return cbor_head(5, len(value)) + b"".join(cbor_encode(k) + cbor_encode(v) for k, v in value.items())
+    raise NotImplementedError(f"Cannot encode {type(value)}")
+
+
+def cbor_decode(data):
+    """Minimal CBOR decoder for the values of RPC replies. Returns the value and the remaining data."""
+    major, info, data = data[0] >> 5, data[0] & 0x1f, data[1:]
+    if major == 7:
+        if info == 27:
+            return struct.unpack(">d", data[:8])[0], data[8:]
+        return {20: False, 21: True, 22: None}[info], data
+    arg = info
+    if info >= 24:
+        size = 1 << (info - 24)
+        arg, data = int.from_bytes(data[:size], "big"), data[size:]
+    if major == 0:
+        return arg, data
+    if major == 1:
+        return -1 - arg, data
+    if major == 2:
+        return data[:arg], data[arg:]
+    if major == 3:
+        return data[:arg].decode(), data[arg:]
+    if major == 4:
+        values = []
+        for _ in range(arg):
+            value, data = cbor_decode(data)
+            values.append(value)
+        return values, data
+    if major == 5:
+        values = {}
+        for _ in range(arg):
+            key, data = cbor_decode(data)
+            values[key], data = cbor_decode(data)
+        return values, data
+    assert_equal(arg, 4)  # decimal fraction
+    (exponent, mantissa), data = cbor_decode(data)
+    return Decimal(mantissa).scaleb(exponent), data
+
+
+def send_cbor_rpc(node, body: object) -> tuple[object, int]:
+    url = urllib.parse.urlparse(node.url)
+    headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}", "Content-Type": "application/cbor"}
+    conn = http.client.HTTPConnection(url.hostname, url.port)
+    conn.request("POST", "/", body if isinstance(body, bytes) else cbor_encode(body), headers)
+    response = conn.getresponse()
+    assert_equal(response.getheader("Content-Type"), "application/cbor")
+    value, rest = cbor_decode(response.read())
+    assert_equal(rest, b"")
+    return value, response.status
+
+
 def expect_http_rpc_status(expected_http_status, expected_rpc_error_code, node, method, params, version=1, notification=False):
     req = format_request(BatchOptions(version, notification), 0, {"method": method, "params": params})
     response, status = send_json_rpc(node, req)
@@ -79,13 +163,10 @@ def expect_http_rpc_status(expected_http_status, expected_rpc_error_code, node,
     assert_equal(status, expected_http_status)
 
 
-def test_work_queue_getblock(node, got_exceeded_error):
-    while not got_exceeded_error:
-        try:
-            node.cli("waitfornewblock", "500").send_cli()
-        except subprocess.CalledProcessError as e:
-            assert_equal(e.output, 'error: Server response: Work queue depth exceeded\n')
-            got_exceeded_error.append(True)
+def test_work_queue_getblock(node, results):
+    # Calls in a batch are not parked, so they keep the worker thread busy.
+    rpc = get_rpc_proxy(node.url, 0, timeout=60, coveragedir=node.coverage_dir)
+    results.append(rpc.batch([rpc.waitfornewblock.get_request(500)])[0]["result"])
 
 
 class RPCInterfaceTest(BitcoinTestFramework):
@@ -105,6 +186,20 @@ class RPCInterfaceTest(BitcoinTestFramework):
         assert_greater_than_or_equal(command['duration'], 0)
         assert_equal(info['logpath'], os.path.join(self.nodes[0].chain_path, 'debug.log'))
 
+        self.log.info("Testing getrpcinfo latency histograms...")
+        before = self.nodes[0].getrpcinfo()['commands']
+        for _ in range(3):
+            self.nodes[0].getblockcount()
+        stats = self.nodes[0].getrpcinfo()['commands']
+        # Calls are counted once they are complete.
+        assert_equal(stats['getrpcinfo']['count'], before['getrpcinfo']['count'] + 1)
+        assert_equal(stats['getblockcount']['count'], before.get('getblockcount', {'count': 0})['count'] + 3)
+        for method_stats in stats.values():
+            histogram = method_stats['histogram']
+            assert_equal(sum(bucket['count'] for bucket in histogram), method_stats['count'])
+            assert_greater_than_or_equal(method_stats['total_duration'], sum(bucket['duration'] // 2 * bucket['count'] for bucket in histogram))
+            assert all(bucket['duration'] & (bucket['duration'] - 1) == 0 for bucket in histogram)
+
     def test_batch_request(self, call_options):
         calls = [
             # A basic request that will work fine.
@@ -177,6 +272,31 @@ class RPCInterfaceTest(BitcoinTestFramework):
             request_fields={"jsonrpc": "2.1"},
             response_fields={"result": None, "error": {"code": RPC_INVALID_REQUEST, "message": "JSON-RPC version not supported"}}))
 
+    def test_concurrent_batch(self):
+        self.log.info("Testing batch requests with concurrent read-only calls...")
+        node = self.nodes[0]
+        height = node.getblockcount()
+        hashes = [node.getblockhash(h) for h in range(height + 1)]
+        # Calls that change the state of the node wait for the calls before
+        # them, and the ones after them see the change.
+        calls = [{"method": "getblockhash", "params": [i % (height + 1)]} for i in range(50)]
+        calls += [{"method": "getblockcount"}, {"method": "generatetoaddress", "params": [1, "bcrt1qqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqdku202"]}, {"method": "getblockcount"}]
+        calls += [{"method": "getblockheader", "params": [hashes[i % (height + 1)]]} for i in range(50)]
+        request = [format_request(BatchOptions(version=2), idx, call) for idx, call in enumerate(calls)]
+        response, status = send_json_rpc(node, request)
+        assert_equal(status, 200)
+        assert_equal([r["id"] for r in response], list(range(len(calls))))
+        assert_equal([r["result"] for r in response[:50]], [hashes[i % (height + 1)] for i in range(50)])
+        assert_equal(response[50]["result"], height)
+        assert_equal(response[52]["result"], height + 1)
+        assert_equal([r["result"]["hash"] for r in response[53:]], [hashes[i % (height + 1)] for i in range(50)])
+
+        self.log.info("Testing batch requests run one call at a time...")
+        self.restart_node(0, ["-rpcbatchthreads=0"])
+        response, status = send_json_rpc(node, request[:50])
+        assert_equal(status, 200)
+        assert_equal([r["result"] for r in response], [hashes[i % (height + 1)] for i in range(50)])
+
     def test_http_status_codes(self):
         self.log.info("Testing HTTP status codes for JSON-RPC 1.1 requests...")
         # OK
@@ -229,20 +349,118 @@ class RPCInterfaceTest(BitcoinTestFramework):
     def test_work_queue_exceeded(self):
         self.log.info("Testing work queue exceeded...")
         self.restart_node(0, ['-rpcworkqueue=1', '-rpcthreads=1'])
-        got_exceeded_error = []
+        # Requests beyond the depth of the work queue wait for the worker
+        # thread instead of being rejected.
+        results = []
         threads = []
+        start = time.time()
         for _ in range(3):
-            t = Thread(target=test_work_queue_getblock, args=(self.nodes[0], got_exceeded_error))
+            t = Thread(target=test_work_queue_getblock, args=(self.nodes[0], results))
             t.start()
             threads.append(t)
         for t in threads:
             t.join()
+        assert_equal(len(results), 3)
+        assert all(result["height"] == self.nodes[0].getblockcount() for result in results)
+        # The requests were handled one after the other.
+        assert_greater_than_or_equal(time.time() - start, 1.5)
+
+    def test_parked_requests(self):
+        self.log.info("Testing that requests waiting for a block do not occupy worker threads...")
+        node = self.nodes[0]
+        tip = node.getbestblockhash()
+        url = urllib.parse.urlparse(node.url)
+        headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"}
+        request = json.dumps({"method": "waitfornewblock", "params": [0, tip], "id": 1})
+        results = []
+
+        def wait_for_block():
+            rpc = get_rpc_proxy(node.url, 0, timeout=60, coveragedir=node.coverage_dir)
+            results.append(rpc.waitfornewblock(0, tip))
+
+        def wait_for_log(message, count):
+            def logged():
+                with open(node.debug_log_path, "rb") as dl:
+                    dl.seek(log_size)
+                    return dl.read().count(message) == count
+            self.wait_until(logged)
+
+        # More waiting requests than there are worker threads (-rpcthreads=1)
+        log_size = node.debug_log_size(mode="rb")
+        thread = Thread(target=wait_for_block)
+        thread.start()
+        dropped = http.client.HTTPConnection(url.hostname, url.port)
+        dropped.request("POST", "/", request, headers)
+        wait_for_log(b"Parking waitfornewblock request", 2)
+
+        # No more than -rpcthreads plus -rpcworkqueue requests are parked.
+        rejected = http.client.HTTPConnection(url.hostname, url.port)
+        rejected.request("POST", "/", request, headers)
+        assert_equal(rejected.getresponse().status, 503)
+        rejected.close()
+
+        # Requests of clients that went away are dropped.
+        dropped.close()
+        wait_for_log(b"Dropping parked waitfornewblock request", 1)
+
+        # The worker thread handles other requests meanwhile.
+        assert_equal(node.getbestblockhash(), tip)
+        assert_equal(node.waitfornewblock(100)["hash"], tip)
+        assert_equal(node.waitforblockheight(node.getblockcount(), 100)["hash"], tip)
+        assert_equal(len(results), 0)
+
+        self.generate(node, 1, sync_fun=self.no_op)
+        thread.join()
+        assert_equal(results, [{"hash": node.getbestblockhash(), "height": node.getblockcount()}])
+
+    def test_cbor(self):
+        self.log.info("Testing CBOR requests and replies...")
+        node = self.nodes[0]
+        block_hash = node.getbestblockhash()
+        # A raw block is documented as hex, so it is sent as bytes.
+        response, status = send_cbor_rpc(node, {"method": "getblock", "params": [block_hash, 0], "id": 1})
+        assert_equal(status, 200)
+        raw_block = node.getblock(block_hash, 0)
+        assert_equal(response, {"result": bytes.fromhex(raw_block), "error": None, "id": 1})
+
+        # So are hex strings nested in results, while amounts keep their digits.
+        response, status = send_cbor_rpc(node, {"jsonrpc": "2.0", "method": "getblock", "params": {"blockhash": block_hash, "verbosity": 1}, "id": 2})
+        assert_equal(status, 200)
+        block = node.getblock(block_hash, 1)
+        assert_equal(response["result"]["tx"], [bytes.fromhex(txid) for txid in block["tx"]])
+        assert_equal(response["result"]["height"], block["height"])
+        response, status = send_cbor_rpc(node, {"method": "getrawtransaction", "params": [block["tx"][0], 1, block_hash], "id": 3})
+        assert_equal(status, 200)
+        tx = node.getrawtransaction(block["tx"][0], 1, block_hash)
+        assert_equal(response["result"]["hex"], bytes.fromhex(tx["hex"]))
+        assert_equal(response["result"]["vout"][0]["value"], tx["vout"][0]["value"])
+        assert_greater_than(len(json.dumps(tx, default=str)), len(cbor_encode(response["result"])))
+
+        # Hex arguments may be sent as bytes.
+        response, status = send_cbor_rpc(node, {"method": "decoderawtransaction", "params": [bytes.fromhex(tx["hex"])], "id": 3})
+        assert_equal(status, 200)
+        assert_equal(response["result"]["txid"], bytes.fromhex(tx["txid"]))
+
+        # Batches and errors are replied to in CBOR too.
+        response, status = send_cbor_rpc(node, [{"method": "getblockcount", "id": 4}, {"method": "invalidmethod", "id": 5}])
+        assert_equal(status, 200)
+        assert_equal(response[0], {"result": node.getblockcount(), "error": None, "id": 4})
+        assert_equal(response[1]["error"]["code"], RPC_METHOD_NOT_FOUND)
+        response, status = send_cbor_rpc(node, {"method": "invalidmethod", "id": 6})
+        assert_equal(status, 404)
+        assert_equal(response["error"]["code"], RPC_METHOD_NOT_FOUND)
+        response, status = send_cbor_rpc(node, b"\x5f")
+        assert_equal(status, 500)
+        assert_equal(response["error"], {"code": RPC_PARSE_ERROR, "message": "Indefinite length CBOR items are not supported"})
 
     def run_test(self):
         self.test_getrpcinfo()
         self.test_batch_requests()
         self.test_http_status_codes()
         self.test_work_queue_exceeded()
+        self.test_parked_requests()
+        self.test_concurrent_batch()
+        self.test_cbor()
 
 
 if __name__ == '__main__':
@@ -130,6 +130,7 @@ class ZMQTest (BitcoinTestFramework):
             self.test_reorg()
             self.test_multiple_interfaces()
             self.test_ipv6()
+            self.test_replay()
         finally:
             # Destroy the ZMQ context.
             self.log.debug("Destroying ZMQ context")
@@ -137,7 +138,7 @@ class ZMQTest (BitcoinTestFramework):
 
     # Restart node with the specified zmq notifications enabled, subscribe to
     # all of them and return the corresponding ZMQSubscriber objects.
-    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True, ipv6=False):
+    def setup_zmq_test(self, services, *, recv_timeout=60, sync_blocks=True, ipv6=False, extra_args=[]):
         subscribers = []
         for topic, address in services:
             socket = self.ctx.socket(zmq.SUB)
@@ -145,7 +146,7 @@ class ZMQTest (BitcoinTestFramework):
                 socket.setsockopt(zmq.IPV6, 1)
             subscribers.append(ZMQSubscriber(socket, topic.encode()))
 
-        self.restart_node(0, [f"-zmqpub{topic}={address.replace('ipc://', 'unix:')}" for topic, address in services])
+        self.restart_node(0, [f"-zmqpub{topic}={address.replace('ipc://', 'unix:')}" for topic, address in services] + extra_args)
 
         for i, sub in enumerate(subscribers):
             sub.socket.connect(services[i][1])
@@ -588,6 +589,52 @@ class ZMQTest (BitcoinTestFramework):
         # Should receive the same block hash
         assert_equal(self.nodes[0].getbestblockhash(), subscribers[0].receive().hex())
 
+    def test_replay(self):
+        self.log.info("Testing replay of published messages")
+        replay_address = f"tcp://127.0.0.1:{self.zmq_port_base + 1}"
+        subscribers = self.setup_zmq_test([
+            ("hashblock", f"tcp://127.0.0.1:{self.zmq_port_base}"),
+            ("hashtx", f"tcp://127.0.0.1:{self.zmq_port_base}"),
+        ], sync_blocks=False, extra_args=[f"-zmqreplay={replay_address}"])
+        hashblock, hashtx = subscribers
+
+        first_seq = hashblock.sequence
+        genhashes = self.generatetoaddress(self.nodes[0], 3, ADDRESS_BCRT1_UNSPENDABLE, sync_fun=self.no_op)
+        for genhash in genhashes:
+            assert_equal(genhash, hashblock.receive().hex())
+            hashtx.receive()
+
+        replay = self.ctx.socket(zmq.REQ)
+        replay.set(zmq.RCVTIMEO, 60000)
+        replay.connect(replay_address)
+
+        def request(topic, seq):
+            replay.send_multipart([topic, struct.pack('<I', seq)])
+            return replay.recv_multipart()
+
+        self.log.debug("Messages are replayed as published, from the requested sequence number on")
+        parts = request(b"hashblock", first_seq)
+        assert_equal(len(parts), 3 * len(genhashes))
+        for i, genhash in enumerate(genhashes):
+            topic, body, seq = parts[3 * i:3 * i + 3]
+            assert_equal(topic, b"hashblock")
+            assert_equal(body.hex(), genhash)
+            assert_equal(struct.unpack('<I', seq)[0], first_seq + i)
+        assert_equal(request(b"hashblock", first_seq + 2)[1].hex(), genhashes[2])
+
+        self.log.debug("Requests for a sequence number that was not published yet or an unknown topic get an empty reply")
+        assert_equal(request(b"hashblock", hashblock.sequence), [b""])
+        assert_equal(request(b"rawtx", 0), [b""])
+        replay.send_multipart([b"hashblock"])
+        assert_equal(replay.recv_multipart(), [b""])
+
+        self.log.debug("No messages are kept with -zmqreplaysize=0")
+        self.setup_zmq_test([
+            ("rawblock", f"tcp://127.0.0.1:{self.zmq_port_base}"),
+        ], sync_blocks=False, extra_args=[f"-zmqreplay={replay_address}", "-zmqreplaysize=0"])
+        assert_equal(request(b"rawblock", 0), [b""])
+        replay.close(linger=0)
+
 
 if __name__ == '__main__':
     ZMQTest(__file__).main()
@@ -195,6 +195,7 @@ class MempoolPersistTest(BitcoinTestFramework):
 
         self.test_importmempool_union()
         self.test_persist_unbroadcast()
+        self.test_persist_interval()
 
     def test_persist_unbroadcast(self):
         node0 = self.nodes[0]
@@ -218,6 +219,26 @@ class MempoolPersistTest(BitcoinTestFramework):
         node0.mockscheduler(16 * 60)  # 15 min + 1 for buffer
         self.wait_until(lambda: len(conn.get_invs()) == 1)
 
+    def test_persist_interval(self):
+        self.log.debug("Check that -persistmempoolinterval saves the mempool while running")
+        node0 = self.nodes[0]
+        self.restart_node(0, extra_args=["-persistmempoolinterval=1"])
+        self.generate(node0, 1, sync_fun=self.no_op)
+        self.wait_until(lambda: node0.getmempoolinfo()["loaded"])
+
+        # The first flush rewrites the file, later ones append to it.
+        tx_rewritten = self.mini_wallet.send_self_transfer(from_node=node0)
+        node0.mockscheduler(1)
+        tx_appended = self.mini_wallet.send_self_transfer(from_node=node0)
+        node0.mockscheduler(1)
+
+        self.log.debug("Kill the node and check the transactions are loaded on restart")
+        node0.kill_process()
+        self.start_node(0)
+        self.wait_until(lambda: node0.getmempoolinfo()["loaded"])
+        assert_equal(set(node0.getrawmempool()), {tx_rewritten["txid"], tx_appended["txid"]})
+        self.stop_node(0)
+
     def test_importmempool_union(self):
         self.log.debug("Submit different transactions to node0 and node1's mempools")
         self.start_node(0)
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction relay through reconciliation (BIP 330).
+
+Relay the same number of transactions through a small network of nodes,
+first announcing them by flooding and then with -txreconciliation, and
+report the bandwidth spent on announcing each relayed transaction.
+
+Nodes on the same host see next to no latency, so flooding rarely announces
+a transaction over a link in both directions here, which is the redundancy
+reconciliation saves on a real network. The figures are logged for
+comparison rather than asserted, which is why this test is only part of the
+extended test suite.
+"""
+import time
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_greater_than
+from test_framework.wallet import MiniWallet
+
+NUM_NODES = 8
+NUM_TXS = 60
+# Transactions submitted per (mock) second.
+TX_RATE = 4
+# Messages announcing transactions, as opposed to relaying them (tx, getdata).
+ANNOUNCEMENT_MSGS = ["inv", "reqrecon", "sketch", "reconcildiff"]
+
+
+class TxReconTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = NUM_NODES
+        self.setup_clean_chain = False
+
+    def setup_network(self):
+        self.setup_nodes()
+        self.connect_ring()
+
+    def connect_ring(self):
+        # Every node makes three outbound connections and accepts three inbound ones.
+        for i in range(NUM_NODES):
+            for j in range(1, 4):
+                self.connect_nodes(i, (i + j) % NUM_NODES)
+
+    def sent_bytes(self):
+        totals = {}
+        for node in self.nodes:
+            for peer in node.getpeerinfo():
+                for msg, sent in peer["bytessent_per_msg"].items():
+                    totals[msg] = totals.get(msg, 0) + sent
+        return totals
+
+    def relay(self, extra_args):
+        self.log.info(f"Relay {NUM_TXS} transactions among {NUM_NODES} nodes with {extra_args or 'flooding'}")
+        for i in range(NUM_NODES):
+            self.restart_node(i, extra_args=extra_args)
+        self.connect_ring()
+        self.sync_blocks()
+        mock_time = int(time.time())
+        for node in self.nodes:
+            node.setmocktime(mock_time)
+
+        def bump_mocktime():
+            nonlocal mock_time
+            mock_time += 1
+            for node in self.nodes:
+                node.setmocktime(mock_time)
+
+        # Submit each transaction to a different node.
+        before = self.sent_bytes()
+        txids = set()
+        for i in range(NUM_TXS):
+            tx = self.wallet.send_self_transfer(from_node=self.nodes[i % NUM_NODES], utxo_to_spend=self.wallet.get_utxo(confirmed_only=True))
+            txids.add(tx["txid"])
+            if i % TX_RATE == TX_RATE - 1:
+                bump_mocktime()
+                time.sleep(0.2)
+
+        def relayed():
+            bump_mocktime()
+            time.sleep(0.2)
+            return all(txids <= set(node.getrawmempool()) for node in self.nodes)
+        self.wait_until(relayed)
+
+        after = self.sent_bytes()
+        sent = {msg: after.get(msg, 0) - before.get(msg, 0) for msg in ANNOUNCEMENT_MSGS}
+        per_tx = sum(sent.values()) / NUM_TXS
+        self.log.info(f"Announcement bytes per relayed transaction: {per_tx:.1f} ({sent})")
+
+        self.generate(self.nodes[0], 1)
+        return sent, per_tx
+
+    def run_test(self):
+        self.wallet = MiniWallet(self.nodes[0])
+        # Confirmed coins to spend in both runs.
+        self.wallet.send_self_transfer_multi(from_node=self.nodes[0], num_outputs=2 * NUM_TXS)
+        self.generate(self.nodes[0], 1)
+        self.wallet.rescan_utxos()
+
+        flood_sent, flood_per_tx = self.relay([])
+        assert_greater_than(flood_sent["inv"], 0)
+        assert all(flood_sent[msg] == 0 for msg in ["reqrecon", "sketch", "reconcildiff"])
+
+        recon_sent, recon_per_tx = self.relay(["-txreconciliation"])
+        assert all(recon_sent[msg] > 0 for msg in ["reqrecon", "sketch", "reconcildiff"])
+        self.log.info(f"Reconciliation changed announcement bytes per transaction by {(recon_per_tx / flood_per_tx - 1) * 100:+.0f}%")
+
+
+if __name__ == '__main__':
+    TxReconTest(__file__).main()
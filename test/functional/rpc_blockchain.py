@@ -716,8 +716,11 @@ class BlockchainTest(BitcoinTestFramework):
         # Move instead of deleting so we can restore chain state afterwards
         move_block_file('rev00000.dat', 'rev_wrong')
 
-        assert_raises_rpc_error(-32603, "Undo data expected but can't be read. This could be due to disk corruption or a conflict with a pruning event.", lambda: node.getblock(blockhash, 2))
-        assert_raises_rpc_error(-32603, "Undo data expected but can't be read. This could be due to disk corruption or a conflict with a pruning event.", lambda: node.getblock(blockhash, 3))
+        # The results for blockhash above are served from the response cache
+        # without reading the undo data, so use a block not requested yet.
+        uncached_blockhash = node.getblockhash(1)
+        assert_raises_rpc_error(-32603, "Undo data expected but can't be read. This could be due to disk corruption or a conflict with a pruning event.", lambda: node.getblock(uncached_blockhash, 2))
+        assert_raises_rpc_error(-32603, "Undo data expected but can't be read. This could be due to disk corruption or a conflict with a pruning event.", lambda: node.getblock(uncached_blockhash, 3))
 
         # Restore chain state
         move_block_file('rev_wrong', 'rev00000.dat')
@@ -747,7 +750,7 @@ class BlockchainTest(BitcoinTestFramework):
 
         self.log.info("Test getblock when block is missing")
         move_block_file('blk00000.dat', 'blk00000.dat.bak')
-        assert_raises_rpc_error(-1, "Block not found on disk", node.getblock, blockhash)
+        assert_raises_rpc_error(-1, "Block not found on disk", node.getblock, uncached_blockhash)
         move_block_file('blk00000.dat.bak', 'blk00000.dat')
 
 
@@ -7,10 +7,14 @@
 Test the following RPCs:
    - estimatesmartfee
    - estimaterawfee
+   - estimatemempoolfee
 """
 
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_raises_rpc_error
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
 
 class EstimateFeeTest(BitcoinTestFramework):
     def set_test_params(self):
@@ -20,6 +24,7 @@ class EstimateFeeTest(BitcoinTestFramework):
         # missing required params
         assert_raises_rpc_error(-1, "estimatesmartfee", self.nodes[0].estimatesmartfee)
         assert_raises_rpc_error(-1, "estimaterawfee", self.nodes[0].estimaterawfee)
+        assert_raises_rpc_error(-1, "estimatemempoolfee", self.nodes[0].estimatemempoolfee)
 
         # cli handles wrong types differently
         if not self.options.usecli:
@@ -38,6 +43,8 @@ class EstimateFeeTest(BitcoinTestFramework):
 
         # max value of 1008 per src/policy/fees.h
         assert_raises_rpc_error(-8, "Invalid conf_target, must be between 1 and 1008", self.nodes[0].estimaterawfee, 1009)
+        # max value of 24 per src/node/mempool_forecast.h
+        assert_raises_rpc_error(-8, "Invalid conf_target, must be between 1 and 24", self.nodes[0].estimatemempoolfee, 25)
 
         # valid calls
         self.nodes[0].estimatesmartfee(1)
@@ -50,6 +57,11 @@ class EstimateFeeTest(BitcoinTestFramework):
         self.nodes[0].estimaterawfee(1, None)
         self.nodes[0].estimaterawfee(1, 1)
 
+        # an empty mempool needs no more than the minimum fee
+        mempool_fee = self.nodes[0].estimatemempoolfee(2)
+        assert_equal(mempool_fee["feerate"], self.nodes[0].getmempoolinfo()["mempoolminfee"])
+        assert_equal(mempool_fee["blocks"], 2)
+
 
 if __name__ == '__main__':
     EstimateFeeTest(__file__).main()
@@ -22,6 +22,7 @@ from test_framework.util import (
     assert_approx,
     assert_equal,
     assert_greater_than,
+    assert_greater_than_or_equal,
     assert_raises_rpc_error,
     p2p_port,
 )
@@ -150,6 +151,8 @@ class NetTest(BitcoinTestFramework):
                 "addr_relay_enabled": False,
                 "bip152_hb_from": False,
                 "bip152_hb_to": False,
+                "block_download_rate": 0,
+                "block_latency": 0,
                 "bytesrecv_per_msg": {},
                 "bytessent_per_msg": {},
                 "connection_type": "inbound",
@@ -157,6 +160,7 @@ class NetTest(BitcoinTestFramework):
                 "id": no_version_peer_id,
                 "inbound": True,
                 "inflight": [],
+                "inflight_limit": 16,
                 "last_block": 0,
                 "last_transaction": 0,
                 "lastrecv": 0 if not self.options.v2transport else no_version_peer_conntime,
@@ -199,6 +203,12 @@ class NetTest(BitcoinTestFramework):
         self.wait_until(lambda: (self.nodes[0].getnettotals()['totalbytessent'] >= net_totals_before['totalbytessent'] + ping_size * 2), timeout=1)
         self.wait_until(lambda: (self.nodes[0].getnettotals()['totalbytesrecv'] >= net_totals_before['totalbytesrecv'] + ping_size * 2), timeout=1)
 
+        send_path_before = net_totals_before['sendpath']
+        send_path_after = self.nodes[0].getnettotals()['sendpath']
+        assert_greater_than(send_path_after['syscalls'], send_path_before['syscalls'])
+        assert_greater_than(send_path_after['messages'], send_path_before['messages'])
+        assert_greater_than_or_equal(send_path_after['bytes'], send_path_before['bytes'] + ping_size * 2)
+
         for peer_before in peer_info_before:
             peer_after = lambda: next(p for p in self.nodes[0].getpeerinfo() if p['id'] == peer_before['id'])
             self.wait_until(lambda: peer_after()['bytesrecv_per_msg'].get('pong', 0) >= peer_before['bytesrecv_per_msg'].get('pong', 0) + ping_size, timeout=1)
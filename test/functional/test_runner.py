@@ -85,6 +85,7 @@ EXTENDED_SCRIPTS = [
     'feature_pruning.py',
     'feature_dbcrash.py',
     'feature_index_prune.py',
+    'p2p_txrecon.py',
 ]
 
 BASE_SCRIPTS = [